@@ -61,10 +61,17 @@ from bdi_agent_core import *
             ** "search_interval": if planning_mode=="online", it is possible to specify the interval search (in ms, min 100, default 500)
                                     which corresponds to the lapse of time in which JavaFF needs to provide an update about its plan search
 
+            ** "problem_delta": if planning_mode=="online", boolean value specifying if JavaFF gets just the changes to the PDDL problem
+                                    wrt. the last one it received, rather than the whole problem every time (default value = false)
+
             ** "min_commit_steps": if planning_mode=="online", it is possible to specify the min number of sequentially committed steps when an action is running
             (e.g. if b starts running and in the plan we have b->(c||e)->d, with 1 (default) we commit till the starts of (c||d), with 2 commit till the start of d)
 
             ** "debug_log_active": array containing the nodes of which you want to activate the debug log
+
+            ** "hosted_core": boolean value specifying if all the core nodes of the agent are run in a single process
+                                    (offline planning mode only, default value = false). One process per agent: agents
+                                    launched with it still get a host process each, PlanSys2 nodes stay separate processes
 '''
 def AgentLaunchDescription(
     agent_id='agent0',
@@ -156,8 +163,8 @@ def AgentLaunchDescription(
 
     if(not run_only_psys2):
 
-        # create tmp folder, delete if already there
-        create_tmp_folder_agent(agent_id, True)
+        # create tmp folder, delete if already there (unless warm restart: the snapshots of the previous run are kept there)
+        create_tmp_folder_agent(agent_id, not get_warm_restart(init_params))
         if INIT_BSET_PARAM in init_params:
             # if passed as a param, put init belief set file in the agent tmp folder
             load_init_file(init_params[INIT_BSET_PARAM], 'init_bset.yaml', agent_id)
@@ -170,6 +177,16 @@ def AgentLaunchDescription(
             # if passed as a param, put init reactive rules set file in the agent tmp folder
             load_init_file(init_params[INIT_RRULESSET_PARAM], 'init_reactive_rules.yaml', agent_id)   
     
+    if(not run_only_psys2 and get_hosted_core(init_params) and planning_mode != 'offline'):
+        print("Core nodes of agent \"{}\" cannot be hosted in a single process in \"{}\" planning mode".format(agent_id, planning_mode))
+
+    if(not run_only_psys2 and get_hosted_core(init_params) and planning_mode == 'offline'):
+        '''
+            [*] ROS2_BDI CORE nodes hosted in a single process
+        '''
+        ld.add_action(build_AgentCoreHost(namespace, agent_id, agent_group, init_params))
+
+    elif(not run_only_psys2):
         '''
             [*] PLANSYS MONITOR NODE init.
         '''
@@ -218,6 +235,7 @@ def AgentLaunchDescription(
         #Add event listener node
         ld.add_action(event_listener)
         
+    if(not run_only_psys2):
         for act in sensors:
             if isinstance(act, AgentSensor):
                 ld.add_action( act.to_node(namespace, [{AGENT_ID_PARAM: agent_id}, {AGENT_GROUP_ID_PARAM: agent_group}]) )
@@ -1,4 +1,5 @@
 from math import inf
+import yaml
 from launch_ros.actions import Node
 
 # Bringup parameters
@@ -26,63 +27,108 @@ def is_list_of(l, type):
 
 
 
+'''
+    Hosted core flag (all the core nodes of the agent in a single process), default False
+'''
+def get_hosted_core(init_params):
+    return HOSTED_CORE_PARAM in init_params and isinstance(init_params[HOSTED_CORE_PARAM], bool) and init_params[HOSTED_CORE_PARAM]
+
+'''
+    Warm restart flag (restore mental state from the snapshots of the previous run), default False
+'''
+def get_warm_restart(init_params):
+    return WARM_RESTART_PARAM in init_params and isinstance(init_params[WARM_RESTART_PARAM], bool) and init_params[WARM_RESTART_PARAM]
+
+'''
+    Names of predicates/functions (or types of instances) whose beliefs are static, i.e. immutable once known, default none
+'''
+def get_static_belief_names(init_params):
+    if STATIC_BELIEF_NAMES_PARAM in init_params and isinstance(init_params[STATIC_BELIEF_NAMES_PARAM], list):
+        return [name for name in init_params[STATIC_BELIEF_NAMES_PARAM] if isinstance(name, str)]
+    return []
+
 '''
     PlanSys2Monitor Node builder
 '''
 def build_PlanSysMonitor(namespace, agent_id, init_params):
-    debug = (DEBUG_ACTIVE_NODES_PARAM in init_params) and ('plansys_monitor' in init_params[DEBUG_ACTIVE_NODES_PARAM])
-    planning_mode = 'offline'
-    if PLANNING_MODE_PARAM in init_params:
-        planning_mode = init_params[PLANNING_MODE_PARAM] if init_params[PLANNING_MODE_PARAM] in ['offline', 'online'] else 'offline'
-    
     return Node(
         package='ros2_bdi_core',
         executable='plansys_monitor',
         name='plansys_monitor',
         namespace=namespace,
         output='screen',
-        parameters=[ {AGENT_ID_PARAM: agent_id}, {DEBUG_PARAM: debug}, {PLANNING_MODE_PARAM: planning_mode}])
+        parameters=PlanSysMonitor_params(agent_id, init_params))
 
-'''
-    BeliefManager Node builder
-'''
-def build_BeliefManager(namespace, agent_id, init_params):
-    debug = (DEBUG_ACTIVE_NODES_PARAM in init_params) and ('belief_manager' in init_params[DEBUG_ACTIVE_NODES_PARAM])
+def PlanSysMonitor_params(agent_id, init_params):
+    debug = (DEBUG_ACTIVE_NODES_PARAM in init_params) and ('plansys_monitor' in init_params[DEBUG_ACTIVE_NODES_PARAM])
     planning_mode = 'offline'
     if PLANNING_MODE_PARAM in init_params:
         planning_mode = init_params[PLANNING_MODE_PARAM] if init_params[PLANNING_MODE_PARAM] in ['offline', 'online'] else 'offline'
+    
+    return [ {AGENT_ID_PARAM: agent_id}, {DEBUG_PARAM: debug}, {PLANNING_MODE_PARAM: planning_mode}]
 
+'''
+    BeliefManager Node builder
+'''
+def build_BeliefManager(namespace, agent_id, init_params):
     return Node(
         package='ros2_bdi_core',
         executable='belief_manager',
         name='belief_manager',
         namespace=namespace,
         output='screen',
-        parameters= [ {AGENT_ID_PARAM: agent_id}, {DEBUG_PARAM: debug},{PLANNING_MODE_PARAM: planning_mode},  ])
+        parameters=BeliefManager_params(agent_id, init_params))
+
+def BeliefManager_params(agent_id, init_params):
+    debug = (DEBUG_ACTIVE_NODES_PARAM in init_params) and ('belief_manager' in init_params[DEBUG_ACTIVE_NODES_PARAM])
+    planning_mode = 'offline'
+    if PLANNING_MODE_PARAM in init_params:
+        planning_mode = init_params[PLANNING_MODE_PARAM] if init_params[PLANNING_MODE_PARAM] in ['offline', 'online'] else 'offline'
+    # empty list not passed at all (its type could not be inferred)
+    static_belief_names = get_static_belief_names(init_params)
+
+    return [ {AGENT_ID_PARAM: agent_id}, {DEBUG_PARAM: debug},{PLANNING_MODE_PARAM: planning_mode}, {WARM_RESTART_PARAM: get_warm_restart(init_params)}, ] + \
+            ([{STATIC_BELIEF_NAMES_PARAM: static_belief_names}] if len(static_belief_names) > 0 else [])
     
 
 '''
     Reactive Rules Event Listener Node builder
 '''
 def build_EventListener(namespace, agent_id, init_params):
-    debug = (DEBUG_ACTIVE_NODES_PARAM in init_params) and ('event_listener' in init_params[DEBUG_ACTIVE_NODES_PARAM])
-    planning_mode = 'offline'
-    if PLANNING_MODE_PARAM in init_params:
-        planning_mode = init_params[PLANNING_MODE_PARAM] if init_params[PLANNING_MODE_PARAM] in ['offline', 'online'] else 'offline'
-
     return Node(
         package='ros2_bdi_core',
         executable='event_listener',
         name='event_listener',
         namespace=namespace,
         output='screen',
-        parameters= [ {AGENT_ID_PARAM: agent_id}, {DEBUG_PARAM: debug},{PLANNING_MODE_PARAM: planning_mode}, ])
+        parameters=EventListener_params(agent_id, init_params))
+
+def EventListener_params(agent_id, init_params):
+    debug = (DEBUG_ACTIVE_NODES_PARAM in init_params) and ('event_listener' in init_params[DEBUG_ACTIVE_NODES_PARAM])
+    planning_mode = 'offline'
+    if PLANNING_MODE_PARAM in init_params:
+        planning_mode = init_params[PLANNING_MODE_PARAM] if init_params[PLANNING_MODE_PARAM] in ['offline', 'online'] else 'offline'
+
+    return [ {AGENT_ID_PARAM: agent_id}, {DEBUG_PARAM: debug},{PLANNING_MODE_PARAM: planning_mode}, {WARM_RESTART_PARAM: get_warm_restart(init_params)}, ]
 
 
 '''
     Scheduler Node builder, pass init_params to check, eval and set init parameters for the node
 '''
 def build_Scheduler(namespace, agent_id, init_params):
+    planning_mode = 'offline'
+    if PLANNING_MODE_PARAM in init_params:
+        planning_mode = init_params[PLANNING_MODE_PARAM] if init_params[PLANNING_MODE_PARAM] in ['offline', 'online'] else 'offline'
+
+    return Node(
+        package='ros2_bdi_core',
+        executable='scheduler_'+planning_mode,
+        name='scheduler_'+planning_mode,
+        namespace=namespace,
+        output='screen',
+        parameters=Scheduler_params(agent_id, init_params))
+
+def Scheduler_params(agent_id, init_params):
     
     debug = (DEBUG_ACTIVE_NODES_PARAM in init_params) and ('scheduler' in init_params[DEBUG_ACTIVE_NODES_PARAM])
 
@@ -128,6 +174,7 @@ def build_Scheduler(namespace, agent_id, init_params):
     interval_search_ms = 500
     max_pplan_size = 32000
     max_empty_search_intervals = 16
+    problem_delta = False
 
     if planning_mode == 'online' and SEARCH_INTERVAL_MS_PARAM in init_params and isinstance(init_params[SEARCH_INTERVAL_MS_PARAM], int):
         interval_search_ms = init_params[SEARCH_INTERVAL_MS_PARAM]
@@ -141,13 +188,10 @@ def build_Scheduler(namespace, agent_id, init_params):
         max_empty_search_intervals = init_params[MAX_EMPTY_SEARCH_INTERVALS_PARAM]
         max_empty_search_intervals = max_empty_search_intervals if max_empty_search_intervals > 0 else 1
 
-    return Node(
-        package='ros2_bdi_core',
-        executable='scheduler_'+planning_mode,
-        name='scheduler_'+planning_mode,
-        namespace=namespace,
-        output='screen',
-        parameters=[
+    if planning_mode == 'online' and PROBLEM_DELTA_PARAM in init_params and isinstance(init_params[PROBLEM_DELTA_PARAM], bool):
+        problem_delta = init_params[PROBLEM_DELTA_PARAM]
+
+    return [
             {AGENT_ID_PARAM: agent_id},
             {RESCHEDULE_POLICY_PARAM: reschedule_policy},
             {COMP_PLAN_TRIES_PARAM: comp_plan_tries},
@@ -158,14 +202,25 @@ def build_Scheduler(namespace, agent_id, init_params):
             {SEARCH_INTERVAL_MS_PARAM: interval_search_ms},
             {MAX_PPLAN_SIZE_PARAM: max_pplan_size},
             {MAX_EMPTY_SEARCH_INTERVALS_PARAM: max_empty_search_intervals},
+            {PROBLEM_DELTA_PARAM: problem_delta},
+            {WARM_RESTART_PARAM: get_warm_restart(init_params)},
             {DEBUG_PARAM: debug}
-        ])
+        ]
 
 
 '''
     PlanDirector Node builder, pass init_params to check, eval and set init parameters for the node
 '''
 def build_PlanDirector(namespace, agent_id, init_params):
+    return Node(
+        package='ros2_bdi_core',
+        executable='plan_director',
+        name='plan_director',
+        namespace=namespace,
+        output='screen',
+        parameters=PlanDirector_params(agent_id, init_params))
+
+def PlanDirector_params(agent_id, init_params):
 
     debug = (DEBUG_ACTIVE_NODES_PARAM in init_params) and ('plan_director' in init_params[DEBUG_ACTIVE_NODES_PARAM])
 
@@ -182,18 +237,12 @@ def build_PlanDirector(namespace, agent_id, init_params):
     if PLANNING_MODE_PARAM in init_params:
         planning_mode = init_params[PLANNING_MODE_PARAM] if init_params[PLANNING_MODE_PARAM] in ['offline', 'online'] else 'offline'
 
-    return Node(
-        package='ros2_bdi_core',
-        executable='plan_director',
-        name='plan_director',
-        namespace=namespace,
-        output='screen',
-        parameters=[
+    return [
             {AGENT_ID_PARAM: agent_id},
             {ABORT_SURPASS_DEADLINE_DEADLINE_PARAM: abort_surpass_deadline},
             {PLANNING_MODE_PARAM: planning_mode},
             {DEBUG_PARAM: debug}
-        ])
+        ]
 
 
 '''
@@ -201,6 +250,16 @@ def build_PlanDirector(namespace, agent_id, init_params):
     Agent group id is needed too
 '''
 def build_MARequestHandlerNode(namespace, agent_id, agent_group, init_params):
+    return Node(
+        package='ros2_bdi_core',
+        executable='ma_request_handler',
+        name='ma_request_handler',
+        namespace=namespace,
+        output='screen',
+        parameters=MARequestHandler_params(agent_id, agent_group, init_params)
+    )
+
+def MARequestHandler_params(agent_id, agent_group, init_params):
 
     debug = (DEBUG_ACTIVE_NODES_PARAM in init_params) and ('ma_request_handler' in init_params[DEBUG_ACTIVE_NODES_PARAM])
 
@@ -223,11 +282,32 @@ def build_MARequestHandlerNode(namespace, agent_id, agent_group, init_params):
     if PLANNING_MODE_PARAM in init_params:
         planning_mode = init_params[PLANNING_MODE_PARAM] if init_params[PLANNING_MODE_PARAM] in ['offline', 'online'] else 'offline'
 
+    return communication_node_params + [{PLANNING_MODE_PARAM: planning_mode},]
+
+
+'''
+    Agent Core Host Node builder: single process hosting all the core nodes of ONE agent (offline planning mode only),
+    with the params of each node written in /tmp/{agent_id}/core_params.yaml under a section named after the node
+    (the host serves the agent in its namespace only, since PlanSys2 clients cannot be given another one)
+'''
+def build_AgentCoreHost(namespace, agent_id, agent_group, init_params):
+    core_params = {
+        'plansys_monitor': PlanSysMonitor_params(agent_id, init_params),
+        'belief_manager': BeliefManager_params(agent_id, init_params),
+        'scheduler': Scheduler_params(agent_id, init_params),
+        'plan_director': PlanDirector_params(agent_id, init_params),
+        'ma_request_handler': MARequestHandler_params(agent_id, agent_group, init_params),
+        'event_listener': EventListener_params(agent_id, init_params)
+    }
+
+    params_file = '/tmp/' + agent_id + '/core_params.yaml'
+    with open(params_file, 'w') as f:
+        yaml.dump({'/**/' + node_name: {'ros__parameters': {k: v for p in params for k, v in p.items()}} 
+            for node_name, params in core_params.items()}, f)
+
     return Node(
         package='ros2_bdi_core',
-        executable='ma_request_handler',
-        name='ma_request_handler',
+        executable='agent_core_host',
         namespace=namespace,
         output='screen',
-        parameters=communication_node_params + [{PLANNING_MODE_PARAM: planning_mode},]
-    )
\ No newline at end of file
+        parameters=[params_file])
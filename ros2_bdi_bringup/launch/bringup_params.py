@@ -11,6 +11,7 @@ PLANNER_PARAM = 'planner'
 SEARCH_INTERVAL_MS_PARAM = 'search_interval'
 MAX_PPLAN_SIZE_PARAM = 'max_pplan_size'
 MAX_EMPTY_SEARCH_INTERVALS_PARAM = 'max_null_search_intervals'
+PROBLEM_DELTA_PARAM = 'problem_delta'
 
 ACCEPT_BELIEFS_R_PARAM = 'belief_ck'
 ACCEPT_BELIEFS_W_PARAM = 'belief_w'
@@ -33,5 +34,9 @@ RESCHEDULE_POLICY_VAL_IF_EXEC_CLEAN = 'CLEAN_PREEMPT'
 MIN_COMMIT_STEPS_PARAM = 'min_commit_steps'
 SIM_TO_N_PARAM = 'sim_to_n'
 
+WARM_RESTART_PARAM = 'warm_restart'
+STATIC_BELIEF_NAMES_PARAM = 'static_belief_names'
+HOSTED_CORE_PARAM = 'hosted_core'
+
 DEBUG_PARAM = 'debug'
 DEBUG_ACTIVE_NODES_PARAM = 'debug_log_active'
\ No newline at end of file
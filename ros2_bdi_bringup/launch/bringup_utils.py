@@ -8,6 +8,7 @@ import shutil
 
     Folder will contain init files for agent and other tmp files 
     created and managed by @agent_id nodes during execution
+    (e.g. the snapshots used for warm restarts, hence do not wipe it when warm restarting)
 '''
 def create_tmp_folder_agent(agent_id, wipe = True):
     # remove tmp folder for agent if it does exist already
@@ -4,16 +4,21 @@
 #include <string>
 #include <vector>
 #include <set>
+#include <unordered_set>
 #include <map>
 #include <memory>
 #include <mutex>  
+#include <atomic>
+#include <optional>
 
 #include "plansys2_problem_expert/ProblemExpertClient.hpp"
 #include "plansys2_domain_expert/DomainExpertClient.hpp"
 #include "ros2_bdi_interfaces/msg/lifecycle_status.hpp"
 #include "ros2_bdi_interfaces/msg/belief.hpp"
 #include "ros2_bdi_interfaces/msg/belief_set.hpp"
+#include "ros2_bdi_interfaces/msg/belief_set_delta.hpp"
 #include "ros2_bdi_interfaces/msg/planning_system_state.hpp"
+#include "ros2_bdi_interfaces/srv/load_static_beliefs.hpp"
 #include "ros2_bdi_utils/ManagedBelief.hpp"
 
 #include "ros2_bdi_core/params/core_common_params.hpp"
@@ -49,14 +54,19 @@ class BeliefManager : public rclcpp::Node
         void step();
 
         /*
-            Wait for PlanSys2 to boot at best for max_wait
+            Wait for PlanSys2 to boot at best for max_wait (as notified by the PlanSys2 monitor of the agent)
         */
         bool wait_psys2_boot(const std::chrono::seconds max_wait = std::chrono::seconds(16))
         {
-            psys_monitor_client_ = std::make_shared<PlanSysMonitorClient>(BELIEF_MANAGER_NODE_NAME + std::string("_psys2caller_"), sel_planning_mode_);
-            return psys_monitor_client_->areAllPsysNodeActive(max_wait);
+            return PlanSysMonitorClient::waitPsysBoot(this->shared_from_this(), sel_planning_mode_, max_wait);
         }
 
+        /*
+            Write the current belief set (instances + predicates/functions) into the snapshot file
+            "/tmp/{agent_id}/bset.snapshot" (warm restart only); called periodically and on shutdown
+        */
+        void saveSnapshot();
+
     private:
         /*  
             Change internal state of the node
@@ -81,21 +91,39 @@ class BeliefManager : public rclcpp::Node
         }
 
         /*
-            Publish the current belief set of the agent in agent_id_/belief_set topic
+            Publish the dynamic partition of the current belief set of the agent in agent_id_/belief_set topic
+            (and the static one in agent_id_/static_belief_set, if it has grown since its last publication)
         */
         void publishBeliefSet();
 
+        /*
+            Publish the alterations to the belief set not notified yet in agent_id_/belief_set_delta topic (if any)
+        */
+        void publishBeliefSetDelta();
+
         /*
             Expect to find yaml file to init the belief set in "/tmp/{agent_id}/init_bset.yaml"
         */
         void tryInitBeliefSet();
 
+        /*
+            Restore the belief set from the snapshot file "/tmp/{agent_id}/bset.snapshot" in one pass:
+            instances first, then predicates and functions (no yaml parsing, no domain expert lookups, no missing instances checks)
+            Returns false if there is no valid snapshot to restore from or the init. file has been edited since the snapshot
+        */
+        bool tryRestoreBeliefSet();
+
         /*
             Callback wrt. "problem_expert/update_notify" topic which notifies about any change in the PDDL problem
             update belief set accordingly
         */
         void updatedPDDLProblem(const std_msgs::msg::Empty::SharedPtr msg);
 
+        /*
+            Retrieve the PDDL problem and, if it has changed since the last time, update the belief set accordingly
+        */
+        void syncBeliefSetWithPDDLProblem();
+
         
         bool updateBeliefSet(const std::vector<ros2_bdi_interfaces::msg::Belief>& ins_beliefs, 
             const std::vector<ros2_bdi_interfaces::msg::Belief>& pred_beliefs, const std::vector<ros2_bdi_interfaces::msg::Belief>& fun_beliefs);
@@ -150,6 +178,20 @@ class BeliefManager : public rclcpp::Node
         */
         void addBeliefSyncPDDL(const BDIManaged::ManagedBelief& mb);
 
+        /*
+            Load static beliefs service handler: install the requested block of facts (+ the ones in the given yaml file)
+        */
+        void handleLoadStaticBeliefs(const ros2_bdi_interfaces::srv::LoadStaticBeliefs::Request::SharedPtr request,
+            const ros2_bdi_interfaces::srv::LoadStaticBeliefs::Response::SharedPtr response);
+
+        /*
+            Install the block of facts @block in the pddl problem and in the belief set as a single belief set operation
+            (instances first, then predicates and functions creating the missing instances on the fly, one notification at the end)
+            and mark them as static. Each fact is still a distinct problem expert call, but the belief set is synced
+            with the PDDL problem just once, after the whole block. Returns the number of facts of the block which could not be installed
+        */
+        int loadStaticBeliefs(const std::vector<BDIManaged::ManagedBelief>& block);
+
         /*
             Create array of boolean flags denoting missing instances' positions
             wrt. parameters in the passed ManagedBelief argument
@@ -187,6 +229,19 @@ class BeliefManager : public rclcpp::Node
             delete belief from belief set
         */
         void delBelief(const BDIManaged::ManagedBelief& mb);
+
+        /*
+            mark belief (already in the belief set or about to be added) as static
+        */
+        void markStatic(const BDIManaged::ManagedBelief& mb);
+
+        /*
+            true if the belief is tagged as static through the static_belief_names param
+        */
+        bool isTaggedStatic(const BDIManaged::ManagedBelief& mb) const
+        {
+            return static_names_.count(mb.pddlType() == ros2_bdi_interfaces::msg::Belief().INSTANCE_TYPE? mb.type().name : mb.getName()) == 1;
+        }
         
 
         // internal state of the node
@@ -228,11 +283,42 @@ class BeliefManager : public rclcpp::Node
         // belief set of the agent <agent_id_>
         std::set<BDIManaged::ManagedBelief> belief_set_;
 
+        // belief set altered since the last snapshot (set from several callbacks)
+        std::atomic<bool> snapshot_dirty_;
+
+        // hash of the content of the init. file the belief set descends from (stored in the snapshots)
+        std::optional<uint32_t> init_bset_hash_;
+
+        // immutable beliefs (subset of belief_set_) installed through the static beliefs loader, flagged as static
+        // in the init. file or tagged through the static_belief_names param:
+        // they can't be deleted/modified, they're not diffed against the pddl problem and they're published
+        // apart from the dynamic ones, just when they grow
+        std::set<BDIManaged::ManagedBelief> static_beliefs_;
+        // predicate/function names and instance types tagged as static
+        std::unordered_set<std::string> static_names_;
+        // static beliefs altered since their last publication
+        bool static_bset_changed_;
+        // dynamic partition of the belief set as last published and flag to tell whether it needs to be rebuilt
+        ros2_bdi_interfaces::msg::BeliefSet dynamic_bset_msg_;
+        bool dynamic_bset_changed_;
+        // load static beliefs server
+        rclcpp::Service<ros2_bdi_interfaces::srv::LoadStaticBeliefs>::SharedPtr load_static_beliefs_server_;
+        // true while a block of static beliefs is being installed (PDDL problem update notifications not synced meanwhile)
+        std::atomic<bool> loading_static_block_;
+
+        // alterations to the belief set not published yet in the belief set delta topic
+        std::set<BDIManaged::ManagedBelief> delta_added_;
+        std::set<BDIManaged::ManagedBelief> delta_removed_;
+        // sequence number of the last published belief set delta
+        uint64_t delta_seq_;
+
         // belief set publishers/subscribers
         rclcpp::Subscription<ros2_bdi_interfaces::msg::Belief>::SharedPtr add_belief_subscriber_;//add belief notify on topic
         rclcpp::Subscription<ros2_bdi_interfaces::msg::BeliefSet>::SharedPtr add_belief_set_subscriber_;//add belief set notify on topic
         rclcpp::Subscription<ros2_bdi_interfaces::msg::Belief>::SharedPtr del_belief_subscriber_;//del belief notify on topic
         rclcpp::Publisher<ros2_bdi_interfaces::msg::BeliefSet>::SharedPtr belief_set_publisher_;//belief set publisher
+        rclcpp::Publisher<ros2_bdi_interfaces::msg::BeliefSetDelta>::SharedPtr belief_set_delta_publisher_;//belief set delta publisher
+        rclcpp::Publisher<ros2_bdi_interfaces::msg::BeliefSet>::SharedPtr static_belief_set_publisher_;//static belief set publisher
         rclcpp::Subscription<ros2_bdi_interfaces::msg::BeliefSet>::SharedPtr del_belief_set_subscriber_;//del belief set notify on topic
         
         // plansys2 problem expert notification for updates
@@ -245,9 +331,6 @@ class BeliefManager : public rclcpp::Node
         // Sub to updated lifecycle status
         rclcpp::Subscription<ros2_bdi_interfaces::msg::LifecycleStatus>::SharedPtr lifecycle_status_subscriber_;
 
-        // PlanSys2 Monitor Client supporting nodes & clients for calling the {psys2_node}/get_state services
-        std::shared_ptr<PlanSysMonitorClient> psys_monitor_client_;
-
 }; //BeliefManager class prototype
 
 #endif //BELIEF_MANAGER_H_
@@ -20,6 +20,7 @@
 #include "ros2_bdi_utils/ManagedDesire.hpp"
 #include "ros2_bdi_utils/ManagedCondition.hpp"
 #include "ros2_bdi_utils/ManagedReactiveRule.hpp"
+#include "ros2_bdi_utils/PartitionedBeliefSet.hpp"
 
 #include "ros2_bdi_utils/BDIFilter.hpp"
 
@@ -55,12 +56,11 @@ class EventListener : public rclcpp::Node
         bool init();
 
         /*
-            Wait for PlanSys2 to boot at best for max_wait
+            Wait for PlanSys2 to boot at best for max_wait (as notified by the PlanSys2 monitor of the agent)
         */
         bool wait_psys2_boot(const std::chrono::seconds max_wait = std::chrono::seconds(16))
         {
-            psys_monitor_client_ = std::make_shared<PlanSysMonitorClient>(EVENT_LISTENER_NODE_NAME + std::string("_psys2caller_"), sel_planning_mode_);
-            return psys_monitor_client_->areAllPsysNodeActive(max_wait);
+            return PlanSysMonitorClient::waitPsysBoot(this->shared_from_this(), sel_planning_mode_, max_wait);
         }
 
     private:
@@ -71,6 +71,9 @@ class EventListener : public rclcpp::Node
         /* Callback of belief set update -> if something changes and you've correctly booted, check if any rule applies*/
         void updBeliefSetCallback(const ros2_bdi_interfaces::msg::BeliefSet::SharedPtr msg);
 
+        /* Callback of static belief set update -> if it has grown and you've correctly booted, check if any rule applies*/
+        void updStaticBeliefSetCallback(const ros2_bdi_interfaces::msg::BeliefSet::SharedPtr msg);
+
         /* Callback of desire set update */
         void updDesireSetCallback(const ros2_bdi_interfaces::msg::DesireSet::SharedPtr msg)
         {
@@ -121,7 +124,7 @@ class EventListener : public rclcpp::Node
         // domain expert instance to call the plansys2 domain expert api
         std::shared_ptr<plansys2::DomainExpertClient> domain_expert_;
 
-        std::set<BDIManaged::ManagedBelief> belief_set_;
+        BDIManaged::PartitionedBeliefSet belief_set_;
         std::set<BDIManaged::ManagedDesire> desire_set_;
 
         // belief set publishers
@@ -134,6 +137,7 @@ class EventListener : public rclcpp::Node
         rclcpp::Publisher<ros2_bdi_interfaces::msg::Desire>::SharedPtr del_desire_publisher_;//del desire topic pub
 
         rclcpp::Subscription<ros2_bdi_interfaces::msg::BeliefSet>::SharedPtr belief_set_subscription_;//belief set subscription
+        rclcpp::Subscription<ros2_bdi_interfaces::msg::BeliefSet>::SharedPtr static_belief_set_subscription_;//static belief set subscription
         rclcpp::Subscription<ros2_bdi_interfaces::msg::DesireSet>::SharedPtr desire_set_subscription_;//desire set subscription
 
 
@@ -144,9 +148,6 @@ class EventListener : public rclcpp::Node
         // Sub to updated lifecycle status
         rclcpp::Subscription<ros2_bdi_interfaces::msg::LifecycleStatus>::SharedPtr lifecycle_status_subscriber_;
 
-        // PlanSys2 Monitor Client supporting nodes & clients for calling the {psys2_node}/get_state services
-        std::shared_ptr<PlanSysMonitorClient> psys_monitor_client_;
-
 }; //BeliefManager class prototype
 
 #endif //EVENT_LISTENER_H_
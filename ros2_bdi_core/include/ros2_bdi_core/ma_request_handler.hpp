@@ -2,13 +2,20 @@
 #define MA_REQUEST_HANDLER_H_
 
 #include <mutex>
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <algorithm>
 #include <vector>
 #include <map>
+#include <unordered_map>
+#include <memory>
 #include <thread>
 
 #include "ros2_bdi_interfaces/msg/lifecycle_status.hpp"
 #include "ros2_bdi_interfaces/msg/belief.hpp"
 #include "ros2_bdi_interfaces/msg/belief_set.hpp"
+#include "ros2_bdi_interfaces/msg/belief_set_delta.hpp"
 #include "ros2_bdi_interfaces/msg/desire.hpp"
 #include "ros2_bdi_interfaces/msg/desire_set.hpp"
 #include "ros2_bdi_interfaces/srv/is_accepted_operation.hpp"
@@ -16,20 +23,58 @@
 #include "ros2_bdi_interfaces/srv/upd_belief_set.hpp"
 #include "ros2_bdi_interfaces/srv/check_desire.hpp"
 #include "ros2_bdi_interfaces/srv/upd_desire_set.hpp"
+#include "ros2_bdi_interfaces/srv/check_belief_batch.hpp"
+#include "ros2_bdi_interfaces/srv/upd_belief_set_batch.hpp"
+#include "ros2_bdi_interfaces/srv/check_desire_batch.hpp"
+#include "ros2_bdi_interfaces/srv/upd_desire_set_batch.hpp"
 
 #include "ros2_bdi_utils/ManagedBelief.hpp"
 #include "ros2_bdi_utils/ManagedDesire.hpp"
+#include "ros2_bdi_utils/PartitionedBeliefSet.hpp"
 
 #include "ros2_bdi_core/params/core_common_params.hpp"
 #include "ros2_bdi_core/params/ma_request_handler_params.hpp"
 #include "ros2_bdi_core/support/planning_mode.hpp"
 #include "ros2_bdi_core/support/plansys_monitor_client.hpp"
+#include "ros2_bdi_core/support/deferred_service.hpp"
 
 #include "rclcpp/rclcpp.hpp"
 
 typedef enum {BELIEF, DESIRE} RequestObjType;  
 typedef enum {CHECK, WRITE} RequestObjOp;  
 
+/*
+  Write request (addition/deletion of beliefs or desires) waiting for the requested alterations to be confirmed,
+  its response deferred till then
+*/
+template<typename T>
+struct PendingUpdRequest
+{
+    std::vector<T> items;         // beliefs/desires to be added or deleted
+    std::vector<bool> confirmed;  // confirmation flag for each item
+    int upd_index;                // ADD_I or DEL_I
+    int waited_notifications;     // whole set notifications received since the request has been registered
+    std::chrono::steady_clock::time_point deadline; // request considered over (not confirmed alterations failed) once passed
+    std::function<void(const std::vector<bool>&)> respond; // send the deferred response given the final confirmation flags
+};
+
+/*
+  Permissions granted to a single agent group (compiled from the belief_ck, belief_w, desire_ck, desire_w, desire_pr params)
+*/
+struct GroupPermissions
+{
+    bool belief_check = false;
+    bool belief_write = false;
+    bool desire_check = false;
+    bool desire_write = false;
+    float desire_max_priority = -1.0f; // negative if desire_write not granted
+};
+
+/*
+  Immutable snapshot of the access-control policy: agent group name -> granted permissions
+*/
+typedef std::unordered_map<std::string, GroupPermissions> AccessPolicy;
+
 class MARequestHandler : public rclcpp::Node
 {
 public:
@@ -41,12 +86,11 @@ public:
     void init();
 
     /*
-        Wait for PlanSys2 to boot at best for max_wait
+        Wait for PlanSys2 to boot at best for max_wait (as notified by the PlanSys2 monitor of the agent)
     */
     bool wait_psys2_boot(const std::chrono::seconds max_wait = std::chrono::seconds(16))
     {
-        psys_monitor_client_ = std::make_shared<PlanSysMonitorClient>(MA_REQUEST_HANDLER_NODE_NAME + std::string("_psys2caller_"), sel_planning_mode_);
-        return psys_monitor_client_->areAllPsysNodeActive(max_wait);
+        return PlanSysMonitorClient::waitPsysBoot(this->shared_from_this(), sel_planning_mode_, max_wait);
     }
   
 
@@ -84,12 +128,48 @@ private:
     float getMaxAcceptedPriority(const std::string& requestingAgentGroup);
 
     /*
-      @updIndex to be used to know which lock has to be checked among the two in desire_set_upd_locks_
-      and which waiting counter has to be incremented and/or checked
+      Compile the access-control policy out of the current values of the access params, 
+      overridden by the ones in @changedParams (if any)
+    */
+    std::shared_ptr<const AccessPolicy> compileAccessPolicy(const std::vector<rclcpp::Parameter>& changedParams = {});
 
-      @countCheck in order to check if desire is present (ADD op) or not present (DEL op)
+    /*
+      Return the current access-control policy snapshot (lock-free, safe to be called from any srv callback)
     */
-    void checkDesireSetWaitingUpd(const int& updIndex, const int& countCheck);
+    std::shared_ptr<const AccessPolicy> getAccessPolicy() const
+    {
+        return std::atomic_load(&access_policy_);
+    }
+
+    /*
+      Access params changed at runtime: compile the new policy and swap it with the current one
+    */
+    rcl_interfaces::msg::SetParametersResult onAccessParamsChange(const std::vector<rclcpp::Parameter>& params);
+
+    /*
+      Check against the mirrored desire set whether the addition (updIndex = ADD_I) or the deletion (updIndex = DEL_I) 
+      of @md can be considered performed (call it when holding process_desire_set_upd_lock_)
+    */
+    bool isDesireUpdConfirmed(const BDIManaged::ManagedDesire& md, const int& updIndex);
+
+    /*
+      Look for newly confirmed alterations among the pending desire upd requests (call it when holding process_desire_set_upd_lock_)
+      @newNotification to be put to true when a new whole desire set notification has been received
+    */
+    void confirmPendingDesireUpd(const bool& newNotification);
+
+    /*
+      Register a new pending upd request for the addition (updIndex = ADD_I) or the deletion (updIndex = DEL_I) of @desires
+      (to be called BEFORE publishing the alteration request): @respond is called with the confirmation flags (same order as in the request) 
+      once all the desires have been confirmed, MAX_WAIT_UPD desire set notifications have been received or MAX_WAIT_UPD_MS have passed
+    */
+    void registerDesireUpdRequest(const int& updIndex, const std::vector<BDIManaged::ManagedDesire>& desires,
+      const std::function<void(const std::vector<bool>&)>& respond);
+
+    /*
+      Remove the pending desire upd requests which are over, sending their deferred responses (call it without holding process_desire_set_upd_lock_)
+    */
+    void completeDesireUpdRequests();
 
     /*
         The desire set has been updated
@@ -97,18 +177,47 @@ private:
     void updatedDesireSet(const ros2_bdi_interfaces::msg::DesireSet::SharedPtr msg);
 
     /*
-      @updIndex to be used to know which lock has to be checked among the two in belief_set_upd_locks_
-      and which waiting counter has to be incremented and/or checked
+      Check against the mirrored belief set whether the addition (updIndex = ADD_I) or the deletion (updIndex = DEL_I) 
+      of @mb can be considered performed (call it when holding process_belief_set_upd_lock_)
+    */
+    bool isBeliefUpdConfirmed(const BDIManaged::ManagedBelief& mb, const int& updIndex);
+
+    /*
+      Look for newly confirmed alterations among the pending belief upd requests (call it when holding process_belief_set_upd_lock_)
+      @newNotification to be put to true when a new whole belief set notification has been received
+    */
+    void confirmPendingBeliefUpd(const bool& newNotification);
+
+    /*
+      Register a new pending upd request for the addition (updIndex = ADD_I) or the deletion (updIndex = DEL_I) of @beliefs
+      (to be called BEFORE publishing the alteration request): @respond is called with the confirmation flags (same order as in the request) 
+      once all the beliefs have been confirmed, MAX_WAIT_UPD belief set notifications have been received or MAX_WAIT_UPD_MS have passed
+    */
+    void registerBeliefUpdRequest(const int& updIndex, const std::vector<BDIManaged::ManagedBelief>& beliefs,
+      const std::function<void(const std::vector<bool>&)>& respond);
 
-      @countCheck in order to check if belief is present (ADD op) or not present (DEL op)
+    /*
+      Remove the pending belief upd requests which are over, sending their deferred responses (call it without holding process_belief_set_upd_lock_)
     */
-    void checkBeliefSetWaitingUpd(const int& updIndex, const int& countCheck);
+    void completeBeliefUpdRequests();
     
     /*
-        The belief set has been updated
+        The belief set has been updated (discarded if older than the last delta applied)
     */
     void updatedBeliefSet(const ros2_bdi_interfaces::msg::BeliefSet::SharedPtr msg);
 
+    /*
+        The belief set has been altered: apply the delta to the mirrored belief set
+        and ack the pending upd requests whose alterations have been performed
+    */
+    void updatedBeliefSetDelta(const ros2_bdi_interfaces::msg::BeliefSetDelta::SharedPtr msg);
+
+    /*
+        The static partition of the belief set has grown: replace the mirrored one
+        and ack the pending upd requests whose alterations have been performed
+    */
+    void updatedStaticBeliefSet(const ros2_bdi_interfaces::msg::BeliefSet::SharedPtr msg);
+
     
 
     /*  
@@ -119,17 +228,10 @@ private:
 
 
     /*  
-        Add Belief Request service handler
-    
-    */
-    void handleAddBeliefRequest(const ros2_bdi_interfaces::srv::UpdBeliefSet::Request::SharedPtr request,
-        const ros2_bdi_interfaces::srv::UpdBeliefSet::Response::SharedPtr response);
-
-    /*  
-        Del Belief Request service handler        
+        Add/Del Belief Request service handler (response deferred till the alteration is confirmed)
     */
-    void handleDelBeliefRequest(const ros2_bdi_interfaces::srv::UpdBeliefSet::Request::SharedPtr request,
-        const ros2_bdi_interfaces::srv::UpdBeliefSet::Response::SharedPtr response);
+    void handleUpdBeliefRequest(const std::shared_ptr<rmw_request_id_t>& request_header, 
+        const ros2_bdi_interfaces::srv::UpdBeliefSet::Request::SharedPtr request, const int& updIndex);
 
     /*  
         Read Desire Request service handler        
@@ -138,16 +240,36 @@ private:
         const ros2_bdi_interfaces::srv::CheckDesire::Response::SharedPtr response);
 
     /*  
-        Add Desire Request service handler        
+        Add/Del Desire Request service handler (response deferred till the alteration is confirmed)
     */
-    void handleAddDesireRequest(const ros2_bdi_interfaces::srv::UpdDesireSet::Request::SharedPtr request,
-        const ros2_bdi_interfaces::srv::UpdDesireSet::Response::SharedPtr response);
+    void handleUpdDesireRequest(const std::shared_ptr<rmw_request_id_t>& request_header, 
+        const ros2_bdi_interfaces::srv::UpdDesireSet::Request::SharedPtr request, const int& updIndex);
 
     /*  
-         Del Desire Request service handler       
+        Batched Read Belief Request service handler        
     */
-    void handleDelDesireRequest(const ros2_bdi_interfaces::srv::UpdDesireSet::Request::SharedPtr request,
-        const ros2_bdi_interfaces::srv::UpdDesireSet::Response::SharedPtr response);
+    void handleCheckBeliefBatchRequest(const ros2_bdi_interfaces::srv::CheckBeliefBatch::Request::SharedPtr request,
+        const ros2_bdi_interfaces::srv::CheckBeliefBatch::Response::SharedPtr response);
+
+    /*  
+        Batched Add/Del Belief Request service handler (whole batch published as a single belief set operation,
+        response deferred till the alterations are confirmed)
+    */
+    void handleUpdBeliefBatchRequest(const std::shared_ptr<rmw_request_id_t>& request_header, 
+        const ros2_bdi_interfaces::srv::UpdBeliefSetBatch::Request::SharedPtr request, const int& updIndex);
+
+    /*  
+        Batched Read Desire Request service handler        
+    */
+    void handleCheckDesireBatchRequest(const ros2_bdi_interfaces::srv::CheckDesireBatch::Request::SharedPtr request,
+        const ros2_bdi_interfaces::srv::CheckDesireBatch::Response::SharedPtr response);
+
+    /*  
+        Batched Add/Del Desire Request service handler (whole batch published as a single desire set operation,
+        response deferred till the alterations are confirmed)
+    */
+    void handleUpdDesireBatchRequest(const std::shared_ptr<rmw_request_id_t>& request_header, 
+        const ros2_bdi_interfaces::srv::UpdDesireSetBatch::Request::SharedPtr request, const int& updIndex);
     
     // agent id that defines the namespace in which the node operates
     std::string agent_id_;
@@ -163,13 +285,30 @@ private:
     // handle accepted group queries by other agents
     rclcpp::Service<ros2_bdi_interfaces::srv::IsAcceptedOperation>::SharedPtr accepted_server_;
 
+    // current access-control policy snapshot (atomically swapped on access params change)
+    std::shared_ptr<const AccessPolicy> access_policy_;
+    // handle of the callback recompiling access_policy_ on access params change
+    rclcpp::Node::OnSetParametersCallbackHandle::SharedPtr access_params_cb_handle_;
+
     // mirroring of the current state of the belief set
-    std::set<BDIManaged::ManagedBelief> belief_set_;
+    BDIManaged::PartitionedBeliefSet belief_set_;
+    // seq number of the last belief set delta applied to belief_set_ (whole belief sets older than it are discarded)
+    uint64_t last_delta_seq_;
     // belief set update subscription
     rclcpp::Subscription<ros2_bdi_interfaces::msg::BeliefSet>::SharedPtr belief_set_subscriber_;
+    // static belief set update subscription
+    rclcpp::Subscription<ros2_bdi_interfaces::msg::BeliefSet>::SharedPtr static_belief_set_subscriber_;
+    // belief set delta subscription
+    rclcpp::Subscription<ros2_bdi_interfaces::msg::BeliefSetDelta>::SharedPtr belief_set_delta_subscriber_;
     
     rclcpp::callback_group::CallbackGroup::SharedPtr callback_group_upd_subscribers_;
 
+    // id to be assigned to the next registered upd request
+    std::atomic<uint64_t> next_upd_request_id_;
+
+    // timer to send the deferred responses of the pending upd requests whose deadline has passed
+    rclcpp::TimerBase::SharedPtr upd_requests_timer_;
+
     // mirroring of the current state of the desire set
     std::set<BDIManaged::ManagedDesire> desire_set_;
     // desire set update subscription
@@ -178,42 +317,58 @@ private:
     // handle check belief requests from other agents
     rclcpp::Service<ros2_bdi_interfaces::srv::CheckBelief>::SharedPtr chk_belief_server_;
     // handle add belief requests from other agents
-    rclcpp::Service<ros2_bdi_interfaces::srv::UpdBeliefSet>::SharedPtr add_belief_server_;
+    DeferredService<ros2_bdi_interfaces::srv::UpdBeliefSet>::SharedPtr add_belief_server_;
     // handle del belief requests from other agents
-    rclcpp::Service<ros2_bdi_interfaces::srv::UpdBeliefSet>::SharedPtr del_belief_server_;
+    DeferredService<ros2_bdi_interfaces::srv::UpdBeliefSet>::SharedPtr del_belief_server_;
     
-    // lock to put waiting for next belief set addition/deletion
+    // lock on the mirrored belief set and the pending belief upd requests
     std::mutex process_belief_set_upd_lock_;
-    std::vector<std::mutex> belief_set_upd_locks_;
-    // managed belief you're waiting for (to be added or deleted)
-    std::vector<BDIManaged::ManagedBelief> belief_waiting_for_;
-    // belief operation in waiting and not performed in last belief set upd counter
-    std::vector<int> belief_waiting_for_counter_;
+    // pending belief upd requests (request id -> request)
+    std::map<uint64_t, PendingUpdRequest<BDIManaged::ManagedBelief>> pending_belief_upd_;
     
+    // handle batched check belief requests from other agents
+    rclcpp::Service<ros2_bdi_interfaces::srv::CheckBeliefBatch>::SharedPtr chk_belief_batch_server_;
+    // handle batched add belief requests from other agents
+    DeferredService<ros2_bdi_interfaces::srv::UpdBeliefSetBatch>::SharedPtr add_belief_batch_server_;
+    // handle batched del belief requests from other agents
+    DeferredService<ros2_bdi_interfaces::srv::UpdBeliefSetBatch>::SharedPtr del_belief_batch_server_;
+
     //add_belief publisher
     rclcpp::Publisher<ros2_bdi_interfaces::msg::Belief>::SharedPtr add_belief_publisher_;
     //del_belief publisher
     rclcpp::Publisher<ros2_bdi_interfaces::msg::Belief>::SharedPtr del_belief_publisher_;
+    //add_belief_set publisher
+    rclcpp::Publisher<ros2_bdi_interfaces::msg::BeliefSet>::SharedPtr add_belief_set_publisher_;
+    //del_belief_set publisher
+    rclcpp::Publisher<ros2_bdi_interfaces::msg::BeliefSet>::SharedPtr del_belief_set_publisher_;
 
     // handle check desire requests from other agents
     rclcpp::Service<ros2_bdi_interfaces::srv::CheckDesire>::SharedPtr chk_desire_server_;
     // handle add desire requests from other agents
-    rclcpp::Service<ros2_bdi_interfaces::srv::UpdDesireSet>::SharedPtr add_desire_server_;
+    DeferredService<ros2_bdi_interfaces::srv::UpdDesireSet>::SharedPtr add_desire_server_;
     // handle del desire requests from other agents
-    rclcpp::Service<ros2_bdi_interfaces::srv::UpdDesireSet>::SharedPtr del_desire_server_;
+    DeferredService<ros2_bdi_interfaces::srv::UpdDesireSet>::SharedPtr del_desire_server_;
     
-    // lock to put waiting for next desire set addition/deletion
+    // lock on the mirrored desire set and the pending desire upd requests
     std::mutex process_desire_set_upd_lock_;
-    std::vector<std::mutex> desire_set_upd_locks_;
-    // managed desire you're waiting for (to be added or deleted)
-    std::vector<BDIManaged::ManagedDesire> desire_waiting_for_;
-    // desire operation in waiting and not performed in last desire set upd counter
-    std::vector<int> desire_waiting_for_counter_;
+    // pending desire upd requests (request id -> request)
+    std::map<uint64_t, PendingUpdRequest<BDIManaged::ManagedDesire>> pending_desire_upd_;
     
+    // handle batched check desire requests from other agents
+    rclcpp::Service<ros2_bdi_interfaces::srv::CheckDesireBatch>::SharedPtr chk_desire_batch_server_;
+    // handle batched add desire requests from other agents
+    DeferredService<ros2_bdi_interfaces::srv::UpdDesireSetBatch>::SharedPtr add_desire_batch_server_;
+    // handle batched del desire requests from other agents
+    DeferredService<ros2_bdi_interfaces::srv::UpdDesireSetBatch>::SharedPtr del_desire_batch_server_;
+
     //add_desire publisher
     rclcpp::Publisher<ros2_bdi_interfaces::msg::Desire>::SharedPtr add_desire_publisher_;
     //del_desire publisher
     rclcpp::Publisher<ros2_bdi_interfaces::msg::Desire>::SharedPtr del_desire_publisher_;
+    //add_desire_set publisher
+    rclcpp::Publisher<ros2_bdi_interfaces::msg::DesireSet>::SharedPtr add_desire_set_publisher_;
+    //del_desire_set publisher
+    rclcpp::Publisher<ros2_bdi_interfaces::msg::DesireSet>::SharedPtr del_desire_set_publisher_;
 
     // current known status of the system nodes
     std::map<std::string, uint8_t> lifecycle_status_;
@@ -222,8 +377,6 @@ private:
     // Sub to updated lifecycle status
     rclcpp::Subscription<ros2_bdi_interfaces::msg::LifecycleStatus>::SharedPtr lifecycle_status_subscriber_;
 
-    // PlanSys2 Monitor Client supporting nodes & clients for calling the {psys2_node}/get_state services
-    std::shared_ptr<PlanSysMonitorClient> psys_monitor_client_;
 
 };
 
@@ -3,10 +3,21 @@
 
 /* Parameters affecting internal logic (recompiling required) */
 #define BELIEF_SET_TOPIC "belief_set"
+#define BELIEF_SET_DELTA_TOPIC "belief_set_delta"
+// static partition of the belief set (latched, published again only when it grows)
+#define STATIC_BELIEF_SET_TOPIC "static_belief_set"
 #define ADD_BELIEF_TOPIC "add_belief"
 #define ADD_BELIEF_SET_TOPIC "add_belief_set"
 #define DEL_BELIEF_SET_TOPIC "del_belief_set"
 #define DEL_BELIEF_TOPIC "del_belief"
+#define LOAD_STATIC_BELIEFS_SRV "load_static_beliefs"
 #define INIT_BELIEF_SET_FILENAME "init_bset.yaml"
+#define BELIEF_SET_SNAPSHOT_FILENAME "bset.snapshot"
+
+// names of predicates/functions (or types of instances) whose beliefs are immutable once known
+#define PARAM_STATIC_BELIEF_NAMES "static_belief_names"
+
+// steps between two snapshots of the belief set (written only if it has been altered in the meantime)
+#define BELIEF_SET_SNAPSHOT_INTERVAL_STEPS 20
 
 #endif
\ No newline at end of file
@@ -6,6 +6,8 @@
 #define PARAM_DEBUG "debug"
 #define PARAM_AGENT_GROUP_ID "agent_group"
 #define MAX_COMM_ERRORS 16
+// restore the mental state from the binary snapshots in /tmp/{agent_id}/ (when valid) instead of the init. yaml files
+#define PARAM_WARM_RESTART "warm_restart"
 
 #define BELIEF_MANAGER_NODE_NAME "belief_manager"
 #define EVENT_LISTENER_NODE_NAME "event_listener"
@@ -3,5 +3,6 @@
 
 /* Parameters affecting internal logic (recompiling required) */
 #define INIT_REACTIVE_RULES_FILENAME "init_reactive_rules.yaml"
+#define REACTIVE_RULES_SNAPSHOT_FILENAME "reactive_rules.snapshot"
 
 #endif
\ No newline at end of file
@@ -13,9 +13,19 @@
 #define ADD_DESIRE_SRV "add_desire_srv"
 #define DEL_DESIRE_SRV "del_desire_srv"
 
+#define CK_BELIEF_BATCH_SRV "check_belief_batch_srv"
+#define ADD_BELIEF_BATCH_SRV "add_belief_batch_srv"
+#define DEL_BELIEF_BATCH_SRV "del_belief_batch_srv"
+
+#define CK_DESIRE_BATCH_SRV "check_desire_batch_srv"
+#define ADD_DESIRE_BATCH_SRV "add_desire_batch_srv"
+#define DEL_DESIRE_BATCH_SRV "del_desire_batch_srv"
+
 #define ADD_I 1
 #define DEL_I 0
 #define MAX_WAIT_UPD 4 // indicates number of belief/desire set notification to wait before considering a submitted upd request failed 
+#define MAX_WAIT_UPD_MS 4000 // max time (ms) to wait before considering a submitted upd request failed (whatever the received notifications)
+#define UPD_REQUESTS_SWEEP_MS 100 // period (ms) of the check for pending upd requests whose max waiting time has passed
 
 /* ROS2 Parameter names for PlanSys2Monitor node */
 #define PARAM_BELIEF_CHECK "belief_ck"
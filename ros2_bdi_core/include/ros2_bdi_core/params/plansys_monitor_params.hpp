@@ -7,6 +7,7 @@
 
 #define PSYS2NODES 4
 #define PSYS2_CK_STATE_SRV "get_state"
+#define PSYS2_TRANSITION_EVENT_TOPIC "transition_event"
 
 #define PSYS_STATE_TOPIC "plansys_state"
 
@@ -10,8 +10,14 @@
 #define ADD_DESIRE_TOPIC "add_desire"
 #define BOOST_DESIRE_TOPIC "boost_desire"
 #define DEL_DESIRE_TOPIC "del_desire"
+#define ADD_DESIRE_SET_TOPIC "add_desire_set"
+#define DEL_DESIRE_SET_TOPIC "del_desire_set"
 
 #define INIT_DESIRE_SET_FILENAME "init_dset.yaml"
+#define DESIRE_SET_SNAPSHOT_FILENAME "dset.snapshot"
+
+// steps between two snapshots of the desire set (written only if it has been altered in the meantime)
+#define DESIRE_SET_SNAPSHOT_INTERVAL_STEPS 20
 
 /*  Consider the plan almost completed if this threshold is surpassed by its progress status
     (useful to decide whether to abort the plan in case the target desire appears 
@@ -34,6 +40,9 @@
 
 
 #define CURR_INTENTIONS_TOPIC "current_intentions"
+#define CURR_INTENTIONS_DELTA_TOPIC "current_intentions_delta"
+//max number of intention deltas published after a snapshot before publishing a fresh one (to realign late joiners/subscribers which missed a delta)
+#define MAX_INTENTION_DELTAS_PER_SNAPSHOT 20
 
 #define JAVAFF_SEARCH_TOPIC "javaff_search/plan"
 #define JAVAFF_COMMITTED_STATUS_TOPIC "javaff_search/committed_status"
@@ -41,12 +50,15 @@
 #define JAVAFF_START_PLAN_SRV "javaff_server/start_plan"
 #define JAVAFF_UNEXPECTED_STATE_SRV "javaff_server/unexpected_state"
 #define JAVAFF_SEARCH_INTERVAL_PARAM "search_interval"
+#define JAVAFF_PROBLEM_NAME "problem_1" // name of the full PDDL problems built for JavaFF in problem delta mode (as PlanSys2 names them)
 #define JAVAFF_MAX_PPLAN_SIZE_PARAM "max_pplan_size"
 #define JAVAFF_SEARCH_MAX_EMPTY_SEARCH_INTERVALS_PARAM "max_null_search_intervals"
+#define JAVAFF_PROBLEM_DELTA_PARAM "problem_delta"
 
 #define JAVAFF_SEARCH_INTERVAL_PARAM_DEFAULT 500
 #define JAVAFF_SEARCH_MAX_EMPTY_SEARCH_INTERVALS_PARAM_DEFAULT 16
 #define JAVAFF_MAX_PPLAN_SIZE_PARAM_DEFAULT 32000
+#define JAVAFF_PROBLEM_DELTA_PARAM_DEFAULT false
 
 #define PLAN_LIBRARY_NAME "plan_lib.db"
 
@@ -25,6 +25,7 @@
 #include "ros2_bdi_interfaces/srv/bdi_plan_execution.hpp"
 #include "ros2_bdi_utils/ManagedBelief.hpp"
 #include "ros2_bdi_utils/ManagedPlan.hpp"
+#include "ros2_bdi_utils/PartitionedBeliefSet.hpp"
 
 #include "ros2_bdi_core/params/core_common_params.hpp"
 #include "ros2_bdi_core/params/plan_director_params.hpp"
@@ -56,12 +57,11 @@ public:
     void step();
 
     /*
-        Wait for PlanSys2 to boot at best for max_wait
+        Wait for PlanSys2 to boot at best for max_wait (as notified by the PlanSys2 monitor of the agent)
     */
     bool wait_psys2_boot(const std::chrono::seconds max_wait = std::chrono::seconds(16))
     {
-        psys_monitor_client_ = std::make_shared<PlanSysMonitorClient>(PLAN_DIRECTOR_NODE_NAME + std::string("_psys2caller_"), sel_planning_mode_);
-        return psys_monitor_client_->areAllPsysNodeActive(max_wait);
+        return PlanSysMonitorClient::waitPsysBoot(this->shared_from_this(), sel_planning_mode_, max_wait);
     }
 
 private:
@@ -173,6 +173,11 @@ private:
     */
     void updatedBeliefSet(const ros2_bdi_interfaces::msg::BeliefSet::SharedPtr msg);
 
+    /*
+        The static partition of the belief set has grown
+    */
+    void updatedStaticBeliefSet(const ros2_bdi_interfaces::msg::BeliefSet::SharedPtr msg);
+
     // internal state of the node
     StateType state_;
 
@@ -215,9 +220,10 @@ private:
     ros2_bdi_interfaces::msg::BDIPlanExecutionInfo no_plan_msg_;
 
     // current belief set (in order to check precondition && context condition)
-    std::set<BDIManaged::ManagedBelief> belief_set_;
+    BDIManaged::PartitionedBeliefSet belief_set_;
     // belief set subscriber
     rclcpp::Subscription<ros2_bdi_interfaces::msg::BeliefSet>::SharedPtr belief_set_subscriber_;//belief set sub.
+    rclcpp::Subscription<ros2_bdi_interfaces::msg::BeliefSet>::SharedPtr static_belief_set_subscriber_;//static belief set sub.
     // belief add publisher
     rclcpp::Publisher<ros2_bdi_interfaces::msg::Belief>::SharedPtr belief_add_publisher_;
     // belief del publisher
@@ -242,9 +248,6 @@ private:
     // Sub to updated lifecycle status
     rclcpp::Subscription<ros2_bdi_interfaces::msg::LifecycleStatus>::SharedPtr lifecycle_status_subscriber_;
 
-    // PlanSys2 Monitor Client supporting nodes & clients for calling the {psys2_node}/get_state services
-    std::shared_ptr<PlanSysMonitorClient> psys_monitor_client_;
-
 }; // PlanDirector class prototype
 
 #endif // PLAN_DIRECTOR
\ No newline at end of file
@@ -4,6 +4,8 @@
 #include <string>
 #include <memory>
 #include <map>
+#include <vector>
+#include <chrono>
 
 #include "ros2_bdi_interfaces/msg/lifecycle_status.hpp"
 #include "ros2_bdi_core/support/plansys_monitor_client.hpp"
@@ -11,6 +13,10 @@
 
 #include "ros2_bdi_interfaces/msg/planning_system_state.hpp"
 
+#include "lifecycle_msgs/msg/state.hpp"
+#include "lifecycle_msgs/msg/transition_event.hpp"
+#include "lifecycle_msgs/srv/get_state.hpp"
+
 #include "rclcpp/rclcpp.hpp"
 
 class PlanSysMonitor : public rclcpp::Node
@@ -44,10 +50,27 @@ class PlanSysMonitor : public rclcpp::Node
         bool allActive();
 
         /*
-            Activate thread to check active state of plansys2 node (planner, domain_expert, problem_expert)
+            Send an async {psysNodeName}/get_state request (if none pending) to check the active state of plansys2 node
+            (planner, domain_expert, problem_expert, executor), unless its state is already known
+            through its transition events
         */
         void checkPsysNodeActive(const std::string& psysNodeName);
 
+        /*
+            Received lifecycle transition event of plansys2 node @psysNodeName
+        */
+        void callbackPsysTransitionEvent(const std::string& psysNodeName, const lifecycle_msgs::msg::TransitionEvent::SharedPtr msg);
+
+        /*
+            Update the active flag of the plansys2 node @psysNodeName, publishing the new state right away if it changes
+        */
+        void setPsysNodeActive(const std::string& psysNodeName, const bool& active);
+
+        /*
+            Get the reference to the active flag of the plansys2 node @psysNodeName within psys_active_
+        */
+        bool& psysNodeActiveFlag(const std::string& psysNodeName);
+
         /*Build updated ros2_bdi_interfaces::msg::LifecycleStatus msg*/
         ros2_bdi_interfaces::msg::LifecycleStatus getLifecycleStatus();
 
@@ -84,8 +107,16 @@ class PlanSysMonitor : public rclcpp::Node
         // Sub to updated lifecycle status
         rclcpp::Subscription<ros2_bdi_interfaces::msg::LifecycleStatus>::SharedPtr lifecycle_status_subscriber_;
         
-        // PlanSys2 Monitor Client supporting nodes & clients for calling the {psys2_node}/get_state services
-        std::shared_ptr<PlanSysMonitorClient> psys_monitor_client_;
+        // monitored psys2 nodes
+        std::vector<std::string> psys2_nodes_;
+        // {psys2_node}/transition_event subscriptions (state changes notified as soon as they happen)
+        std::map<std::string, rclcpp::Subscription<lifecycle_msgs::msg::TransitionEvent>::SharedPtr> transition_event_subscribers_;
+        // psys2 nodes whose state is known from their transition events (no need to query them while they're around)
+        std::map<std::string, bool> state_from_events_;
+        // {psys2_node}/get_state clients (async requests, no blocking wait within the work timer)
+        std::map<std::string, rclcpp::Client<lifecycle_msgs::srv::GetState>::SharedPtr> get_state_clients_;
+        // psys2 nodes with a get_state request pending -> time it has been sent
+        std::map<std::string, std::chrono::steady_clock::time_point> pending_get_state_;
         
         // PlanSys2 state publisher
         rclcpp::Publisher<ros2_bdi_interfaces::msg::PlanningSystemState>::SharedPtr psys_state_publisher_;
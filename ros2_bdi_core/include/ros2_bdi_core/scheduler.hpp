@@ -3,9 +3,13 @@
 
 #include <optional>
 #include <mutex>
+#include <atomic>
 #include <vector>
 #include <set>   
 #include <map>   
+#include <chrono>
+#include <deque>
+#include <functional>
 
 #include "plansys2_planner/PlannerClient.hpp"
 #include "plansys2_domain_expert/DomainExpertClient.hpp"
@@ -14,6 +18,7 @@
 #include "ros2_bdi_interfaces/msg/belief.hpp"
 #include "ros2_bdi_interfaces/msg/desire.hpp"
 #include "ros2_bdi_interfaces/msg/belief_set.hpp"
+#include "ros2_bdi_interfaces/msg/belief_set_delta.hpp"
 #include "ros2_bdi_interfaces/msg/desire_set.hpp"
 #include "ros2_bdi_interfaces/msg/condition.hpp"
 #include "ros2_bdi_interfaces/msg/conditions_conjunction.hpp"
@@ -27,6 +32,8 @@
 
 #include "ros2_bdi_utils/ManagedBelief.hpp"
 #include "ros2_bdi_utils/ManagedDesire.hpp"
+#include "ros2_bdi_utils/ManagedDesireSet.hpp"
+#include "ros2_bdi_utils/PartitionedBeliefSet.hpp"
 #include "ros2_bdi_utils/ManagedPlan.hpp"
 
 #include "ros2_bdi_core/params/core_common_params.hpp"
@@ -66,14 +73,19 @@ public:
     void step();
 
     /*
-        Wait for PlanSys2 to boot at best for max_wait
+        Wait for PlanSys2 to boot at best for max_wait (as notified by the PlanSys2 monitor of the agent)
     */
     bool wait_psys2_boot(const std::chrono::seconds max_wait = std::chrono::seconds(16))
     {
-        psys_monitor_client_ = std::make_shared<PlanSysMonitorClient>(SCHEDULER_NODE_NAME + std::string("_psys2caller_"), sel_planning_mode_);
-        return psys_monitor_client_->areAllPsysNodeActive(max_wait);
+        return PlanSysMonitorClient::waitPsysBoot(this->shared_from_this(), sel_planning_mode_, max_wait);
     }
 
+    /*
+        Write the current desire set into the snapshot file "/tmp/{agent_id}/dset.snapshot" (warm restart only);
+        called periodically and on shutdown
+    */
+    void saveSnapshot();
+
 protected:
 
     virtual void publishCurrentIntention() = 0;
@@ -134,20 +146,37 @@ protected:
     /*
         If selected plan fit the minimal requirements for a plan (i.e. not empty body and a desire which is in the desire_set)
         try triggering its execution by srv request to PlanDirector (/{agent}/plan_execution)
+        @onDone notified with true if successful (n.b. the request does not block: it is notified once PlanDirector has replied)
     */
-    bool tryTriggerPlanExecution(const BDIManaged::ManagedPlan& selectedPlan);
+    void tryTriggerPlanExecution(const BDIManaged::ManagedPlan& selectedPlan, const std::function<void(bool)>& onDone);
 
     /*
-        Launch execution of selectedPlan; if successful waiting_plans_.access() gets value of selectedPlan
-        return true if successful
+        Launch execution of selectedPlan; if successful current plan gets value of selectedPlan
+        @onDone notified with true if successful
     */
-    bool launchPlanExecution(const BDIManaged::ManagedPlan& selectedPlan);
+    void launchPlanExecution(const BDIManaged::ManagedPlan& selectedPlan, const std::function<void(bool)>& onDone);
     
     /*
-        Abort execution of first waiting_plans_; if successful waiting_plans_ first element is popped
-        return true if successful
+        Abort execution of current plan; if successful there is no current plan anymore
+        @onDone (if any) notified with true if successful
+    */
+    void abortCurrentPlanExecution(const std::function<void(bool)>& onDone = nullptr);
+
+    /*
+        True while waiting for PlanDirector to reply to a plan execution request: in the meantime no new plan is scheduled
+        and plan execution updates are put aside (they're processed in order as soon as the reply has been handled)
+    */
+    bool planExecRequestPending() const {return plan_exec_srv_client_->busy();}
+
+    /*
+        A reply from PlanDirector has been handled: process what has been put aside meanwhile, unless another request is pending
+    */
+    virtual void planExecRequestCompleted();
+
+    /*
+        Received update on plan execution: processed right away unless waiting for PlanDirector to reply to a request
     */
-    bool abortCurrentPlanExecution();
+    void receivedPlanExecutionInfo(const ros2_bdi_interfaces::msg::BDIPlanExecutionInfo::SharedPtr msg);
 
     /*
         Check if there is a current valid plan selected
@@ -180,6 +209,12 @@ protected:
     */
     void tryInitDesireSet();
 
+    /*
+        Restore the desire set from the snapshot file "/tmp/{agent_id}/dset.snapshot" (no yaml parsing)
+        Returns false if there is no valid snapshot to restore from or the init. file has been edited since the snapshot
+    */
+    bool tryRestoreDesireSet();
+
     /*
         returns ACCEPTED iff managed belief can be put as part of a desire's value
         wrt. to its syntax
@@ -207,10 +242,32 @@ protected:
     bool isDesireSatisfied(BDIManaged::ManagedDesire& md);
 
     /*
-        The belief set has been updated
+        The belief set has been updated (discarded if older than the last delta applied)
     */
     void updatedBeliefSet(const ros2_bdi_interfaces::msg::BeliefSet::SharedPtr msg);
 
+    /*
+        The belief set has been altered: apply the delta to the mirrored belief set
+        (and to the fulfillment index of the desire set)
+    */
+    void updatedBeliefSetDelta(const ros2_bdi_interfaces::msg::BeliefSetDelta::SharedPtr msg);
+
+    /*
+        The static partition of the belief set has grown: replace the mirrored one
+    */
+    void updatedStaticBeliefSet(const ros2_bdi_interfaces::msg::BeliefSet::SharedPtr msg);
+
+    /*
+        Feed the alterations to the mirrored belief set into the fulfillment index of the desire set,
+        return true if there has been any
+    */
+    bool applyBeliefSetChanges(const BDIManaged::BeliefSetChanges& changes);
+
+    /*
+        React to an alteration of the mirrored belief set: check for satisfied desires and reschedule
+    */
+    void onBeliefSetAltered();
+
     /*  
         Someone has publish a new desire to be fulfilled in the respective topic
     */
@@ -222,6 +279,18 @@ protected:
     */
     void delDesireTopicCallBack(const ros2_bdi_interfaces::msg::Desire::SharedPtr msg);
 
+    /*  
+        Someone has publish a new set of desires to be fulfilled in the respective topic
+        (desire set is published and post addition behaviour triggered just once for the whole set)
+    */
+    void addDesireSetTopicCallBack(const ros2_bdi_interfaces::msg::DesireSet::SharedPtr msg);
+
+    /*  
+        Someone has publish a set of desires to be removed from the one to be fulfilled (if present)
+        in the respective topic
+    */
+    void delDesireSetTopicCallBack(const ros2_bdi_interfaces::msg::DesireSet::SharedPtr msg);
+
     /*
         Wrapper for calling addDesire with just desire to added (where not linked to any other desires)
         N.B see addDesire(const ManagedDesire mdAdd, const optional<ManagedDesire> necessaryForMd)
@@ -260,16 +329,12 @@ protected:
     {
         mtx_add_del_.lock();
         {
-            if(desire_set_.count(mdOriginal) == 0)
+            if(!desire_set_.replace(mdOriginal, mdNew))//mdNew keeps the id of mdOriginal
             {
                 mtx_add_del_.unlock();
                 return false;
             }
-            else
-            {
-                desire_set_.erase(mdOriginal);
-                desire_set_.insert(mdNew);
-            }
+            snapshot_dirty_ = true;
         }
         mtx_add_del_.unlock();
         return desire_set_.count(mdNew) == 1;
@@ -329,6 +394,11 @@ protected:
     // step counter
     uint64_t step_counter_;
 
+    // time at which the node has been created (to log the time to first plan)
+    std::chrono::steady_clock::time_point boot_time_;
+    // no plan execution has been triggered yet
+    bool first_plan_;
+
     // Selected planning mode
     PlanningMode sel_planning_mode_;
 
@@ -364,11 +434,20 @@ protected:
     // desire set has been init. (or at least the process to do so has been tried)
     bool init_dset_;
 
-    // belief set of the agent <agent_id_>
-    std::set<BDIManaged::ManagedBelief> belief_set_;
+    // desire set altered since the last snapshot (set from several callbacks)
+    std::atomic<bool> snapshot_dirty_;
+
+    // hash of the content of the init. file the desire set descends from (stored in the snapshots)
+    std::optional<uint32_t> init_dset_hash_;
+
+    // belief set of the agent <agent_id_> (static + dynamic partition)
+    BDIManaged::PartitionedBeliefSet belief_set_;
+
+    // seq number of the last belief set delta applied to belief_set_ (whole belief sets older than it are discarded)
+    uint64_t last_delta_seq_;
 
-    // desire set of the agent <agent_id_>
-    std::set<BDIManaged::ManagedDesire> desire_set_;
+    // desire set of the agent <agent_id_> (iterated by priority desc., deadline asc.)
+    BDIManaged::ManagedDesireSet desire_set_;
 
     // fulfilling desire 
     BDIManaged::ManagedDesire fulfilling_desire_;
@@ -401,6 +480,8 @@ protected:
     // desire set publishers/subscribers
     rclcpp::Subscription<ros2_bdi_interfaces::msg::Desire>::SharedPtr add_desire_subscriber_;//add desire notify on topic
     rclcpp::Subscription<ros2_bdi_interfaces::msg::Desire>::SharedPtr del_desire_subscriber_;//del desire notify on topic
+    rclcpp::Subscription<ros2_bdi_interfaces::msg::DesireSet>::SharedPtr add_desire_set_subscriber_;//add desire set notify on topic
+    rclcpp::Subscription<ros2_bdi_interfaces::msg::DesireSet>::SharedPtr del_desire_set_subscriber_;//del desire set notify on topic
     rclcpp::Publisher<ros2_bdi_interfaces::msg::DesireSet>::SharedPtr desire_set_publisher_;//desire set publisher
 
 
@@ -412,9 +493,15 @@ protected:
 
     // belief set subscriber
     rclcpp::Subscription<ros2_bdi_interfaces::msg::BeliefSet>::SharedPtr belief_set_subscriber_;//belief set sub.
+    // belief set delta subscriber
+    rclcpp::Subscription<ros2_bdi_interfaces::msg::BeliefSetDelta>::SharedPtr belief_set_delta_subscriber_;//belief set delta sub.
+    // static belief set subscriber
+    rclcpp::Subscription<ros2_bdi_interfaces::msg::BeliefSet>::SharedPtr static_belief_set_subscriber_;//static belief set sub.
 
     // plan executioninfo subscriber
     rclcpp::Subscription<ros2_bdi_interfaces::msg::BDIPlanExecutionInfo>::SharedPtr plan_exec_info_subscriber_;//plan execution info publisher
+    // plan execution updates received while waiting for PlanDirector to reply to a request
+    std::deque<ros2_bdi_interfaces::msg::BDIPlanExecutionInfo::SharedPtr> deferred_plan_exec_info_;
 
     // current intention publisher
     rclcpp::Publisher<ros2_bdi_interfaces::msg::BDIPlanExecutionInfoMin>::SharedPtr intention_publisher_;//intention publisher
@@ -426,8 +513,6 @@ protected:
     // Sub to updated lifecycle status
     rclcpp::Subscription<ros2_bdi_interfaces::msg::LifecycleStatus>::SharedPtr lifecycle_status_subscriber_;
 
-    // PlanSys2 Monitor Client supporting nodes & clients for calling the {psys2_node}/get_state services
-    std::shared_ptr<PlanSysMonitorClient> psys_monitor_client_;
 };
 
 #endif // SCHEDULER_H_
\ No newline at end of file
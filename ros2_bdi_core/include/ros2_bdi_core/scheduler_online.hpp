@@ -1,6 +1,9 @@
 #ifndef SCHEDULER_ONLINE_H_
 #define SCHEDULER_ONLINE_H_
 
+#include <deque>
+#include <algorithm>
+
 #include "ros2_bdi_core/scheduler.hpp"
 #include "ros2_bdi_core/support/javaff_client.hpp"
 
@@ -9,6 +12,9 @@
 #include "javaff_interfaces/msg/execution_status.hpp"
 
 #include "ros2_bdi_utils/BDIPlanLibrary.hpp"
+#include "ros2_bdi_utils/PlannerProblemDelta.hpp"
+
+#include "ros2_bdi_interfaces/msg/intention_delta.hpp"
 
 #include "rclcpp/rclcpp.hpp"
 
@@ -24,6 +30,12 @@ public:
     void init() override;
 
 
+protected:
+    /*
+        A reply from PlanDirector has been handled: process plan execution updates and search result put aside meanwhile
+    */
+    void planExecRequestCompleted() override;
+
 private:    
     /*
         Store plan in plan library && enqueue in waiting_plans
@@ -40,10 +52,7 @@ private:
     */
     void enqueuePlan(BDIManaged::ManagedPlan& el)
     {
-        if(waiting_plans_.size() == 0)
-            waiting_plans_.push_back(el);
-        else
-            waiting_plans_.insert(waiting_plans_.begin(), el);
+        waiting_plans_.push_front(el);
     }
 
     /*
@@ -92,6 +101,24 @@ private:
         return true;
     }
 
+    /*
+        Index of the last partial plan enqueued for execution (or of the executing one if the waiting list is empty)
+    */
+    int highestPPlanIndex() const
+    {
+        return waiting_plans_.empty()? executing_pplan_index_ : waiting_plans_.front().getPlanQueueIndex();
+    }
+
+    /*
+        Position of the first partial plan in @pplans with index greater than @highestPPlanId
+        (search results are cumulative and sorted by plan index, so it's found by bisection instead of skipping them one by one)
+    */
+    size_t firstNewPPlan(const std::vector<javaff_interfaces::msg::PartialPlan>& pplans, const int& highestPPlanId) const
+    {
+        return std::partition_point(pplans.begin(), pplans.end(),
+            [highestPPlanId](const javaff_interfaces::msg::PartialPlan& pp){return pp.plan.plan_index <= highestPPlanId;}) - pplans.begin();
+    }
+
     /*
         Find plan index, -1 if not there
     */
@@ -103,10 +130,22 @@ private:
         return -1;
     }
 
+    /*
+        Publish current intention, i.e. current plan followed by the waiting ones in execution order:
+        a whole (latched) snapshot when the chain of plans has changed or MAX_INTENTION_DELTAS_PER_SNAPSHOT deltas have followed the last one,
+        otherwise just a delta wrt. the intention subscribers know
+        (plans dequeued from its head, plans appended to its tail, actions whose status/committed flag/progress has changed)
+    */
     void publishCurrentIntention();
 
-    /* Launch first partial plan execution of a queue of plans which are going to be stored in the waiting list, waiting for their turn */
-    bool launchFirstPPlanExecution(const javaff_interfaces::msg::PartialPlan& firstpplan);
+    /* Publish @chain of plans as a new intention snapshot, resetting the published intention to it */
+    void publishIntentionSnapshot(const std::vector<const BDIManaged::ManagedPlan*>& chain);
+
+    /* 
+        Launch first partial plan execution of a queue of plans which are going to be stored in the waiting list, waiting for their turn
+        @onDone notified with true if launched
+    */
+    void launchFirstPPlanExecution(const javaff_interfaces::msg::PartialPlan& firstpplan, const std::function<void(bool)>& onDone);
 
     /*
         Increment counter for failed computation of plans that aimed at fulfilling desire x
@@ -131,10 +170,10 @@ private:
     void postDelDesireSuccess(const BDIManaged::ManagedDesire& md);
 
     /* 
-        Request to make an early stop at a certain committed point
+        Request to make an early stop at a certain committed point, @onDone (if any) notified with true if accepted
         NOTE: committedPlan has to be extracted from current_plan_ otherwise request is going to fail for sure
     */
-    bool makeEarlyArrestRequest(const plansys2_msgs::msg::Plan& committedPlan);
+    void makeEarlyArrestRequest(const plansys2_msgs::msg::Plan& committedPlan, const std::function<void(bool)>& onDone);
 
     /*
         Operations related to the selection of the next active desire and Intentions to be enforced
@@ -169,10 +208,21 @@ private:
     void updatePlanExecution(const ros2_bdi_interfaces::msg::BDIPlanExecutionInfo::SharedPtr msg);
 
     /*
-        Received update on current plan search
+        Current plan cannot go on: drop it together with the waiting ones and let JavaFF handle the unexpected state (via srv),
+        reschedule from scratch if it can't
+    */
+    void handleUnexpectedState();
+
+    /*
+        Received update on current plan search: put aside while waiting for PlanDirector to reply to a request
     */
     void updatedSearchResult(const javaff_interfaces::msg::SearchResult::SharedPtr msg);
 
+    /*
+        Process progressing search result @msg, whose search baseline compared to the current one is @more_upd_baseline
+    */
+    void processSearchResult(const javaff_interfaces::msg::SearchResult::SharedPtr msg, const int& more_upd_baseline);
+
     /*
         Received update on current committed status for plan execution
     */
@@ -185,9 +235,15 @@ private:
 
     /*
         Process updated search result presenting a new search baseline compared to previous msgs of the same type
-        returns true if new baseline and search results are accepted (i.e. not too late)
+        (applied only if the early arrest it requires, if any, is accepted, i.e. not too late)
     */
-    bool processSearchResultWithNewBaseline(const javaff_interfaces::msg::SearchResult::SharedPtr msg);
+    void processSearchResultWithNewBaseline(const javaff_interfaces::msg::SearchResult::SharedPtr msg);
+
+    /*
+        Search result @msg with new search baseline accepted (i.e. not too late): 
+        replace the waiting queue with its partial plans (launching the first one if no plan is executing) and update the search baseline
+    */
+    void applySearchResultWithNewBaseline(const javaff_interfaces::msg::SearchResult::SharedPtr msg);
 
     /*
         Process desire boost request for active goal augmentation
@@ -195,9 +251,22 @@ private:
     void boostDesireTopicCallBack(const ros2_bdi_interfaces::msg::Desire::SharedPtr msg);
 
     /*
-        Call JavaFF for triggering the search for a plan fulfilling @selDesire
+        Call JavaFF for triggering the search for a plan fulfilling @selDesire, @onDone notified with true if accepted
+    */
+    void launchPlanSearch(const BDIManaged::ManagedDesire& selDesire, const std::function<void(bool)>& onDone);
+
+    /*
+        Problem to be shipped to JavaFF with goal @goal: just the delta wrt. the last one it got
+        if JAVAFF_PROBLEM_DELTA_PARAM is set and JavaFF is in sync, the full problem otherwise
     */
-    bool launchPlanSearch(const BDIManaged::ManagedDesire& selDesire);
+    std::string problemForPlanner(const std::string& goal);
+
+    /*
+        Full problem to be shipped to JavaFF with goal @goal: the one of the problem expert, unless JAVAFF_PROBLEM_DELTA_PARAM is set;
+        in that case it is built from the same belief set snapshot recorded as the last problem JavaFF got
+        (so that the next deltas are computed wrt. what it has actually received)
+    */
+    std::string fullProblemForPlanner(const std::string& goal);
 
     /* build empty search baseline method */
     javaff_interfaces::msg::CommittedStatus emptySearchBaseline()
@@ -215,9 +284,12 @@ private:
                 1:  if sb is more recent (more actions committed or greater executing plan index)
     */
     int compareBaseline(javaff_interfaces::msg::CommittedStatus sb);
+
+    /* Set @sb as current search baseline, keeping its committed status as bits for comparing it with the next ones */
+    void setSearchBaseline(const javaff_interfaces::msg::CommittedStatus& sb);
     
     // queue of waiting_plans for execution (LAST element of the vector is the first one that has been pushed)
-    std::vector<BDIManaged::ManagedPlan> waiting_plans_;
+    std::deque<BDIManaged::ManagedPlan> waiting_plans_;
 
     // search is progressing
     bool searching_;
@@ -227,6 +299,8 @@ private:
 
     // committed status of ongoing search result
     javaff_interfaces::msg::CommittedStatus search_baseline_;
+    // committed status of search_baseline_ actions (bit i of word i/64 for the i-th action)
+    std::vector<uint64_t> search_baseline_committed_;
 
     // computed partial plans echoed by JavaFF
     rclcpp::Subscription<javaff_interfaces::msg::SearchResult>::SharedPtr javaff_search_subscriber_;//javaff search sub.
@@ -240,6 +314,32 @@ private:
     // Client to wrap srv call to JavaFFServer
     std::shared_ptr<JavaFFClient> javaff_client_;
 
+    // last search result received while waiting for PlanDirector to reply to a request (nullptr if none)
+    javaff_interfaces::msg::SearchResult::SharedPtr deferred_search_result_;
+
+    // intention delta publisher (deltas wrt. the last snapshot published on the current intention topic)
+    rclcpp::Publisher<ros2_bdi_interfaces::msg::IntentionDelta>::SharedPtr intention_delta_publisher_;//intention delta pub.
+
+    // plan of the intention known by subscribers (identified by its action table) with its number of actions
+    typedef struct {
+        std::shared_ptr<const BDIManaged::ActionTable> action_table;
+        size_t n_actions;
+    } PublishedPlan;
+
+    // intention known by subscribers (last snapshot + deltas published since): target, chain of plans, actions
+    BDIManaged::ManagedDesire published_target_;
+    std::deque<PublishedPlan> published_chain_;
+    std::deque<ros2_bdi_interfaces::msg::BDIActionExecutionInfoMin> published_actions_;
+
+    // seq of the last intention snapshot published and of the last delta published wrt. it
+    uint64_t intention_seq_;
+    uint64_t intention_delta_seq_;
+
+    // versioned view of the problem JavaFF has received last (for problem delta submission)
+    PlannerProblemDelta::ProblemView planner_problem_;
+    // name of the PDDL domain (retrieved the first time a full problem is built for JavaFF)
+    std::string planner_domain_name_;
+
     //Plan library db utility (just used in online for now: put it here, so we can close connection in bringdown)
     PlanLibrary::BDIPlanLibrary planlib_db_;
     bool planlib_conn_ok_;
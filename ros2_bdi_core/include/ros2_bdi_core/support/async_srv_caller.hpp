@@ -0,0 +1,171 @@
+#ifndef ASYNC_SRV_CALLER_H_
+#define ASYNC_SRV_CALLER_H_
+
+#include <string>
+#include <memory>
+#include <chrono>
+#include <functional>
+#include <deque>
+
+#include "rclcpp/rclcpp.hpp"
+
+/*
+    Non blocking caller of a service of type ServiceT: requests go through a client of the host node, so that their completion
+    callbacks are executed by the executor spinning the host node, which is never blocked waiting for a response.
+    At most one request is in flight at a time: requests made meanwhile are queued and sent in FIFO order.
+    When coalescing is on (i.e. all requests are of the same kind and just the latest one matters, e.g. a new plan search), 
+    at most one request waits in the queue instead: it's replaced by any newer one, the replaced one completing as not performed.
+    Completion callbacks receive the response, nullptr if the request has not been performed
+    (replaced while pending, service not available or no response within the timeout)
+*/
+template<typename ServiceT>
+class AsyncSrvCaller
+{
+    public:
+        typedef typename ServiceT::Request::SharedPtr RequestPtr;
+        typedef typename ServiceT::Response::SharedPtr ResponsePtr;
+        typedef std::function<void(const ResponsePtr&)> Callback;
+        typedef std::function<RequestPtr()> RequestBuilder;
+
+        /* 
+            Caller of the service @service_name through a client of @host_node (which has to outlive the caller),
+            coalescing the requests waiting to be sent if @coalesce
+        */
+        AsyncSrvCaller(rclcpp::Node* host_node, const std::string& service_name, const std::chrono::milliseconds& timeout, 
+                const bool& coalesce = false):
+            host_node_(host_node),
+            timeout_(timeout),
+            coalesce_(coalesce),
+            generation_(0),
+            in_flight_(false)
+        {
+            client_ = host_node_->create_client<ServiceT>(service_name);
+        }
+
+        ~AsyncSrvCaller()
+        {
+            if(timeout_timer_)
+                timeout_timer_->cancel();
+        }
+
+        /* Send @request (or queue it if another one is in flight), @callback called on completion */
+        void call(const RequestPtr& request, const Callback& callback)
+        {
+            call([request](){return request;}, callback);
+        }
+
+        /* 
+            Send the request built by @buildRequest (or queue it if another one is in flight), @callback called on completion:
+            the request is built just when it's actually sent, i.e. after the ones queued before it have completed
+        */
+        void call(const RequestBuilder& buildRequest, const Callback& callback)
+        {
+            if(in_flight_)
+            {
+                if(coalesce_ && !pending_.empty())
+                {
+                    Callback replaced = pending_.back().callback;
+                    pending_.back() = PendingRequest{buildRequest, callback};
+                    if(replaced)
+                        replaced(nullptr);
+                }
+                else
+                    pending_.push_back(PendingRequest{buildRequest, callback});
+                return;
+            }
+            send(buildRequest(), callback);
+        }
+
+        /* Drop the queued requests and ignore the response to the one in flight: their callbacks are never called */
+        void cancel()
+        {
+            generation_++;
+            in_flight_ = false;
+            in_flight_callback_ = nullptr;
+            pending_.clear();
+            if(timeout_timer_)
+                timeout_timer_->cancel();
+        }
+
+        /* True if a request is waiting for its response */
+        bool busy() const {return in_flight_;}
+
+    private:
+        /* Request waiting for the one in flight to complete */
+        typedef struct {
+            RequestBuilder build;
+            Callback callback;
+        } PendingRequest;
+
+        void send(const RequestPtr& request, const Callback& callback)
+        {
+            uint64_t generation = ++generation_;
+            in_flight_ = true;
+            in_flight_callback_ = callback;
+            if(timeout_timer_)
+                timeout_timer_->cancel();
+            timeout_timer_ = host_node_->create_wall_timer(timeout_, [this, generation](){complete(generation, nullptr);});
+
+            if(!client_->service_is_ready())
+            {
+                // not waiting for the service to appear: the request completes as not performed when the timeout expires
+                RCLCPP_ERROR_STREAM(host_node_->get_logger(), client_->get_service_name() << " service client: service not available");
+                return;
+            }
+
+            try{
+                client_->async_send_request(request,
+                    [this, generation](typename rclcpp::Client<ServiceT>::SharedFuture future){complete(generation, future.get());});
+            }
+            catch(const rclcpp::exceptions::RCLError& rclerr)
+            {
+                RCLCPP_ERROR(host_node_->get_logger(), rclerr.what());
+            }
+        }
+
+        /* Request sent as @generation completed with @response: ignored if it isn't the one in flight anymore */
+        void complete(const uint64_t& generation, const ResponsePtr& response)
+        {
+            if(generation != generation_ || !in_flight_)
+                return;
+
+            timeout_timer_->cancel();
+            in_flight_ = false;
+            Callback callback = in_flight_callback_;
+            in_flight_callback_ = nullptr;
+
+            // send the next queued request first, so that anything requested by the callback queues up after it
+            if(!pending_.empty())
+            {
+                PendingRequest next = pending_.front();
+                pending_.pop_front();
+                send(next.build(), next.callback);
+            }
+
+            if(callback)
+                callback(response);
+        }
+
+        // node whose executor runs the completion callbacks
+        rclcpp::Node* host_node_;
+
+        // client instance to make the requests
+        typename rclcpp::Client<ServiceT>::SharedPtr client_;
+
+        // max time to wait for a response
+        std::chrono::milliseconds timeout_;
+        rclcpp::TimerBase::SharedPtr timeout_timer_;
+
+        // at most one queued request, replaced by newer ones
+        bool coalesce_;
+
+        // request in flight (generation tells apart its response from late responses to dropped requests)
+        uint64_t generation_;
+        bool in_flight_;
+        Callback in_flight_callback_;
+
+        // requests waiting for the one in flight to complete (FIFO)
+        std::deque<PendingRequest> pending_;
+};
+
+#endif //ASYNC_SRV_CALLER_H_
@@ -0,0 +1,76 @@
+#ifndef DEFERRED_SERVICE_H_
+#define DEFERRED_SERVICE_H_
+
+#include <string>
+#include <memory>
+#include <functional>
+
+#include "rclcpp/rclcpp.hpp"
+
+/*
+    Service of type ServiceT whose responses are not sent when the request callback returns, but whenever sendResponse is called
+    with the header of the request (e.g. from a subscription callback, once what has been requested is done),
+    so that no executor thread is kept busy while waiting for it.
+    The request callback receives the request header and the request: it has to call sendResponse exactly once per request,
+    right away or later on
+*/
+template<typename ServiceT>
+class DeferredService : public rclcpp::Service<ServiceT>
+{
+    public:
+        typedef std::shared_ptr<DeferredService<ServiceT>> SharedPtr;
+        typedef typename ServiceT::Request::SharedPtr RequestPtr;
+        typedef typename ServiceT::Response::SharedPtr ResponsePtr;
+        typedef std::function<void(const std::shared_ptr<rmw_request_id_t>&, const RequestPtr&)> Callback;
+
+        DeferredService(std::shared_ptr<rcl_node_t> node_handle, const std::string& service_name,
+                rcl_service_options_t& service_options, const Callback& callback):
+            rclcpp::Service<ServiceT>(node_handle, service_name, noResponseCallback(), service_options),
+            callback_(callback)
+            {}
+
+        /* Request received: the response is up to the callback */
+        void handle_request(std::shared_ptr<rmw_request_id_t> request_header, std::shared_ptr<void> request) override
+        {
+            callback_(request_header, std::static_pointer_cast<typename ServiceT::Request>(request));
+        }
+
+        /* Send @response to the request with header @request_header (safe to be called from any thread) */
+        void sendResponse(const std::shared_ptr<rmw_request_id_t>& request_header, const ResponsePtr& response)
+        {
+            rcl_ret_t ret = rcl_send_response(this->get_service_handle().get(), request_header.get(), response.get());
+            if(ret != RCL_RET_OK)
+            {
+                RCLCPP_ERROR(rclcpp::get_logger("deferred_service"), "Failed to send response to %s request: %s",
+                    this->get_service_name(), rcl_get_error_string().str);
+                rcl_reset_error();
+            }
+        }
+
+    private:
+        /* Never called, since requests are handled by handle_request, but the base class wants a callback to be set */
+        static rclcpp::AnyServiceCallback<ServiceT> noResponseCallback()
+        {
+            rclcpp::AnyServiceCallback<ServiceT> any_callback;
+            any_callback.set([](const RequestPtr, ResponsePtr){});
+            return any_callback;
+        }
+
+        Callback callback_;
+};
+
+/* Create a deferred service @service_name of @node within @group (as rclcpp::Node::create_service does for plain services) */
+template<typename ServiceT>
+typename DeferredService<ServiceT>::SharedPtr createDeferredService(rclcpp::Node* node, const std::string& service_name,
+        const typename DeferredService<ServiceT>::Callback& callback, rclcpp::callback_group::CallbackGroup::SharedPtr group = nullptr)
+{
+    rcl_service_options_t service_options = rcl_service_get_default_options();
+    service_options.qos = rmw_qos_profile_services_default;
+
+    auto service = std::make_shared<DeferredService<ServiceT>>(
+        node->get_node_base_interface()->get_shared_rcl_node_handle(), service_name, service_options, callback);
+    node->get_node_services_interface()->add_service(std::dynamic_pointer_cast<rclcpp::ServiceBase>(service), group);
+    return service;
+}
+
+#endif //DEFERRED_SERVICE_H_
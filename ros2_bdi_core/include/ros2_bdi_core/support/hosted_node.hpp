@@ -0,0 +1,29 @@
+#ifndef HOSTED_NODE_H_
+#define HOSTED_NODE_H_
+
+#include <functional>
+
+#include "rclcpp/rclcpp.hpp"
+
+/*
+    Core node of an agent hosted in the agent_core_host process (i.e. spinned in an executor shared with the other core nodes
+    of the agent), with the hooks called by the host in place of the main of the node executable
+*/
+typedef struct {
+    // node to be added to the shared executor
+    rclcpp::Node::SharedPtr node;
+    // wait for PlanSys2 to boot (when needed) and init the node: false if the node should not be spinned at all
+    std::function<bool()> boot;
+    // called once the shared executor has stopped spinning
+    std::function<void()> shutdown;
+} HostedNode;
+
+/* Factories of the hosted core nodes (each one defined in the source of the respective node) */
+HostedNode hostPlanSysMonitor();
+HostedNode hostBeliefManager();
+HostedNode hostSchedulerOffline();
+HostedNode hostPlanDirector();
+HostedNode hostMARequestHandler();
+HostedNode hostEventListener();
+
+#endif // HOSTED_NODE_H_
@@ -3,38 +3,48 @@
 
 #include <string>
 #include <memory>
+#include <functional>
 
 #include "ros2_bdi_interfaces/msg/desire.hpp"
 #include "ros2_bdi_utils/ManagedDesire.hpp"
 #include "javaff_interfaces/srv/java_ff_plan.hpp"
 #include "javaff_interfaces/srv/unexpected_state.hpp"
+#include "ros2_bdi_core/support/async_srv_caller.hpp"
 
 #include "rclcpp/rclcpp.hpp"
 
 class JavaFFClient
 {
     public:
-        /* Constructor for the supporting node for calling javaff services */
-        JavaFFClient(const std::string& nodeBasename);
+        /* Callback receiving true if the request has been accepted/handled by JavaFF */
+        typedef std::function<void(bool)> ResultCallback;
 
-        bool launchPlanSearch(const ros2_bdi_interfaces::msg::Desire& fulfilling_desire, const std::string& problem, const int& interval, const int& max_pplan_size, const int& max_empty_search_intervals);
-        bool callUnexpectedStateSrv(const std::string& pddl_problem);
+        /* 
+            Constructor for the client calling javaff services through @host_node:
+            requests never block, their results are notified to callbacks executed by the executor spinning @host_node
+        */
+        JavaFFClient(rclcpp::Node* host_node);
 
-    private:
-        bool makePlanSearchRequest(const javaff_interfaces::srv::JavaFFPlan::Request::SharedPtr& request);
+        /* Request to start a plan search, @callback notified whether it has been accepted */
+        void launchPlanSearch(const ros2_bdi_interfaces::msg::Desire& fulfilling_desire, const std::string& problem, const int& interval, const int& max_pplan_size, const int& max_empty_search_intervals,
+            const ResultCallback& callback);
 
-        bool makeUnexpectedStateRequest(const javaff_interfaces::srv::UnexpectedState::Request::SharedPtr& request);
+        /* Notify JavaFF of an unexpected state, @callback notified whether it has been handled */
+        void callUnexpectedStateSrv(const std::string& pddl_problem, const ResultCallback& callback);
 
+        /* Drop the requests not completed yet: their callbacks are never called */
+        void cancel();
 
-        // node to be spinned while making request to javaff srvs 
-        rclcpp::Node::SharedPtr caller_node_;
+        /* True if a request is waiting for its response */
+        bool busy() const {return start_plan_caller_.busy() || unexpected_state_caller_.busy();}
 
-        // client instance to make the request to the javaff_server/start_plan srv
-        rclcpp::Client<javaff_interfaces::srv::JavaFFPlan>::SharedPtr start_plan_client_;
+    private:
+        // non blocking caller of the javaff_server/start_plan srv (just the latest search request waits to be sent)
+        AsyncSrvCaller<javaff_interfaces::srv::JavaFFPlan> start_plan_caller_;
 
-        // client instance to make the request to the javaff_server/unexpected_state srv
-        rclcpp::Client<javaff_interfaces::srv::UnexpectedState>::SharedPtr unexpected_state_client_;
+        // non blocking caller of the javaff_server/unexpected_state srv (just the latest state waits to be sent)
+        AsyncSrvCaller<javaff_interfaces::srv::UnexpectedState> unexpected_state_caller_;
 
 };
 
-#endif //JAVAFF_CLIENT_H_
\ No newline at end of file
+#endif //JAVAFF_CLIENT_H_
@@ -7,6 +7,7 @@
 #include <memory>
 
 #include "lifecycle_msgs/srv/get_state.hpp"
+#include "ros2_bdi_interfaces/msg/planning_system_state.hpp"
 #include "ros2_bdi_core/support/planning_mode.hpp"
 
 #include "rclcpp/rclcpp.hpp"
@@ -15,38 +16,52 @@ class PlanSysMonitorClient
 {
     public:
 
-        /* 
-            Constructor for the supporting nodes for calling the services 
-                @nodesBasename is the basename given to the supporting nodes
+        /*
+            Constructor for the supporting node for calling the services
+                @nodesBasename is the basename given to the supporting node
                 @selPlanningMode selected planning mode {OFFLINE, ONLINE}
         */
         PlanSysMonitorClient(const std::string& nodesBasename) : PlanSysMonitorClient(nodesBasename, OFFLINE){};
-        /* 
-            Constructor for the supporting nodes for calling the services 
-                @nodesBasename is the basename given to the supporting nodes
+        /*
+            Constructor for the supporting node for calling the services
+                @nodesBasename is the basename given to the supporting node
                 @selPlanningMode selected planning mode {OFFLINE, ONLINE}
         */
         PlanSysMonitorClient(const std::string& nodesBasename, const PlanningMode& selPlanningMode);
-        
+
         /* Return true if {psysNodeName}/get_state service called confirm that the node is active */
         bool isPsysNodeActive(const std::string& psysNodeName);
 
+        /*
+            Call the {psysNodeName}/get_state services of all @psysNodeNames concurrently (requests all sent at once,
+            then waited for max @timeout overall); i-th flag true if the i-th node has confirmed to be active
+            (nodes whose service is not up yet are not waited for)
+        */
+        std::vector<bool> arePsysNodesActive(const std::vector<std::string>& psysNodeNames, const std::chrono::seconds timeout);
+
         /* Return true if all {psysNodeName}/get_state service called confirm that the nodes are active, wait max_wait in case they're not before returning false */
         bool areAllPsysNodeActive(const std::chrono::seconds max_wait = std::chrono::seconds(0));
 
+        /*
+            Wait max @max_wait for the PlanSys2 monitor of the agent to notify (in its latched plansys_state topic) that all the
+            PlanSys2 nodes are active, spinning @node meanwhile (call it before adding @node to any executor);
+            if no notification is received at all (e.g. monitor not running), fall back to query them directly
+        */
+        static bool waitPsysBoot(const rclcpp::Node::SharedPtr& node, const PlanningMode& selPlanningMode, const std::chrono::seconds max_wait);
+
+        /* True if @psysState notifies that all PlanSys2 nodes needed in the @selPlanningMode are active */
+        static bool allActive(const ros2_bdi_interfaces::msg::PlanningSystemState& psysState, const PlanningMode& selPlanningMode);
+
     private:
 
         PlanningMode sel_planning_mode;
 
-        /* Get the reference to the node caller instance for the PlanSys2 node @psys2NodeName */
-        rclcpp::Node::SharedPtr getCallerNode(const std::string& psys2NodeName);
-        
         /* Get the reference to the client caller instance for the PlanSys2 node @psys2NodeName */
         rclcpp::Client<lifecycle_msgs::srv::GetState>::SharedPtr getCallerClient(const std::string& psys2NodeName);
 
-        
-        // nodes to be spinned while making request (one for each plansys2 node to be called)
-        std::vector<rclcpp::Node::SharedPtr> caller_nodes_;
+
+        // node to be spinned while making requests (shared by all the clients below)
+        rclcpp::Node::SharedPtr caller_node_;
 
         // below client instances to be instantiated while making a request to ...
 
@@ -54,4 +69,4 @@ class PlanSysMonitorClient
         std::vector<rclcpp::Client<lifecycle_msgs::srv::GetState>::SharedPtr> caller_clients_;
 };
 
-#endif // PLANSYS_MONITOR_CLIENT_H_
\ No newline at end of file
+#endif // PLANSYS_MONITOR_CLIENT_H_
@@ -3,26 +3,41 @@
 
 #include <string>
 #include <memory>
+#include <functional>
 
 #include "ros2_bdi_interfaces/msg/bdi_plan.hpp"
 #include "ros2_bdi_interfaces/srv/bdi_plan_execution.hpp"
+#include "ros2_bdi_core/support/async_srv_caller.hpp"
 
 #include "rclcpp/rclcpp.hpp"
 
 class TriggerPlanClient
 {
     public:
-        /* Constructor for the supporting node for calling the plan_execution service */
-        TriggerPlanClient(const std::string& nodeBasename);
+        /* Callback receiving true if the operation has been successful */
+        typedef std::function<void(bool)> ResultCallback;
+
+        /* 
+            Constructor for the client calling the plan_execution service through @host_node:
+            requests never block, their results are notified to callbacks executed by the executor spinning @host_node.
+            Requests are sent one at a time in the order they're made (never coalesced, whatever their kind)
+        */
+        TriggerPlanClient(rclcpp::Node* host_node);
         
-        /* Return true if operation is successful */
-        bool triggerPlanExecution(const ros2_bdi_interfaces::msg::BDIPlan& bdiPlan);
+        /* Request to trigger @bdiPlan execution, @callback notified with the result */
+        void triggerPlanExecution(const ros2_bdi_interfaces::msg::BDIPlan& bdiPlan, const ResultCallback& callback);
 
-        /* Return true if operation is successful */
-        bool abortPlanExecution(const ros2_bdi_interfaces::msg::BDIPlan& bdiPlan);
+        /* 
+            Request to abort the execution of the plan returned by @planToAbort, @callback notified with the result:
+            @planToAbort is called once the requests made before have completed (e.g. a plan triggered meanwhile is the one to abort)
+        */
+        void abortPlanExecution(const std::function<ros2_bdi_interfaces::msg::BDIPlan()>& planToAbort, const ResultCallback& callback);
+
+        /* Request to stop @bdiPlan execution at its committed point, @callback notified with the result */
+        void earlyArrestRequest(const ros2_bdi_interfaces::msg::BDIPlan& bdiPlan, const ResultCallback& callback);
 
-        /* Return true if operation is successful */
-        bool earlyArrestRequest(const ros2_bdi_interfaces::msg::BDIPlan& bdiPlan);
+        /* True if a request is waiting for its response */
+        bool busy() const {return caller_.busy();}
 
     private:
 
@@ -30,13 +45,10 @@ class TriggerPlanClient
             Manage the request call toward the plan_execution service, so that the public functions
             for triggering/aborting plan execution are just wrappers for it avoiding code duplication
         */
-        bool makePlanExecutionRequest(const ros2_bdi_interfaces::srv::BDIPlanExecution::Request::SharedPtr& request);
-
-        // node to be spinned while making request to the plan_execution srv 
-        rclcpp::Node::SharedPtr caller_node_;
+        void makePlanExecutionRequest(const ros2_bdi_interfaces::srv::BDIPlanExecution::Request::SharedPtr& request, const ResultCallback& callback);
 
-        // client instance to make the request to the plan_execution srv
-        rclcpp::Client<ros2_bdi_interfaces::srv::BDIPlanExecution>::SharedPtr caller_client_;
+        // non blocking caller of the plan_execution srv
+        AsyncSrvCaller<ros2_bdi_interfaces::srv::BDIPlanExecution> caller_;
 };
 
-#endif //TRIGGER_PLAN_CLIENT_H_
\ No newline at end of file
+#endif //TRIGGER_PLAN_CLIENT_H_
@@ -0,0 +1,63 @@
+#include <iostream>
+#include <thread>
+#include <vector>
+
+// hooks to spin the core nodes within this process
+#include "ros2_bdi_core/support/hosted_node.hpp"
+
+#include "rclcpp/rclcpp.hpp"
+
+using std::vector;
+
+/*
+    Single process hosting all the core nodes of an agent (offline planning mode), spinned by a shared multi threaded executor
+    (callbacks of the same node are still mutually exclusive, unless the node itself defines reentrant callback groups)
+    in place of the six processes of the distinct node executables
+
+    The agent is given by the namespace of the process (e.g. --ros-args -r __ns:=/agent0) and the node params by a params file
+    with a section per core node name.
+
+    Scope: one process hosts exactly ONE agent, i.e. N agents still need N host processes. PlanSys2 client classes 
+    (DomainExpertClient, ProblemExpertClient, ExecutorClient) create their own nodes with default options and do not take a namespace, 
+    so they always talk to the PlanSys2 instance in the namespace of the process: several agents in here would share it.
+    Hosting N agents per process would need namespaced PlanSys2 clients (not available in the PlanSys2 version in use),
+    and the PlanSys2 nodes themselves are still run as separate processes.
+
+    No hosted core node callback blocks waiting for messages of another node (MARequestHandler write requests are answered
+    with deferred responses), so the threads of the shared executor cannot be all tied up by pending requests
+*/
+int main(int argc, char ** argv)
+{
+  rclcpp::init(argc, argv);
+  rclcpp::executors::MultiThreadedExecutor executor;
+
+  // the PlanSys2 monitor goes first and gets spinned straight away: the others wait for its notifications to boot
+  vector<HostedNode> hosted_nodes = {hostPlanSysMonitor()};
+  hosted_nodes[0].boot();
+  executor.add_node(hosted_nodes[0].node);
+  std::thread spin_thread([&executor](){ executor.spin(); });
+
+  for(auto host : {hostBeliefManager, hostSchedulerOffline, hostPlanDirector, hostMARequestHandler, hostEventListener})
+  {
+    if(!rclcpp::ok())
+      break;
+
+    HostedNode hosted_node = host();
+    if(hosted_node.boot())
+    {
+      executor.add_node(hosted_node.node);
+      hosted_nodes.push_back(hosted_node);
+    }
+    else
+      std::cerr << "Core node \"" << hosted_node.node->get_name() << "\" will not spin" << std::endl;
+  }
+
+  spin_thread.join();
+
+  for(HostedNode& hosted_node : hosted_nodes)
+    hosted_node.shutdown();
+
+  rclcpp::shutdown();
+
+  return 0;
+}
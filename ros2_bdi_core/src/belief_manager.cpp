@@ -1,5 +1,7 @@
 // header file for Belief Manager node
 #include "ros2_bdi_core/belief_manager.hpp"
+// hooks to spin the node within the agent_core_host process
+#include "ros2_bdi_core/support/hosted_node.hpp"
 // Inner logic + ROS PARAMS & FIXED GLOBAL VALUES for ROS2 core nodes
 #include "ros2_bdi_core/params/core_common_params.hpp"
 // Inner logic + ROS2 PARAMS & FIXED GLOBAL VALUES for Belief Manager node
@@ -14,9 +16,11 @@
 #include "ros2_bdi_utils/PDDLBDIConverter.hpp"
 #include "ros2_bdi_utils/BDIFilter.hpp"
 #include "ros2_bdi_utils/BDIYAMLParser.hpp"
+#include "ros2_bdi_utils/BDISnapshot.hpp"
 
 #include <iostream>
 #include <fstream>
+#include <unordered_set>
 
 using std::string;
 using std::vector;
@@ -27,6 +31,7 @@ using std::shared_ptr;
 using std::chrono::milliseconds;
 using std::bind;
 using std::placeholders::_1;
+using std::placeholders::_2;
 
 using plansys2::ProblemExpertClient;
 using plansys2::DomainExpertClient;
@@ -38,8 +43,10 @@ using std_msgs::msg::Empty;
 
 using ros2_bdi_interfaces::msg::Belief;
 using ros2_bdi_interfaces::msg::BeliefSet;
+using ros2_bdi_interfaces::msg::BeliefSetDelta;
 using ros2_bdi_interfaces::msg::LifecycleStatus;
 using ros2_bdi_interfaces::msg::PlanningSystemState;
+using ros2_bdi_interfaces::srv::LoadStaticBeliefs;
 
 using BDIManaged::ManagedType;
 using BDIManaged::ManagedParam;
@@ -54,6 +61,8 @@ BeliefManager::BeliefManager()
     this->declare_parameter(PARAM_AGENT_ID, "agent0");
     this->declare_parameter(PARAM_DEBUG, true);
     this->declare_parameter(PARAM_PLANNING_MODE, PLANNING_MODE_OFFLINE);
+    this->declare_parameter(PARAM_WARM_RESTART, false);
+    this->declare_parameter(PARAM_STATIC_BELIEF_NAMES, vector<string>());
 
     sel_planning_mode_ = this->get_parameter(PARAM_PLANNING_MODE).as_string() == PLANNING_MODE_OFFLINE? OFFLINE : ONLINE;
     this->undeclare_parameter(PARAM_PLANNING_MODE);
@@ -86,9 +95,25 @@ void BeliefManager::init()
     belief_set_ = set<ManagedBelief>();
     //wait for it to be init
     init_bset_ = false;
+    snapshot_dirty_ = false;
+
+    //predicates/functions names and instance types whose beliefs are static
+    static_names_ = std::unordered_set<string>();
+    for(string static_name : this->get_parameter(PARAM_STATIC_BELIEF_NAMES).as_string_array())
+        static_names_.insert(static_name);
+    static_bset_changed_ = false;
+    dynamic_bset_changed_ = true;
+    loading_static_block_ = false;
 
     //Belief set publisher
     belief_set_publisher_ = this->create_publisher<BeliefSet>(BELIEF_SET_TOPIC, 10);
+
+    //Belief set delta publisher
+    delta_seq_ = 0;
+    belief_set_delta_publisher_ = this->create_publisher<BeliefSetDelta>(BELIEF_SET_DELTA_TOPIC, rclcpp::QoS(10).reliable());
+
+    //Static belief set publisher (latched, so that late joiners get it even if it's not published again)
+    static_belief_set_publisher_ = this->create_publisher<BeliefSet>(STATIC_BELIEF_SET_TOPIC, rclcpp::QoS(1).reliable().transient_local());
     
     rclcpp::QoS qos_reliable = rclcpp::QoS(10);
     qos_reliable.reliable();
@@ -106,12 +131,12 @@ void BeliefManager::init()
     // init step_counter
     step_counter_ = 0;
 
-    //Lifecycle status publisher
-    lifecycle_status_publisher_ = this->create_publisher<LifecycleStatus>(LIFECYCLE_STATUS_TOPIC, 10);
+    //Lifecycle status publisher (latched, so that nodes booting later get the last status of each node right away)
+    lifecycle_status_publisher_ = this->create_publisher<LifecycleStatus>(LIFECYCLE_STATUS_TOPIC, rclcpp::QoS(1).reliable().transient_local());
 
     //Lifecycle status subscriber
     lifecycle_status_subscriber_ = this->create_subscription<LifecycleStatus>(
-                LIFECYCLE_STATUS_TOPIC, qos_reliable,
+                LIFECYCLE_STATUS_TOPIC, rclcpp::QoS(10).reliable().transient_local(),
                 bind(&BeliefManager::callbackLifecycleStatus, this, _1));
 
     //Check for plansys2 active state flags init to false
@@ -120,7 +145,7 @@ void BeliefManager::init()
 
     //plansys2 nodes status subscriber (receive notification from plansys2_monitor node)
     plansys2_status_subscriber_ = this->create_subscription<PlanningSystemState>(
-                PSYS_STATE_TOPIC, qos_reliable,
+                PSYS_STATE_TOPIC, rclcpp::QoS(1).reliable().transient_local(),
                 bind(&BeliefManager::callbackPsys2State, this, _1));
 
     //Belief to be added notification
@@ -143,6 +168,10 @@ void BeliefManager::init()
                 DEL_BELIEF_TOPIC, qos_reliable,
                 bind(&BeliefManager::delBeliefTopicCallBack, this, _1));
 
+    //Static beliefs bulk loader
+    load_static_beliefs_server_ = this->create_service<LoadStaticBeliefs>(LOAD_STATIC_BELIEFS_SRV, 
+        bind(&BeliefManager::handleLoadStaticBeliefs, this, _1, _2));
+
     //problem_expert update subscriber
     updated_problem_subscriber_ = this->create_subscription<Empty>(
                 "problem_expert/update_notify", 10,
@@ -180,7 +209,8 @@ void BeliefManager::step()
                 psys2_comm_errors_ = 0;
                 if(!init_bset_)//hasn't been tried to init belief set yet
                 {    
-                    tryInitBeliefSet();
+                    if(!this->get_parameter(PARAM_WARM_RESTART).as_bool() || !tryRestoreBeliefSet())
+                        tryInitBeliefSet();
                     init_bset_ = true;
                 }
                 setState(SYNC);
@@ -199,6 +229,8 @@ void BeliefManager::step()
         case SYNC:
         {    
             publishBeliefSet();
+            if(step_counter_ % BELIEF_SET_SNAPSHOT_INTERVAL_STEPS == 0)
+                saveSnapshot();
         }
 
         case PAUSE:
@@ -233,13 +265,58 @@ void BeliefManager::callbackPsys2State(const PlanningSystemState::SharedPtr msg)
 }
 
 /*
-    Publish the current belief set of the agent in agent_id_/belief_set topic
+    Publish the dynamic partition of the current belief set of the agent in agent_id_/belief_set topic
+    (and the static one in agent_id_/static_belief_set, if it has grown since its last publication)
 */
 void BeliefManager::publishBeliefSet()
 {
-    BeliefSet bset_msg = BDIFilter::extractBeliefSetMsg(belief_set_);
-    bset_msg.agent_id = agent_id_;
-    belief_set_publisher_->publish(bset_msg);
+    publishBeliefSetDelta();//notify pending alterations first, so that delta receivers can ack them asap
+
+    mtx_sync.lock();
+        if(static_bset_changed_)
+        {
+            // static partition published before the dynamic one, so that the latter never refers to beliefs which are not known yet
+            BeliefSet static_bset_msg = BDIFilter::extractBeliefSetMsg(static_beliefs_);
+            static_bset_msg.agent_id = agent_id_;
+            static_belief_set_publisher_->publish(static_bset_msg);
+            static_bset_changed_ = false;
+        }
+
+        if(dynamic_bset_changed_)
+        {
+            // rebuilt just after a change, otherwise the last one is published again
+            dynamic_bset_msg_ = BeliefSet{};
+            dynamic_bset_msg_.agent_id = agent_id_;
+            for(ManagedBelief mb : belief_set_)
+                if(static_beliefs_.count(mb) == 0)
+                    dynamic_bset_msg_.value.push_back(mb.toBelief());
+            dynamic_bset_changed_ = false;
+        }
+        dynamic_bset_msg_.seq = delta_seq_;//every delta published so far is reflected in it
+    mtx_sync.unlock();
+
+    belief_set_publisher_->publish(dynamic_bset_msg_);
+}
+
+/*
+    Publish the alterations to the belief set not notified yet in agent_id_/belief_set_delta topic (if any)
+*/
+void BeliefManager::publishBeliefSetDelta()
+{
+    if(delta_added_.size() == 0 && delta_removed_.size() == 0)
+        return;
+
+    BeliefSetDelta delta_msg = BeliefSetDelta{};
+    delta_msg.agent_id = agent_id_;
+    delta_msg.seq = ++delta_seq_;
+    for(ManagedBelief mb : delta_added_)
+        delta_msg.added.push_back(mb.toBelief());
+    for(ManagedBelief mb : delta_removed_)
+        delta_msg.removed.push_back(mb.toBelief());
+    delta_added_.clear();
+    delta_removed_.clear();
+
+    belief_set_delta_publisher_->publish(delta_msg);
 }
 
 /*
@@ -248,9 +325,13 @@ void BeliefManager::publishBeliefSet()
 void BeliefManager::tryInitBeliefSet()
 {
     string init_bset_filepath = "/tmp/"+this->get_parameter(PARAM_AGENT_ID).as_string()+"/"+INIT_BELIEF_SET_FILENAME;
+    init_bset_hash_ = BDISnapshot::fileHash(init_bset_filepath);
     
     try{
-        vector<ManagedBelief> init_mgbeliefs = BDIYAMLParser::extractMGBeliefs(init_bset_filepath, domain_expert_);
+        vector<ManagedBelief> init_static_mgbeliefs;
+        vector<ManagedBelief> init_mgbeliefs = BDIYAMLParser::extractMGBeliefs(init_bset_filepath, domain_expert_, init_static_mgbeliefs);
+        if(init_static_mgbeliefs.size() > 0)
+            loadStaticBeliefs(init_static_mgbeliefs);//beliefs flagged as static in the init. file
         for(ManagedBelief initMGBelief : init_mgbeliefs)
             addBeliefSyncPDDL(initMGBelief);
         if(this->get_parameter(PARAM_DEBUG).as_bool())
@@ -267,12 +348,128 @@ void BeliefManager::tryInitBeliefSet()
     }
 }
 
+/*
+    Restore the belief set from the snapshot file "/tmp/{agent_id}/bset.snapshot" in one pass:
+    instances first, then predicates and functions (no yaml parsing, no domain expert lookups, no missing instances checks)
+    Returns false if there is no valid snapshot to restore from or the init. file has been edited since the snapshot
+*/
+bool BeliefManager::tryRestoreBeliefSet()
+{
+    string snapshot_filepath = "/tmp/"+this->get_parameter(PARAM_AGENT_ID).as_string()+"/"+BELIEF_SET_SNAPSHOT_FILENAME;
+    string init_bset_filepath = "/tmp/"+this->get_parameter(PARAM_AGENT_ID).as_string()+"/"+INIT_BELIEF_SET_FILENAME;
+    BDISnapshot::Snapshot snapshot(snapshot_filepath);
+    if(!snapshot.valid())
+        return false;
+
+    if(!snapshot.isUpToDate(init_bset_filepath))
+    {
+        RCLCPP_INFO(this->get_logger(), "Belief set snapshot " + snapshot_filepath + " is older than the current init. file: falling back to init. file");
+        return false;
+    }
+    init_bset_hash_ = BDISnapshot::fileHash(init_bset_filepath);
+
+    auto instances = snapshot.getBeliefs(BDISnapshot::INSTANCES_SECTION);
+    auto beliefs = snapshot.getBeliefs(BDISnapshot::BELIEFS_SECTION);
+    if(!instances.has_value() || !beliefs.has_value())
+    {
+        RCLCPP_ERROR(this->get_logger(), "Belief set snapshot " + snapshot_filepath + " is corrupted: falling back to init. file");
+        return false;
+    }
+
+    // static partition (missing in snapshots with no static beliefs)
+    set<ManagedBelief> static_beliefs = snapshot.getBeliefs(BDISnapshot::STATIC_BELIEFS_SECTION).value_or(set<ManagedBelief>());
+
+    int restored = 0;
+    mtx_sync.lock();
+        for(ManagedBelief mb : instances.value())
+            if(problem_expert_->addInstance(BDIPDDLConverter::buildInstance(mb)))
+            {
+                belief_set_.insert(mb);
+                delta_added_.insert(mb);
+                if(static_beliefs.count(mb) == 1 || isTaggedStatic(mb))
+                    markStatic(mb);
+                restored++;
+            }
+
+        for(ManagedBelief mb : beliefs.value())
+        {
+            bool added = false;
+            if(mb.pddlType() == Belief().PREDICATE_TYPE)
+                added = problem_expert_->addPredicate(BDIPDDLConverter::buildPredicate(mb));
+            else if(mb.pddlType() == Belief().FUNCTION_TYPE)
+                added = problem_expert_->addFunction(BDIPDDLConverter::buildFunction(mb));
+
+            if(added)
+            {
+                belief_set_.insert(mb);
+                delta_added_.insert(mb);
+                if(static_beliefs.count(mb) == 1 || isTaggedStatic(mb))
+                    markStatic(mb);
+                restored++;
+            }
+        }
+        dynamic_bset_changed_ = true;
+    mtx_sync.unlock();
+
+    RCLCPP_INFO(this->get_logger(), "Belief set restored from snapshot " + snapshot_filepath + " (" + 
+        std::to_string(restored) + "/" + std::to_string(instances.value().size() + beliefs.value().size()) + " beliefs)");
+    publishBeliefSet();
+    return true;
+}
+
+/*
+    Write the current belief set (instances + predicates/functions) into the snapshot file
+    "/tmp/{agent_id}/bset.snapshot" (warm restart only); called periodically and on shutdown
+*/
+void BeliefManager::saveSnapshot()
+{
+    if(!this->get_parameter(PARAM_WARM_RESTART).as_bool() || !snapshot_dirty_)
+        return;
+
+    set<ManagedBelief> instances, beliefs, static_beliefs;
+    mtx_sync.lock();
+        for(ManagedBelief mb : belief_set_)
+            if(mb.pddlType() == Belief().INSTANCE_TYPE)
+                instances.insert(instances.end(), mb);
+            else
+                beliefs.insert(beliefs.end(), mb);
+        static_beliefs = static_beliefs_;
+        snapshot_dirty_ = false;
+    mtx_sync.unlock();
+
+    BDISnapshot::Sections sections;
+    BDISnapshot::putBeliefs(sections, BDISnapshot::INSTANCES_SECTION, instances);
+    BDISnapshot::putBeliefs(sections, BDISnapshot::BELIEFS_SECTION, beliefs);
+    if(static_beliefs.size() > 0)
+        BDISnapshot::putBeliefs(sections, BDISnapshot::STATIC_BELIEFS_SECTION, static_beliefs);
+    if(init_bset_hash_.has_value())
+        BDISnapshot::putSourceHash(sections, init_bset_hash_.value());
+
+    string snapshot_filepath = "/tmp/"+agent_id_+"/"+BELIEF_SET_SNAPSHOT_FILENAME;
+    if(!BDISnapshot::writeSnapshot(snapshot_filepath, sections))
+    {
+        snapshot_dirty_ = true;//retry at the next round
+        RCLCPP_ERROR(this->get_logger(), "Failed to write belief set snapshot " + snapshot_filepath);
+    }
+}
+
 /*
     Callback wrt. "problem_expert/update_notify" topic which notifies about any change in the PDDL problem
     update belief set accordingly
 */
 void BeliefManager::updatedPDDLProblem(const Empty::SharedPtr msg)
 {   
+    if(loading_static_block_)
+        return;//synced once the whole block has been installed
+
+    syncBeliefSetWithPDDLProblem();
+}
+
+/*
+    Retrieve the PDDL problem and, if it has changed since the last time, update the belief set accordingly
+*/
+void BeliefManager::syncBeliefSetWithPDDLProblem()
+{
     string pddlProblemNow = problem_expert_->getProblem();
     //strip off goal part (the belief regards just instances, predicates, fluents)
     pddlProblemNow = pddlProblemNow.substr(0,pddlProblemNow.find(":goal")-1);
@@ -345,6 +542,8 @@ bool BeliefManager::addOrModifyBeliefs(const vector<Belief>& beliefs, const bool
     for(auto bel : beliefs)
     {   
         ManagedBelief mb = ManagedBelief{bel};
+        if(static_beliefs_.count(mb) == 1)
+            continue;//static beliefs are immutable, no need to diff them
         int count_bs = belief_set_.count(mb);
         
         if(count_bs == 0)//not found
@@ -384,7 +583,7 @@ bool BeliefManager::removedInstanceBeliefs(const vector<Belief>& beliefs)
     {
         //some instance has to be removed from the belief set, since it has already been removed from the pddl problem
         for(ManagedBelief mb : instances_in_belief_set)
-            if(instances_in_pddl_prob.count(mb) == 0)
+            if(static_beliefs_.count(mb) == 0 && instances_in_pddl_prob.count(mb) == 0)
             {
                 modified = true;
                 delBelief(mb);//mb shall be removed from belief_set_ since it's not present in the pddl_problem
@@ -410,7 +609,7 @@ bool BeliefManager::removedFunctionBeliefs(const vector<Belief>& beliefs)
     {
         //some function has to be removed from the belief set, since it has already been removed from the pddl problem
         for(ManagedBelief mb : function_in_belief_set)
-            if(function_in_pddl_prob.count(mb) == 0)
+            if(static_beliefs_.count(mb) == 0 && function_in_pddl_prob.count(mb) == 0)
             {
                 modified = true;
                 delBelief(mb);//mb shall be removed from belief_set_ since it's not present in the pddl_problem
@@ -436,7 +635,7 @@ bool BeliefManager::removedPredicateBeliefs(const vector<Belief>& beliefs)
     {
         //some predicate has to be removed from the belief set, since it has already been removed from the pddl problem
         for(ManagedBelief mb : pred_in_belief_set_)
-            if(pred_in_pddl_prob.count(mb) == 0)
+            if(static_beliefs_.count(mb) == 0 && pred_in_pddl_prob.count(mb) == 0)
             {
                 modified = true;
                 delBelief(mb);//mb shall be removed from belief_set_ since it's not present in the pddl_problem
@@ -493,6 +692,7 @@ void BeliefManager::delBeliefSetTopicCallBack(const BeliefSet::SharedPtr msg)
 void BeliefManager::addBeliefSyncPDDL(const ManagedBelief& mb)
 {   
     bool alreadyThere = true;//belief already in belief set (check later)
+    bool modified = false;//function already in belief set, but with its value modified
     mtx_sync.lock();
         if(belief_set_.count(mb)==0)
         {
@@ -525,19 +725,150 @@ void BeliefManager::addBeliefSyncPDDL(const ManagedBelief& mb)
             }
 
         }
-        else if(mb.pddlType() == Belief().FUNCTION_TYPE && mb.getValue() != (*(belief_set_.find(mb))).getValue())
+        else if(mb.pddlType() == Belief().FUNCTION_TYPE && static_beliefs_.count(mb) == 0 && mb.getValue() != (*(belief_set_.find(mb))).getValue())
         {
             //function present in the belief set with diff. value
             Function f_upd = BDIPDDLConverter::buildFunction(mb);
             if(problem_expert_->updateFunction(f_upd))//instances have to be already present
+            {
                 modifyBelief(mb);
+                modified = true;
+            }
         }
     mtx_sync.unlock();
     
-    if(!alreadyThere && belief_set_.count(mb) > 0)//modification to belief set
+    if(modified || !alreadyThere && belief_set_.count(mb) > 0)//modification to belief set
         publishBeliefSet();
 }
 
+/*
+    Load static beliefs service handler: install the requested block of facts (+ the ones in the given yaml file)
+*/
+void BeliefManager::handleLoadStaticBeliefs(const LoadStaticBeliefs::Request::SharedPtr request,
+            const LoadStaticBeliefs::Response::SharedPtr response)
+{
+    auto start = std::chrono::steady_clock::now();
+    response->success = false;
+    response->loaded = 0;
+    response->rejected = 0;
+
+    if(!psys2_domain_expert_active_ || !psys2_problem_expert_active_)
+        return;
+
+    vector<ManagedBelief> block;
+    block.reserve(request->beliefs.size());
+    for(Belief b : request->beliefs)
+        block.push_back(ManagedBelief{b});
+
+    if(request->filepath != "")
+    {
+        try{
+            vector<ManagedBelief> file_block = BDIYAMLParser::extractMGBeliefs(request->filepath, domain_expert_);
+            block.insert(block.end(), file_block.begin(), file_block.end());
+        }catch(const YAML::Exception& e){
+            RCLCPP_ERROR(this->get_logger(), "Static beliefs loading failed because file " + request->filepath + " isn't a valid belief array");
+            return;
+        }
+    }
+
+    int rejected = loadStaticBeliefs(block);
+    double elapsed_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+    response->success = rejected == 0;
+    response->loaded = block.size() - rejected;
+    response->rejected = rejected;
+    response->elapsed_ms = elapsed_ms;
+    RCLCPP_INFO(this->get_logger(), "Static beliefs block loaded: %d facts installed, %d rejected in %.1f ms", 
+        response->loaded, response->rejected, elapsed_ms);
+}
+
+/*
+    Install the block of facts @block in the pddl problem and in the belief set as a single belief set operation
+    (instances first, then predicates and functions creating the missing instances on the fly, one notification at the end)
+    and mark them as static. Each fact is still a distinct problem expert call (the PlanSys2 client offers no batched addition), 
+    but the update notifications they trigger are not synced one by one: the belief set is synced with the PDDL problem just once,
+    after the whole block. Returns the number of facts of the block which could not be installed
+*/
+int BeliefManager::loadStaticBeliefs(const vector<ManagedBelief>& block)
+{
+    int rejected = 0;
+    bool modified = false;
+    loading_static_block_ = true;
+    mtx_sync.lock();
+        // instances known by the problem expert, retrieved once for the whole block
+        std::unordered_set<string> known_instances;
+        for(Instance ins : problem_expert_->getInstances())
+            known_instances.insert(ins.name);
+
+        for(ManagedBelief mb : block)
+            if(mb.pddlType() == Belief().INSTANCE_TYPE)
+            {
+                if(known_instances.count(mb.getName()) == 0)
+                {
+                    if(!problem_expert_->addInstance(BDIPDDLConverter::buildInstance(mb)))
+                    {
+                        rejected++;
+                        continue;
+                    }
+                    known_instances.insert(mb.getName());
+                }
+                if(belief_set_.count(mb) == 0)
+                {
+                    addBelief(mb);
+                    modified = true;
+                }
+                modified = static_beliefs_.count(mb) == 0 || modified;
+                markStatic(mb);
+            }
+
+        for(ManagedBelief mb : block)
+        {
+            if(mb.pddlType() != Belief().PREDICATE_TYPE && mb.pddlType() != Belief().FUNCTION_TYPE)
+                continue;
+            
+            if(belief_set_.count(mb) == 1)
+            {
+                modified = static_beliefs_.count(mb) == 0 || modified;
+                markStatic(mb);//already there, from now on static
+                continue;
+            }
+
+            // add missing instances (if any), asking the problem expert just when some param is not a known instance
+            bool missing_ok = true;
+            for(ManagedParam param : mb.getParams())
+                if(known_instances.count(param.name) == 0)
+                {
+                    missing_ok = tryAddMissingInstances(mb);
+                    modified = missing_ok || modified;
+                    break;
+                }
+            if(missing_ok)
+                for(ManagedParam param : mb.getParams())
+                    known_instances.insert(param.name);
+
+            bool added = missing_ok && (mb.pddlType() == Belief().PREDICATE_TYPE?
+                problem_expert_->addPredicate(BDIPDDLConverter::buildPredicate(mb)) :
+                problem_expert_->addFunction(BDIPDDLConverter::buildFunction(mb)));
+
+            if(added)
+            {
+                addBelief(mb);
+                markStatic(mb);
+                modified = true;
+            }
+            else
+                rejected++;
+        }
+    mtx_sync.unlock();
+    loading_static_block_ = false;
+
+    if(modified)
+        publishBeliefSet();//whole block notified at once
+    
+    syncBeliefSetWithPDDLProblem();//single sync for all the update notifications skipped while installing the block
+    return rejected;
+}
+
 /*
     Create array of boolean flags denoting missing instances' positions
     wrt. parameters in the passed ManagedBelief argument
@@ -657,7 +988,7 @@ void BeliefManager::delBeliefSyncPDDL(const ManagedBelief& mb)
 {
     bool done = false;
     mtx_sync.lock();
-        if(belief_set_.count(mb)==1)
+        if(belief_set_.count(mb)==1 && static_beliefs_.count(mb)==0)//static beliefs can't be removed
         {
             if(mb.pddlType() == Belief().INSTANCE_TYPE)
             {
@@ -680,7 +1011,7 @@ void BeliefManager::delBeliefSyncPDDL(const ManagedBelief& mb)
             }
             
             if(done)
-                belief_set_.erase(mb);
+                delBelief(mb);
         }
     mtx_sync.unlock();
 
@@ -694,6 +1025,13 @@ void BeliefManager::delBeliefSyncPDDL(const ManagedBelief& mb)
 void BeliefManager::addBelief(const ManagedBelief& mb)
 {
     belief_set_.insert(mb);
+    delta_removed_.erase(mb);
+    delta_added_.erase(mb);
+    delta_added_.insert(mb);
+    snapshot_dirty_ = true;
+    dynamic_bset_changed_ = true;
+    if(isTaggedStatic(mb))
+        markStatic(mb);
     if(this->get_parameter(PARAM_DEBUG).as_bool())
         RCLCPP_INFO(this->get_logger(), "Added belief ("+mb.pddlTypeString()+"): " + 
             mb.getName() + " " + (mb.pddlType() == Belief().INSTANCE_TYPE? mb.type().name : mb.getParamsJoined()) + 
@@ -712,6 +1050,10 @@ void BeliefManager::modifyBelief(const ManagedBelief& mb)
     if(belief_set_.count(mb) == 1){
         belief_set_.erase(mb);
         belief_set_.insert(mb);
+        delta_added_.erase(mb);
+        delta_added_.insert(mb);//modified function notified with its new value
+        snapshot_dirty_ = true;
+        dynamic_bset_changed_ = true;
         if(this->get_parameter(PARAM_DEBUG).as_bool())
             RCLCPP_INFO(this->get_logger(), "Modified belief ("+mb.pddlTypeString()+"): " + 
                 mb.getName() + " " + (mb.pddlType() == Belief().INSTANCE_TYPE? mb.type().name : mb.getParamsJoined()) + 
@@ -727,6 +1069,10 @@ void BeliefManager::modifyBelief(const ManagedBelief& mb)
 void BeliefManager::delBelief(const ManagedBelief& mb)
 {
     belief_set_.erase(mb);
+    delta_added_.erase(mb);
+    delta_removed_.insert(mb);
+    snapshot_dirty_ = true;
+    dynamic_bset_changed_ = true;
     if(this->get_parameter(PARAM_DEBUG).as_bool())
         RCLCPP_INFO(this->get_logger(), "Removed belief ("+mb.pddlTypeString()+"): " + 
             mb.getName() + " " + (mb.pddlType() == Belief().INSTANCE_TYPE? mb.type().name : mb.getParamsJoined()) + 
@@ -735,6 +1081,36 @@ void BeliefManager::delBelief(const ManagedBelief& mb)
             );
 }
 
+/*
+    mark belief (already in the belief set or about to be added) as static
+*/
+void BeliefManager::markStatic(const ManagedBelief& mb)
+{
+    if(static_beliefs_.insert(mb).second)
+    {
+        static_bset_changed_ = true;
+        dynamic_bset_changed_ = true;//it leaves the dynamic partition
+        snapshot_dirty_ = true;
+    }
+}
+
+/*
+    BeliefManager node to be spinned in the agent_core_host process, together with the other core nodes of the agent
+*/
+HostedNode hostBeliefManager()
+{
+  auto node = std::make_shared<BeliefManager>();
+  return HostedNode{node,
+    [node](){
+      if(!node->wait_psys2_boot(std::chrono::seconds(8)))//Wait max 8 seconds for plansys2 to boot
+        return false;
+      node->init();
+      return true;
+    },
+    [node](){ node->saveSnapshot(); }};//keep the last belief set for the next warm restart
+}
+
+#ifndef AGENT_CORE_HOST
 int main(int argc, char ** argv)
 {
   rclcpp::init(argc, argv);
@@ -745,6 +1121,7 @@ int main(int argc, char ** argv)
   {
     node->init();
     rclcpp::spin(node);
+    node->saveSnapshot();//keep the last belief set for the next warm restart
   }
   else
   {
@@ -755,3 +1132,4 @@ int main(int argc, char ** argv)
 
   return 0;
 }
+#endif
@@ -3,6 +3,8 @@
 
 // header file for Event listener node
 #include "ros2_bdi_core/event_listener.hpp"
+// hooks to spin the node within the agent_core_host process
+#include "ros2_bdi_core/support/hosted_node.hpp"
 // Inner logic + ROS2 PARAMS & FIXED GLOBAL VALUES for Event Listener node
 #include "ros2_bdi_core/params/event_listener_params.hpp"
 // Inner logic + ROS2 PARAMS & FIXED GLOBAL VALUES for Belief Manager node
@@ -11,6 +13,7 @@
 #include "ros2_bdi_core/params/scheduler_params.hpp"
 
 #include "ros2_bdi_utils/BDIYAMLParser.hpp"
+#include "ros2_bdi_utils/BDISnapshot.hpp"
 
 using ros2_bdi_interfaces::msg::Belief;
 using ros2_bdi_interfaces::msg::BeliefSet;
@@ -33,6 +36,7 @@ EventListener::EventListener()
 {
     this->declare_parameter(PARAM_AGENT_ID, "agent0");
     this->declare_parameter(PARAM_DEBUG, true);
+    this->declare_parameter(PARAM_WARM_RESTART, false);
 
     this->declare_parameter(PARAM_PLANNING_MODE, PLANNING_MODE_OFFLINE);
 
@@ -73,18 +77,23 @@ bool EventListener::init()
     // init step_counter
     step_counter_ = 0;
 
-    //Lifecycle status publisher
-    lifecycle_status_publisher_ = this->create_publisher<LifecycleStatus>(LIFECYCLE_STATUS_TOPIC, 10);
+    //Lifecycle status publisher (latched)
+    lifecycle_status_publisher_ = this->create_publisher<LifecycleStatus>(LIFECYCLE_STATUS_TOPIC, rclcpp::QoS(1).reliable().transient_local());
 
     //Lifecycle status subscriber
     lifecycle_status_subscriber_ = this->create_subscription<LifecycleStatus>(
-                LIFECYCLE_STATUS_TOPIC, qos_reliable,
+                LIFECYCLE_STATUS_TOPIC, rclcpp::QoS(10).reliable().transient_local(),
                 bind(&EventListener::callbackLifecycleStatus, this, _1));
 
     //Receive belief set update notification to keep the event listener belief set mirror up to date
     belief_set_subscription_ = this->create_subscription<BeliefSet>(
                 BELIEF_SET_TOPIC, qos_reliable,
                 bind(&EventListener::updBeliefSetCallback, this, _1));
+
+    //Receive the static partition of the belief set (latched, published again only when it grows)
+    static_belief_set_subscription_ = this->create_subscription<BeliefSet>(
+                STATIC_BELIEF_SET_TOPIC, rclcpp::QoS(1).reliable().transient_local(),
+                bind(&EventListener::updStaticBeliefSetCallback, this, _1));
     
     //Receive desire set update notification to keep the event listener desire set mirror up to date
     desire_set_subscription_ = this->create_subscription<DesireSet>(
@@ -113,18 +122,45 @@ LifecycleStatus EventListener::getLifecycleStatus()
 }
 
 /*
-    Expect to find yaml file to init the belief set in "/tmp/{agent_id}/init_bset.yaml"
+    Expect to find yaml file to init the reactive rules in "/tmp/{agent_id}/init_reactive_rules.yaml"
+    (warm restart: rules compiled by a previous run are taken from "/tmp/{agent_id}/reactive_rules.snapshot"
+    if the yaml file has not been edited since, otherwise the snapshot is rewritten after parsing the yaml file)
 */
 set<ManagedReactiveRule> EventListener::init_reactive_rules()
 {
     string init_reactive_rules_filepath = "/tmp/"+this->get_parameter(PARAM_AGENT_ID).as_string()+"/"+INIT_REACTIVE_RULES_FILENAME;
+    string snapshot_filepath = "/tmp/"+this->get_parameter(PARAM_AGENT_ID).as_string()+"/"+REACTIVE_RULES_SNAPSHOT_FILENAME;
+    bool warm_restart = this->get_parameter(PARAM_WARM_RESTART).as_bool();
     set<ManagedReactiveRule> rules;
 
+    if(warm_restart)
+    {
+        BDISnapshot::Snapshot snapshot(snapshot_filepath);
+        auto snapshot_rules = snapshot.valid() && snapshot.isUpToDate(init_reactive_rules_filepath)? 
+            snapshot.getReactiveRules() : std::nullopt;
+        if(snapshot_rules.has_value())
+        {
+            RCLCPP_INFO(this->get_logger(), "Reactive rules restored from snapshot " + snapshot_filepath);
+            return snapshot_rules.value();
+        }
+    }
+
     try{
         rules = BDIYAMLParser::extractMGReactiveRules(init_reactive_rules_filepath, domain_expert_);//TODO test
 
         if(this->get_parameter(PARAM_DEBUG).as_bool())
             RCLCPP_INFO(this->get_logger(), "Reactive rules initialization performed through " + init_reactive_rules_filepath);
+
+        if(warm_restart)
+        {
+            BDISnapshot::Sections sections;
+            BDISnapshot::putReactiveRules(sections, rules);
+            auto source_hash = BDISnapshot::fileHash(init_reactive_rules_filepath);
+            if(source_hash.has_value())
+                BDISnapshot::putSourceHash(sections, source_hash.value());
+            if(!BDISnapshot::writeSnapshot(snapshot_filepath, sections))
+                RCLCPP_ERROR(this->get_logger(), "Failed to write reactive rules snapshot " + snapshot_filepath);
+        }
     
     }catch(const YAML::BadFile& bfile){
         RCLCPP_ERROR(this->get_logger(), "Bad File: Reactive rules initialization failed because init. file " + init_reactive_rules_filepath + " hasn't been found");
@@ -142,25 +178,11 @@ set<ManagedReactiveRule> EventListener::init_reactive_rules()
 void EventListener::updBeliefSetCallback(const BeliefSet::SharedPtr msg)
 {
     std::set<BDIManaged::ManagedBelief> new_belief_set = BDIFilter::extractMGBeliefs(msg->value);
-    bool belief_set_upd = false;
-    if(new_belief_set.size() != belief_set_.size())
-        belief_set_upd = true;
-    else
-    {
-        for(BDIManaged::ManagedBelief mb : new_belief_set)
-        {
-            if(belief_set_.count(mb) == 0)
-            {
-                belief_set_upd = true;
-                break;
-            }
-        }
-    }       
+    //just the dynamic partition gets compared
+    bool belief_set_upd = !belief_set_.setDynamic(new_belief_set).empty();
 
     if(belief_set_upd || desire_set_.size() == 0)// second case is to avoid that some desire generation function rules are not pushed when belief set does not change
     {
-        //there has been an update //TODO improve the check above and the assignment below :-(
-        belief_set_ = new_belief_set;
         if(state_ == CHECKING)
             check_if_any_rule_apply();
     }
@@ -171,6 +193,13 @@ void EventListener::updBeliefSetCallback(const BeliefSet::SharedPtr msg)
     step_counter_++;
 }
 
+void EventListener::updStaticBeliefSetCallback(const BeliefSet::SharedPtr msg)
+{
+    auto segment = std::make_shared<const BDIManaged::StaticBeliefSegment>(BDIFilter::extractMGBeliefs(msg->value));
+    if(!belief_set_.setStatic(segment).empty() && state_ == CHECKING)
+        check_if_any_rule_apply();
+}
+
 /*Apply satisfying rules starting from extracted possible assignments for the placeholders*/
 void EventListener::apply_satisfying_rules(const ManagedReactiveRule& reactive_rule, const map<string, vector<ManagedBelief>>& assignments, const set<ManagedBelief>& belief_set)
 {
@@ -202,7 +231,7 @@ void EventListener::apply_satisfying_rules(const ManagedReactiveRule& reactive_r
         }
 
         ManagedReactiveRule reactive_rule_subs = ManagedReactiveRule::applySubstitution(reactive_rule, actual_assignments);
-        if(reactive_rule_subs.getMGCondition().isSatisfied(belief_set_))
+        if(reactive_rule_subs.getMGCondition().isSatisfied(belief_set_.get()))
             apply_rule(reactive_rule_subs);
         else
         {
@@ -246,7 +275,9 @@ void EventListener::check_if_any_rule_apply()
         if(reactive_rule.getMGCondition().containsPlaceholders())
         {
             // std::cout << "reactive rule " << std::to_string(reactive_rule.getId()) << " assignments:" << std::flush << std::endl;
-            assignments = reactive_rule.getMGCondition().extractAssignmentsMap(belief_set_);
+            assignments = reactive_rule.getMGCondition().extractAssignmentsMap(belief_set_.get());
+            // drop the candidates failing the function value checks, all at once over the function columns
+            reactive_rule.getMGCondition().pruneAssignments(assignments, belief_set_.getFunctions());
             // for(auto key_it = assignments.begin(); key_it != assignments.end(); key_it++)
             // {
             //     std::cout << key_it->first << ":" << std::flush << std::endl;
@@ -254,10 +285,10 @@ void EventListener::check_if_any_rule_apply()
             //         std::cout << mb.getName() << ", ";
             //     std::cout << std::flush << std::endl;
             // }
-            apply_satisfying_rules(reactive_rule, assignments, belief_set_);
+            apply_satisfying_rules(reactive_rule, assignments, belief_set_.get());
         }
 
-        else if(reactive_rule.getMGCondition().isSatisfied(belief_set_))//rule with no placeholders sat -> apply rune as is
+        else if(reactive_rule.getMGCondition().isSatisfied(belief_set_.get()))//rule with no placeholders sat -> apply rune as is
         {
             //std::cout << "reactive rule " << std::to_string(reactive_rule.getId()) << " SAT" << std::flush << std::endl;
             //rule is satisfied! apply effects
@@ -265,7 +296,7 @@ void EventListener::check_if_any_rule_apply()
         }
         // else
         // {
-        //     bool res = reactive_rule.getMGCondition().isSatisfied(belief_set_);
+        //     bool res = reactive_rule.getMGCondition().isSatisfied(belief_set_.get());
         //     std::cout << "reactive rule " << std::to_string(reactive_rule.getId()) << " sat = " << res
         //         << std::flush << std::endl;
         // }
@@ -346,6 +377,21 @@ void EventListener::apply_rule(const BDIManaged::ManagedReactiveRule& reactive_r
 
 
 
+/*
+    EventListener node to be spinned in the agent_core_host process, together with the other core nodes of the agent
+*/
+HostedNode hostEventListener()
+{
+  auto node = std::make_shared<EventListener>();
+  return HostedNode{node,
+    [node](){
+      //if init() returns false, no proper reactive rules defined -> hence no point in having the node spinned
+      return node->wait_psys2_boot(std::chrono::seconds(8)) && node->init();
+    },
+    [](){}};
+}
+
+#ifndef AGENT_CORE_HOST
 int main(int argc, char ** argv)
 {
   rclcpp::init(argc, argv);
@@ -368,3 +414,4 @@ int main(int argc, char ** argv)
 
   return 0;
 }
+#endif
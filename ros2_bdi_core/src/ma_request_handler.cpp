@@ -1,5 +1,7 @@
 // header file for Communications MA (Multi-Agent) Request Handler node
 #include "ros2_bdi_core/ma_request_handler.hpp"
+// hooks to spin the node within the agent_core_host process
+#include "ros2_bdi_core/support/hosted_node.hpp"
 // Inner logic + ROS PARAMS & FIXED GLOBAL VALUES for ROS2 core nodes
 #include "ros2_bdi_core/params/core_common_params.hpp"
 // Inner logic + ROS2 PARAMS & FIXED GLOBAL VALUES for Communications (Multi-Agent) Request Handler node
@@ -18,6 +20,7 @@ using std::map;
 using std::mutex;
 using std::shared_ptr;
 using std::chrono::milliseconds;
+using std::chrono::steady_clock;
 using std::bind;
 using std::placeholders::_1;
 using std::placeholders::_2;
@@ -25,6 +28,7 @@ using std::placeholders::_2;
 using ros2_bdi_interfaces::msg::LifecycleStatus;
 using ros2_bdi_interfaces::msg::Belief;
 using ros2_bdi_interfaces::msg::BeliefSet;
+using ros2_bdi_interfaces::msg::BeliefSetDelta;
 using ros2_bdi_interfaces::msg::Desire;
 using ros2_bdi_interfaces::msg::DesireSet;
 using ros2_bdi_interfaces::srv::IsAcceptedOperation;
@@ -32,6 +36,10 @@ using ros2_bdi_interfaces::srv::CheckBelief;
 using ros2_bdi_interfaces::srv::UpdBeliefSet;
 using ros2_bdi_interfaces::srv::CheckDesire;
 using ros2_bdi_interfaces::srv::UpdDesireSet;
+using ros2_bdi_interfaces::srv::CheckBeliefBatch;
+using ros2_bdi_interfaces::srv::UpdBeliefSetBatch;
+using ros2_bdi_interfaces::srv::CheckDesireBatch;
+using ros2_bdi_interfaces::srv::UpdDesireSetBatch;
 
 using BDIManaged::ManagedBelief;
 using BDIManaged::ManagedDesire;
@@ -63,6 +71,11 @@ void MARequestHandler::init()
   // agent's namespace
   agent_id_ = this->get_parameter(PARAM_AGENT_ID).as_string();
 
+  // compile the access-control policy and keep it up to date wrt. access params changes
+  std::atomic_store(&access_policy_, compileAccessPolicy());
+  access_params_cb_handle_ = this->add_on_set_parameters_callback(
+      bind(&MARequestHandler::onAccessParamsChange, this, _1));
+
   // init server for handling is accepted group queries
   accepted_server_ = this->create_service<IsAcceptedOperation>(IS_ACCEPTED_OP_SRV, 
       bind(&MARequestHandler::handleIsAcceptedGroup, this, _1, _2));
@@ -83,12 +96,15 @@ void MARequestHandler::init()
   // init step_counter
   step_counter_ = 0;
 
-  //Lifecycle status publisher
-  lifecycle_status_publisher_ = this->create_publisher<LifecycleStatus>(LIFECYCLE_STATUS_TOPIC, 10);
+  // no belief set delta applied yet
+  last_delta_seq_ = 0;
+
+  //Lifecycle status publisher (latched)
+  lifecycle_status_publisher_ = this->create_publisher<LifecycleStatus>(LIFECYCLE_STATUS_TOPIC, rclcpp::QoS(1).reliable().transient_local());
 
   //Lifecycle status subscriber
   lifecycle_status_subscriber_ = this->create_subscription<LifecycleStatus>(
-              LIFECYCLE_STATUS_TOPIC, qos_reliable,
+              LIFECYCLE_STATUS_TOPIC, rclcpp::QoS(10).reliable().transient_local(),
               bind(&MARequestHandler::callbackLifecycleStatus, this, _1));
 
   // to make the belief/desire set subscription callbacks to run on different threads of execution wrt srv callbacks
@@ -100,59 +116,97 @@ void MARequestHandler::init()
   belief_set_subscriber_ = this->create_subscription<BeliefSet>(
               BELIEF_SET_TOPIC, qos_reliable,
               bind(&MARequestHandler::updatedBeliefSet, this, _1), sub_opt);
+
+  //register to belief set deltas to keep the mirroring up to date and ack pending upd requests as soon as possible
+  belief_set_delta_subscriber_ = this->create_subscription<BeliefSetDelta>(
+              BELIEF_SET_DELTA_TOPIC, qos_reliable,
+              bind(&MARequestHandler::updatedBeliefSetDelta, this, _1), sub_opt);
+
+  //register to the static partition of the belief set (latched, published again only when it grows)
+  static_belief_set_subscriber_ = this->create_subscription<BeliefSet>(
+              STATIC_BELIEF_SET_TOPIC, rclcpp::QoS(1).reliable().transient_local(),
+              bind(&MARequestHandler::updatedStaticBeliefSet, this, _1), sub_opt);
   
   //register to desire set updates to have the mirroring of the last published version of it
   desire_set_subscriber_ = this->create_subscription<DesireSet>(
               DESIRE_SET_TOPIC, qos_reliable,
               bind(&MARequestHandler::updatedDesireSet, this, _1), sub_opt);
 
+  // write srv responses are deferred till the requested alteration is confirmed (by the subscription callbacks above)
+  // or the max waiting time has passed (checked periodically here): no executor thread is kept busy while waiting
+  next_upd_request_id_ = 0;
+  upd_requests_timer_ = this->create_wall_timer(milliseconds(UPD_REQUESTS_SWEEP_MS), [this](){
+      completeBeliefUpdRequests();
+      completeDesireUpdRequests();
+    }, callback_group_upd_subscribers_);
+
   // init server for handling check belief requests from other agents
   chk_belief_server_ = this->create_service<CheckBelief>(CK_BELIEF_SRV, 
       bind(&MARequestHandler::handleCheckBeliefRequest, this, _1, _2));
   
   // init server for handling add belief requests from other agents
-  add_belief_server_ = this->create_service<UpdBeliefSet>(ADD_BELIEF_SRV, 
-      bind(&MARequestHandler::handleAddBeliefRequest, this, _1, _2));
+  add_belief_server_ = createDeferredService<UpdBeliefSet>(this, ADD_BELIEF_SRV, 
+      bind(&MARequestHandler::handleUpdBeliefRequest, this, _1, _2, ADD_I));
     
   // init server for handling del belief requests from other agents
-  del_belief_server_ = this->create_service<UpdBeliefSet>(DEL_BELIEF_SRV, 
-      bind(&MARequestHandler::handleDelBeliefRequest, this, _1, _2));
+  del_belief_server_ = createDeferredService<UpdBeliefSet>(this, DEL_BELIEF_SRV, 
+      bind(&MARequestHandler::handleUpdBeliefRequest, this, _1, _2, DEL_I));
   
   // add belief publisher -> to publish on the topic and alter the belief set when the request can go through
   add_belief_publisher_ = this->create_publisher<Belief>(ADD_BELIEF_TOPIC, 10);
   // del belief publisher -> to publish on the topic and alter the belief set when the request can go through
   del_belief_publisher_ = this->create_publisher<Belief>(DEL_BELIEF_TOPIC, 10);
 
-  // init two locks for waiting belief upd
-  belief_set_upd_locks_ = vector<mutex>(2);
-  // init two counter for waiting belief upd
-  belief_waiting_for_counter_ = vector<int>(2);
-  // init two empty managed beliefs where to store the two you're waiting for an update
-  belief_waiting_for_ = vector<ManagedBelief>(2);
+  // init server for handling batched check belief requests from other agents
+  chk_belief_batch_server_ = this->create_service<CheckBeliefBatch>(CK_BELIEF_BATCH_SRV, 
+      bind(&MARequestHandler::handleCheckBeliefBatchRequest, this, _1, _2));
+  
+  // init server for handling batched add belief requests from other agents
+  add_belief_batch_server_ = createDeferredService<UpdBeliefSetBatch>(this, ADD_BELIEF_BATCH_SRV, 
+      bind(&MARequestHandler::handleUpdBeliefBatchRequest, this, _1, _2, ADD_I));
+    
+  // init server for handling batched del belief requests from other agents
+  del_belief_batch_server_ = createDeferredService<UpdBeliefSetBatch>(this, DEL_BELIEF_BATCH_SRV, 
+      bind(&MARequestHandler::handleUpdBeliefBatchRequest, this, _1, _2, DEL_I));
+
+  // add belief set publisher -> to publish a whole batch of beliefs to be added as a single belief set operation
+  add_belief_set_publisher_ = this->create_publisher<BeliefSet>(ADD_BELIEF_SET_TOPIC, 10);
+  // del belief set publisher -> to publish a whole batch of beliefs to be deleted as a single belief set operation
+  del_belief_set_publisher_ = this->create_publisher<BeliefSet>(DEL_BELIEF_SET_TOPIC, 10);
 
   // init server for handling check desire requests from other agents
   chk_desire_server_ = this->create_service<CheckDesire>(CK_DESIRE_SRV, 
       bind(&MARequestHandler::handleCheckDesireRequest, this, _1, _2));
 
   // init server for handling add belief requests from other agents
-  add_desire_server_ = this->create_service<UpdDesireSet>(ADD_DESIRE_SRV, 
-      bind(&MARequestHandler::handleAddDesireRequest, this, _1, _2));
+  add_desire_server_ = createDeferredService<UpdDesireSet>(this, ADD_DESIRE_SRV, 
+      bind(&MARequestHandler::handleUpdDesireRequest, this, _1, _2, ADD_I));
     
     // init server for handling del belief requests from other agents
-  del_desire_server_ = this->create_service<UpdDesireSet>(DEL_DESIRE_SRV, 
-      bind(&MARequestHandler::handleDelDesireRequest, this, _1, _2));
+  del_desire_server_ = createDeferredService<UpdDesireSet>(this, DEL_DESIRE_SRV, 
+      bind(&MARequestHandler::handleUpdDesireRequest, this, _1, _2, DEL_I));
 
   // add desire publisher -> to publish on the topic and alter the desire set when the request can go through
   add_desire_publisher_ = this->create_publisher<Desire>(ADD_DESIRE_TOPIC, 10);
   // del desire publisher -> to publish on the topic and alter the desire set when the request can go through
   del_desire_publisher_ = this->create_publisher<Desire>(DEL_DESIRE_TOPIC, 10);
 
-  // init two locks for waiting desire upd
-  desire_set_upd_locks_ = vector<mutex>(2);
-  // init two counter for waiting desire upd
-  desire_waiting_for_counter_ = vector<int>(2);
-  // init two empty managed desires where to store the two you're waiting for an update
-  desire_waiting_for_ = vector<ManagedDesire>(2);
+  // init server for handling batched check desire requests from other agents
+  chk_desire_batch_server_ = this->create_service<CheckDesireBatch>(CK_DESIRE_BATCH_SRV, 
+      bind(&MARequestHandler::handleCheckDesireBatchRequest, this, _1, _2));
+
+  // init server for handling batched add desire requests from other agents
+  add_desire_batch_server_ = createDeferredService<UpdDesireSetBatch>(this, ADD_DESIRE_BATCH_SRV, 
+      bind(&MARequestHandler::handleUpdDesireBatchRequest, this, _1, _2, ADD_I));
+    
+  // init server for handling batched del desire requests from other agents
+  del_desire_batch_server_ = createDeferredService<UpdDesireSetBatch>(this, DEL_DESIRE_BATCH_SRV, 
+      bind(&MARequestHandler::handleUpdDesireBatchRequest, this, _1, _2, DEL_I));
+
+  // add desire set publisher -> to publish a whole batch of desires to be added as a single desire set operation
+  add_desire_set_publisher_ = this->create_publisher<DesireSet>(ADD_DESIRE_SET_TOPIC, 10);
+  // del desire set publisher -> to publish a whole batch of desires to be deleted as a single desire set operation
+  del_desire_set_publisher_ = this->create_publisher<DesireSet>(DEL_DESIRE_SET_TOPIC, 10);
 
   string acceptingBeliefsMsg = "accepting beliefs alteration from: ";
   vector<string> acceptingBeliefsGroups = this->get_parameter(PARAM_BELIEF_WRITE).as_string_array();
@@ -211,40 +265,22 @@ LifecycleStatus MARequestHandler::getLifecycleStatus()
 bool MARequestHandler::isAcceptableRequest(const string& requestingAgentGroup, 
   const RequestObjType& requestObjType, const RequestObjOp& requestObjOp)
 {
-  vector<string> acceptedGroups;
+  shared_ptr<const AccessPolicy> policy = getAccessPolicy();
+  auto groupIt = policy->find(requestingAgentGroup);
+  if(groupIt == policy->end())
+    return false;// not found among accepted ones
+
+  const GroupPermissions& permissions = groupIt->second;
   switch(requestObjType)
   {
     case BELIEF:
-      switch(requestObjOp)
-      {
-        case CHECK:
-          acceptedGroups = this->get_parameter(PARAM_BELIEF_CHECK).as_string_array();
-          break;
-        case WRITE:
-          acceptedGroups = this->get_parameter(PARAM_BELIEF_WRITE).as_string_array();
-          break;
-      }
-        
-      break;
-
-      case DESIRE:
-        switch(requestObjOp)
-        {
-        case CHECK:
-          acceptedGroups = this->get_parameter(PARAM_DESIRE_CHECK).as_string_array();
-          break;
-        case WRITE:
-          acceptedGroups = this->get_parameter(PARAM_DESIRE_WRITE).as_string_array();
-          break;
-      }
-      break;
-  }
+      return (requestObjOp == CHECK)? permissions.belief_check : permissions.belief_write;
 
-  for(string accepted : acceptedGroups)
-    if(accepted == requestingAgentGroup)
-      return true;// found among accepted ones
+    case DESIRE:
+      return (requestObjOp == CHECK)? permissions.desire_check : permissions.desire_write;
+  }
 
-  return false;// not found among accepted ones
+  return false;
 }
 
 /*  
@@ -278,54 +314,129 @@ void MARequestHandler::handleIsAcceptedGroup(const IsAcceptedOperation::Request:
 */
 float MARequestHandler::getMaxAcceptedPriority(const string& requestingAgentGroup)
 {
-  int indexAccepted = -1;
-  float maxAcceptedPriority = -1.0f;//init to negative value
-
-  // find index of accepted group in accept_desires_from array string paramters
-  vector<string> acceptedGroups = this->get_parameter(PARAM_DESIRE_WRITE).as_string_array();
-  for(int i = 0; indexAccepted == -1 && i <  acceptedGroups.size(); i++)
-    if(acceptedGroups[i] == requestingAgentGroup)
-      indexAccepted = i;
+  shared_ptr<const AccessPolicy> policy = getAccessPolicy();
+  auto groupIt = policy->find(requestingAgentGroup);
+  return (groupIt != policy->end())? groupIt->second.desire_max_priority : -1.0f;
+}
 
-  if(indexAccepted >= 0)//if found
+/*
+  Compile the access-control policy out of the current values of the access params, 
+  overridden by the ones in @changedParams (if any)
+*/
+shared_ptr<const AccessPolicy> MARequestHandler::compileAccessPolicy(const vector<rclcpp::Parameter>& changedParams)
+{
+  map<string, rclcpp::Parameter> accessParams;
+  for(string paramName : {PARAM_BELIEF_CHECK, PARAM_BELIEF_WRITE, PARAM_DESIRE_CHECK, PARAM_DESIRE_WRITE, PARAM_DESIRE_MAX_PRIORITIES})
+    accessParams[paramName] = this->get_parameter(paramName);
+  for(auto param : changedParams)
+    if(accessParams.count(param.get_name()) == 1)
+      accessParams[param.get_name()] = param;
+
+  auto policy = std::make_shared<AccessPolicy>();
+  for(string group : accessParams[PARAM_BELIEF_CHECK].as_string_array())
+    (*policy)[group].belief_check = true;
+  for(string group : accessParams[PARAM_BELIEF_WRITE].as_string_array())
+    (*policy)[group].belief_write = true;
+  for(string group : accessParams[PARAM_DESIRE_CHECK].as_string_array())
+    (*policy)[group].desire_check = true;
+
+  vector<string> desireWriteGroups = accessParams[PARAM_DESIRE_WRITE].as_string_array();
+  vector<double> acceptedPriorities = accessParams[PARAM_DESIRE_MAX_PRIORITIES].as_double_array();
+  for(int i = 0; i < desireWriteGroups.size(); i++)
   {
-    // retrieve correspondent priority from accept_desires_max_priorities double array
-    vector<double> acceptedPriorities = this->get_parameter(PARAM_DESIRE_MAX_PRIORITIES).as_double_array();
-    
-    if(indexAccepted < acceptedPriorities.size())
-      maxAcceptedPriority = std::max(0.000f, std::min(1.0f, (float)acceptedPriorities[indexAccepted]));//priority has to be between 0.001 and 1
-    
+    GroupPermissions& permissions = (*policy)[desireWriteGroups[i]];
+    if(permissions.desire_write)
+      continue;// first occurrence of the group wins (as in the array lookup)
+
+    permissions.desire_write = true;
+    if(i < acceptedPriorities.size())
+      permissions.desire_max_priority = std::max(0.000f, std::min(1.0f, (float)acceptedPriorities[i]));//priority has to be between 0.001 and 1
     else
-      maxAcceptedPriority = 0.000f; //bad formatted accept_desires_max_priorities array, but do not refuse just put 0.000 as priority of the desire
+      permissions.desire_max_priority = 0.000f; //bad formatted accept_desires_max_priorities array, but do not refuse just put 0.000 as priority of the desire
   }
 
-  return maxAcceptedPriority;
+  return policy;
 }
 
 /*
-  @updIndex to be used to know which lock has to be checked among the two in desire_set_upd_locks_
-  and which waiting counter has to be incremented and/or checked
-
-  @countCheck in order to check if desire is present (ADD op) or not present (DEL op)
+  Access params changed at runtime: compile the new policy and swap it with the current one
 */
-void MARequestHandler::checkDesireSetWaitingUpd(const int& updIndex, const int& countCheck)
+rcl_interfaces::msg::SetParametersResult MARequestHandler::onAccessParamsChange(const vector<rclcpp::Parameter>& params)
 {
-  if(updIndex > desire_set_upd_locks_.size() || countCheck < 0)//invalid params
-    return;
+  auto result = rcl_interfaces::msg::SetParametersResult();
+  result.successful = true;
 
-    
-  if(desire_set_upd_locks_[updIndex].try_lock())//try lock 
+  bool accessParamChanged = false;
+  for(auto param : params)
   {
-    // if acquired, release immediately (no waiting for any belief upd operation)
-    desire_set_upd_locks_[updIndex].unlock();
+    string paramName = param.get_name();
+    if(paramName == PARAM_BELIEF_CHECK || paramName == PARAM_BELIEF_WRITE || paramName == PARAM_DESIRE_CHECK || paramName == PARAM_DESIRE_WRITE)
+    {
+      accessParamChanged = true;
+      if(param.get_type() != rclcpp::ParameterType::PARAMETER_STRING_ARRAY)
+      {
+        result.successful = false;
+        result.reason = paramName + " has to be a string array";
+      }
+    }
+    else if(paramName == PARAM_DESIRE_MAX_PRIORITIES)
+    {
+      accessParamChanged = true;
+      if(param.get_type() != rclcpp::ParameterType::PARAMETER_DOUBLE_ARRAY)
+      {
+        result.successful = false;
+        result.reason = paramName + " has to be a double array";
+      }
+    }
+  }
+
+  if(result.successful && accessParamChanged)
+  {
+    // params are going to be set right after this callback returns: compile the policy with the new values
+    std::atomic_store(&access_policy_, compileAccessPolicy(params));
+    if(this->get_parameter(PARAM_DEBUG).as_bool())
+      RCLCPP_INFO(this->get_logger(), "Access-control policy updated");
+  }
+
+  return result;
+}
+
+/*
+  Check against the mirrored desire set whether the addition (updIndex = ADD_I) or the deletion (updIndex = DEL_I) 
+  of @md can be considered performed (call it when holding process_desire_set_upd_lock_)
+  Addition is considered performed also when the desire appears to be already fulfilled in the mirrored belief set
+*/
+bool MARequestHandler::isDesireUpdConfirmed(const ManagedDesire& md, const int& updIndex)
+{
+  if(updIndex == ADD_I)
+  {
+    if(desire_set_.count(md) == 1)
+      return true;
+    
+    process_belief_set_upd_lock_.lock();//always acquired after the desire one, never the opposite
+      bool fulfilled = md.isFulfilled(belief_set_.get());
+    process_belief_set_upd_lock_.unlock();
+    return fulfilled;
   }
   else
+    return desire_set_.count(md) == 0;
+}
+
+/*
+  Look for newly confirmed alterations among the pending desire upd requests (call it when holding process_desire_set_upd_lock_)
+  @newNotification to be put to true when a new whole desire set notification has been received
+*/
+void MARequestHandler::confirmPendingDesireUpd(const bool& newNotification)
+{
+  for(auto& pending : pending_desire_upd_)
   {
-    //waiting for a belief upd operation
-    if(desire_set_.count(desire_waiting_for_[updIndex]) == countCheck || desire_waiting_for_counter_[updIndex] == MAX_WAIT_UPD)
-      desire_set_upd_locks_[updIndex].unlock();// acquired by add_desire/del_desire srv, release it so it can proceed if alteration done or waited too much already
-    else
-      desire_waiting_for_counter_[updIndex]++;
+    PendingUpdRequest<ManagedDesire>& req = pending.second;
+    for(int i = 0; i < req.items.size(); i++)
+      if(!req.confirmed[i])
+        req.confirmed[i] = isDesireUpdConfirmed(req.items[i], req.upd_index);
+    
+    if(newNotification)
+      req.waited_notifications++;
   }
 }
 
@@ -334,58 +445,212 @@ void MARequestHandler::checkDesireSetWaitingUpd(const int& updIndex, const int&
 */
 void MARequestHandler::updatedDesireSet(const DesireSet::SharedPtr msg)
 {
+    set<ManagedDesire> upd_desire_set = BDIFilter::extractMGDesires(msg->value);//extract it before acquiring the lock
+
     process_desire_set_upd_lock_.lock();
     {
-      desire_set_ = BDIFilter::extractMGDesires(msg->value);
+      desire_set_ = upd_desire_set;
 
-              
-      //check for waiting belief set alteration
-      checkDesireSetWaitingUpd(ADD_I, 1);//check belief set for addition
-      checkDesireSetWaitingUpd(DEL_I, 0);//check belief set for deletion
+      //check for waiting desire set alterations
+      confirmPendingDesireUpd(true);
     }
     process_desire_set_upd_lock_.unlock();
+    completeDesireUpdRequests();
 }
 
 /*
-  @updIndex to be used to know which lock has to be checked among the two in belief_set_upd_locks_
-  and which waiting counter has to be incremented and/or checked
+  Register a new pending upd request for the addition (updIndex = ADD_I) or the deletion (updIndex = DEL_I) of @desires
+  (to be called BEFORE publishing the alteration request, so that no confirmation can be missed)
+  @respond is called with the confirmation flags once the request is over
+*/
+void MARequestHandler::registerDesireUpdRequest(const int& updIndex, const vector<ManagedDesire>& desires,
+  const std::function<void(const vector<bool>&)>& respond)
+{
+  PendingUpdRequest<ManagedDesire> req;
+  req.items = desires;
+  req.upd_index = updIndex;
+  req.waited_notifications = 0;
+  req.deadline = steady_clock::now() + milliseconds(MAX_WAIT_UPD_MS);
+  req.respond = respond;
+
+  process_desire_set_upd_lock_.lock();
+    for(ManagedDesire md : desires)
+      req.confirmed.push_back(updIndex == DEL_I && isDesireUpdConfirmed(md, updIndex));//already not there
+    pending_desire_upd_.emplace(next_upd_request_id_++, req);
+  process_desire_set_upd_lock_.unlock();
+}
 
-  @countCheck in order to check if belief is present (ADD op) or not present (DEL op)
+/*
+  Remove the pending desire upd requests whose desires have all been confirmed, which have waited for MAX_WAIT_UPD desire set notifications
+  or whose deadline (MAX_WAIT_UPD_MS after their registration) has passed, then send their deferred responses
+  (out of the lock, since sending may take a while)
 */
-void MARequestHandler::checkBeliefSetWaitingUpd(const int& updIndex, const int& countCheck)
+void MARequestHandler::completeDesireUpdRequests()
 {
-  if(updIndex > belief_set_upd_locks_.size() || countCheck < 0)//invalid params
-    return;
+  vector<PendingUpdRequest<ManagedDesire>> completed;
+  auto now = steady_clock::now();
 
-  if(belief_set_upd_locks_[updIndex].try_lock())//try lock 
-  {
-    // if acquired, release immediately (no waiting for any belief upd operation)
-    belief_set_upd_locks_[updIndex].unlock();
-  }
+  process_desire_set_upd_lock_.lock();
+    for(auto it = pending_desire_upd_.begin(); it != pending_desire_upd_.end();)
+    {
+      PendingUpdRequest<ManagedDesire>& req = it->second;
+      if(req.waited_notifications >= MAX_WAIT_UPD || now >= req.deadline ||
+          std::find(req.confirmed.begin(), req.confirmed.end(), false) == req.confirmed.end())
+      {
+        for(int i = 0; i < req.items.size(); i++)//last check for the not yet confirmed ones
+          req.confirmed[i] = req.confirmed[i] || isDesireUpdConfirmed(req.items[i], req.upd_index);
+        completed.push_back(req);
+        it = pending_desire_upd_.erase(it);
+      }
+      else
+        it++;
+    }
+  process_desire_set_upd_lock_.unlock();
+
+  for(PendingUpdRequest<ManagedDesire>& req : completed)
+    req.respond(req.confirmed);
+}
+
+/*
+  Check against the mirrored belief set whether the addition (updIndex = ADD_I) or the deletion (updIndex = DEL_I) 
+  of @mb can be considered performed (call it when holding process_belief_set_upd_lock_)
+*/
+bool MARequestHandler::isBeliefUpdConfirmed(const ManagedBelief& mb, const int& updIndex)
+{
+  const ManagedBelief* found = belief_set_.find(mb);
+  if(updIndex == ADD_I)
+    return found != nullptr && (mb.pddlType() != Belief().FUNCTION_TYPE || found->getValue() == mb.getValue());
   else
+    return found == nullptr;
+}
+
+/*
+  Look for newly confirmed alterations among the pending belief upd requests (call it when holding process_belief_set_upd_lock_)
+  @newNotification to be put to true when a new whole belief set notification has been received
+*/
+void MARequestHandler::confirmPendingBeliefUpd(const bool& newNotification)
+{
+  for(auto& pending : pending_belief_upd_)
   {
-    //waiting for a belief upd operation
-    if(belief_set_.count(belief_waiting_for_[updIndex]) == countCheck || belief_waiting_for_counter_[updIndex] == MAX_WAIT_UPD)
-      belief_set_upd_locks_[updIndex].unlock();// acquired by add_belief/del_belief srv, release it so it can proceed if alteration done or waited too much already
-    else
-      belief_waiting_for_counter_[updIndex]++;
+    PendingUpdRequest<ManagedBelief>& req = pending.second;
+    for(int i = 0; i < req.items.size(); i++)
+      if(!req.confirmed[i])
+        req.confirmed[i] = isBeliefUpdConfirmed(req.items[i], req.upd_index);
+    
+    if(newNotification)
+      req.waited_notifications++;
   }
 }
 
 /*
-    The belief set has been updated
+    The belief set has been updated:
+    belief sets and deltas come on different topics, so a belief set not reflecting the last delta applied yet is discarded
 */
 void MARequestHandler::updatedBeliefSet(const BeliefSet::SharedPtr msg)
 {
+    set<ManagedBelief> upd_belief_set = BDIFilter::extractMGBeliefs(msg->value);//extract it before acquiring the lock
+
     process_belief_set_upd_lock_.lock();
+    if(msg->seq >= last_delta_seq_ || msg->seq == 0)//seq 0: no delta published by the belief manager yet (e.g. just restarted)
     {
-      belief_set_ = BDIFilter::extractMGBeliefs(msg->value);
+      belief_set_.setDynamic(upd_belief_set);
 
-      //check for waiting belief set alteration
-      checkBeliefSetWaitingUpd(ADD_I, 1);//check belief set for addition
-      checkBeliefSetWaitingUpd(DEL_I, 0);//check belief set for deletion
+      //check for waiting belief set alterations (e.g. in case some delta went missing)
+      confirmPendingBeliefUpd(true);
     }
     process_belief_set_upd_lock_.unlock();
+    completeBeliefUpdRequests();
+}
+
+/*
+    The belief set has been altered: apply the delta to the mirrored belief set
+    and ack the pending upd requests whose alterations have been performed
+*/
+void MARequestHandler::updatedBeliefSetDelta(const BeliefSetDelta::SharedPtr msg)
+{
+    set<ManagedBelief> removed = BDIFilter::extractMGBeliefs(msg->removed);
+    set<ManagedBelief> added = BDIFilter::extractMGBeliefs(msg->added);
+
+    process_belief_set_upd_lock_.lock();
+    {
+      last_delta_seq_ = msg->seq;
+      belief_set_.applyDelta(removed, added);
+
+      confirmPendingBeliefUpd(false);
+    }
+    process_belief_set_upd_lock_.unlock();
+    completeBeliefUpdRequests();
+}
+
+/*
+    The static partition of the belief set has grown: replace the mirrored one
+    and ack the pending upd requests whose alterations have been performed
+*/
+void MARequestHandler::updatedStaticBeliefSet(const BeliefSet::SharedPtr msg)
+{
+    auto segment = std::make_shared<const BDIManaged::StaticBeliefSegment>(BDIFilter::extractMGBeliefs(msg->value));
+
+    process_belief_set_upd_lock_.lock();
+    {
+      belief_set_.setStatic(segment);
+
+      confirmPendingBeliefUpd(false);
+    }
+    process_belief_set_upd_lock_.unlock();
+    completeBeliefUpdRequests();
+}
+
+/*
+  Register a new pending upd request for the addition (updIndex = ADD_I) or the deletion (updIndex = DEL_I) of @beliefs
+  (to be called BEFORE publishing the alteration request, so that no confirmation can be missed)
+  @respond is called with the confirmation flags once the request is over
+*/
+void MARequestHandler::registerBeliefUpdRequest(const int& updIndex, const vector<ManagedBelief>& beliefs,
+  const std::function<void(const vector<bool>&)>& respond)
+{
+  PendingUpdRequest<ManagedBelief> req;
+  req.items = beliefs;
+  req.upd_index = updIndex;
+  req.waited_notifications = 0;
+  req.deadline = steady_clock::now() + milliseconds(MAX_WAIT_UPD_MS);
+  req.respond = respond;
+
+  process_belief_set_upd_lock_.lock();
+    for(ManagedBelief mb : beliefs)
+      req.confirmed.push_back(isBeliefUpdConfirmed(mb, updIndex));//already there (with same value) or already not there
+    pending_belief_upd_.emplace(next_upd_request_id_++, req);
+  process_belief_set_upd_lock_.unlock();
+}
+
+/*
+  Remove the pending belief upd requests whose beliefs have all been confirmed, which have waited for MAX_WAIT_UPD belief set notifications
+  or whose deadline (MAX_WAIT_UPD_MS after their registration) has passed, then send their deferred responses
+  (out of the lock, since sending may take a while)
+*/
+void MARequestHandler::completeBeliefUpdRequests()
+{
+  vector<PendingUpdRequest<ManagedBelief>> completed;
+  auto now = steady_clock::now();
+
+  process_belief_set_upd_lock_.lock();
+    for(auto it = pending_belief_upd_.begin(); it != pending_belief_upd_.end();)
+    {
+      PendingUpdRequest<ManagedBelief>& req = it->second;
+      if(req.waited_notifications >= MAX_WAIT_UPD || now >= req.deadline ||
+          std::find(req.confirmed.begin(), req.confirmed.end(), false) == req.confirmed.end())
+      {
+        for(int i = 0; i < req.items.size(); i++)//last check for the not yet confirmed ones
+          req.confirmed[i] = req.confirmed[i] || isBeliefUpdConfirmed(req.items[i], req.upd_index);
+        completed.push_back(req);
+        it = pending_belief_upd_.erase(it);
+      }
+      else
+        it++;
+    }
+  process_belief_set_upd_lock_.unlock();
+
+  for(PendingUpdRequest<ManagedBelief>& req : completed)
+    req.respond(req.confirmed);
 }
 
 /*  
@@ -401,141 +666,261 @@ void MARequestHandler::handleCheckBeliefRequest(const CheckBelief::Request::Shar
   else
   {
     response->accepted = true;
-    response->found = belief_set_.count(ManagedBelief{request->belief}) == 1;
+    process_belief_set_upd_lock_.lock();
+      response->found = belief_set_.count(ManagedBelief{request->belief}) == 1;
+    process_belief_set_upd_lock_.unlock();
   }
 }
 
 
 /*  
-    Add Belief Request service handler
-
+    Add/Del Belief Request service handler: the response is sent once the alteration is confirmed
+    (or the max waiting time has passed)
 */
-void MARequestHandler::handleAddBeliefRequest(const UpdBeliefSet::Request::SharedPtr request,
-    const UpdBeliefSet::Response::SharedPtr response)
+void MARequestHandler::handleUpdBeliefRequest(const shared_ptr<rmw_request_id_t>& request_header, 
+    const UpdBeliefSet::Request::SharedPtr request, const int& updIndex)
 {
+  auto server = (updIndex == ADD_I)? add_belief_server_ : del_belief_server_;
+  auto response = std::make_shared<UpdBeliefSet::Response>();
+
   //see if the requesting agent belongs to a group which is entitled to this kind of requests
   if(!isAcceptableRequest(request->agent_group, BELIEF, WRITE))
+  {
+    response->accepted = false;
+    server->sendResponse(request_header, response);
+    return;
+  }
+
+  response->accepted = true;
+  registerBeliefUpdRequest(updIndex, {ManagedBelief{request->belief}}, 
+    [server, request_header, response](const vector<bool>& confirmed){
+      response->updated = confirmed[0];
+      server->sendResponse(request_header, response);
+    });
+  if(updIndex == ADD_I)
+    add_belief_publisher_->publish(request->belief);
+  else
+    del_belief_publisher_->publish(request->belief);
+  
+  completeBeliefUpdRequests();//e.g. already there (with same value)
+}
+
+/*  
+    Read Desire Request service handler        
+*/
+void MARequestHandler::handleCheckDesireRequest(const CheckDesire::Request::SharedPtr request,
+    const CheckDesire::Response::SharedPtr response)
+{
+  //see if the requesting agent belongs to a group which is entitled to this kind of requests
+  if(!isAcceptableRequest(request->agent_group, DESIRE, CHECK))
     response->accepted = false;
 
   else
   {
     response->accepted = true;
-    add_belief_publisher_->publish(request->belief);
-    
-    belief_set_upd_locks_[ADD_I].lock();
-      belief_waiting_for_[ADD_I] = ManagedBelief{request->belief};
-      belief_waiting_for_counter_[ADD_I] = 0;
-    belief_set_upd_locks_[ADD_I].lock();//stuck until belief_set upd unlock it
-    belief_set_upd_locks_[ADD_I].unlock();//release it
+    process_desire_set_upd_lock_.lock();
+      response->found = desire_set_.count(ManagedDesire{request->desire}) == 1;
+    process_desire_set_upd_lock_.unlock();
+  }
+}
 
-    response->updated = belief_set_.count(ManagedBelief{request->belief}) == 1;
+/*  
+    Add/Del Desire Request service handler: the response is sent once the alteration is confirmed
+    (or the max waiting time has passed)
+*/
+void MARequestHandler::handleUpdDesireRequest(const shared_ptr<rmw_request_id_t>& request_header, 
+    const UpdDesireSet::Request::SharedPtr request, const int& updIndex)
+{
+  auto server = (updIndex == ADD_I)? add_desire_server_ : del_desire_server_;
+  auto response = std::make_shared<UpdDesireSet::Response>();
+
+  //see if the requesting agent belongs to a group which is entitled to this kind of requests
+  if(!isAcceptableRequest(request->agent_group, DESIRE, WRITE))
+  {
+    response->accepted = false;
+    server->sendResponse(request_header, response);
+    return;
+  }
 
+  if(updIndex == ADD_I)
+  {
+    float maxAcceptedPriority = getMaxAcceptedPriority(request->agent_group);
+    if(maxAcceptedPriority < 0)
+    {
+      response->accepted = false;// max priority for given agent's requesting group is negative -> not accepted
+      server->sendResponse(request_header, response);
+      return;
+    }
+    // set at most the desire priority to the fixed upper threshold
+    request->desire.priority = std::max(0.000f, std::min(request->desire.priority, maxAcceptedPriority)); 
   }
+
+  response->accepted = true;
+  registerDesireUpdRequest(updIndex, {ManagedDesire{request->desire}}, 
+    [server, request_header, response](const vector<bool>& confirmed){
+      response->updated = confirmed[0];
+      server->sendResponse(request_header, response);
+    });
+  if(updIndex == ADD_I)
+    add_desire_publisher_->publish(request->desire);
+  else
+    del_desire_publisher_->publish(request->desire);
+
+  completeDesireUpdRequests();//e.g. already not there
 }
 
 /*  
-    Del Belief Request service handler        
+    Batched Read Belief Request service handler        
 */
-void MARequestHandler::handleDelBeliefRequest(const UpdBeliefSet::Request::SharedPtr request,
-    const UpdBeliefSet::Response::SharedPtr response)
+void MARequestHandler::handleCheckBeliefBatchRequest(const CheckBeliefBatch::Request::SharedPtr request,
+    const CheckBeliefBatch::Response::SharedPtr response)
 {
   //see if the requesting agent belongs to a group which is entitled to this kind of requests
-  if(!isAcceptableRequest(request->agent_group, BELIEF, WRITE))
+  if(!isAcceptableRequest(request->agent_group, BELIEF, CHECK))
     response->accepted = false;
 
   else
   {
     response->accepted = true;
-    del_belief_publisher_->publish(request->belief);
-    
-    belief_set_upd_locks_[DEL_I].lock();
-      belief_waiting_for_[DEL_I] = ManagedBelief{request->belief};
-      belief_waiting_for_counter_[DEL_I] = 0;
-    belief_set_upd_locks_[DEL_I].lock();//stuck until belief_set upd unlock it
-    belief_set_upd_locks_[DEL_I].unlock();//release it
-
-    response->updated = belief_set_.count(ManagedBelief{request->belief}) == 0;
+    process_belief_set_upd_lock_.lock();
+      for(Belief b : request->beliefs)
+        response->found.push_back(belief_set_.count(ManagedBelief{b}) == 1);
+    process_belief_set_upd_lock_.unlock();
   }
 }
 
 /*  
-    Read Desire Request service handler        
+    Batched Add/Del Belief Request service handler (whole batch published as a single belief set operation):
+    the response is sent once the alterations are confirmed (or the max waiting time has passed)
 */
-void MARequestHandler::handleCheckDesireRequest(const CheckDesire::Request::SharedPtr request,
-    const CheckDesire::Response::SharedPtr response)
+void MARequestHandler::handleUpdBeliefBatchRequest(const shared_ptr<rmw_request_id_t>& request_header, 
+    const UpdBeliefSetBatch::Request::SharedPtr request, const int& updIndex)
 {
+  auto server = (updIndex == ADD_I)? add_belief_batch_server_ : del_belief_batch_server_;
+  auto response = std::make_shared<UpdBeliefSetBatch::Response>();
+
   //see if the requesting agent belongs to a group which is entitled to this kind of requests
-  if(!isAcceptableRequest(request->agent_group, DESIRE, CHECK))
+  if(!isAcceptableRequest(request->agent_group, BELIEF, WRITE))
+  {
     response->accepted = false;
+    server->sendResponse(request_header, response);
+    return;
+  }
+
+  response->accepted = true;
 
+  vector<ManagedBelief> mgBeliefs;
+  for(Belief b : request->beliefs)
+    mgBeliefs.push_back(ManagedBelief{b});
+  registerBeliefUpdRequest(updIndex, mgBeliefs, 
+    [server, request_header, response](const vector<bool>& confirmed){
+      response->updated = confirmed;
+      server->sendResponse(request_header, response);
+    });
+  
+  BeliefSet batch_msg = BeliefSet{};
+  batch_msg.agent_id = agent_id_;
+  batch_msg.value = request->beliefs;
+  if(updIndex == ADD_I)
+    add_belief_set_publisher_->publish(batch_msg);
   else
-  {
-    response->accepted = true;
-    response->found = desire_set_.count(ManagedDesire{request->desire}) == 1;
-  }
+    del_belief_set_publisher_->publish(batch_msg);
+
+  completeBeliefUpdRequests();
 }
 
 /*  
-    Add Desire Request service handler        
+    Batched Read Desire Request service handler        
 */
-void MARequestHandler::handleAddDesireRequest(const UpdDesireSet::Request::SharedPtr request,
-    const UpdDesireSet::Response::SharedPtr response)
+void MARequestHandler::handleCheckDesireBatchRequest(const CheckDesireBatch::Request::SharedPtr request,
+    const CheckDesireBatch::Response::SharedPtr response)
 {
   //see if the requesting agent belongs to a group which is entitled to this kind of requests
-  if(!isAcceptableRequest(request->agent_group, DESIRE, WRITE))
+  if(!isAcceptableRequest(request->agent_group, DESIRE, CHECK))
     response->accepted = false;
 
   else
   {
-    float maxAcceptedPriority = getMaxAcceptedPriority(request->agent_group);
-    
-    if(maxAcceptedPriority >= 0)
-    {
-      response->accepted = true;
-      // set at most the desire priority to the fixed upper threshold
-      request->desire.priority = std::max(0.000f, std::min(request->desire.priority, maxAcceptedPriority)); 
-      add_desire_publisher_->publish(request->desire);
-              
-      desire_set_upd_locks_[ADD_I].lock();
-        desire_waiting_for_[ADD_I] = ManagedDesire{request->desire};
-        desire_waiting_for_counter_[ADD_I] = 0;
-      desire_set_upd_locks_[ADD_I].lock();//stuck until desire_set upd unlock it
-      desire_set_upd_locks_[ADD_I].unlock();//release it
-
-      response->updated = desire_set_.count(ManagedDesire{request->desire}) == 1 || ManagedDesire{request->desire}.isFulfilled(belief_set_);
-    }
-    else
-      response->accepted = false;// max priority for given agent's requesting group is negative -> not accepted
-    
+    response->accepted = true;
+    process_desire_set_upd_lock_.lock();
+      for(Desire d : request->desires)
+        response->found.push_back(desire_set_.count(ManagedDesire{d}) == 1);
+    process_desire_set_upd_lock_.unlock();
   }
 }
 
 /*  
-      Del Desire Request service handler       
+    Batched Add/Del Desire Request service handler (whole batch published as a single desire set operation):
+    the response is sent once the alterations are confirmed (or the max waiting time has passed)
 */
-void MARequestHandler::handleDelDesireRequest(const UpdDesireSet::Request::SharedPtr request,
-    const UpdDesireSet::Response::SharedPtr response)
+void MARequestHandler::handleUpdDesireBatchRequest(const shared_ptr<rmw_request_id_t>& request_header, 
+    const UpdDesireSetBatch::Request::SharedPtr request, const int& updIndex)
 {
+  auto server = (updIndex == ADD_I)? add_desire_batch_server_ : del_desire_batch_server_;
+  auto response = std::make_shared<UpdDesireSetBatch::Response>();
+
   //see if the requesting agent belongs to a group which is entitled to this kind of requests
   if(!isAcceptableRequest(request->agent_group, DESIRE, WRITE))
+  {
     response->accepted = false;
+    server->sendResponse(request_header, response);
+    return;
+  }
+  
+  DesireSet batch_msg = DesireSet{};
+  batch_msg.agent_id = agent_id_;
+  batch_msg.value = request->desires;
+  if(updIndex == ADD_I)
+  {
+    float maxAcceptedPriority = getMaxAcceptedPriority(request->agent_group);
+    if(maxAcceptedPriority < 0)
+    {
+      response->accepted = false;// max priority for given agent's requesting group is negative -> not accepted
+      server->sendResponse(request_header, response);
+      return;
+    }
+    // set at most the desires priority to the fixed upper threshold
+    for(Desire& d : batch_msg.value)
+      d.priority = std::max(0.000f, std::min(d.priority, maxAcceptedPriority)); 
+  }
+
+  response->accepted = true;
 
+  vector<ManagedDesire> mgDesires;
+  for(Desire d : batch_msg.value)
+    mgDesires.push_back(ManagedDesire{d});
+  registerDesireUpdRequest(updIndex, mgDesires, 
+    [server, request_header, response](const vector<bool>& confirmed){
+      response->updated = confirmed;
+      server->sendResponse(request_header, response);
+    });
+
+  if(updIndex == ADD_I)
+    add_desire_set_publisher_->publish(batch_msg);
   else
-  {
-    response->accepted = true;
-    del_desire_publisher_->publish(request->desire);
-    desire_set_upd_locks_[DEL_I].lock();
-        desire_waiting_for_[DEL_I] = ManagedDesire{request->desire};
-        desire_waiting_for_counter_[DEL_I] = 0;
-    desire_set_upd_locks_[DEL_I].lock();//stuck until desire_set upd unlock it
-    desire_set_upd_locks_[DEL_I].unlock();//release it
+    del_desire_set_publisher_->publish(batch_msg);
 
-    response->updated = desire_set_.count(ManagedDesire{request->desire}) == 0;
-  }
+  completeDesireUpdRequests();
 }
 
 
+/*
+    MARequestHandler node to be spinned in the agent_core_host process, together with the other core nodes of the agent
+*/
+HostedNode hostMARequestHandler()
+{
+  auto node = std::make_shared<MARequestHandler>();
+  return HostedNode{node,
+    [node](){
+      if(!node->wait_psys2_boot(std::chrono::seconds(8)))//Wait max 8 seconds for plansys2 to boot
+        return false;
+      node->init();
+      return true;
+    },
+    [](){}};
+}
 
+#ifndef AGENT_CORE_HOST
 int main(int argc, char ** argv)
 {
   rclcpp::init(argc, argv);
@@ -557,3 +942,4 @@ int main(int argc, char ** argv)
 
   return 0;
 }
+#endif
@@ -1,5 +1,7 @@
 // header file for Plan Director node
 #include "ros2_bdi_core/plan_director.hpp"
+// hooks to spin the node within the agent_core_host process
+#include "ros2_bdi_core/support/hosted_node.hpp"
 // Inner logic + ROS PARAMS & FIXED GLOBAL VALUES for ROS2 core nodes
 #include "ros2_bdi_core/params/core_common_params.hpp"
 // Inner logic + ROS2 PARAMS & FIXED GLOBAL VALUES for Plan Director node
@@ -57,6 +59,8 @@ using BDIManaged::ManagedBelief;
 using BDIManaged::ManagedConditionsDNF;
 using BDIManaged::ManagedDesire;
 using BDIManaged::ManagedPlan;
+using BDIManaged::ActionTable;
+using BDIManaged::StaticBeliefSegment;
 
 PlanDirector::PlanDirector()
   : rclcpp::Node(PLAN_DIRECTOR_NODE_NAME), state_(STARTING)
@@ -114,12 +118,12 @@ void PlanDirector::init()
     // init step_counter
     step_counter_ = 0;
 
-    //Lifecycle status publisher
-    lifecycle_status_publisher_ = this->create_publisher<LifecycleStatus>(LIFECYCLE_STATUS_TOPIC, 10);
+    //Lifecycle status publisher (latched)
+    lifecycle_status_publisher_ = this->create_publisher<LifecycleStatus>(LIFECYCLE_STATUS_TOPIC, rclcpp::QoS(1).reliable().transient_local());
 
     //Lifecycle status subscriber
     lifecycle_status_subscriber_ = this->create_subscription<LifecycleStatus>(
-                LIFECYCLE_STATUS_TOPIC, qos_reliable,
+                LIFECYCLE_STATUS_TOPIC, rclcpp::QoS(10).reliable().transient_local(),
                 bind(&PlanDirector::callbackLifecycleStatus, this, _1));
 
     //Check for plansys2 active state flags init to false
@@ -128,7 +132,7 @@ void PlanDirector::init()
     psys2_executor_active_ = false;
     //plansys2 nodes status subscriber (receive notification from plansys2_monitor node)
     plansys2_status_subscriber_ = this->create_subscription<PlanningSystemState>(
-                PSYS_STATE_TOPIC, qos_reliable,
+                PSYS_STATE_TOPIC, rclcpp::QoS(1).reliable().transient_local(),
                 bind(&PlanDirector::callbackPsys2State, this, _1));
 
     //belief_set_subscriber_ 
@@ -136,6 +140,11 @@ void PlanDirector::init()
                 BELIEF_SET_TOPIC, qos_reliable,
                 bind(&PlanDirector::updatedBeliefSet, this, _1));
 
+    //static_belief_set_subscriber_ (latched, static partition of the belief set)
+    static_belief_set_subscriber_ = this->create_subscription<BeliefSet>(
+                STATIC_BELIEF_SET_TOPIC, rclcpp::QoS(1).reliable().transient_local(),
+                bind(&PlanDirector::updatedStaticBeliefSet, this, _1));
+
     // belief add + belief del publishers
     belief_add_publisher_ = this->create_publisher<Belief>(ADD_BELIEF_TOPIC, 10);
     belief_del_publisher_ = this->create_publisher<Belief>(DEL_BELIEF_TOPIC, 10);
@@ -466,11 +475,11 @@ void PlanDirector::handlePlanRequest(const BDIPlanExecution::Request::SharedPtr
     {
         ManagedPlan requestedPlan = ManagedPlan{request->plan.psys2_plan.plan_index, mdPlan, request->plan.psys2_plan.items, mdPlanPrecondition, mdPlanContext};
         // verify precondition before actually trying triggering executor
-        if(requestedPlan.getPrecondition().isSatisfied(belief_set_)) // check again user defined precondition just for first subplan
+        if(requestedPlan.getPrecondition().isSatisfied(belief_set_.get())) // check again user defined precondition just for first subplan
         {
             bool desire_precondition_check = requestedPlan.getPlanQueueIndex() > 0;// no need to check target precondition here, executing an intermediate plan
             if(requestedPlan.getPlanQueueIndex() == 0)
-                desire_precondition_check = requestedPlan.getFinalTarget().getPrecondition().isSatisfied(belief_set_);
+                desire_precondition_check = requestedPlan.getFinalTarget().getPrecondition().isSatisfied(belief_set_.get());
             
             if(desire_precondition_check)
             {
@@ -493,7 +502,7 @@ void PlanDirector::handlePlanRequest(const BDIPlanExecution::Request::SharedPtr
 */
 void PlanDirector::checkContextConditions()
 {
-    if(!current_plan_.getContext().isSatisfied(belief_set_))
+    if(!current_plan_.getContext().isSatisfied(belief_set_.get()))
     {
         //need to abort current plan execution because context condition are not valid anymore
         if(this->get_parameter(PARAM_DEBUG).as_bool())
@@ -594,8 +603,8 @@ ActionExecutionInfo extractEarliestAction(const vector<ActionExecutionInfo>& psy
 */
 BDIPlanExecutionInfo PlanDirector::getPlanExecutionInfo(const ExecutorClient::ExecutePlan::Feedback& feedback)
 {
-    // retrieve plan body (action with duration and planned start step by step as computed by the pddl planner)
-    vector<PlanItem> current_plan_body = current_plan_.toPsys2Plan().items;
+    // retrieve plan actions (action with duration and planned start step by step as computed by the pddl planner), parsed once with the plan
+    const ActionTable& current_plan_actions = current_plan_.getActionTable();
 
     BDIPlanExecutionInfo planExecutionInfo = BDIPlanExecutionInfo();
     float status_time_s = -1.0;//current exec time relatively to plan start referred as the "zero" time point
@@ -612,11 +621,19 @@ BDIPlanExecutionInfo PlanDirector::getPlanExecutionInfo(const ExecutorClient::Ex
         }
     }
 
+    // feedback entry of each action of the plan (first one, if repeated), mapped through its action_full_name
+    vector<int> psys2_feed_indexes(current_plan_actions.size(), -1);
+    for(int k=0; k<feedback.action_execution_status.size(); k++)
+    {
+        int i = current_plan_actions.index(feedback.action_execution_status[k].action_full_name);
+        if(i >= 0 && psys2_feed_indexes[i] < 0)
+            psys2_feed_indexes[i] = k;
+    }
+
     // find executing action status
-    for (int i=0; i<current_plan_body.size(); i++) {
-        string timex1000s = std::to_string(static_cast<int>(current_plan_body[i].time * 1000));
-        string action_full_name = current_plan_body[i].action + ":" + timex1000s;
-        int aindex_psys2_feed = PDDLBDIConverter::getActionIndex(feedback.action_execution_status,  action_full_name);
+    planExecutionInfo.actions_exec_info.reserve(current_plan_actions.size());
+    for (int i=0; i<current_plan_actions.size(); i++) {
+        int aindex_psys2_feed = psys2_feed_indexes[i];
         
         std::optional<ActionExecutionInfo> psys2_action_feed_opt = {};
         if(aindex_psys2_feed >= 0)
@@ -625,7 +642,7 @@ BDIPlanExecutionInfo PlanDirector::getPlanExecutionInfo(const ExecutorClient::Ex
             executing += (psys2_action_feed_opt.value().status == psys2_action_feed_opt.value().EXECUTING)? 1 : 0;
         }   
 
-        BDIActionExecutionInfo bdiActionExecutionInfo = PDDLBDIConverter::buildBDIActionExecutionInfo(psys2_action_feed_opt, current_plan_body, i,
+        BDIActionExecutionInfo bdiActionExecutionInfo = PDDLBDIConverter::buildBDIActionExecutionInfo(psys2_action_feed_opt, current_plan_actions, i,
                 first_ts_plan_sec_, first_ts_plan_nanosec_);
         planExecutionInfo.actions_exec_info.push_back(bdiActionExecutionInfo);//add action execution info to plan execution info 
 
@@ -636,7 +653,7 @@ BDIPlanExecutionInfo PlanDirector::getPlanExecutionInfo(const ExecutorClient::Ex
 
     //TODO sort before directly on Plansys2 feedback DO IT!!!!! SHOULD BE SOLVED
     sort(planExecutionInfo.actions_exec_info.begin(), planExecutionInfo.actions_exec_info.end(), 
-        [](BDIActionExecutionInfo bdi_a1, BDIActionExecutionInfo bdi_a2){
+        [](const BDIActionExecutionInfo& bdi_a1, const BDIActionExecutionInfo& bdi_a2){
             return bdi_a1.index < bdi_a2.index;
         }
     );
@@ -678,9 +695,34 @@ int16_t PlanDirector::getPlanExecutionStatus()
 */
 void PlanDirector::updatedBeliefSet(const BeliefSet::SharedPtr msg)
 {
-    belief_set_ = BDIFilter::extractMGBeliefs(msg->value);
+    belief_set_.setDynamic(BDIFilter::extractMGBeliefs(msg->value));
+}
+
+/*
+    The static partition of the belief set has grown
+*/
+void PlanDirector::updatedStaticBeliefSet(const BeliefSet::SharedPtr msg)
+{
+    belief_set_.setStatic(std::make_shared<const StaticBeliefSegment>(BDIFilter::extractMGBeliefs(msg->value)));
+}
+
+/*
+    PlanDirector node to be spinned in the agent_core_host process, together with the other core nodes of the agent
+*/
+HostedNode hostPlanDirector()
+{
+  auto node = std::make_shared<PlanDirector>();
+  return HostedNode{node,
+    [node](){
+      if(!node->wait_psys2_boot(std::chrono::seconds(8)))//Wait max 8 seconds for plansys2 to boot
+        return false;
+      node->init();
+      return true;
+    },
+    [](){}};
 }
 
+#ifndef AGENT_CORE_HOST
 int main(int argc, char ** argv)
 {
   rclcpp::init(argc, argv);
@@ -701,3 +743,4 @@ int main(int argc, char ** argv)
 
   return 0;
 }
+#endif
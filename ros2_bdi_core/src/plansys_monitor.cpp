@@ -1,5 +1,7 @@
 // header file for PlanSys2 Monitor node
 #include "ros2_bdi_core/plansys_monitor.hpp"
+// hooks to spin the node within the agent_core_host process
+#include "ros2_bdi_core/support/hosted_node.hpp"
 // Inner logic + ROS PARAMS & FIXED GLOBAL VALUES for ROS2 core nodes
 #include "ros2_bdi_core/params/core_common_params.hpp"
 // Inner logic + ROS2 PARAMS & FIXED GLOBAL VALUES for PlanSys2 Monitor node
@@ -13,6 +15,11 @@ using std::chrono::milliseconds;
 using std::map;
 using std::bind;
 using std::placeholders::_1;
+using std::vector;
+
+using lifecycle_msgs::msg::State;
+using lifecycle_msgs::msg::TransitionEvent;
+using lifecycle_msgs::srv::GetState;
 
 using ros2_bdi_interfaces::msg::LifecycleStatus;
 using ros2_bdi_interfaces::msg::PlanningSystemState;
@@ -26,8 +33,6 @@ PlanSysMonitor::PlanSysMonitor() : rclcpp::Node(PSYS_MONITOR_NODE_NAME)
 
     sel_planning_mode_ = this->get_parameter(PARAM_PLANNING_MODE).as_string() == PLANNING_MODE_OFFLINE? OFFLINE : ONLINE;
     this->undeclare_parameter(PARAM_PLANNING_MODE);
-
-    psys_monitor_client_ = std::make_shared<PlanSysMonitorClient>(PSYS_MONITOR_NODE_NAME + string("_caller_"), sel_planning_mode_);
 }
 
 /*
@@ -39,8 +44,21 @@ void PlanSysMonitor::init()
     // agent's namespace
     agent_id_ = this->get_parameter(PARAM_AGENT_ID).as_string();
 
-    // PlanSys2 state monitor publisher
-    psys_state_publisher_ = this->create_publisher<PlanningSystemState>(PSYS_STATE_TOPIC, 10);
+    // PlanSys2 state monitor publisher (latched, so that the core nodes waiting for PlanSys2 to boot get the last state right away)
+    psys_state_publisher_ = this->create_publisher<PlanningSystemState>(PSYS_STATE_TOPIC, rclcpp::QoS(1).reliable().transient_local());
+
+    // psys2 nodes to monitor: state changes received through their transition events,
+    // get_state queried just for the ones whose state is not known (yet) that way
+    psys2_nodes_ = vector<string>{PSYS2_DOM_EXPERT, PSYS2_PROB_EXPERT, 
+        (sel_planning_mode_ == OFFLINE)? PSYS2_PLANNER : JAVAFF_PLANNER, PSYS2_EXECUTOR};
+    for(string psys2_node : psys2_nodes_)
+    {
+        state_from_events_[psys2_node] = false;
+        get_state_clients_[psys2_node] = this->create_client<GetState>(psys2_node + "/" + PSYS2_CK_STATE_SRV);
+        transition_event_subscribers_[psys2_node] = this->create_subscription<TransitionEvent>(
+                psys2_node + "/" + PSYS2_TRANSITION_EVENT_TOPIC, rclcpp::QoS(10).reliable(),
+                [this, psys2_node](const TransitionEvent::SharedPtr msg){callbackPsysTransitionEvent(psys2_node, msg);});
+    }
 
     // set at start work timer interval at minimum (so it checks very frequently)
     // if all up & active, it'll grow, checking the services less frequently
@@ -65,12 +83,12 @@ void PlanSysMonitor::init()
     // init step_counter
     step_counter_ = 0;
 
-    //Lifecycle status publisher
-    lifecycle_status_publisher_ = this->create_publisher<LifecycleStatus>(LIFECYCLE_STATUS_TOPIC, 10);
+    //Lifecycle status publisher (latched)
+    lifecycle_status_publisher_ = this->create_publisher<LifecycleStatus>(LIFECYCLE_STATUS_TOPIC, rclcpp::QoS(1).reliable().transient_local());
 
     //Lifecycle status subscriber
     lifecycle_status_subscriber_ = this->create_subscription<LifecycleStatus>(
-                LIFECYCLE_STATUS_TOPIC, rclcpp::QoS(10),
+                LIFECYCLE_STATUS_TOPIC, rclcpp::QoS(10).reliable().transient_local(),
                 bind(&PlanSysMonitor::callbackLifecycleStatus, this, _1));
 
     // init flag values to false
@@ -122,15 +140,9 @@ void PlanSysMonitor::checkPlanningSystemState()
         resetWorkTimer();
     }
 
-    checkPsysNodeActive(PSYS2_DOM_EXPERT);// check if domain expert is up & active
-    checkPsysNodeActive(PSYS2_PROB_EXPERT);// check if problem expert is up & active
-
-    if(sel_planning_mode_ == OFFLINE)
-        checkPsysNodeActive(PSYS2_PLANNER);// check if psys2 planner is up & active
-    else if(sel_planning_mode_ == ONLINE)
-        checkPsysNodeActive(JAVAFF_PLANNER);// check if javaff online planner is up & active
-
-    checkPsysNodeActive(PSYS2_EXECUTOR);// check if problem expert is up & active
+    // check if domain expert, problem expert, planner (psys2 or javaff online planner) and executor are up & active
+    for(string psys2_node : psys2_nodes_)
+        checkPsysNodeActive(psys2_node);
 
     //publish current state
     psys_state_publisher_->publish(psys_active_);
@@ -161,37 +173,101 @@ bool PlanSysMonitor::allActive()
 }
 
 /*
-    Activate supporting client node to check active status of plansys2 node (planner, domain_expert, problem_expert)
-
-    Use result to update corresponding flag
+    Send an async {psysNodeName}/get_state request (if none pending) to check the active state of plansys2 node
+    (planner, domain_expert, problem_expert, executor), unless its state is already known
+    through its transition events
 */
 void PlanSysMonitor::checkPsysNodeActive(const string& psysNodeName)
 {
-    bool activeResult = psys_monitor_client_->isPsysNodeActive(psysNodeName);
+    if(state_from_events_[psysNodeName] && this->count_publishers(psysNodeName + "/" + PSYS2_TRANSITION_EVENT_TOPIC) > 0)
+        return;//state kept up to date by the transition events and the node is still around
+    state_from_events_[psysNodeName] = false;
+
+    auto pending_it = pending_get_state_.find(psysNodeName);
+    if(pending_it != pending_get_state_.end())
+    {
+        if(std::chrono::steady_clock::now() - pending_it->second < std::chrono::seconds(WAIT_GET_STATE_RESPONSE_TIMEOUT))
+            return;//still waiting for the response
+        pending_get_state_.erase(pending_it);
+        setPsysNodeActive(psysNodeName, false);//no response in time
+    }
+
+    auto client = get_state_clients_[psysNodeName];
+    if(!client->service_is_ready())
+    {
+        setPsysNodeActive(psysNodeName, false);
+        return;
+    }
+
+    pending_get_state_[psysNodeName] = std::chrono::steady_clock::now();
+    client->async_send_request(std::make_shared<GetState::Request>(),
+        [this, psysNodeName](rclcpp::Client<GetState>::SharedFuture future)
+        {
+            pending_get_state_.erase(psysNodeName);
+            setPsysNodeActive(psysNodeName, future.get()->current_state.id == State::PRIMARY_STATE_ACTIVE);
+        });
+}
+
+/*
+    Received lifecycle transition event of plansys2 node @psysNodeName
+*/
+void PlanSysMonitor::callbackPsysTransitionEvent(const string& psysNodeName, const TransitionEvent::SharedPtr msg)
+{
+    state_from_events_[psysNodeName] = true;
+    setPsysNodeActive(psysNodeName, msg->goal_state.id == State::PRIMARY_STATE_ACTIVE);
+}
+
+/*
+    Update the active flag of the plansys2 node @psysNodeName, publishing the new state right away if it changes
+*/
+void PlanSysMonitor::setPsysNodeActive(const string& psysNodeName, const bool& active)
+{
+    bool& active_flag = psysNodeActiveFlag(psysNodeName);
+    if(active_flag == active)
+        return;
 
-    //assign active flag to respective boolean value representing the active state of the PlanSys2 node
+    active_flag = active;
+    psys_state_publisher_->publish(psys_active_);
+}
+
+/*
+    Get the reference to the active flag of the plansys2 node @psysNodeName within psys_active_
+*/
+bool& PlanSysMonitor::psysNodeActiveFlag(const string& psysNodeName)
+{
     if(psysNodeName == PSYS2_DOM_EXPERT)
-        psys_active_.domain_expert_active = activeResult;
+        return psys_active_.domain_expert_active;
     else if(psysNodeName == PSYS2_PROB_EXPERT)
-        psys_active_.problem_expert_active = activeResult;
+        return psys_active_.problem_expert_active;
     else if(psysNodeName == PSYS2_PLANNER)
-        psys_active_.offline_planner_active = activeResult;
+        return psys_active_.offline_planner_active;
     else if(psysNodeName == JAVAFF_PLANNER)
-        psys_active_.online_planner_active = activeResult;
-    else if(psysNodeName == PSYS2_EXECUTOR)
-        psys_active_.executor_active = activeResult;
+        return psys_active_.online_planner_active;
+    else
+        return psys_active_.executor_active;
 }
 
 
+/*
+    PlanSysMonitor node to be spinned in the agent_core_host process, together with the other core nodes of the agent
+*/
+HostedNode hostPlanSysMonitor()
+{
+  auto node = std::make_shared<PlanSysMonitor>();
+  return HostedNode{node,
+    [node](){ node->init(); return true; },
+    [](){}};
+}
+
+#ifndef AGENT_CORE_HOST
 int main(int argc, char ** argv)
 {
   rclcpp::init(argc, argv);
   auto node = std::make_shared<PlanSysMonitor>();
-  std::this_thread::sleep_for(std::chrono::seconds(1));//WAIT PSYS2 TO BOOT
-
   node->init();
   rclcpp::spin(node);
   rclcpp::shutdown();
 
   return 0;
 }
+#endif
@@ -17,6 +17,7 @@
 #include "ros2_bdi_utils/BDIFilter.hpp"
 #include "ros2_bdi_utils/BDIPDDLConverter.hpp"
 #include "ros2_bdi_utils/BDIYAMLParser.hpp"
+#include "ros2_bdi_utils/BDISnapshot.hpp"
 
 #include "ros2_bdi_utils/ManagedCondition.hpp"
 #include "ros2_bdi_utils/ManagedConditionsConjunction.hpp"
@@ -60,11 +61,16 @@ using ros2_bdi_interfaces::srv::BDIPlanExecution;
 using BDIManaged::ManagedParam;
 using BDIManaged::ManagedBelief;
 using BDIManaged::ManagedDesire;
+using BDIManaged::ManagedDesireSet;
+using BDIManaged::StaticBeliefSegment;
+using BDIManaged::BeliefSetChanges;
 using BDIManaged::ManagedPlan;
 
 Scheduler::Scheduler()
   : rclcpp::Node(SCHEDULER_NODE_NAME), state_(STARTING)
 {
+    boot_time_ = std::chrono::steady_clock::now();
+    first_plan_ = true;
     psys2_comm_errors_ = 0;
     
     this->declare_parameter(PARAM_AGENT_ID, "agent0");
@@ -78,6 +84,7 @@ Scheduler::Scheduler()
     this->declare_parameter(PARAM_AUTOSUBMIT_PREC, false);
     this->declare_parameter(PARAM_AUTOSUBMIT_CONTEXT, false);
     this->declare_parameter(PARAM_PLANNING_MODE, PLANNING_MODE_OFFLINE);
+    this->declare_parameter(PARAM_WARM_RESTART, false);
 
     sel_planning_mode_ = this->get_parameter(PARAM_PLANNING_MODE).as_string() == PLANNING_MODE_OFFLINE? OFFLINE : ONLINE;
     this->undeclare_parameter(PARAM_PLANNING_MODE);
@@ -106,9 +113,13 @@ void Scheduler::init()
     planner_client_ = std::make_shared<plansys2::PlannerClient>();
 
     // Declare empty desire set
-    desire_set_ = set<ManagedDesire>();
+    desire_set_ = ManagedDesireSet();
     // wait for it to be init
     init_dset_ = false;
+    snapshot_dirty_ = false;
+
+    // no belief set delta applied yet
+    last_delta_seq_ = 0;
 
     //Desire set publisher
     desire_set_publisher_ = this->create_publisher<DesireSet>(DESIRE_SET_TOPIC, 10);
@@ -130,15 +141,15 @@ void Scheduler::init()
     lifecycle_status_[EVENT_LISTENER_NODE_NAME] = lifecycle_status.UNKNOWN;
     lifecycle_status_[MA_REQUEST_HANDLER_NODE_NAME] = lifecycle_status.UNKNOWN;
 
-    //Lifecycle status publisher
-    lifecycle_status_publisher_ = this->create_publisher<LifecycleStatus>(LIFECYCLE_STATUS_TOPIC, 10);
+    //Lifecycle status publisher (latched)
+    lifecycle_status_publisher_ = this->create_publisher<LifecycleStatus>(LIFECYCLE_STATUS_TOPIC, rclcpp::QoS(1).reliable().transient_local());
 
-    //Current intention publisher
-    intention_publisher_ = this->create_publisher<BDIPlanExecutionInfoMin>(CURR_INTENTIONS_TOPIC, 10);
+    //Current intention publisher (latched)
+    intention_publisher_ = this->create_publisher<BDIPlanExecutionInfoMin>(CURR_INTENTIONS_TOPIC, rclcpp::QoS(1).reliable().transient_local());
 
     //Lifecycle status subscriber
     lifecycle_status_subscriber_ = this->create_subscription<LifecycleStatus>(
-                LIFECYCLE_STATUS_TOPIC, qos_reliable,
+                LIFECYCLE_STATUS_TOPIC, rclcpp::QoS(10).reliable().transient_local(),
                 bind(&Scheduler::callbackLifecycleStatus, this, _1));
 
     //Check for plansys2 active state flags init to false
@@ -147,7 +158,7 @@ void Scheduler::init()
     psys2_problem_expert_active_ = false;
     //plansys2 nodes status subscriber (receive notification from plansys2_monitor node)
     plansys2_status_subscriber_ = this->create_subscription<PlanningSystemState>(
-                PSYS_STATE_TOPIC, qos_reliable,
+                PSYS_STATE_TOPIC, rclcpp::QoS(1).reliable().transient_local(),
                 bind(&Scheduler::callbackPsys2State, this, _1));
 
     //Desire to be added notification
@@ -159,6 +170,16 @@ void Scheduler::init()
     del_desire_subscriber_ = this->create_subscription<Desire>(
                 DEL_DESIRE_TOPIC, qos_reliable,
                 bind(&Scheduler::delDesireTopicCallBack, this, _1));
+
+    //Desire set to be added notification
+    add_desire_set_subscriber_ = this->create_subscription<DesireSet>(
+                ADD_DESIRE_SET_TOPIC, qos_reliable,
+                bind(&Scheduler::addDesireSetTopicCallBack, this, _1));
+
+    //Desire set to be removed notification
+    del_desire_set_subscriber_ = this->create_subscription<DesireSet>(
+                DEL_DESIRE_SET_TOPIC, qos_reliable,
+                bind(&Scheduler::delDesireSetTopicCallBack, this, _1));
     
     //Topic where a desire to be augmented to currently active goal or added to the desire set is published
     boost_desire_subscriber_ = this->create_subscription<Desire>(
@@ -170,11 +191,23 @@ void Scheduler::init()
                 BELIEF_SET_TOPIC, qos_reliable,
                 bind(&Scheduler::updatedBeliefSet, this, _1));
 
-    plan_exec_srv_client_ = std::make_shared<TriggerPlanClient>(PLAN_EXECUTION_SRV + string("_s_caller"));
+    //belief_set_delta_subscriber_ (react just to the altered beliefs, full belief set acts as a resync)
+    belief_set_delta_subscriber_ = this->create_subscription<BeliefSetDelta>(
+                BELIEF_SET_DELTA_TOPIC, qos_reliable,
+                bind(&Scheduler::updatedBeliefSetDelta, this, _1));
+
+    //static_belief_set_subscriber_ (latched, static partition of the belief set)
+    static_belief_set_subscriber_ = this->create_subscription<BeliefSet>(
+                STATIC_BELIEF_SET_TOPIC, rclcpp::QoS(1).reliable().transient_local(),
+                bind(&Scheduler::updatedStaticBeliefSet, this, _1));
+
+    // plan execution srv client (non blocking: replies are handled by the executor spinning this node)
+    plan_exec_srv_client_ = std::make_shared<TriggerPlanClient>(this);
+    deferred_plan_exec_info_.clear();
 
     plan_exec_info_subscriber_ = this->create_subscription<BDIPlanExecutionInfo>(
         PLAN_EXECUTION_TOPIC, 10,
-        bind(&Scheduler::updatePlanExecution, this, _1)
+        bind(&Scheduler::receivedPlanExecutionInfo, this, _1)
     );
 
     //loop to be called regularly to perform work (publish belief_set_, sync with plansys2 problem_expert node...)
@@ -209,7 +242,8 @@ void Scheduler::step()
                 psys2_comm_errors_ = 0;
                 if(!init_dset_)//hasn't ben tried to init desire set yet    
                 {    
-                    tryInitDesireSet();
+                    if(!this->get_parameter(PARAM_WARM_RESTART).as_bool() || !tryRestoreDesireSet())
+                        tryInitDesireSet();
                     init_dset_ = true;
                 }
                 
@@ -249,6 +283,8 @@ void Scheduler::step()
         case SCHEDULING:
         {   
             publishDesireSet();
+            if(step_counter_ % DESIRE_SET_SNAPSHOT_INTERVAL_STEPS == 0)
+                saveSnapshot();
 
             auto reschedulePolicy = this->get_parameter(PARAM_RESCHEDULE_POLICY).as_string();
             /*
@@ -305,7 +341,9 @@ LifecycleStatus Scheduler::getLifecycleStatus()
 */
 void Scheduler::publishDesireSet()
 {
-    DesireSet dset_msg = BDIFilter::extractDesireSetMsg(desire_set_);
+    DesireSet dset_msg = DesireSet();
+    for(const ManagedDesire& md : desire_set_)
+        dset_msg.value.push_back(md.toDesire());
     dset_msg.agent_id = agent_id_;
     desire_set_publisher_->publish(dset_msg);
 }
@@ -327,6 +365,7 @@ void Scheduler::callbackPsys2State(const PlanningSystemState::SharedPtr msg)
 void Scheduler::tryInitDesireSet()
 {
     string init_dset_filepath = "/tmp/"+this->get_parameter(PARAM_AGENT_ID).as_string() + "/" + INIT_DESIRE_SET_FILENAME; 
+    init_dset_hash_ = BDISnapshot::fileHash(init_dset_filepath);
     try{
         vector<ManagedDesire> init_mgdesires = BDIYAMLParser::extractMGDesires(init_dset_filepath, domain_expert_);
         for(ManagedDesire initMGDesire : init_mgdesires)
@@ -346,6 +385,66 @@ void Scheduler::tryInitDesireSet()
     }   
 }
 
+/*
+    Restore the desire set from the snapshot file "/tmp/{agent_id}/dset.snapshot" (no yaml parsing)
+    Returns false if there is no valid snapshot to restore from or the init. file has been edited since the snapshot
+*/
+bool Scheduler::tryRestoreDesireSet()
+{
+    string snapshot_filepath = "/tmp/"+this->get_parameter(PARAM_AGENT_ID).as_string() + "/" + DESIRE_SET_SNAPSHOT_FILENAME;
+    string init_dset_filepath = "/tmp/"+this->get_parameter(PARAM_AGENT_ID).as_string() + "/" + INIT_DESIRE_SET_FILENAME; 
+    BDISnapshot::Snapshot snapshot(snapshot_filepath);
+    if(!snapshot.valid())
+        return false;
+
+    if(!snapshot.isUpToDate(init_dset_filepath))
+    {
+        RCLCPP_INFO(this->get_logger(), "Desire set snapshot " + snapshot_filepath + " is older than the current init. file: falling back to init. file");
+        return false;
+    }
+    init_dset_hash_ = BDISnapshot::fileHash(init_dset_filepath);
+
+    auto desires = snapshot.getDesires();
+    if(!desires.has_value())
+    {
+        RCLCPP_ERROR(this->get_logger(), "Desire set snapshot " + snapshot_filepath + " is corrupted: falling back to init. file");
+        return false;
+    }
+
+    for(ManagedDesire md : desires.value())
+        if(md.getValue().size() > 0)
+            addDesire(md);
+    
+    RCLCPP_INFO(this->get_logger(), "Desire set restored from snapshot " + snapshot_filepath + " (" + 
+        std::to_string(desire_set_.size()) + "/" + std::to_string(desires.value().size()) + " desires)");
+    return true;
+}
+
+/*
+    Write the current desire set into the snapshot file "/tmp/{agent_id}/dset.snapshot" (warm restart only);
+    called periodically and on shutdown
+*/
+void Scheduler::saveSnapshot()
+{
+    if(!this->get_parameter(PARAM_WARM_RESTART).as_bool() || !snapshot_dirty_)
+        return;
+
+    BDISnapshot::Sections sections;
+    mtx_add_del_.lock();
+        BDISnapshot::putDesires(sections, desire_set_.toSet());
+        snapshot_dirty_ = false;
+    mtx_add_del_.unlock();
+    if(init_dset_hash_.has_value())
+        BDISnapshot::putSourceHash(sections, init_dset_hash_.value());
+
+    string snapshot_filepath = "/tmp/"+agent_id_+"/"+DESIRE_SET_SNAPSHOT_FILENAME;
+    if(!BDISnapshot::writeSnapshot(snapshot_filepath, sections))
+    {
+        snapshot_dirty_ = true;//retry at the next round
+        RCLCPP_ERROR(this->get_logger(), "Failed to write desire set snapshot " + snapshot_filepath);
+    }
+}
+
 /*
     returns ACCEPTED iff managed belief can be put as part of a desire's value
     wrt. to its syntax
@@ -410,7 +509,11 @@ TargetBeliefAcceptance Scheduler::desireAcceptanceCheck(const ManagedDesire& md)
 */
 bool Scheduler::matchingMDInDesireSet(const BDIManaged::ManagedDesire& md, const bool& doNotCheckConditions)
 {
-    for(auto mdInSet : desire_set_)
+    // a matching desire contains the whole value of md: look just among the ones targeting its first belief
+    vector<ManagedDesire> candidates = (md.getValue().size() > 0)? 
+        desire_set_.getByTargetBelief(md.getValue()[0]) : desire_set_.getByGroup(md.getDesireGroup());
+
+    for(auto mdInSet : candidates)
         if(mdInSet.baseMatch(md))
             if(!doNotCheckConditions || mdInSet.getPrecondition() == md.getPrecondition() &&  mdInSet.getContext() == md.getContext())
                 return true;
@@ -428,65 +531,131 @@ void Scheduler::setNewMDName(BDIManaged::ManagedDesire& md)
 
 
 /*
-    Launch execution of selectedPlan; if successful current plan is pushed into waiting plans for execution gets value of selectedPlan
-    return true if successful
+    Launch execution of selectedPlan; if successful current plan gets value of selectedPlan
+    @onDone notified with true if successful
 */
-bool Scheduler::launchPlanExecution(const BDIManaged::ManagedPlan& selectedPlan)
+void Scheduler::launchPlanExecution(const BDIManaged::ManagedPlan& selectedPlan, const std::function<void(bool)>& onDone)
 {   
     //trigger plan execution
-    bool triggered = plan_exec_srv_client_->triggerPlanExecution(selectedPlan.toPlan());
-    if(triggered)
-    {
-        current_plan_ = selectedPlan;// selectedPlan can now be set as currently executing plan
-        publishTargetGoalInfo(ADD_GOAL_BELIEFS);
-    }
+    plan_exec_srv_client_->triggerPlanExecution(selectedPlan.toPlan(), [this, selectedPlan, onDone](bool triggered){
+        if(triggered)
+        {
+            current_plan_ = selectedPlan;// selectedPlan can now be set as currently executing plan
+            publishTargetGoalInfo(ADD_GOAL_BELIEFS);
 
-    if(this->get_parameter(PARAM_DEBUG).as_bool())
-    {
-        string desireValue = "";
-        for(auto mbVal : selectedPlan.getFinalTarget().getValue())
-            desireValue += "(" + mbVal.getName() + " "+mbVal.getParamsJoined()+")";
-        if(triggered) RCLCPP_INFO(this->get_logger(), "Triggered new plan execution fulfilling desire \"" + current_plan_.getPlanTarget().getName() + "\": " + desireValue + " success");
-        else RCLCPP_INFO(this->get_logger(), "Triggered new plan execution fulfilling desire \"" + selectedPlan.getPlanTarget().getName() + "\": " + desireValue + " failed");
-    }
+            if(first_plan_)
+            {
+                first_plan_ = false;
+                auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - boot_time_);
+                RCLCPP_INFO(this->get_logger(), "Time to first plan: " + std::to_string(elapsed.count()) + " ms");
+            }
+        }
+
+        if(this->get_parameter(PARAM_DEBUG).as_bool())
+        {
+            string desireValue = "";
+            for(auto mbVal : selectedPlan.getFinalTarget().getValue())
+                desireValue += "(" + mbVal.getName() + " "+mbVal.getParamsJoined()+")";
+            if(triggered) RCLCPP_INFO(this->get_logger(), "Triggered new plan execution fulfilling desire \"" + current_plan_.getPlanTarget().getName() + "\": " + desireValue + " success");
+            else RCLCPP_INFO(this->get_logger(), "Triggered new plan execution fulfilling desire \"" + selectedPlan.getPlanTarget().getName() + "\": " + desireValue + " failed");
+        }
 
-    return triggered;
+        if(onDone)
+            onDone(triggered);
+        planExecRequestCompleted();
+    });
 }
 
 /*
-    Abort execution of current plan; if successful waiting plans is popped empty
-    return true if successful
+    Abort execution of current plan; if successful there is no current plan anymore
+    (as it is when the request is actually sent, i.e. after the plan exec. requests made before it have completed)
+    @onDone (if any) notified with true if successful
 */
-bool Scheduler::abortCurrentPlanExecution()
+void Scheduler::abortCurrentPlanExecution(const std::function<void(bool)>& onDone)
 {
-    bool aborted = plan_exec_srv_client_->abortPlanExecution(current_plan_.toPlan());
-    if(aborted)
+    // the plan to be aborted (plans are told apart by their action table), set when the request is sent:
+    // the current one by then if it still pursues the same target (e.g. it's been triggered meanwhile), the current one by now otherwise
+    auto aborting = std::make_shared<ManagedPlan>(current_plan_);
+
+    plan_exec_srv_client_->abortPlanExecution([this, aborting](){
+            if(current_plan_.getFinalTarget() == aborting->getFinalTarget())
+                *aborting = current_plan_;
+            return aborting->toPlan();
+        }, 
+        [this, aborting, onDone](bool aborted){
+        string targetName = aborting->getFinalTarget().getName();
+        if(aborted)
+        {
+            if(this->get_parameter(PARAM_DEBUG).as_bool())
+                RCLCPP_INFO(this->get_logger(), "Aborted plan execution fulfilling desire \"%s\"", targetName.c_str());
+            
+            if(current_plan_.getSharedActionTable() == aborting->getSharedActionTable())// still the current one
+            {
+                publishTargetGoalInfo(DEL_GOAL_BELIEFS);//goal disactivated -> upd belief set
+                current_plan_ = BDIManaged::ManagedPlan{}; //no plan in execution
+                fulfilling_desire_ = ManagedDesire{};
+            }
+        }
+        else if(this->get_parameter(PARAM_DEBUG).as_bool())
+            RCLCPP_INFO(this->get_logger(), "The request to abort plan execution fulfilling desire \"%s\" has not been fulfilled", targetName.c_str());
+
+        if(onDone)
+            onDone(aborted);
+        planExecRequestCompleted();
+    });
+}
+
+/*
+    A reply from PlanDirector has been handled: process what has been put aside meanwhile, unless another request is pending
+*/
+void Scheduler::planExecRequestCompleted()
+{
+    while(!planExecRequestPending() && !deferred_plan_exec_info_.empty())
     {
-        if(this->get_parameter(PARAM_DEBUG).as_bool())
-            RCLCPP_INFO(this->get_logger(), "Aborted plan execution fulfilling desire \"%s\"", current_plan_.getFinalTarget().getName());
-        
-        publishTargetGoalInfo(DEL_GOAL_BELIEFS);//goal disactivated -> upd belief set
-        current_plan_ = BDIManaged::ManagedPlan{}; //no plan in execution
-        fulfilling_desire_ = ManagedDesire{};
+        BDIPlanExecutionInfo::SharedPtr msg = deferred_plan_exec_info_.front();
+        deferred_plan_exec_info_.pop_front();
+        updatePlanExecution(msg);
     }
-    else if(this->get_parameter(PARAM_DEBUG).as_bool())
-        RCLCPP_INFO(this->get_logger(), "The request to abort plan execution fulfilling desire \"%s\" has not been fulfilled", current_plan_.getFinalTarget().getName());
-    return aborted;
+}
+
+/*
+    Received update on plan execution: processed right away unless waiting for PlanDirector to reply to a request
+*/
+void Scheduler::receivedPlanExecutionInfo(const BDIPlanExecutionInfo::SharedPtr msg)
+{
+    if(planExecRequestPending() || !deferred_plan_exec_info_.empty())
+        deferred_plan_exec_info_.push_back(msg);
+    else
+        updatePlanExecution(msg);
 }
 
 
 /*
     If selected plan fit the minimal requirements for a plan (i.e. not empty body and a desire which is in the desire_set)
     try triggering its execution by srv request to PlanDirector (/{agent}/plan_execution) by exploiting the TriggerPlanClient
-
+    @onDone notified with true if successful (n.b. the request does not block: it is notified once PlanDirector has replied)
 */
-bool Scheduler::tryTriggerPlanExecution(const ManagedPlan& selectedPlan)
+void Scheduler::tryTriggerPlanExecution(const ManagedPlan& selectedPlan, const std::function<void(bool)>& onDone)
 {      
     string reschedulePolicy = this->get_parameter(PARAM_RESCHEDULE_POLICY).as_string();
     bool noPlan = noPlanExecuting();
     //rescheduling not ammitted -> a plan already executing and policy not admit any switch with higher priority plans
     if(reschedulePolicy == VAL_RESCHEDULE_POLICY_NO_IF_EXEC && !noPlan)
-        return false;
+    {
+        onDone(false);
+        return;
+    }
+
+    // launch selected plan, if it's still a proper one (with actions and fulfilling a desire in the desire_set_)
+    auto launchIfValid = [this, selectedPlan, onDone]()
+    {
+        //desire still in desire set
+        bool desireInDesireSet = desire_set_.count(selectedPlan.getFinalTarget())==1;
+        if(selectedPlan.getActionsExecInfo().size() == 0 || !desireInDesireSet)
+            onDone(false);
+        else
+            launchPlanExecution(selectedPlan, onDone);
+    };
 
     //rescheduling possible, but plan currently in exec (substitute just for plan with higher priority)
     bool planinExec = reschedulePolicy != VAL_RESCHEDULE_POLICY_NO_IF_EXEC && !noPlan;
@@ -498,19 +667,16 @@ bool Scheduler::tryTriggerPlanExecution(const ManagedPlan& selectedPlan)
                             " in order to trigger plan execution for desire \"" + selectedPlan.getPlanTarget().getName() + "\"");
             
         //trigger plan abortion
-        if(!abortCurrentPlanExecution())
-            return false;//current plan abortion failed
+        abortCurrentPlanExecution([launchIfValid, onDone](bool aborted){
+            if(aborted)
+                launchIfValid();
+            else
+                onDone(false);//current plan abortion failed
+        });
+        return;
     }
-    
-    //desire still in desire set
-    bool desireInDesireSet = desire_set_.count(selectedPlan.getFinalTarget())==1;
 
-    //check that a proper plan has been selected (with actions and fulfilling a desire in the desire_set_)
-    if(selectedPlan.getActionsExecInfo().size() == 0 || !desireInDesireSet)
-        return false;
-    
-
-    return launchPlanExecution(selectedPlan);
+    launchIfValid();
 }
 
 /*
@@ -519,41 +685,70 @@ bool Scheduler::tryTriggerPlanExecution(const ManagedPlan& selectedPlan)
 */
 bool Scheduler::isDesireSatisfied(ManagedDesire& md)
 {
-    return md.isFulfilled(belief_set_);
+    if(desire_set_.count(md) == 1)
+        return desire_set_.isFulfilled(md);//look it up in the fulfillment index
+    return md.isFulfilled(belief_set_.get());
 }
 
 /*
-    The belief set has been updated
+    The belief set has been updated (dynamic partition only):
+    belief sets and deltas come on different topics, so a belief set not reflecting the last delta applied yet is discarded
+    (otherwise it would revert the delta, till the next one)
 */
 void Scheduler::updatedBeliefSet(const BeliefSet::SharedPtr msg)
 {
+    if(msg->seq < last_delta_seq_ && msg->seq != 0)//seq 0: no delta published by the belief manager yet (e.g. just restarted)
+        return;
+
     set<ManagedBelief> newBeliefSet = BDIFilter::extractMGBeliefs(msg->value);
-    bool bsetModified = false;//is belief set altered from last update?
-    
-    for(ManagedBelief mb : newBeliefSet)
-        if(belief_set_.count(mb) == 0)//check if new belief set has new items
-        {
-            bsetModified = true;
-            break;
-        }
-    
-    if(!bsetModified)
-        for(ManagedBelief mb : belief_set_)
-            if(newBeliefSet.count(mb) == 0)//check if new belief set has lost a few items
-            {
-                bsetModified = true;
-                break;
-            }
+    //if belief set appears different from last update (i.e. not already aligned by the deltas)
+    if(applyBeliefSetChanges(belief_set_.setDynamic(newBeliefSet)))
+        onBeliefSetAltered();
+}
 
-    if(bsetModified)//if belief set appears different from last update
-    {
-        belief_set_ = newBeliefSet;//update current mirroring of the belief set
-        
-        checkForSatisfiedDesires();//check for satisfied desires
-        if(state_ == SCHEDULING)
-            reschedule();//do a rescheduling
-    }
-    
+/*
+    The belief set has been altered: apply the delta to the mirrored belief set
+    (and to the fulfillment index of the desire set)
+*/
+void Scheduler::updatedBeliefSetDelta(const BeliefSetDelta::SharedPtr msg)
+{
+    last_delta_seq_ = msg->seq;
+    if(applyBeliefSetChanges(belief_set_.applyDelta(BDIFilter::extractMGBeliefs(msg->removed), BDIFilter::extractMGBeliefs(msg->added))))
+        onBeliefSetAltered();
+}
+
+/*
+    The static partition of the belief set has grown: replace the mirrored one
+*/
+void Scheduler::updatedStaticBeliefSet(const BeliefSet::SharedPtr msg)
+{
+    auto segment = std::make_shared<const StaticBeliefSegment>(BDIFilter::extractMGBeliefs(msg->value));
+    if(applyBeliefSetChanges(belief_set_.setStatic(segment)))
+        onBeliefSetAltered();
+}
+
+/*
+    Feed the alterations to the mirrored belief set into the fulfillment index of the desire set,
+    return true if there has been any
+*/
+bool Scheduler::applyBeliefSetChanges(const BeliefSetChanges& changes)
+{
+    for(ManagedBelief mb : changes.removed)
+        desire_set_.beliefRemoved(mb);
+    for(ManagedBelief mb : changes.added)
+        desire_set_.beliefAdded(mb);
+    // function value updates do not affect desire fulfillment, but they might affect preconditions
+    return !changes.empty();
+}
+
+/*
+    React to an alteration of the mirrored belief set: check for satisfied desires and reschedule
+*/
+void Scheduler::onBeliefSetAltered()
+{
+    checkForSatisfiedDesires();//check for satisfied desires
+    if(state_ == SCHEDULING)
+        reschedule();//do a rescheduling
 }
 
 /*  
@@ -591,6 +786,59 @@ void Scheduler::delDesireTopicCallBack(const Desire::SharedPtr msg)
     }
 }
 
+/*  
+    Someone has publish a new set of desires to be fulfilled in the respective topic
+    (desire set is published and post addition behaviour triggered just once for the whole set)
+*/
+void Scheduler::addDesireSetTopicCallBack(const DesireSet::SharedPtr msg)
+{
+    if(msg->agent_id != agent_id_)
+        return;
+
+    optional<ManagedDesire> lastAdded = std::nullopt;
+    for(Desire d : msg->value)
+    {
+        ManagedDesire mdAdd = ManagedDesire{d};
+        if(addDesire(mdAdd))
+            lastAdded = mdAdd;
+    }
+
+    if(lastAdded.has_value())//at least an addition done
+    {   
+        publishDesireSet();
+
+        //call specific methods of SchedulerOffline/SchedulerOnline
+        postAddDesireSuccess(lastAdded.value());
+    }
+}
+
+/*  
+    Someone has publish a set of desires to be removed from the one to be fulfilled (if present)
+    in the respective topic
+*/
+void Scheduler::delDesireSetTopicCallBack(const DesireSet::SharedPtr msg)
+{
+    if(msg->agent_id != agent_id_)
+        return;
+
+    vector<ManagedDesire> deleted;
+    for(Desire d : msg->value)
+    {
+        ManagedDesire mdDel = ManagedDesire{d};
+        if(delDesire(mdDel))
+            deleted.push_back(mdDel);
+    }
+
+    if(deleted.size() > 0)
+    {
+        publishDesireSet();
+        
+        //call specific methods of SchedulerOffline/SchedulerOnline
+        for(ManagedDesire mdDel : deleted)
+            postDelDesireSuccess(mdDel);
+    }
+}
+
 /*
     Add desire Critical Section (to be executed AFTER having acquired mtx_add_del_.lock())
 
@@ -621,6 +869,7 @@ bool Scheduler::addDesireCS(ManagedDesire mdAdd, optional<ManagedDesire> necessa
         }
 
         desire_set_.insert(mdAdd);
+        snapshot_dirty_ = true;
         computed_plan_desire_map_.insert(std::pair<string, int>(mdAdd.getName(), 0));//to count invalid goal computations and discard after x
         aborted_plan_desire_map_.insert(std::pair<string, int>(mdAdd.getName(), 0));//to count invalid goal computations and discard after x
         
@@ -653,7 +902,8 @@ bool Scheduler::delDesireCS(const ManagedDesire mdDel, const bool& wipeSameGroup
 
     if(desire_set_.count(mdDel)!=0)
     {
-        desire_set_.erase(desire_set_.find(mdDel));
+        desire_set_.erase(mdDel);
+        snapshot_dirty_ = true;
         computed_plan_desire_map_.erase(mdDel.getName());
         deleted = true;
         //RCLCPP_INFO(this->get_logger(), "Desire \"" + mdDel.getName() + "\" removed!");
@@ -672,11 +922,7 @@ bool Scheduler::delDesireCS(const ManagedDesire mdDel, const bool& wipeSameGroup
 */
 void Scheduler::delDesireInGroupCS(const string& desireGroup)
 {
-    vector<ManagedDesire> toBeDiscarded;
-
-    for(ManagedDesire md : desire_set_)
-        if(md.getDesireGroup() == desireGroup)
-            toBeDiscarded.push_back(md);
+    vector<ManagedDesire> toBeDiscarded = desire_set_.getByGroup(desireGroup);
     
     for(ManagedDesire md : toBeDiscarded)
         delDesireCS(md, false);//you're already iterating over all the desires within the same group
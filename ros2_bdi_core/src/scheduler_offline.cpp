@@ -1,5 +1,7 @@
 // header file for SchedulerOffline node
 #include "ros2_bdi_core/scheduler_offline.hpp"
+// hooks to spin the node within the agent_core_host process
+#include "ros2_bdi_core/support/hosted_node.hpp"
 // Inner logic + ROS PARAMS & FIXED GLOBAL VALUES for ROS2 core nodes
 #include "ros2_bdi_core/params/core_common_params.hpp"
 // Inner logic + ROS2 PARAMS & FIXED GLOBAL VALUES for Belief Manager node (for plan exec srv & topic)
@@ -73,6 +75,8 @@ void SchedulerOffline::reschedule()
     bool noPlan = noPlanExecuting();
     if(reschedulePolicy == VAL_RESCHEDULE_POLICY_NO_IF_EXEC && !noPlan)//rescheduling not ammitted
         return;
+    if(planExecRequestPending())//waiting for PlanDirector to reply to the last request
+        return;
     
     //rescheduling possible, but plan currently in exec (substitute just for plan with higher priority)
     bool planinExec = reschedulePolicy != VAL_RESCHEDULE_POLICY_NO_IF_EXEC && !noPlan;
@@ -108,7 +112,7 @@ void SchedulerOffline::reschedule()
         
         // select just desires with satisyfing precondition and 
         // with higher or equal priority with respect to the one currently selected
-        bool explicitPreconditionSatisfied = md.getPrecondition().isSatisfied(belief_set_);
+        bool explicitPreconditionSatisfied = md.getPrecondition().isSatisfied(belief_set_.get());
         if(explicitPreconditionSatisfied && md.getPriority() >= highestPriority){
             optional<Plan> opt_p = computePlan(md);
             if(opt_p.has_value())
@@ -205,10 +209,7 @@ void SchedulerOffline::reschedule()
                 
                 // check if this is trying to satisfy precondition and/or context condition of another desire
                 // and there are no other desires within the same group -> delete that desire too
-                int groupCounter = 0;
-                for(ManagedDesire mdCheck : desire_set_)
-                    if(mdCheck.getDesireGroup() == md.getDesireGroup())
-                        groupCounter ++;
+                int groupCounter = desire_set_.countInGroup(md.getDesireGroup());
                 if(md.hasParent() && groupCounter == 0)//invalid desire has remained the last one in the group
                 {
                     discarded_desires.push_back(md.getParent());//parent cannot be satisfied either
@@ -227,14 +228,16 @@ void SchedulerOffline::reschedule()
 
     if(selectedPlan.getActionsExecInfo().size() > 0)
     {
-        bool triggered = tryTriggerPlanExecution(selectedPlan);
-        if(triggered)
-            fulfilling_desire_ = selectedPlan.getFinalTarget();
-        if(this->get_parameter(PARAM_DEBUG).as_bool())
-        {
-            if(triggered) RCLCPP_INFO(this->get_logger(), "Triggered new plan execution success");
-            else RCLCPP_INFO(this->get_logger(), "Triggered new plan execution failed");
-        }
+        ManagedDesire selectedTarget = selectedPlan.getFinalTarget();
+        tryTriggerPlanExecution(selectedPlan, [this, selectedTarget](bool triggered){
+            if(triggered)
+                fulfilling_desire_ = selectedTarget;
+            if(this->get_parameter(PARAM_DEBUG).as_bool())
+            {
+                if(triggered) RCLCPP_INFO(this->get_logger(), "Triggered new plan execution success");
+                else RCLCPP_INFO(this->get_logger(), "Triggered new plan execution failed");
+            }
+        });
     }
 }
 
@@ -294,7 +297,7 @@ void SchedulerOffline::updatePlanExecution(const BDIPlanExecutionInfo::SharedPtr
                         RCLCPP_INFO(this->get_logger(), "Desire \"" + targetDesireName + "\" will be removed because it doesn't seem feasible to fulfill it: too many plan abortions!");
                     delDesire(targetDesire, true);
                 
-                }else if(!targetDesire.getContext().isSatisfied(belief_set_) && this->get_parameter(PARAM_AUTOSUBMIT_CONTEXT).as_bool()){
+                }else if(!targetDesire.getContext().isSatisfied(belief_set_.get()) && this->get_parameter(PARAM_AUTOSUBMIT_CONTEXT).as_bool()){
                     // check for context condition failed 
                     // (just if not already done... that's why you look into the invalid map)
                     // plan exec could have failed cause of them: evaluate if they can be reached and submit the desire to yourself
@@ -347,16 +350,15 @@ void SchedulerOffline::boostDesireTopicCallBack(const ros2_bdi_interfaces::msg::
     {
         // it does match a desire in the desire set which is currently not active, perform offline boost
         bool boosted = false;
-        for(ManagedDesire md : desire_set_)
-            if(md.getName() == mdBoost.getName())
-            {
-                ManagedDesire original_desire = md.clone();
-                boosted = md.boostDesire(mdBoost);
-                if(boosted) // if not boosted, no boosting value
-                    replaceDesire(original_desire, md);
-                
-                break;
-            }
+        optional<ManagedDesire> optMd = desire_set_.getByName(mdBoost.getName());
+        if(optMd.has_value())
+        {
+            ManagedDesire md = optMd.value();
+            ManagedDesire original_desire = md.clone();
+            boosted = md.boostDesire(mdBoost);
+            if(boosted) // if not boosted, no boosting value
+                replaceDesire(original_desire, md);
+        }
     }
     else if (mdBoost.getName() == fulfilling_desire_.getName())
     {
@@ -429,35 +431,31 @@ void SchedulerOffline::checkForSatisfiedDesires()
     mtx_iter_dset_.lock();//to sync between iteration in checkForSatisfiedDesires( ) && reschedule()
 
     vector<ManagedDesire> satisfiedDesires;
-    for(ManagedDesire md : desire_set_)
+    for(ManagedDesire md : desire_set_.getFulfilled())//just desires whose targets are all in the belief set (fulfillment index)
     {   
-        if(isDesireSatisfied(md))//desire already achieved, remove it
+        if(!noPlanExecuting() && current_plan_.getFinalTarget() == md && 
+            current_plan_exec_info_.status == current_plan_exec_info_.RUNNING)  
         {
-            if(!noPlanExecuting() && current_plan_.getFinalTarget() == md && 
-                current_plan_exec_info_.status == current_plan_exec_info_.RUNNING)  
-            {
-                float plan_progress_status = computePlanProgressStatus();
-                
-                if(plan_progress_status < COMPLETED_THRESHOLD)
-                {
-                    if(this->get_parameter(PARAM_DEBUG).as_bool())
-                        RCLCPP_INFO(this->get_logger(), "Current plan execution fulfilling desire \"" + md.getName() + 
-                            "\" will be aborted since desire is already fulfilled and plan exec. is still far from being completed " +
-                            "(progress status = %f)", plan_progress_status);
-
-                    //abort current plan execution since current target desire is already achieved and you're far from completing the plan (missing more than last action)
-                    abortCurrentPlanExecution();   
-                }
-            }
-            else
+            float plan_progress_status = computePlanProgressStatus();
+            
+            if(plan_progress_status < COMPLETED_THRESHOLD && !planExecRequestPending())
             {
                 if(this->get_parameter(PARAM_DEBUG).as_bool())
-                    RCLCPP_INFO(this->get_logger(), "Desire \"" + md.getName() + "\" will be removed from the desire set since its "+
-                        "target appears to be already fulfilled given the current belief set");
-            
-                satisfiedDesires.push_back(md);//delete desire just if not executing one, otherwise will be deleted when aborted feedback comes and desire is satisfied
-            }
+                    RCLCPP_INFO(this->get_logger(), "Current plan execution fulfilling desire \"" + md.getName() + 
+                        "\" will be aborted since desire is already fulfilled and plan exec. is still far from being completed " +
+                        "(progress status = %f)", plan_progress_status);
 
+                //abort current plan execution since current target desire is already achieved and you're far from completing the plan (missing more than last action)
+                abortCurrentPlanExecution();   
+            }
+        }
+        else
+        {
+            if(this->get_parameter(PARAM_DEBUG).as_bool())
+                RCLCPP_INFO(this->get_logger(), "Desire \"" + md.getName() + "\" will be removed from the desire set since its "+
+                    "target appears to be already fulfilled given the current belief set");
+        
+            satisfiedDesires.push_back(md);//delete desire just if not executing one, otherwise will be deleted when aborted feedback comes and desire is satisfied
         }
     }
 
@@ -512,6 +510,23 @@ void SchedulerOffline::postDelDesireSuccess(const BDIManaged::ManagedDesire& md)
 
 
 
+/*
+    SchedulerOffline node to be spinned in the agent_core_host process, together with the other core nodes of the agent
+*/
+HostedNode hostSchedulerOffline()
+{
+  auto node = std::make_shared<SchedulerOffline>();
+  return HostedNode{node,
+    [node](){
+      if(!node->wait_psys2_boot(std::chrono::seconds(8)))//Wait max 8 seconds for plansys2 to boot
+        return false;
+      node->init();
+      return true;
+    },
+    [node](){ node->saveSnapshot(); }};//keep the last desire set for the next warm restart
+}
+
+#ifndef AGENT_CORE_HOST
 int main(int argc, char ** argv)
 {
   rclcpp::init(argc, argv); 
@@ -521,6 +536,7 @@ int main(int argc, char ** argv)
   {
     node->init();
     rclcpp::spin(node);
+    node->saveSnapshot();//keep the last desire set for the next warm restart
   }
   else
   {
@@ -531,3 +547,4 @@ int main(int argc, char ** argv)
 
   return 0;
 }
+#endif
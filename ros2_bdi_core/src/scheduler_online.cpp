@@ -11,6 +11,8 @@
 
 #include "ros2_bdi_interfaces/msg/bdi_plan.hpp"
 
+#include <bitset>
+
 using std::string;
 using std::vector;
 using std::set;
@@ -34,6 +36,7 @@ using ros2_bdi_interfaces::msg::BDIActionExecutionInfo;
 using ros2_bdi_interfaces::msg::BDIPlanExecutionInfo;
 using ros2_bdi_interfaces::msg::BDIActionExecutionInfoMin;
 using ros2_bdi_interfaces::msg::BDIPlanExecutionInfoMin;
+using ros2_bdi_interfaces::msg::IntentionDelta;
 using ros2_bdi_interfaces::msg::BDIPlan;
 using ros2_bdi_interfaces::srv::BDIPlanExecution;
 
@@ -50,6 +53,47 @@ using BDIManaged::ManagedConditionsDNF;
 
 using PlanLibrary::BDIPlanLibrary;
 
+namespace
+{
+    /* Minified exec. info of action @action */
+    BDIActionExecutionInfoMin toMinExecInfo(const BDIActionExecutionInfo& action)
+    {
+        BDIActionExecutionInfoMin ai_min = BDIActionExecutionInfoMin{};
+        ai_min.name = action.name;
+        ai_min.planned_start = action.planned_start;
+        ai_min.progress = action.progress;
+        ai_min.args = action.args;
+        ai_min.committed = action.committed;
+        ai_min.status = action.status;
+        return ai_min;
+    }
+
+    /* True if exec. info of @action differs from the published @ai_min (name, args and planned start never change) */
+    bool execInfoChanged(const BDIActionExecutionInfoMin& ai_min, const BDIActionExecutionInfo& action)
+    {
+        return ai_min.progress != action.progress || ai_min.status != action.status || ai_min.committed != action.committed;
+    }
+
+    /* Committed status of the actions in @cs (bit i of word i/64 for the i-th action) */
+    vector<uint64_t> committedBits(const CommittedStatus& cs)
+    {
+        vector<uint64_t> bits((cs.committed_actions.size() + 63) / 64, 0);
+        for(size_t i = 0; i < cs.committed_actions.size(); i++)
+            if(cs.committed_actions[i].committed)
+                bits[i / 64] |= uint64_t{1} << (i % 64);
+        return bits;
+    }
+
+    /* Number of set bits in @bits & ~@mask */
+    size_t countSetBitsNotIn(const vector<uint64_t>& bits, const vector<uint64_t>& mask)
+    {
+        size_t count = 0;
+        for(size_t w = 0; w < bits.size(); w++)
+            count += std::bitset<64>(bits[w] & ~(w < mask.size()? mask[w] : uint64_t{0})).count();
+        return count;
+    }
+}
+
 
 void SchedulerOnline::init()
 {
@@ -57,7 +101,7 @@ void SchedulerOnline::init()
 
     //init SchedulerOffline specific props
     fulfilling_desire_ = ManagedDesire{};
-    waiting_plans_ = vector<ManagedPlan>();
+    waiting_plans_.clear();
     current_plan_ = ManagedPlan{};
 
     searching_ = false;
@@ -74,7 +118,12 @@ void SchedulerOnline::init()
     // max null search interval ms
     this->declare_parameter(JAVAFF_SEARCH_MAX_EMPTY_SEARCH_INTERVALS_PARAM, JAVAFF_MAX_PPLAN_SIZE_PARAM_DEFAULT);
 
-    javaff_client_ = std::make_shared<JavaFFClient>(string("javaff_srvs_caller"));
+    // ship just the problem deltas to JavaFF
+    this->declare_parameter(JAVAFF_PROBLEM_DELTA_PARAM, JAVAFF_PROBLEM_DELTA_PARAM_DEFAULT);
+
+    // javaff srvs client (non blocking: replies are handled by the executor spinning this node)
+    javaff_client_ = std::make_shared<JavaFFClient>(this);
+    deferred_search_result_ = nullptr;
 
     javaff_search_subscriber_ = this->create_subscription<SearchResult>(
         JAVAFF_SEARCH_TOPIC, rclcpp::QoS(10).reliable(),
@@ -87,6 +136,14 @@ void SchedulerOnline::init()
     
     //javaff_exec_status_publisher_ init
     javaff_exec_status_publisher_ = this->create_publisher<ExecutionStatus>(JAVAFF_EXEC_STATUS_TOPIC, 10);
+
+    //intention delta publisher init (no intention published yet: first publication is going to be a snapshot)
+    intention_delta_publisher_ = this->create_publisher<IntentionDelta>(CURR_INTENTIONS_DELTA_TOPIC, rclcpp::QoS(10).reliable());
+    published_target_ = ManagedDesire{};
+    published_chain_.clear();
+    published_actions_.clear();
+    intention_seq_ = 0;
+    intention_delta_seq_ = 0;
     
     // open connection to plan library and init. tables, if not already present
     planlib_conn_ok_ = planlib_db_.initPlanLibrary();
@@ -105,8 +162,8 @@ void SchedulerOnline::storeEnqueuePlan(BDIManaged::ManagedPlan&mp)
         if(waiting_plans_.size() == 0 && current_plan_.getPlanLibID() >= 0)//mp is successor of current_plan_
             planlib_db_.markSuccessors(current_plan_, mp);
         
-        else if(waitingPlansBack().value().getPlanLibID() >= 0)//mp is successor of current_plan_
-            planlib_db_.markSuccessors(waitingPlansBack().value(), mp);
+        else if(waiting_plans_.size() > 0 && waiting_plans_.front().getPlanLibID() >= 0)//mp is successor of last waiting plan
+            planlib_db_.markSuccessors(waiting_plans_.front(), mp);
     }
     enqueuePlan(mp);
 
@@ -146,6 +203,8 @@ void SchedulerOnline::reschedule()
     bool noPlan = noPlanExecuting();
     if(reschedulePolicy == VAL_RESCHEDULE_POLICY_NO_IF_EXEC && !noPlan)//rescheduling not ammitted
         return;
+    if(planExecRequestPending() || javaff_client_->busy())//waiting for PlanDirector or JavaFF to reply to the last request
+        return;
 
 
     RCLCPP_INFO(this->get_logger(), "Online rescheduling");
@@ -159,11 +218,15 @@ void SchedulerOnline::reschedule()
     for(ManagedDesire md : desire_set_)
     {   
         // FIRST BASIC RESCHEDULING selects highest priority desire which passes acceptance check, precondition check && has the highest priority atm
+        // (desire set is iterated by priority desc., deadline asc. -> the first one passing the checks is the one to be selected)
         TargetBeliefAcceptance validDesire = Scheduler::desireAcceptanceCheck(md);
         if(validDesire == ACCEPTED && 
-            md.getPrecondition().isSatisfied(belief_set_) && 
+            md.getPrecondition().isSatisfied(belief_set_.get()) && 
             md.getPriority() > selDesire.getPriority())
+        {
             selDesire = md;
+            break;
+        }
         
         else if(validDesire == UNKNOWN_INSTANCES)
         {
@@ -187,24 +250,29 @@ void SchedulerOnline::reschedule()
     else if(reschedulePolicy == VAL_RESCHEDULE_POLICY_IF_EXEC_CLEAN && !noPlanExecuting())//clean preemption needed
     {
         waiting_plans_.clear(); // clear waiting queue immediately
-        bool ear = makeEarlyArrestRequest(current_plan_.getActionCommittedStatus());
-        if(ear)
-            waiting_clean_preempt_ = true;
-        RCLCPP_INFO(this->get_logger(), "Clean preemption to stop execution of plan for the fullfillment of Alex's desire to " + current_plan_.getFinalTarget().getName() + 
-            " before starting to launch a search for the fullfillment of Alex's desire to " + selDesire.getName() + 
-            " (early arrest request = " + std::to_string(ear) + ")");
+        string currentTargetName = current_plan_.getFinalTarget().getName();
+        makeEarlyArrestRequest(current_plan_.getActionCommittedStatus(), [this, currentTargetName, selDesire](bool ear){
+            if(ear)
+                waiting_clean_preempt_ = true;
+            RCLCPP_INFO(this->get_logger(), "Clean preemption to stop execution of plan for the fullfillment of Alex's desire to " + currentTargetName + 
+                " before starting to launch a search for the fullfillment of Alex's desire to " + selDesire.getName() + 
+                " (early arrest request = " + std::to_string(ear) + ")");
+        });
         return;
     }
 
     RCLCPP_INFO(this->get_logger(), "Starting search for the fullfillment of Alex's desire to " + selDesire.getName());
 
-    if(selDesire.getValue().size() > 0 && launchPlanSearch(selDesire))//a desire has effectively been selected && a search for it has been launched
-    {    
-        searching_ = true;
-        search_baseline_ = emptySearchBaseline();
-        RCLCPP_INFO(this->get_logger(), "Search started for the fullfillment of Alex's desire to " + selDesire.getName());
-        fulfilling_desire_ = selDesire; 
-    }
+    if(selDesire.getValue().size() > 0)//a desire has effectively been selected
+        launchPlanSearch(selDesire, [this, selDesire](bool accepted){
+            if(!accepted)
+                return;
+            // a search for it has been launched
+            searching_ = true;
+            setSearchBaseline(emptySearchBaseline());
+            RCLCPP_INFO(this->get_logger(), "Search started for the fullfillment of Alex's desire to " + selDesire.getName());
+            fulfilling_desire_ = selDesire; 
+        });
 }
 
 void SchedulerOnline::abortedPlanHandler(const bool handleDelete)
@@ -248,11 +316,13 @@ void SchedulerOnline::planCompFailureHandler(const BDIManaged::ManagedDesire& md
 */
 void SchedulerOnline::resetSearchInfo()
 {
+    javaff_client_->cancel();//replies to requests made for the previous search are not relevant anymore
+    deferred_search_result_ = nullptr;
     fulfilling_desire_ = ManagedDesire{};
     current_plan_ = ManagedPlan{};//no plan executing rn
-    waiting_plans_ = vector<ManagedPlan>();
+    waiting_plans_.clear();
     searching_ = false;//saluti da T.V.
-    search_baseline_ = emptySearchBaseline();
+    setSearchBaseline(emptySearchBaseline());
     executing_pplan_index_ = -1;//will be put to 0 as soon as next first computed and received pplan is launched for execution and then upd over time 
 
 }
@@ -266,37 +336,105 @@ void SchedulerOnline::forcedReschedule()
     reschedule();
 }
 
+/*
+    Publish current intention, i.e. current plan followed by the waiting ones in execution order:
+    a whole (latched) snapshot when the chain of plans has changed or MAX_INTENTION_DELTAS_PER_SNAPSHOT deltas have followed the last one,
+    otherwise just a delta wrt. the intention subscribers know
+    (plans dequeued from its head, plans appended to its tail, actions whose status/committed flag/progress has changed)
+*/
 void SchedulerOnline::publishCurrentIntention()
-{   
-    BDIPlanExecutionInfoMin intentionMsg = BDIPlanExecutionInfoMin{};
-    for(auto target_value : current_plan_.getFinalTarget().getValue())
-        intentionMsg.target_value.push_back(target_value.toBelief());
+{
+    // plans the intention is made of (the empty ones do not contribute to it)
+    vector<const ManagedPlan*> chain;
+    if(current_plan_.getActionsExecInfo().size() > 0)
+        chain.push_back(&current_plan_);
+    for(int i = waiting_plans_.size() - 1; i >= 0; i--)
+        if(waiting_plans_[i].getActionsExecInfo().size() > 0)
+            chain.push_back(&waiting_plans_[i]);
+
+    // find how many plans have been dequeued from the head of the published chain, i.e. the shortest head
+    // to be dropped so that the rest of the published chain is the head of the current one
+    size_t dequeued = published_chain_.size();
+    for(size_t d = 0; d < published_chain_.size() && dequeued == published_chain_.size(); d++)
+    {
+        bool head_match = published_chain_.size() - d <= chain.size();
+        for(size_t k = 0; head_match && d + k < published_chain_.size(); k++)
+            head_match = published_chain_[d + k].action_table == chain[k]->getSharedActionTable() &&
+                published_chain_[d + k].n_actions == chain[k]->getActionsExecInfo().size();
+        if(head_match)
+            dequeued = d;
+    }
 
-    for(auto action : current_plan_.getActionsExecInfo())
+    // snapshot when there is no intention known by subscribers to start from (first one, different target, none of its plans left)
+    // or when enough deltas have followed the last one (subscribers which joined late or missed a delta can realign on it)
+    if(intention_seq_ == 0 || !(current_plan_.getFinalTarget() == published_target_) ||
+            (published_chain_.size() > 0 && dequeued == published_chain_.size()) ||
+            intention_delta_seq_ >= MAX_INTENTION_DELTAS_PER_SNAPSHOT)
     {
-        BDIActionExecutionInfoMin ai_min = BDIActionExecutionInfoMin{};
-        ai_min.name = action.name;
-        ai_min.planned_start = action.planned_start;
-        ai_min.progress = action.progress;
-        ai_min.args = action.args;
-        ai_min.committed = action.committed;
-        ai_min.status = action.status;
-        intentionMsg.actions_exec_info.push_back(ai_min);
+        publishIntentionSnapshot(chain);
+        return;
+    }
+
+    IntentionDelta delta = IntentionDelta{};
+    delta.seq = intention_seq_;
+    delta.dequeued = 0;
+    for(size_t d = 0; d < dequeued; d++)
+    {
+        delta.dequeued += published_chain_.front().n_actions;
+        published_actions_.erase(published_actions_.begin(), published_actions_.begin() + published_chain_.front().n_actions);
+        published_chain_.pop_front();
+    }
+
+    // just the actions of the head plan can change (waiting plans are untouched till they're dequeued)
+    if(published_chain_.size() > 0)
+    {
+        const vector<BDIActionExecutionInfo>& head_actions = chain[0]->getActionsExecInfo();
+        for(size_t i = 0; i < head_actions.size(); i++)
+            if(execInfoChanged(published_actions_[i], head_actions[i]))
+            {
+                published_actions_[i] = toMinExecInfo(head_actions[i]);
+                delta.updated_indexes.push_back(i);
+                delta.updated.push_back(published_actions_[i]);
+            }
+    }
+
+    for(size_t k = published_chain_.size(); k < chain.size(); k++)
+    {
+        published_chain_.push_back(PublishedPlan{chain[k]->getSharedActionTable(), chain[k]->getActionsExecInfo().size()});
+        for(const BDIActionExecutionInfo& action : chain[k]->getActionsExecInfo())
+        {
+            published_actions_.push_back(toMinExecInfo(action));
+            delta.appended.push_back(published_actions_.back());
+        }
+    }
+
+    if(delta.dequeued > 0 || delta.updated.size() > 0 || delta.appended.size() > 0)
+    {
+        delta.delta_seq = ++intention_delta_seq_;
+        intention_delta_publisher_->publish(delta);
     }
+}
+
+/* Publish @chain of plans as a new intention snapshot, resetting the published intention to it */
+void SchedulerOnline::publishIntentionSnapshot(const vector<const ManagedPlan*>& chain)
+{
+    published_target_ = current_plan_.getFinalTarget();
+    published_chain_.clear();
+    published_actions_.clear();
+
+    BDIPlanExecutionInfoMin intentionMsg = BDIPlanExecutionInfoMin{};
+    intentionMsg.seq = ++intention_seq_;
+    intention_delta_seq_ = 0;
+    for(auto target_value : published_target_.getValue())
+        intentionMsg.target_value.push_back(target_value.toBelief());
 
-    for(int i = waiting_plans_.size() - 1; i >=0; i--)
+    for(const ManagedPlan* plan : chain)
     {
-        auto plan = waiting_plans_[i];
-        for(auto action : plan.getActionsExecInfo())
+        published_chain_.push_back(PublishedPlan{plan->getSharedActionTable(), plan->getActionsExecInfo().size()});
+        for(const BDIActionExecutionInfo& action : plan->getActionsExecInfo())
         {
-            BDIActionExecutionInfoMin ai_min = BDIActionExecutionInfoMin{};
-            ai_min.name = action.name;
-            ai_min.planned_start = action.planned_start;
-            ai_min.progress = action.progress;
-            ai_min.args = action.args;
-            ai_min.committed = action.committed;
-            ai_min.status = action.status;
-            intentionMsg.actions_exec_info.push_back(ai_min);
+            published_actions_.push_back(toMinExecInfo(action));
+            intentionMsg.actions_exec_info.push_back(published_actions_.back());
         }
     }
 
@@ -340,8 +478,6 @@ void SchedulerOnline::updatePlanExecution(const BDIPlanExecutionInfo::SharedPtr
                 return;
             }
             
-            bool callUnexpectedState = false;
-
             if(planExecInfo.status == planExecInfo.SUCCESSFUL)//plan exec completed successful
             {
                 current_plan_ = ManagedPlan{};//no plan executing rn
@@ -353,25 +489,31 @@ void SchedulerOnline::updatePlanExecution(const BDIPlanExecutionInfo::SharedPtr
                     //launch plan execution
                     if(nextPPlanToExec.has_value() && nextPPlanToExec.value().getActionsExecInfo().size() > 0)
                     {
-                        bool triggeredNewPlanExec;
-                        triggeredNewPlanExec = tryTriggerPlanExecution(nextPPlanToExec.value());
-                        if(triggeredNewPlanExec)
-                            executing_pplan_index_ = nextPPlanToExec.value().getPlanQueueIndex();
-                        callUnexpectedState = !triggeredNewPlanExec;//if failed, call unexpected state srv
-                        
-                        if(this->get_parameter(PARAM_DEBUG).as_bool())
-                        {
-                            string plan_queue_indexes = "";
-                            for(int i=0; i<waiting_plans_.size(); i++)
-                                plan_queue_indexes += std::to_string(waiting_plans_[i].getPlanQueueIndex()) + ", ";
+                        int16_t nextPPlanIndex = nextPPlanToExec.value().getPlanQueueIndex();
+                        tryTriggerPlanExecution(nextPPlanToExec.value(), [this, nextPPlanIndex](bool triggeredNewPlanExec){
                             if(triggeredNewPlanExec)
-                                RCLCPP_INFO(this->get_logger(), "Started plan with index " + std::to_string(executing_pplan_index_) + "\n" + 
-                                                    " Current waiting queue status: " + plan_queue_indexes + "\"");
-                            else
-                                RCLCPP_INFO(this->get_logger(), "Failed to start new plan with index " + std::to_string(nextPPlanToExec.value().getPlanQueueIndex()) + "\n" +
-                                                    " Calling unexpectedState service\n" + 
-                                                    " Current waiting queue status: " + plan_queue_indexes + "\"");
-                        }
+                                executing_pplan_index_ = nextPPlanIndex;
+                            
+                            if(this->get_parameter(PARAM_DEBUG).as_bool())
+                            {
+                                string plan_queue_indexes = "";
+                                for(int i=0; i<waiting_plans_.size(); i++)
+                                    plan_queue_indexes += std::to_string(waiting_plans_[i].getPlanQueueIndex()) + ", ";
+                                if(triggeredNewPlanExec)
+                                    RCLCPP_INFO(this->get_logger(), "Started plan with index " + std::to_string(executing_pplan_index_) + "\n" + 
+                                                        " Current waiting queue status: " + plan_queue_indexes + "\"");
+                                else
+                                    RCLCPP_INFO(this->get_logger(), "Failed to start new plan with index " + std::to_string(nextPPlanIndex) + "\n" +
+                                                        " Calling unexpectedState service\n" + 
+                                                        " Current waiting queue status: " + plan_queue_indexes + "\"");
+                            }
+
+                            if(!triggeredNewPlanExec)//if failed, call unexpected state srv
+                            {
+                                abortedPlanHandler();//increment counter for aborted plans that aimed at fulfilling desire x
+                                handleUnexpectedState();
+                            }
+                        });
                     }
                 }
                 else if(!searching_)
@@ -385,27 +527,46 @@ void SchedulerOnline::updatePlanExecution(const BDIPlanExecutionInfo::SharedPtr
                 }
             }
 
-            if(!desireAchieved && (callUnexpectedState || planExecInfo.status == planExecInfo.ABORT))
+            if(planExecInfo.status == planExecInfo.ABORT)//n.b. desire not achieved here
             {
-                callUnexpectedState = true;
                 abortedPlanHandler();//increment counter for aborted plans that aimed at fulfilling desire x
+                handleUnexpectedState();
             }
+        }
+    }
+}
 
-            if(callUnexpectedState)//handle the following with unexpected state srv
-            {   
-                publishTargetGoalInfo(DEL_GOAL_BELIEFS);
-                fulfilling_desire_ = ManagedDesire{};
-                //tmp cleaning //TODO need to be revised this after having fixed search full reset 
-                current_plan_ = ManagedPlan{};//no plan executing rn
-                waiting_plans_ = vector<ManagedPlan>();
-                executing_pplan_index_ = -1;//will be put to 0 as soon as next first computed and received pplan is launched for execution and then upd over time 
-                search_baseline_ = emptySearchBaseline();
-                searching_ = javaff_client_->callUnexpectedStateSrv(problem_expert_->getProblem());
+/*
+    Current plan cannot go on: drop it together with the waiting ones and let JavaFF handle the unexpected state (via srv),
+    reschedule from scratch if it can't
+*/
+void SchedulerOnline::handleUnexpectedState()
+{
+    publishTargetGoalInfo(DEL_GOAL_BELIEFS);
+    fulfilling_desire_ = ManagedDesire{};
+    //tmp cleaning //TODO need to be revised this after having fixed search full reset 
+    current_plan_ = ManagedPlan{};//no plan executing rn
+    waiting_plans_.clear();
+    executing_pplan_index_ = -1;//will be put to 0 as soon as next first computed and received pplan is launched for execution and then upd over time 
+    setSearchBaseline(emptySearchBaseline());
+    string problem = problemForPlanner(planner_problem_.goal());
+    bool isDelta = PlannerProblemDelta::isDelta(problem);
+    javaff_client_->callUnexpectedStateSrv(problem, [this, isDelta](bool handled){
+        if(!handled && isDelta)
+        {
+            // JavaFF out of sync wrt. the delta: fall back to the full problem
+            planner_problem_.reset();
+            javaff_client_->callUnexpectedStateSrv(problemForPlanner(planner_problem_.goal()), [this](bool handled){
+                searching_ = handled;
                 if(!searching_)
                     forcedReschedule();//if service call failed, just reschedule from scratch solution!!!
-            }
+            });
+            return;
         }
-    }
+        searching_ = handled;
+        if(!searching_)
+            forcedReschedule();//if service call failed, just reschedule from scratch solution!!!
+    });
 }
 
 /* 
@@ -426,16 +587,15 @@ int SchedulerOnline::compareBaseline(javaff_interfaces::msg::CommittedStatus sb)
     if(search_baseline_.committed_actions.size() != sb.committed_actions.size()) // diff plans' sizes
         return 1;//should be a different plan, more updated one: check this better in the future, but it should be the right assumption
     
-    //count additional committed el in sb and search_baseline_
-    int diff_committed1 = 0, diff_committed2 = 0;
-    for(int i = 0; i < search_baseline_.committed_actions.size(); i++)//check action by action committed status
+    //check action by action that they're the same ones
+    for(int i = 0; i < search_baseline_.committed_actions.size(); i++)
         if(search_baseline_.committed_actions[i].committed_action != sb.committed_actions[i].committed_action || search_baseline_.committed_actions[i].planned_start_time != sb.committed_actions[i].planned_start_time)
             return 1;//should be a different plan, more updated one: check this better in the future, but it should be the right assumption
-        else if(search_baseline_.committed_actions[i].committed != sb.committed_actions[i].committed)
-        {
-            diff_committed1 += search_baseline_.committed_actions[i].committed? 1 : 0;
-            diff_committed2 += sb.committed_actions[i].committed? 1 : 0;
-        }
+
+    //count additional committed el in sb and search_baseline_ (word by word over their committed bits)
+    vector<uint64_t> sb_committed = committedBits(sb);
+    int diff_committed1 = countSetBitsNotIn(search_baseline_committed_, sb_committed);
+    int diff_committed2 = countSetBitsNotIn(sb_committed, search_baseline_committed_);
     
     // std::cout << "compareBaseline: search_baseline_.commit+ = " << diff_committed1 
     //     << "\t sb.commit+ = " << diff_committed2 << std::flush << std::endl;
@@ -450,11 +610,25 @@ int SchedulerOnline::compareBaseline(javaff_interfaces::msg::CommittedStatus sb)
         return 0; // matching baselines
 }
 
+/* Set @sb as current search baseline, keeping its committed status as bits for comparing it with the next ones */
+void SchedulerOnline::setSearchBaseline(const CommittedStatus& sb)
+{
+    search_baseline_ = sb;
+    search_baseline_committed_ = committedBits(sb);
+}
+
 /*
-    Received update on current plan search
+    Received update on current plan search: put aside while waiting for PlanDirector to reply to a request,
+    since the reply can change the plan in execution the search result is compared with
 */
 void SchedulerOnline::updatedSearchResult(const SearchResult::SharedPtr msg)
 {
+    if(planExecRequestPending())
+    {
+        deferred_search_result_ = msg;//search results are cumulative: just the last one matters
+        return;
+    }
+
     int more_upd_baseline = compareBaseline(msg->search_baseline); //-1 less upd, 0 matching_baseline, 1 more upd
     bool matching_baseline = more_upd_baseline == 0;// baselines are at the same level
     if(!matching_baseline && more_upd_baseline >= 0)// search baseline is NOT matching with previously received search result and is not less recent
@@ -478,7 +652,7 @@ void SchedulerOnline::updatedSearchResult(const SearchResult::SharedPtr msg)
             {
                 // plan executing -> force clean arrest (i.e. early arrest of current plan)
                 waiting_plans_.clear(); // clear waiting queue immediately
-                bool ear = makeEarlyArrestRequest(current_plan_.getActionCommittedStatus());
+                makeEarlyArrestRequest(current_plan_.getActionCommittedStatus(), nullptr);
                 waiting_clean_preempt_ = true;// don't care if ear is false -> simply stop at the end of current plan (since waiting has been erased)
             }
         }
@@ -487,28 +661,52 @@ void SchedulerOnline::updatedSearchResult(const SearchResult::SharedPtr msg)
             //search is progressing
             if(!noPlanExecuting() && !current_plan_.getFinalTarget().equalsOrSupersetIgnoreAdvancedInfo(fulfilling_desire_))//started a new search for a different desire -> should abort old executing plan
             {    
-                if(abortCurrentPlanExecution())//if aborted is correctly performed, clean away the current waiting list as well, exploiting new msg to build the new one, for new instantiated search
-                    resetSearchInfo();
+                abortCurrentPlanExecution([this, msg, more_upd_baseline](bool aborted){
+                    if(aborted)//if aborted is correctly performed, clean away the current waiting list as well, exploiting new msg to build the new one, for new instantiated search
+                        resetSearchInfo();
+                    processSearchResult(msg, more_upd_baseline);
+                });
+                return;
             }
 
-            if(matching_baseline) // search baseline is matching with previously received search result
-            {
-                // received incremental plans obtained through "search from scratch" or search with same search base line as last enqueued plan
-                processIncrementalSearchResult(msg);
-            }
-            else if(more_upd_baseline == 1) // msg->search_baseline MORE_RECENT THAN search_baseline_
-            {   
-                // search baseline is NOT matching with previously received search results
-                // received sub plan with a different search baseline wrt previous notification
-                if(processSearchResultWithNewBaseline(msg))
-                    search_baseline_ = msg->search_baseline;//update search baseline
-                // javaff will stop curr search via exec status because it is too late compared to current exec status
-            }
-            
+            processSearchResult(msg, more_upd_baseline);
         }
     }   
 }
 
+/*
+    Process progressing search result @msg, whose search baseline compared to the current one is @more_upd_baseline
+*/
+void SchedulerOnline::processSearchResult(const SearchResult::SharedPtr msg, const int& more_upd_baseline)
+{
+    if(more_upd_baseline == 0) // search baseline is matching with previously received search result
+    {
+        // received incremental plans obtained through "search from scratch" or search with same search base line as last enqueued plan
+        processIncrementalSearchResult(msg);
+    }
+    else if(more_upd_baseline == 1) // msg->search_baseline MORE_RECENT THAN search_baseline_
+    {   
+        // search baseline is NOT matching with previously received search results
+        // received sub plan with a different search baseline wrt previous notification (search baseline updated if accepted)
+        processSearchResultWithNewBaseline(msg);
+        // javaff will stop curr search via exec status because it is too late compared to current exec status
+    }
+}
+
+/*
+    A reply from PlanDirector has been handled: process plan execution updates and search result put aside meanwhile
+*/
+void SchedulerOnline::planExecRequestCompleted()
+{
+    Scheduler::planExecRequestCompleted();
+    if(!planExecRequestPending() && deferred_search_result_ != nullptr)
+    {
+        SearchResult::SharedPtr msg = deferred_search_result_;
+        deferred_search_result_ = nullptr;
+        updatedSearchResult(msg);
+    }
+}
+
 /*
     Received update on current committed status for plan execution
 */
@@ -535,30 +733,27 @@ void SchedulerOnline::updatedCommittedStatus(const javaff_interfaces::msg::Commi
 */
 void SchedulerOnline::processIncrementalSearchResult(const javaff_interfaces::msg::SearchResult::SharedPtr msg)
 {
-    int i = 0;
     // store incremental partial plans 
     // as soon as you have the first, trigger plan execution
-    int highestPPlanId = (waitingPlansBack().has_value())? waitingPlansBack().value().getPlanQueueIndex() : executing_pplan_index_;
-    while(i<msg->plans.size() && msg->plans[i].plan.plan_index <= highestPPlanId){i++;}//go over all the search result till you reach the new ones
+    int highestPPlanId = highestPPlanIndex();
+    size_t i = firstNewPPlan(msg->plans, highestPPlanId);//go straight to the new ones, the others have already been processed
+    if(i == msg->plans.size() || msg->plans[i].plan.items.size() == 0)
+        return;//nothing new (e.g. stale or repeated search result)
     //TODO check for plan exec and waiting queue inconsistencies, if detected, take action
 
-    if(noPlanExecuting() && i<msg->plans.size() && msg->plans[i].plan.items.size() > 0)
+    if(noPlanExecuting())
     {  
-        bool launched = (launchFirstPPlanExecution(msg->plans[i]));
-        if(launched)
-            publishCurrentIntention();
-    }else if(msg->plans[i].plan.items.size() > 0){
+        launchFirstPPlanExecution(msg->plans[i], [this](bool launched){
+            if(launched)
+                publishCurrentIntention();
+        });
+    }else{
         bool enqueuedSomething = false;
-        for(; i<msg->plans.size(); i++)//avoid considering first pplan which is demanded for execution in the if branch above
+        for(; i<msg->plans.size(); i++)//just the new pplans, each with a higher index than the previous one
         {
-            highestPPlanId = (waitingPlansBack().has_value())? waitingPlansBack().value().getPlanQueueIndex() : executing_pplan_index_;
-            //to be enqueued must be higher than last waiting plan in queue or if queue is empty must be higher than the one currently in execution
-            if(msg->plans[i].plan.plan_index > highestPPlanId)//should be enqueued
-            {
-                ManagedPlan computedMPP = ManagedPlan{msg->plans[i].plan.plan_index, fulfilling_desire_, ManagedDesire{msg->plans[i].target}, msg->plans[i].plan.items, ManagedConditionsDNF{msg->plans[i].target.precondition}, fulfilling_desire_.getContext()};
-                storeEnqueuePlan(computedMPP);
-                enqueuedSomething = true;
-            }
+            ManagedPlan computedMPP = ManagedPlan{msg->plans[i].plan.plan_index, fulfilling_desire_, ManagedDesire{msg->plans[i].target}, msg->plans[i].plan.items, ManagedConditionsDNF{msg->plans[i].target.precondition}, fulfilling_desire_.getContext()};
+            storeEnqueuePlan(computedMPP);
+            enqueuedSomething = true;
         }
         if(enqueuedSomething)
             publishCurrentIntention();
@@ -566,7 +761,8 @@ void SchedulerOnline::processIncrementalSearchResult(const javaff_interfaces::ms
     }
 }
 
-bool SchedulerOnline::launchFirstPPlanExecution(const PartialPlan& firstpplan)
+/* Launch first partial plan execution of a queue of plans which are going to be stored in the waiting list, @onDone notified with true if launched */
+void SchedulerOnline::launchFirstPPlanExecution(const PartialPlan& firstpplan, const std::function<void(bool)>& onDone)
 {
     // insert subplan precondition as received by planner, desire precondition checked in scheduling
     ManagedPlan firstPPlanToExec = ManagedPlan{
@@ -574,11 +770,16 @@ bool SchedulerOnline::launchFirstPPlanExecution(const PartialPlan& firstpplan)
         fulfilling_desire_, 
         ManagedDesire{firstpplan.target}, firstpplan.plan.items, 
         ManagedConditionsDNF{firstpplan.target.precondition}, fulfilling_desire_.getContext()};
+    if(firstPPlanToExec.getActionsExecInfo().size() == 0)
+    {
+        onDone(false);
+        return;
+    }
+
     //launch plan execution
-    if(firstPPlanToExec.getActionsExecInfo().size() > 0)
-    {   
-        storePlan(firstPPlanToExec);
-        bool triggered = tryTriggerPlanExecution(firstPPlanToExec);
+    storePlan(firstPPlanToExec);
+    int16_t firstPPlanIndex = firstPPlanToExec.getPlanQueueIndex();
+    tryTriggerPlanExecution(firstPPlanToExec, [this, firstPPlanIndex, onDone](bool triggered){
         if(this->get_parameter(PARAM_DEBUG).as_bool())
         {
             if(triggered) RCLCPP_INFO(this->get_logger(), "Triggered new plan execution success");
@@ -589,24 +790,19 @@ bool SchedulerOnline::launchFirstPPlanExecution(const PartialPlan& firstpplan)
         {
             abortedPlanHandler();
             forcedReschedule();
-            return false;
         }
         else
-            executing_pplan_index_ = firstPPlanToExec.getPlanQueueIndex();
-    }
-    else
-        return false;
-
-    return true;
+            executing_pplan_index_ = firstPPlanIndex;
+        onDone(triggered);
+    });
 }
 
 /* 
-    Request to make an early stop at a certain committed point
+    Request to make an early stop at a certain committed point, @onDone (if any) notified with true if accepted
     NOTE: committedPlan has to be extracted from current_plan_ otherwise request is going to fail for sure
 */
-bool SchedulerOnline::makeEarlyArrestRequest(const plansys2_msgs::msg::Plan& committedPlan)
+void SchedulerOnline::makeEarlyArrestRequest(const plansys2_msgs::msg::Plan& committedPlan, const std::function<void(bool)>& onDone)
 {
-    bool early_abort_request_success = false;
     BDIPlan early_abort_bdiplan = BDIPlan{};
     early_abort_bdiplan.target = current_plan_.getPlanTarget().toDesire();
     early_abort_bdiplan.precondition = current_plan_.getPrecondition().toConditionsDNF();
@@ -621,107 +817,146 @@ bool SchedulerOnline::makeEarlyArrestRequest(const plansys2_msgs::msg::Plan& com
     }
 
     early_abort_bdiplan.context = current_plan_.getContext().toConditionsDNF();
-    early_abort_request_success = plan_exec_srv_client_->earlyArrestRequest(early_abort_bdiplan);
-    if(this->get_parameter(PARAM_DEBUG).as_bool())
-        if(early_abort_request_success) RCLCPP_INFO(this->get_logger(), "Early arrest request: ACCEPTED");
-        else RCLCPP_INFO(this->get_logger(), "Early arrest request: TOO LATE!");
-    
-    return early_abort_request_success;
+    plan_exec_srv_client_->earlyArrestRequest(early_abort_bdiplan, [this, onDone](bool early_abort_request_success){
+        if(this->get_parameter(PARAM_DEBUG).as_bool())
+            if(early_abort_request_success) RCLCPP_INFO(this->get_logger(), "Early arrest request: ACCEPTED");
+            else RCLCPP_INFO(this->get_logger(), "Early arrest request: TOO LATE!");
+        
+        if(onDone)
+            onDone(early_abort_request_success);
+        planExecRequestCompleted();
+    });
 }
 
 /*
     Process updated search result presenting a new search baseline compared to previous msgs of the same type
 */
-bool SchedulerOnline::processSearchResultWithNewBaseline(const javaff_interfaces::msg::SearchResult::SharedPtr msg)
+void SchedulerOnline::processSearchResultWithNewBaseline(const javaff_interfaces::msg::SearchResult::SharedPtr msg)
 {
     // processSearchResultWithNewBaseline
     //      check if still feasible wrt. search_baseline and request early abort.
     //      If early abort success -> replace waiting_plan with new search result
 
-    Plan psys2_current_plan = current_plan_.toPsys2Plan();
+    size_t n_actions = current_plan_.getActionTable().size();
 
-    if(psys2_current_plan.items.size() > 0 && psys2_current_plan.items.size() != msg->search_baseline.committed_actions.size())
+    if(n_actions > 0 && n_actions != msg->search_baseline.committed_actions.size())
     {
-        return false; // plans do not match: cannot be handled
+        return; // plans do not match: cannot be handled
     }
     
-    // std::cout << "SchedulerOnline::processSearchResultWithNewBaseline\npindex: " << std::to_string(msg->search_baseline.executing_plan_index) << std::flush << std::endl;
-    // for(int i=0; i<msg->search_baseline.committed_actions.size(); i++)
-    // {
-    //     std::cout <<  "- " << msg->search_baseline.committed_actions[i].committed_action << ":" << 
-    //         std::to_string(static_cast<int>(msg->search_baseline.committed_actions[i].planned_start_time*1000)) <<
-    //         "\t" << std::to_string(msg->search_baseline.committed_actions[i].committed) << std::flush << std::endl;
-    // }
-    
-    int committed_counter = 0;
-    for(int i=0; i<psys2_current_plan.items.size(); i++)
-    {
-        psys2_current_plan.items[i].committed = msg->search_baseline.committed_actions[i].committed;
-        if(psys2_current_plan.items[i].committed)
-            committed_counter++;
-    }
-
-    bool successful_update = false;// it was possible to process successfully the search result with new baseline (i.e. not too late)
+    // committed status of current plan actions wrt. the new search baseline
+    vector<uint64_t> baseline_committed = committedBits(msg->search_baseline);
+    size_t committed_counter = n_actions > 0? countSetBitsNotIn(baseline_committed, {}) : 0;
 
-    bool early_abort_request_success = false; // early abort success result
-    if(committed_counter < psys2_current_plan.items.size())
+    if(committed_counter < n_actions)
     {
         //in this case it make sense to do an early abort request
-        early_abort_request_success = makeEarlyArrestRequest(psys2_current_plan);
+        makeEarlyArrestRequest(current_plan_.getActionCommittedStatus(baseline_committed), [this, msg](bool early_abort_request_success){
+            if(early_abort_request_success)
+                applySearchResultWithNewBaseline(msg);
+        });
     }
+    else
+        applySearchResultWithNewBaseline(msg);
+}
 
-    if(committed_counter == psys2_current_plan.items.size() || early_abort_request_success)
-    {
-        successful_update = true;
-        int i = msg->base_plan_index;
-
-        if(noPlanExecuting() && msg->plans[i].plan.items.size() > 0)
-        {  
-            successful_update = launchFirstPPlanExecution(msg->plans[i]); 
-            i++;
-        }
+/*
+    Search result @msg with new search baseline accepted (i.e. not too late): 
+    replace the waiting queue with its partial plans (launching the first one if no plan is executing) and update the search baseline
+*/
+void SchedulerOnline::applySearchResultWithNewBaseline(const javaff_interfaces::msg::SearchResult::SharedPtr msg)
+{
+    int i = msg->base_plan_index;
 
-        if(successful_update)
+    // substitute waiting queue with partial plans in msg from the @first one on
+    auto replaceWaitingPlans = [this, msg](int first){
+        waiting_plans_.clear();
+        for(int i = first; i < msg->plans.size(); i++)
         {
-            // substitute waiting queue
-            waiting_plans_.clear();
-            while(i < msg->plans.size())
-            {
-                ManagedPlan computedMPP = ManagedPlan{msg->plans[i].plan.plan_index, 
-                    fulfilling_desire_, 
-                    ManagedDesire{msg->plans[i].target}, msg->plans[i].plan.items, 
-                    ManagedConditionsDNF{msg->plans[i].target.precondition}, 
-                    fulfilling_desire_.getContext()};
-                storeEnqueuePlan(computedMPP);
-                i++;
-            }
+            ManagedPlan computedMPP = ManagedPlan{msg->plans[i].plan.plan_index, 
+                fulfilling_desire_, 
+                ManagedDesire{msg->plans[i].target}, msg->plans[i].plan.items, 
+                ManagedConditionsDNF{msg->plans[i].target.precondition}, 
+                fulfilling_desire_.getContext()};
+            storeEnqueuePlan(computedMPP);
         }
-        
+        setSearchBaseline(msg->search_baseline);//update search baseline
+    };
+
+    if(noPlanExecuting() && i < msg->plans.size() && msg->plans[i].plan.items.size() > 0)
+    {  
+        launchFirstPPlanExecution(msg->plans[i], [replaceWaitingPlans, i](bool launched){
+            if(launched)
+                replaceWaitingPlans(i + 1);
+        }); 
+        return;
     }
 
-    return successful_update;
+    replaceWaitingPlans(i);
 }
 
 
 /*
-    Launch a new plan search
+    Launch a new plan search, @onDone notified with true if accepted by JavaFF
 */
-bool SchedulerOnline::launchPlanSearch(const BDIManaged::ManagedDesire& selDesire)
+void SchedulerOnline::launchPlanSearch(const BDIManaged::ManagedDesire& selDesire, const std::function<void(bool)>& onDone)
 {
     //set desire as goal of the pddl_problem
-    if(!problem_expert_->setGoal(Goal{BDIPDDLConverter::desireToGoal(selDesire.toDesire())})){
+    string goal = BDIPDDLConverter::desireToGoal(selDesire.toDesire());
+    if(!problem_expert_->setGoal(Goal{goal})){
         //psys2_comm_errors_++;//plansys2 comm. errors
-        return false;
+        onDone(false);
+        return;
     }
 
-    string pddl_problem = problem_expert_->getProblem();//get problem string
     int intervalSearchMS = this->get_parameter(JAVAFF_SEARCH_INTERVAL_PARAM).as_int();
     int maxPPlanSize = this->get_parameter(JAVAFF_MAX_PPLAN_SIZE_PARAM).as_int();
     int maxEmptySearchIntervals = this->get_parameter(JAVAFF_SEARCH_MAX_EMPTY_SEARCH_INTERVALS_PARAM).as_int();
     intervalSearchMS = intervalSearchMS >= 100? intervalSearchMS : 100;
     maxPPlanSize = maxPPlanSize > 0? maxPPlanSize : 32000;
     maxEmptySearchIntervals = maxEmptySearchIntervals > 0? maxEmptySearchIntervals : 16;
-    return javaff_client_->launchPlanSearch(selDesire.toDesire(), pddl_problem, intervalSearchMS,maxPPlanSize, maxEmptySearchIntervals);
+
+    string pddl_problem = problemForPlanner(goal);//get problem string (or just its delta)
+    bool isDelta = PlannerProblemDelta::isDelta(pddl_problem);
+    javaff_client_->launchPlanSearch(selDesire.toDesire(), pddl_problem, intervalSearchMS, maxPPlanSize, maxEmptySearchIntervals, 
+        [this, selDesire, goal, isDelta, intervalSearchMS, maxPPlanSize, maxEmptySearchIntervals, onDone](bool accepted){
+            if(!accepted && isDelta)
+            {
+                // JavaFF out of sync wrt. the delta: fall back to the full problem
+                planner_problem_.reset();
+                javaff_client_->launchPlanSearch(selDesire.toDesire(), problemForPlanner(goal), intervalSearchMS, maxPPlanSize, maxEmptySearchIntervals, onDone);
+                return;
+            }
+            onDone(accepted);
+        });
+}
+
+/*
+    Problem to be shipped to JavaFF with goal @goal: just the delta wrt. the last one it got
+    if JAVAFF_PROBLEM_DELTA_PARAM is set and JavaFF is in sync, the full problem otherwise
+*/
+string SchedulerOnline::problemForPlanner(const string& goal)
+{
+    if(this->get_parameter(JAVAFF_PROBLEM_DELTA_PARAM).as_bool() && planner_problem_.version() > 0)
+        return planner_problem_.nextDelta(belief_set_.get(), goal);
+
+    return fullProblemForPlanner(goal);
+}
+
+/*
+    Full problem to be shipped to JavaFF with goal @goal: the one of the problem expert, unless JAVAFF_PROBLEM_DELTA_PARAM is set;
+    in that case it is built from the same belief set snapshot recorded as the last problem JavaFF got
+    (so that the next deltas are computed wrt. what it has actually received)
+*/
+string SchedulerOnline::fullProblemForPlanner(const string& goal)
+{
+    planner_problem_.setFull(belief_set_.get(), goal);
+    if(!this->get_parameter(JAVAFF_PROBLEM_DELTA_PARAM).as_bool())
+        return problem_expert_->getProblem();
+
+    if(planner_domain_name_ == "")
+        planner_domain_name_ = domain_expert_->getName();
+    return PlannerProblemDelta::toPDDLProblem(JAVAFF_PROBLEM_NAME, planner_domain_name_, belief_set_.get(), goal);
 }
 
 /*
@@ -749,35 +984,33 @@ void SchedulerOnline::checkForSatisfiedDesires()
     mtx_iter_dset_.lock();//to sync between iteration in checkForSatisfiedDesires( ) && reschedule()
 
     vector<ManagedDesire> satisfiedDesires;
-    for(ManagedDesire md : desire_set_)
+    for(ManagedDesire md : desire_set_.getFulfilled())//just desires whose targets are all in the belief set (fulfillment index)
     {   
-        if(isDesireSatisfied(md))//desire already achieved, remove it
+        if(!noPlanExecuting() && current_plan_.getFinalTarget() == md && 
+            current_plan_exec_info_.status == current_plan_exec_info_.RUNNING)  
         {
-            if(!noPlanExecuting() && current_plan_.getFinalTarget() == md && 
-                current_plan_exec_info_.status == current_plan_exec_info_.RUNNING)  
+            float plan_progress_status = computePlanProgressStatus();
+            
+            if(plan_progress_status < COMPLETED_THRESHOLD && !planExecRequestPending())
             {
-                float plan_progress_status = computePlanProgressStatus();
-                
-                if(plan_progress_status < COMPLETED_THRESHOLD)
-                {
-                    if(this->get_parameter(PARAM_DEBUG).as_bool())
-                        RCLCPP_INFO(this->get_logger(), "Current plan execution fulfilling desire \"" + md.getName() + 
-                            "\" will be aborted since desire is already fulfilled and plan exec. is still far from being completed " +
-                            "(progress status = %f)", plan_progress_status);
+                if(this->get_parameter(PARAM_DEBUG).as_bool())
+                    RCLCPP_INFO(this->get_logger(), "Current plan execution fulfilling desire \"" + md.getName() + 
+                        "\" will be aborted since desire is already fulfilled and plan exec. is still far from being completed " +
+                        "(progress status = %f)", plan_progress_status);
 
-                    if(abortCurrentPlanExecution())
+                abortCurrentPlanExecution([this](bool aborted){
+                    if(aborted)
                         resetSearchInfo();
-                }
-            }
-            else
-            {
-                if(this->get_parameter(PARAM_DEBUG).as_bool())
-                    RCLCPP_INFO(this->get_logger(), "Desire \"" + md.getName() + "\" will be removed from the desire set since its "+
-                        "target appears to be already fulfilled given the current belief set");
-            
-                satisfiedDesires.push_back(md);//delete desire just if not executing one, otherwise will be deleted when aborted feedback comes and desire is satisfied
+                });
             }
-
+        }
+        else
+        {
+            if(this->get_parameter(PARAM_DEBUG).as_bool())
+                RCLCPP_INFO(this->get_logger(), "Desire \"" + md.getName() + "\" will be removed from the desire set since its "+
+                    "target appears to be already fulfilled given the current belief set");
+        
+            satisfiedDesires.push_back(md);//delete desire just if not executing one, otherwise will be deleted when aborted feedback comes and desire is satisfied
         }
     }
 
@@ -797,21 +1030,20 @@ void SchedulerOnline::boostDesireTopicCallBack(const Desire::SharedPtr msg)
     {
         // it does match a desire in the desire set which is currently not active, perform offline boost
         bool boosted = false;
-        for(ManagedDesire md : desire_set_)
-            if(md.getName() == mdBoost.getName())
-            {
-                ManagedDesire original_desire = md.clone();
-                boosted = md.boostDesire(mdBoost);
-                if(boosted) // if not boosted, no boosting value
-                    replaceDesire(original_desire, md);
-    
-                break;
-            }
+        optional<ManagedDesire> optMd = desire_set_.getByName(mdBoost.getName());
+        if(optMd.has_value())
+        {
+            ManagedDesire md = optMd.value();
+            ManagedDesire original_desire = md.clone();
+            boosted = md.boostDesire(mdBoost);
+            if(boosted) // if not boosted, no boosting value
+                replaceDesire(original_desire, md);
+        }
     }
     else if (mdBoost.getName() == fulfilling_desire_.getName())
     {
         bool boosted = false;
-        if(mdBoost.getPrecondition().isSatisfied(belief_set_) && mdBoost.getContext().isSatisfied(belief_set_))
+        if(mdBoost.getPrecondition().isSatisfied(belief_set_.get()) && mdBoost.getContext().isSatisfied(belief_set_.get()))
         {
             // perform online boost
             ManagedDesire original_desire = fulfilling_desire_.clone();
@@ -825,7 +1057,8 @@ void SchedulerOnline::boostDesireTopicCallBack(const Desire::SharedPtr msg)
                     //inform planner, by pub a new execution status
                     ExecutionStatus boosted_goal_msg = ExecutionStatus{};
                     boosted_goal_msg.executing_plan_index = executing_pplan_index_;
-                    boosted_goal_msg.pddl_problem = problem_expert_->getProblem();
+                    // full problem here: there is no reply to a topic msg, so JavaFF could not reject a delta it can't apply
+                    boosted_goal_msg.pddl_problem = fullProblemForPlanner(BDIPDDLConverter::desireToGoal(fulfilling_desire_.toDesire()));
                     boosted_goal_msg.sim_to_goal = boosted_goal_msg.SIM_TO_GOAL_FORCE_REPLAN;
                     boosted_goal_msg.notification_reason = boosted_goal_msg.GOAL_BOOST;
                     javaff_exec_status_publisher_->publish(boosted_goal_msg);
@@ -884,8 +1117,10 @@ void SchedulerOnline::postDelDesireSuccess(const BDIManaged::ManagedDesire& md)
     if(md == current_plan_.getFinalTarget())//deleted desire of current executing plan)
     {
         //ABORT CURRENT AND WAITING PLANS
-        if(abortCurrentPlanExecution())
-            resetSearchInfo();
+        abortCurrentPlanExecution([this](bool aborted){
+            if(aborted)
+                resetSearchInfo();
+        });
     }
 }
 
@@ -900,6 +1135,7 @@ int main(int argc, char ** argv)
   {
     node->init();
     rclcpp::spin(node);
+    node->saveSnapshot();//keep the last desire set for the next warm restart
   }
   else
   {
@@ -1,4 +1,4 @@
-/*  Header for supporting plan client trigger node to make call launching/aborting a plan execution*/
+/*  Header for supporting client to make non blocking calls to the javaff srvs*/
 #include "ros2_bdi_core/support/javaff_client.hpp"
 /* Inner logic + ROS2 PARAMS & FIXED GLOBAL VALUES for Scheduler node (timeout for srv)*/
 #include "ros2_bdi_core/params/scheduler_params.hpp"
@@ -11,14 +11,14 @@ using javaff_interfaces::srv::JavaFFPlan;
 using javaff_interfaces::srv::UnexpectedState;
 
 
-JavaFFClient::JavaFFClient(const string& nodeBasename)
-{
-    caller_node_ = rclcpp::Node::make_shared(nodeBasename);
-    start_plan_client_ = caller_node_->create_client<JavaFFPlan>(JAVAFF_START_PLAN_SRV);
-    unexpected_state_client_ = caller_node_->create_client<UnexpectedState>(JAVAFF_UNEXPECTED_STATE_SRV);
-}
+JavaFFClient::JavaFFClient(rclcpp::Node* host_node):
+    start_plan_caller_(host_node, JAVAFF_START_PLAN_SRV, std::chrono::seconds(WAIT_RESPONSE_TIMEOUT), true),
+    unexpected_state_caller_(host_node, JAVAFF_UNEXPECTED_STATE_SRV, std::chrono::seconds(WAIT_RESPONSE_TIMEOUT), true)
+    {}
 
-bool JavaFFClient::launchPlanSearch(const ros2_bdi_interfaces::msg::Desire& fulfilling_desire, const string& problem, const int& interval, const int& max_pplan_size, const int& max_empty_search_intervals)
+/* Request to start a plan search, @callback notified whether it has been accepted */
+void JavaFFClient::launchPlanSearch(const ros2_bdi_interfaces::msg::Desire& fulfilling_desire, const string& problem, const int& interval, const int& max_pplan_size, const int& max_empty_search_intervals,
+    const ResultCallback& callback)
 {
     auto req = std::make_shared<JavaFFPlan::Request>();
     req->fulfilling_desire = fulfilling_desire;
@@ -26,88 +26,26 @@ bool JavaFFClient::launchPlanSearch(const ros2_bdi_interfaces::msg::Desire& fulf
     req->search_interval = interval;
     req->max_pplan_size = max_pplan_size;
     req->max_empty_search_intervals = max_empty_search_intervals;
-    return makePlanSearchRequest(req);
-}
-
-/* 
-    Manage the request call toward the javaff start_plan service
-*/
-bool JavaFFClient::makePlanSearchRequest(const JavaFFPlan::Request::SharedPtr& request)
-{
-    try{
-        while (!start_plan_client_->wait_for_service(std::chrono::seconds(WAIT_SRV_UP))) {
-            if (!rclcpp::ok()) {
-                return false;
-            }
-            RCLCPP_ERROR_STREAM(
-                caller_node_->get_logger(),
-                start_plan_client_->get_service_name() <<
-                    " service client: waiting for service to appear...");
-        }
-        auto future_result = start_plan_client_->async_send_request(request);
-        if (rclcpp::spin_until_future_complete(caller_node_, future_result, std::chrono::seconds(WAIT_RESPONSE_TIMEOUT)) !=
-            rclcpp::FutureReturnCode::SUCCESS)
-        {
-            return false;
-        }
-
-        auto response = future_result.get();
-        return response->accepted;
-    
-    }
-    catch(const rclcpp::exceptions::RCLError& rclerr)
-    {
-        RCLCPP_ERROR(caller_node_->get_logger(), rclerr.what());
-    }
-    catch(const std::exception &e)
-    {
-        RCLCPP_ERROR(caller_node_->get_logger(), "Response error in while trying to call %s srv", JAVAFF_START_PLAN_SRV);
-    }
-    
-    return false;
+    start_plan_caller_.call(req, [callback](const JavaFFPlan::Response::SharedPtr& response){
+        if(callback)
+            callback(response != nullptr && response->accepted);
+    });
 }
 
-bool JavaFFClient::callUnexpectedStateSrv(const string& pddl_problem)
+/* Notify JavaFF of an unexpected state, @callback notified whether it has been handled */
+void JavaFFClient::callUnexpectedStateSrv(const string& pddl_problem, const ResultCallback& callback)
 {
     auto req = std::make_shared<UnexpectedState::Request>();
     req->pddl_problem = pddl_problem;
-    return makeUnexpectedStateRequest(req);
+    unexpected_state_caller_.call(req, [callback](const UnexpectedState::Response::SharedPtr& response){
+        if(callback)
+            callback(response != nullptr && response->handled);
+    });
 }
 
-/* 
-    Manage the request call toward the javaff unexpected_state service
-*/
-bool JavaFFClient::makeUnexpectedStateRequest(const UnexpectedState::Request::SharedPtr& request)
+/* Drop the requests not completed yet: their callbacks are never called */
+void JavaFFClient::cancel()
 {
-    try{
-        while (!unexpected_state_client_->wait_for_service(std::chrono::seconds(WAIT_SRV_UP))) {
-            if (!rclcpp::ok()) {
-                return false;
-            }
-            RCLCPP_ERROR_STREAM(
-                caller_node_->get_logger(),
-                unexpected_state_client_->get_service_name() <<
-                    " service client: waiting for service to appear...");
-        }
-        auto future_result = unexpected_state_client_->async_send_request(request);
-        if (rclcpp::spin_until_future_complete(caller_node_, future_result, std::chrono::seconds(WAIT_RESPONSE_TIMEOUT)) !=
-            rclcpp::FutureReturnCode::SUCCESS)
-        {
-            return false;
-        }
-
-        auto response = future_result.get();
-        return response->handled;
-    
-    }
-    catch(const rclcpp::exceptions::RCLError& rclerr)
-    {
-        RCLCPP_ERROR(caller_node_->get_logger(), rclerr.what());
-    }
-    catch(const std::exception &e)
-    {
-        RCLCPP_ERROR(caller_node_->get_logger(), "Response error in while trying to call %s srv", JAVAFF_UNEXPECTED_STATE_SRV);
-    }
-    
-    return false;
-}
\ No newline at end of file
+    start_plan_caller_.cancel();
+    unexpected_state_caller_.cancel();
+}
@@ -6,57 +6,34 @@
 #include "ros2_bdi_core/params/plansys_monitor_params.hpp"
 
 #include <numeric>
+#include <optional>
+#include <future>
+#include <thread>
 
 using std::string;
 using std::vector;
+using std::shared_future;
 
 using lifecycle_msgs::srv::GetState;
+using ros2_bdi_interfaces::msg::PlanningSystemState;
 
 PlanSysMonitorClient::PlanSysMonitorClient(const string& nodesBasename, const PlanningMode& selPlanningMode)
-{   
-    /*Init caller nodes*/
-    caller_nodes_ = vector<rclcpp::Node::SharedPtr>();
-    for(int i=0; i<PSYS2NODES; i++)
-        caller_nodes_.push_back(rclcpp::Node::make_shared(nodesBasename + std::to_string(i)));
-    
+{
+    /*Init caller node (one for all the clients, requests are spinned all together)*/
+    caller_node_ = rclcpp::Node::make_shared(nodesBasename + "0");
+
     this->sel_planning_mode = selPlanningMode;
 
     /*Init caller clients*/
     caller_clients_ = vector<rclcpp::Client<lifecycle_msgs::srv::GetState>::SharedPtr>();
     string domain_expert_name = PSYS2_DOM_EXPERT;
-    caller_clients_.push_back(caller_nodes_[PSYS2_DOM_EXPERT_I]->create_client<lifecycle_msgs::srv::GetState>(domain_expert_name + "/" + PSYS2_CK_STATE_SRV));  
+    caller_clients_.push_back(caller_node_->create_client<lifecycle_msgs::srv::GetState>(domain_expert_name + "/" + PSYS2_CK_STATE_SRV));
     string problem_expert_name = PSYS2_PROB_EXPERT;
-    caller_clients_.push_back(caller_nodes_[PSYS2_PROB_EXPERT_I]->create_client<lifecycle_msgs::srv::GetState>(problem_expert_name + "/" + PSYS2_CK_STATE_SRV));  
+    caller_clients_.push_back(caller_node_->create_client<lifecycle_msgs::srv::GetState>(problem_expert_name + "/" + PSYS2_CK_STATE_SRV));
     string planner_name = sel_planning_mode == OFFLINE? PSYS2_PLANNER : JAVAFF_PLANNER;
-    caller_clients_.push_back(caller_nodes_[PSYS2_PLANNER_I]->create_client<lifecycle_msgs::srv::GetState>(planner_name + "/" + PSYS2_CK_STATE_SRV));  
+    caller_clients_.push_back(caller_node_->create_client<lifecycle_msgs::srv::GetState>(planner_name + "/" + PSYS2_CK_STATE_SRV));
     string executor_name = PSYS2_EXECUTOR;
-    caller_clients_.push_back(caller_nodes_[PSYS2_EXECUTOR_I]->create_client<lifecycle_msgs::srv::GetState>(executor_name + "/" + PSYS2_CK_STATE_SRV));  
-}
-
-/* Get the reference to the node caller instance for the PlanSys2 node @psysNodeName */
-rclcpp::Node::SharedPtr PlanSysMonitorClient::getCallerNode(const std::string& psysNodeName)
-{
-    if(psysNodeName == PSYS2_DOM_EXPERT && caller_nodes_.size() > PSYS2_DOM_EXPERT_I)
-    {
-        return caller_nodes_[PSYS2_DOM_EXPERT_I];
-    }
-
-    if(psysNodeName == PSYS2_PROB_EXPERT && caller_nodes_.size() > PSYS2_PROB_EXPERT_I)
-    {
-        return caller_nodes_[PSYS2_PROB_EXPERT_I];
-    }
-
-    if((psysNodeName == PSYS2_PLANNER || psysNodeName == JAVAFF_PLANNER) && caller_nodes_.size() > PSYS2_PLANNER_I)
-    {
-        return caller_nodes_[PSYS2_PLANNER_I];
-    }
-
-    if(psysNodeName == PSYS2_EXECUTOR && caller_nodes_.size() > PSYS2_EXECUTOR_I)
-    {
-        return caller_nodes_[PSYS2_EXECUTOR_I];
-    }
-
-    return {}; //unmatched
+    caller_clients_.push_back(caller_node_->create_client<lifecycle_msgs::srv::GetState>(executor_name + "/" + PSYS2_CK_STATE_SRV));
 }
 
 /* Get the reference to the client caller instance for the PlanSys2 node @psysNodeName */
@@ -88,76 +65,131 @@ rclcpp::Client<GetState>::SharedPtr PlanSysMonitorClient::getCallerClient(const
 /* Return true if {psysNodeName}/get_state service called confirm that the node is active */
 bool PlanSysMonitorClient::isPsysNodeActive(const std::string& psysNodeName)
 {
-    rclcpp::Node::SharedPtr node = getCallerNode(psysNodeName);
     rclcpp::Client<GetState>::SharedPtr client = getCallerClient(psysNodeName);
+    if(client == nullptr)
+        return false;
 
-    try{
-        
-        while (!client->wait_for_service(std::chrono::seconds(WAIT_GET_STATE_SRV_UP))) {
-            if (!rclcpp::ok()) {
-                return false;
-            }
-            RCLCPP_ERROR_STREAM(
-                node->get_logger(),
-                client->get_service_name() <<
-                    " service client: waiting for service to appear...");
+    while (!client->wait_for_service(std::chrono::seconds(WAIT_GET_STATE_SRV_UP))) {
+        if (!rclcpp::ok()) {
+            return false;
         }
+        RCLCPP_ERROR_STREAM(
+            caller_node_->get_logger(),
+            client->get_service_name() <<
+                " service client: waiting for service to appear...");
+    }
 
-        auto request = std::make_shared<GetState::Request>();
-        auto future_result = client->async_send_request(request);
+    return arePsysNodesActive({psysNodeName}, std::chrono::seconds(WAIT_GET_STATE_RESPONSE_TIMEOUT))[0];
+}
+
+/*
+    Call the {psysNodeName}/get_state services of all @psysNodeNames concurrently (requests all sent at once,
+    then waited for max @timeout overall); i-th flag true if the i-th node has confirmed to be active
+    (nodes whose service is not up yet are not waited for)
+*/
+vector<bool> PlanSysMonitorClient::arePsysNodesActive(const vector<string>& psysNodeNames, const std::chrono::seconds timeout)
+{
+    vector<bool> active = vector<bool>(psysNodeNames.size(), false);
+    vector<std::optional<shared_future<GetState::Response::SharedPtr>>> futures;
 
-        if (rclcpp::spin_until_future_complete(node, future_result, std::chrono::seconds(WAIT_GET_STATE_RESPONSE_TIMEOUT)) !=
-            rclcpp::FutureReturnCode::SUCCESS)
+    try{
+        // send all the requests at once
+        for(string psysNodeName : psysNodeNames)
         {
-            return false;
+            rclcpp::Client<GetState>::SharedPtr client = getCallerClient(psysNodeName);
+            if(client != nullptr && client->service_is_ready())
+                futures.push_back(client->async_send_request(std::make_shared<GetState::Request>()).share());
+            else
+                futures.push_back(std::nullopt);
         }
 
-        auto response = future_result.get();
-        return response->current_state.id == 3 && response->current_state.label == "active";
-    
+        // then wait for them (the total wait is bounded by the slowest response)
+        auto deadline = std::chrono::steady_clock::now() + timeout;
+        for(int i = 0; i < futures.size(); i++)
+        {
+            if(!futures[i].has_value())
+                continue;
+
+            auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(deadline - std::chrono::steady_clock::now());
+            if(futures[i].value().wait_for(std::chrono::seconds(0)) != std::future_status::ready &&
+                (remaining.count() <= 0 || rclcpp::spin_until_future_complete(caller_node_, futures[i].value(), remaining) != rclcpp::FutureReturnCode::SUCCESS))
+                continue;
+
+            auto response = futures[i].value().get();
+            active[i] = response->current_state.id == 3 && response->current_state.label == "active";
+        }
     }
     catch(const rclcpp::exceptions::RCLError& rclerr)
     {
-        RCLCPP_ERROR(node->get_logger(), rclerr.what());
+        RCLCPP_ERROR(caller_node_->get_logger(), rclerr.what());
     }
     catch(const std::exception &e)
     {
-        RCLCPP_ERROR(node->get_logger(), "Response error in while trying to call %s srv", client->get_service_name());
+        RCLCPP_ERROR(caller_node_->get_logger(), "Response error in while trying to call get_state srvs");
     }
 
-    return false;
+    return active;
 }
 
 
 /* Return true if all {psys2NodeName}/get_state service called confirm that the nodes are active, wait max_wait in case they're not before returning false */
 bool PlanSysMonitorClient::areAllPsysNodeActive(const std::chrono::seconds max_wait)
 {
-    std::vector<bool> active = std::vector<bool>(PSYS2NODES, false);
-
     std::chrono::seconds waited_amount = std::chrono::seconds(0);
 
     std::string planner_name = sel_planning_mode == OFFLINE? PSYS2_PLANNER : JAVAFF_PLANNER;
+    vector<string> psys2_nodes = {PSYS2_DOM_EXPERT, PSYS2_PROB_EXPERT, planner_name, PSYS2_EXECUTOR};
 
-    while(waited_amount.count() <= max_wait.count())
+    while(waited_amount.count() <= max_wait.count() && rclcpp::ok())
     {
-        active[PSYS2_DOM_EXPERT_I] = isPsysNodeActive(PSYS2_DOM_EXPERT);
-        active[PSYS2_PROB_EXPERT_I] = isPsysNodeActive(PSYS2_PROB_EXPERT);
-        active[PSYS2_PLANNER_I] = isPsysNodeActive(planner_name);
-        active[PSYS2_EXECUTOR_I] = isPsysNodeActive(PSYS2_EXECUTOR);
-
-        // std::cout << "active dom_expert = " << active[PSYS2_DOM_EXPERT_I]
-        //             << "active prob_expert = " << active[PSYS2_PROB_EXPERT_I]
-        //             << "active planner = " << active[PSYS2_PLANNER_I]
-        //             << "active executor = " << active[PSYS2_EXECUTOR_I]
-        //             << std::flush << std::endl;
-                    
-                    
+        vector<bool> active = arePsysNodesActive(psys2_nodes, std::chrono::seconds(WAIT_GET_STATE_RESPONSE_TIMEOUT));
 
         if(std::accumulate(active.begin(), active.end(), 0) == PSYS2NODES)
             return true;
-        
+
         std::this_thread::sleep_for(std::chrono::seconds(1));//WAIT PSYS2 TO BOOT
         waited_amount += std::chrono::seconds(1);
     }
     return false;
-}
\ No newline at end of file
+}
+
+/*
+    Wait max @max_wait for the PlanSys2 monitor of the agent to notify (in its latched plansys_state topic) that all the
+    PlanSys2 nodes are active, spinning @node meanwhile (call it before adding @node to any executor);
+    if no notification is received at all (e.g. monitor not running), fall back to query them directly
+*/
+bool PlanSysMonitorClient::waitPsysBoot(const rclcpp::Node::SharedPtr& node, const PlanningMode& selPlanningMode, const std::chrono::seconds max_wait)
+{
+    bool notified = false;
+    bool booted = false;
+    auto psys_state_subscriber = node->create_subscription<PlanningSystemState>(
+        PSYS_STATE_TOPIC, rclcpp::QoS(1).reliable().transient_local(),
+        [&notified, &booted, selPlanningMode](const PlanningSystemState::SharedPtr msg)
+        {
+            notified = true;
+            booted = allActive(*msg, selPlanningMode);
+        });
+
+    auto deadline = std::chrono::steady_clock::now() + max_wait;
+    while(!booted && rclcpp::ok() && std::chrono::steady_clock::now() < deadline)
+    {
+        rclcpp::spin_some(node);
+        if(!booted)
+            std::this_thread::sleep_for(std::chrono::milliseconds(TIMER_MIN / 5));
+    }
+    psys_state_subscriber.reset();
+
+    if(!booted && !notified && rclcpp::ok())
+    {
+        RCLCPP_ERROR(node->get_logger(), "No PlanSys2 state notification received: querying PlanSys2 nodes directly");
+        return PlanSysMonitorClient(node->get_name() + string("_psys2caller_"), selPlanningMode).areAllPsysNodeActive();
+    }
+    return booted;
+}
+
+/* True if @psysState notifies that all PlanSys2 nodes needed in the @selPlanningMode are active */
+bool PlanSysMonitorClient::allActive(const PlanningSystemState& psysState, const PlanningMode& selPlanningMode)
+{
+    return psysState.domain_expert_active && psysState.problem_expert_active && psysState.executor_active &&
+        (selPlanningMode == OFFLINE? psysState.offline_planner_active : psysState.online_planner_active);
+}
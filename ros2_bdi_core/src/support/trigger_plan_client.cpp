@@ -10,77 +10,55 @@ using std::string;
 using ros2_bdi_interfaces::msg::BDIPlan;
 using ros2_bdi_interfaces::srv::BDIPlanExecution;
 
- /* Constructor for the supporting node for calling the plan_execution service */
-TriggerPlanClient::TriggerPlanClient(const string& nodeBasename)
-{
-    caller_node_ = rclcpp::Node::make_shared(nodeBasename);
-    caller_client_ = caller_node_->create_client<BDIPlanExecution>(PLAN_EXECUTION_SRV);
-}
+/* Constructor for the client calling the plan_execution service through @host_node */
+TriggerPlanClient::TriggerPlanClient(rclcpp::Node* host_node):
+    caller_(host_node, PLAN_EXECUTION_SRV, std::chrono::seconds(WAIT_RESPONSE_TIMEOUT))
+    {}
 
-/* Return true if operation is successful */
-bool TriggerPlanClient::triggerPlanExecution(const BDIPlan& bdiPlan)
+/* Request to trigger @bdiPlan execution, @callback notified with the result */
+void TriggerPlanClient::triggerPlanExecution(const BDIPlan& bdiPlan, const ResultCallback& callback)
 {
     auto req = std::make_shared<BDIPlanExecution::Request>();
     req->plan = bdiPlan;
     req->request = req->EXECUTE;
-    return makePlanExecutionRequest(req);
+    makePlanExecutionRequest(req, callback);
 }
 
-/* Return true if operation is successful */
-bool TriggerPlanClient::abortPlanExecution(const BDIPlan& bdiPlan)
+/* 
+    Request to abort the execution of the plan returned by @planToAbort, @callback notified with the result:
+    @planToAbort is called once the requests made before have completed (e.g. a plan triggered meanwhile is the one to abort)
+*/
+void TriggerPlanClient::abortPlanExecution(const std::function<BDIPlan()>& planToAbort, const ResultCallback& callback)
 {
-    auto req = std::make_shared<BDIPlanExecution::Request>();
-    req->plan = bdiPlan;
-    req->request = req->ABORT;
-    return makePlanExecutionRequest(req);
+    caller_.call([planToAbort](){
+            auto req = std::make_shared<BDIPlanExecution::Request>();
+            req->plan = planToAbort();
+            req->request = req->ABORT;
+            return req;
+        }, 
+        [callback](const BDIPlanExecution::Response::SharedPtr& response){
+            if(callback)
+                callback(response != nullptr && response->success);
+        });
 }
 
-/* Return true if operation is successful */
-bool TriggerPlanClient::earlyArrestRequest(const BDIPlan& bdiPlan)
+/* Request to stop @bdiPlan execution at its committed point, @callback notified with the result */
+void TriggerPlanClient::earlyArrestRequest(const BDIPlan& bdiPlan, const ResultCallback& callback)
 {
     auto req = std::make_shared<BDIPlanExecution::Request>();
     req->plan = bdiPlan;
     req->request = req->EARLY_ABORT;
-    return makePlanExecutionRequest(req);
+    makePlanExecutionRequest(req, callback);
 }
+
 /* 
     Manage the request call toward the plan_execution service, so that the public functions
     for triggering/aborting plan execution are just wrappers for it avoiding code duplication
 */
-bool TriggerPlanClient::makePlanExecutionRequest(const BDIPlanExecution::Request::SharedPtr& request)
+void TriggerPlanClient::makePlanExecutionRequest(const BDIPlanExecution::Request::SharedPtr& request, const ResultCallback& callback)
 {
-        try{
-    
-        while (!caller_client_->wait_for_service(std::chrono::seconds(WAIT_SRV_UP))) {
-            if (!rclcpp::ok()) {
-                return false;
-            }
-            RCLCPP_ERROR_STREAM(
-                caller_node_->get_logger(),
-                caller_client_->get_service_name() <<
-                    " service client: waiting for service to appear...");
-        }
-
-        auto future_result = caller_client_->async_send_request(request);
-
-        if (rclcpp::spin_until_future_complete(caller_node_, future_result, std::chrono::seconds(WAIT_RESPONSE_TIMEOUT)) !=
-            rclcpp::FutureReturnCode::SUCCESS)
-        {
-            return false;
-        }
-
-        auto response = future_result.get();
-        return response->success;
-    
-    }
-    catch(const rclcpp::exceptions::RCLError& rclerr)
-    {
-        RCLCPP_ERROR(caller_node_->get_logger(), rclerr.what());
-    }
-    catch(const std::exception &e)
-    {
-        RCLCPP_ERROR(caller_node_->get_logger(), "Response error in while trying to call %s srv", PLAN_EXECUTION_SRV);
-    }
-    
-    return false;
-}
\ No newline at end of file
+    caller_.call(request, [callback](const BDIPlanExecution::Response::SharedPtr& response){
+        if(callback)
+            callback(response != nullptr && response->success);
+    });
+}
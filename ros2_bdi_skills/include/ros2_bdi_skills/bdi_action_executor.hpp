@@ -3,11 +3,15 @@
 
 #include <cstdlib>
 #include <ctime>
+#include <cmath>
+#include <cstdio>
 #include <memory>
 #include <vector>
 #include <set>
 #include <tuple>
 #include <map>
+#include <mutex>
+#include <future>
 
 #include "plansys2_problem_expert/ProblemExpertClient.hpp"
 #include "plansys2_executor/ExecutorClient.hpp"
@@ -24,10 +28,12 @@
 
 #include "ros2_bdi_utils/ManagedBelief.hpp"
 #include "ros2_bdi_utils/ManagedDesire.hpp"
+#include "ros2_bdi_utils/PartitionedBeliefSet.hpp"
 #include "ros2_bdi_utils/BDIFilter.hpp"
 
 #include "ros2_bdi_skills/communications_structs.hpp"
 #include "ros2_bdi_skills/communications_client.hpp"
+#include "ros2_bdi_skills/remote_belief_mirror.hpp"
 
 // Inner logic + ROS PARAMS & FIXED GLOBAL VALUES for ROS2 core nodes
 #include "ros2_bdi_core/params/core_common_params.hpp"
@@ -38,15 +44,6 @@
 #include "rclcpp/rclcpp.hpp"
 #include "rclcpp_action/rclcpp_action.hpp"
 
-typedef std::tuple
-        <
-          std::string, 
-          BDIManaged::ManagedDesire, 
-          rclcpp::Subscription<ros2_bdi_interfaces::msg::BeliefSet>::SharedPtr
-        > 
-
-        MonitorDesire;
-
 class BDIActionExecutor : public plansys2::ActionExecutorClient
 {
 public:
@@ -57,6 +54,11 @@ public:
   */
   BDIActionExecutor(const std::string action_name, const int working_freq, const bool agent_id_as_specialized_arg = true);
 
+  /*
+    Destructor: stop monitoring the desires, so that the mirror shared within the process never calls back a destroyed node
+  */
+  ~BDIActionExecutor();
+
   /*
     Method called when node is triggered by the Executor node of PlanSys2
     Progress for the action sets to 0.0f
@@ -74,8 +76,8 @@ public:
 
 protected:
 
-    /*returns arguments of the actions*/
-    std::vector<std::string> getArguments() {return get_arguments();}
+    /*returns arguments of the actions (retrieved once at activation)*/
+    const std::vector<std::string>& getArguments() {return action_params_;}
     /*returns current progress state of the action*/
     float getProgress() {return progress_;} 
 
@@ -125,12 +127,47 @@ protected:
     BDICommunications::UpdDesireResult sendUpdDesireRequest(const std::string& agent_ref, 
         const ros2_bdi_interfaces::msg::Desire& desire, const BDICommunications::UpdOperation& op, const bool& monitor_fulfill);
 
+    /*
+      Async counterparts of the utility methods above: they return immediately with a future holding the result
+      as soon as the response arrives, so that doWork is not blocked while waiting for it and requests 
+      towards different agents can be sent in parallel (check readiness with future.wait_for(0s))
+      (if monitor_fulfill is set, the monitoring of the desire fulfillment starts as the request is sent)
+    */
+    std::shared_future<BDICommunications::CheckBeliefResult> sendCheckBeliefRequestAsync(const std::string& agent_ref, 
+        const ros2_bdi_interfaces::msg::Belief& belief);
+    std::shared_future<BDICommunications::UpdBeliefResult> sendUpdBeliefRequestAsync(const std::string& agent_ref, 
+        const ros2_bdi_interfaces::msg::Belief& belief, const BDICommunications::UpdOperation& op);
+    std::shared_future<BDICommunications::CheckDesireResult> sendCheckDesireRequestAsync(const std::string& agent_ref, 
+        const ros2_bdi_interfaces::msg::Desire& desire);
+    std::shared_future<BDICommunications::UpdDesireResult> sendUpdDesireRequestAsync(const std::string& agent_ref, 
+        const ros2_bdi_interfaces::msg::Desire& desire, const BDICommunications::UpdOperation& op, const bool& monitor_fulfill);
+
+    /*
+      Batched variants of the utility methods above: beliefs/desires are sent in a single request to the agent
+      which applies them as a single belief/desire set operation, returning per item results (same order)
+      (flag for monitoring fulfillment of each desire is provided for the ADD scenario)
+    */
+    std::vector<BDICommunications::CheckBeliefResult> sendCheckBeliefBatchRequest(const std::string& agent_ref, 
+        const std::vector<ros2_bdi_interfaces::msg::Belief>& beliefs);
+    std::vector<BDICommunications::UpdBeliefResult> sendUpdBeliefBatchRequest(const std::string& agent_ref, 
+        const std::vector<ros2_bdi_interfaces::msg::Belief>& beliefs, const BDICommunications::UpdOperation& op);
+    std::vector<BDICommunications::CheckDesireResult> sendCheckDesireBatchRequest(const std::string& agent_ref, 
+        const std::vector<ros2_bdi_interfaces::msg::Desire>& desires);
+    std::vector<BDICommunications::UpdDesireResult> sendUpdDesireBatchRequest(const std::string& agent_ref, 
+        const std::vector<ros2_bdi_interfaces::msg::Desire>& desires, const BDICommunications::UpdOperation& op, const bool& monitor_fulfill);
+
     /*
       if no monitored desire, just return false
       otherwise check if it is fulfilled in the respective monitored belief set
     */
     bool isMonitoredDesireFulfilled(const std::string& agent_ref, const ros2_bdi_interfaces::msg::Desire& desire);
 
+    /*
+      Method called (within do_work(), before advanceWork) for every monitored desire which has become fulfilled 
+      in the belief set of agent @agent_ref since the last run, so that it has not to be polled through isMonitoredDesireFulfilled
+    */
+    virtual void monitoredDesireFulfilled(const std::string& agent_ref, const ros2_bdi_interfaces::msg::Desire& desire) {}
+
     // method to be called when the execution successfully comes to completion (generic success msg added)
     void execSuccess() { execSuccess(""); }
 
@@ -139,7 +176,7 @@ protected:
     {
       // communicateExecStatus(javaff_interfaces::msg::ActionExecutionStatus().SUCCESS);
 
-      if(this->get_parameter(PARAM_DEBUG).as_bool())
+      if(debug_)
         RCLCPP_INFO(this->get_logger(), "Action execution success: " + success_log);
       finish(true, 1.0, action_name_ + " successful execution" + ((success_log == "")? ": action performed" : ": " + success_log));
     }
@@ -154,7 +191,7 @@ protected:
     void execFailed(const std::string& err_log)
     {
       // communicateExecStatus(javaff_interfaces::msg::ActionExecutionStatus().FAILURE);
-      if(this->get_parameter(PARAM_DEBUG).as_bool())
+      if(debug_)
         RCLCPP_ERROR(this->get_logger(), "Action execution failed: " + err_log);
       finish(false, progress_, action_name_ + " failed execution" + ((err_log == "")? ": generic error" : ": " + err_log));
     }
@@ -163,28 +200,48 @@ protected:
 private:
 
     /*
-      Monitor belief set update of an agent 
+      Monitor the fulfillment of desire in the belief set of an agent (through the mirror shared within the process)
     */
     void monitor(const std::string& agentRef, const ros2_bdi_interfaces::msg::Desire& desire);
 
     /*
-      update the current monitored belief set 
+      Stop monitoring all the desires
+    */
+    void stopMonitoring();
+
+    /*
+      Notify monitoredDesireFulfilled of the monitored desires fulfilled since the last call
+    */
+    void notifyFulfilledDesires();
+
+    /*
+      Send progress feedback to plansys2 executor (logged if debug=TRUE) just if progress has advanced
+      at least feedback_progress_delta_ since the last one sent, building its string only then
     */
-    void agentBeliefSetCallback(const ros2_bdi_interfaces::msg::BeliefSet::SharedPtr msg);
+    void sendProgressFeedback();
+
+
+    //currently monitored desires: map ((agent_id, desire), id of the watch of the desire in the belief set of agent_id)
+    std::map<std::pair<std::string, BDIManaged::ManagedDesire>, uint64_t> monitored_desires_;
 
+    //mirror of the belief sets of the monitored agents (shared within the process)
+    std::shared_ptr<BDICommunications::RemoteBeliefMirror> belief_mirror_;
 
-    //currently monitored desires: vector of tuples in the form (agent_id, desire to fulfill, subs to belief set of agent_id)
-    std::vector<MonitorDesire>  monitored_desires_;
+    //monitored desires fulfilled, still to be notified: vector of pairs in the form (agent_id, desire)
+    std::vector<std::pair<std::string, ros2_bdi_interfaces::msg::Desire>> fulfilled_desires_;
 
-    //currently monitoring belief sets: map (agent_id, belief set for agent_id)
-    std::map<std::string, std::set<BDIManaged::ManagedBelief>> monitored_bsets_;
+    //lock on fulfilled_desires_ (filled in by the mirror thread)
+    std::mutex mtx_fulfilled_;
 
     // action name
     std::string action_name_;
 
-    // action params
+    // action params (retrieved at activation)
     std::vector<std::string> action_params_;
 
+    // debug flag (read at activation)
+    bool debug_;
+
     // agent id that defines the namespace in which the node operates
     std::string agent_id_;
 
@@ -196,6 +253,14 @@ private:
     // progress of the current action execution
     float progress_;
 
+    // min progress advancement to send a new feedback, progress sent with the last one (< 0 if none sent yet)
+    float feedback_progress_delta_;
+    float last_feedback_progress_;
+
+    // "[action_name p1 p2] " (built at activation) and feedback string (storage reused across feedbacks)
+    std::string feedback_prefix_;
+    std::string feedback_string_;
+
     // Publish updated exec action status to online planner
     // rclcpp_lifecycle::LifecyclePublisher<javaff_interfaces::msg::ExecutionStatus>::SharedPtr exec_status_to_planner_publisher_;
 
@@ -4,6 +4,14 @@
 #include <algorithm>
 #include <string>
 #include <memory>
+#include <map>
+#include <mutex>
+#include <atomic>
+#include <thread>
+#include <future>
+#include <chrono>
+#include <functional>
+#include <vector>
 
 #include "ros2_bdi_interfaces/msg/belief.hpp"
 #include "ros2_bdi_interfaces/msg/desire.hpp"
@@ -11,6 +19,10 @@
 #include "ros2_bdi_interfaces/srv/upd_belief_set.hpp"
 #include "ros2_bdi_interfaces/srv/check_desire.hpp"
 #include "ros2_bdi_interfaces/srv/upd_desire_set.hpp"
+#include "ros2_bdi_interfaces/srv/check_belief_batch.hpp"
+#include "ros2_bdi_interfaces/srv/upd_belief_set_batch.hpp"
+#include "ros2_bdi_interfaces/srv/check_desire_batch.hpp"
+#include "ros2_bdi_interfaces/srv/upd_desire_set_batch.hpp"
 
 #include "rclcpp/rclcpp.hpp"
 
@@ -21,12 +33,18 @@ namespace BDICommunications{
     /*
         Helping node to avoid blocking situation in BDIActionExecutor node when sending a request to a communication
         service of another agent (CHECK/WRITE belief/desire operations)
+
+        The helping node is spun by its own executor in a background thread, so that requests can be sent asynchronously
+        (possibly in parallel towards different agents) and their responses collected through futures and/or callbacks.
+        Clients are created once per target service and kept alive, as well as the last known availability of each service.
     */
     class CommunicationsClient
     {
         public:
             CommunicationsClient();
 
+            ~CommunicationsClient();
+
             /*
                 Sending CHECK belief request
                     @agent_ref   -> id of the queried agent
@@ -70,23 +88,147 @@ namespace BDICommunications{
             BDICommunications::UpdDesireResult updDesireRequest(const std::string& agent_ref, 
                     const std::string& agent_group, const ros2_bdi_interfaces::msg::Desire& desire, const UpdOperation& op);
 
+            /*
+                Async counterparts of the methods above: they return immediately with a future which is going to hold the result
+                as soon as the response has been received (if the service appears to be down, the future is ready straight away 
+                with a not accepted result, if no response arrives within RESPONSE_DEADLINE it gets the not accepted result then).
+                Requests towards different agents can hence be sent in parallel and waited together.
+                    @callback   -> optional, called with the result within the spinning thread of the communications client
+                                    (do not block nor call sync. methods of the same client within it)
+            */
+            std::shared_future<BDICommunications::CheckBeliefResult> checkBeliefRequestAsync(const std::string& agent_ref, 
+                    const std::string& agent_group, const ros2_bdi_interfaces::msg::Belief& belief,
+                    std::function<void(const BDICommunications::CheckBeliefResult&)> callback = nullptr);
+
+            std::shared_future<BDICommunications::UpdBeliefResult> updBeliefRequestAsync(const std::string& agent_ref, 
+                    const std::string& agent_group, const ros2_bdi_interfaces::msg::Belief& belief, const UpdOperation& op,
+                    std::function<void(const BDICommunications::UpdBeliefResult&)> callback = nullptr);
+
+            std::shared_future<BDICommunications::CheckDesireResult> checkDesireRequestAsync(const std::string& agent_ref, 
+                    const std::string& agent_group, const ros2_bdi_interfaces::msg::Desire& desire,
+                    std::function<void(const BDICommunications::CheckDesireResult&)> callback = nullptr);
+
+            std::shared_future<BDICommunications::UpdDesireResult> updDesireRequestAsync(const std::string& agent_ref, 
+                    const std::string& agent_group, const ros2_bdi_interfaces::msg::Desire& desire, const UpdOperation& op,
+                    std::function<void(const BDICommunications::UpdDesireResult&)> callback = nullptr);
+
+            /*
+                Batched variants of the methods above: a single request carrying several beliefs/desires at once
+                (applied by the queried agent as a single belief/desire set operation), returning per item results
+                in the same order of the items passed
+            */
+            std::vector<BDICommunications::CheckBeliefResult> checkBeliefBatchRequest(const std::string& agent_ref, 
+                    const std::string& agent_group, const std::vector<ros2_bdi_interfaces::msg::Belief>& beliefs);
+
+            std::vector<BDICommunications::UpdBeliefResult> updBeliefBatchRequest(const std::string& agent_ref, 
+                    const std::string& agent_group, const std::vector<ros2_bdi_interfaces::msg::Belief>& beliefs, const UpdOperation& op);
+
+            std::vector<BDICommunications::CheckDesireResult> checkDesireBatchRequest(const std::string& agent_ref, 
+                    const std::string& agent_group, const std::vector<ros2_bdi_interfaces::msg::Desire>& desires);
+
+            std::vector<BDICommunications::UpdDesireResult> updDesireBatchRequest(const std::string& agent_ref, 
+                    const std::string& agent_group, const std::vector<ros2_bdi_interfaces::msg::Desire>& desires, const UpdOperation& op);
+
+            /*
+                Async counterparts of the batched methods above
+            */
+            std::shared_future<std::vector<BDICommunications::CheckBeliefResult>> checkBeliefBatchRequestAsync(const std::string& agent_ref, 
+                    const std::string& agent_group, const std::vector<ros2_bdi_interfaces::msg::Belief>& beliefs,
+                    std::function<void(const std::vector<BDICommunications::CheckBeliefResult>&)> callback = nullptr);
+
+            std::shared_future<std::vector<BDICommunications::UpdBeliefResult>> updBeliefBatchRequestAsync(const std::string& agent_ref, 
+                    const std::string& agent_group, const std::vector<ros2_bdi_interfaces::msg::Belief>& beliefs, const UpdOperation& op,
+                    std::function<void(const std::vector<BDICommunications::UpdBeliefResult>&)> callback = nullptr);
+
+            std::shared_future<std::vector<BDICommunications::CheckDesireResult>> checkDesireBatchRequestAsync(const std::string& agent_ref, 
+                    const std::string& agent_group, const std::vector<ros2_bdi_interfaces::msg::Desire>& desires,
+                    std::function<void(const std::vector<BDICommunications::CheckDesireResult>&)> callback = nullptr);
+
+            std::shared_future<std::vector<BDICommunications::UpdDesireResult>> updDesireBatchRequestAsync(const std::string& agent_ref, 
+                    const std::string& agent_group, const std::vector<ros2_bdi_interfaces::msg::Desire>& desires, const UpdOperation& op,
+                    std::function<void(const std::vector<BDICommunications::UpdDesireResult>&)> callback = nullptr);
+
         private:
-            // node to be spinned while making request
+
+            /*
+                Return the client for @serviceName stored in @clients, creating it just the first time it's needed
+            */
+            template<typename ServiceT>
+            typename rclcpp::Client<ServiceT>::SharedPtr getClient(const std::string& serviceName,
+                    std::map<std::string, typename rclcpp::Client<ServiceT>::SharedPtr>& clients);
+
+            /*
+                Check whether the service behind @client is up, relying on the cached availability of it:
+                block (max WAIT_SRV_UP) just when the service has not been seen up yet and it has not been found down recently
+            */
+            bool isServiceUp(const rclcpp::ClientBase::SharedPtr& client);
+
+            /*
+                Send @request through @client, fulfilling the returned future with @res, 
+                filled in with the response by @fillRes (or left as it is if the service appears to be down 
+                or no response has been received within RESPONSE_DEADLINE)
+            */
+            template<typename ServiceT, typename ResultT>
+            std::shared_future<ResultT> sendRequestAsync(const typename rclcpp::Client<ServiceT>::SharedPtr& client,
+                    const typename ServiceT::Request::SharedPtr& request, const ResultT& res,
+                    std::function<void(ResultT&, const typename ServiceT::Response::SharedPtr&)> fillRes,
+                    std::function<void(const ResultT&)> callback);
+
+            /*
+                Wait for @future to be fulfilled at most WAIT_RESPONSE_TIMEOUT, returning @timeoutRes otherwise
+            */
+            template<typename ResultT>
+            ResultT waitResult(const std::shared_future<ResultT>& future, const ResultT& timeoutRes);
+
+            // node used to make requests, always spinning in its own thread
             rclcpp::Node::SharedPtr node_;
 
-            // below client instances to be instantiated while making a request to ...
+            // executor spinning node_
+            rclcpp::executors::SingleThreadedExecutor::SharedPtr executor_;
+
+            // thread in which executor_ spins
+            std::thread spin_thread_;
+
+            // lock on the client maps and the service availability cache below
+            std::mutex mtx_clients_;
+
+            // below client instances, instantiated once per target service name (i.e. per queried agent) while making a request to ...
 
             // ... @agent_ref/check_belief_srv
-            rclcpp::Client<ros2_bdi_interfaces::srv::CheckBelief>::SharedPtr ck_belief_client_;
+            std::map<std::string, rclcpp::Client<ros2_bdi_interfaces::srv::CheckBelief>::SharedPtr> ck_belief_clients_;
 
             // ... @agent_ref/check_desire_srv
-            rclcpp::Client<ros2_bdi_interfaces::srv::CheckDesire>::SharedPtr ck_desire_client_;
+            std::map<std::string, rclcpp::Client<ros2_bdi_interfaces::srv::CheckDesire>::SharedPtr> ck_desire_clients_;
 
             // ... @agent_ref/add_belief_srv OR  ... @agent_ref/del_belief_srv
-            rclcpp::Client<ros2_bdi_interfaces::srv::UpdBeliefSet>::SharedPtr upd_belief_client_;
+            std::map<std::string, rclcpp::Client<ros2_bdi_interfaces::srv::UpdBeliefSet>::SharedPtr> upd_belief_clients_;
 
             // ... @agent_ref/add_desire_srv OR  ... @agent_ref/del_desire_srv
-            rclcpp::Client<ros2_bdi_interfaces::srv::UpdDesireSet>::SharedPtr upd_desire_client_;
+            std::map<std::string, rclcpp::Client<ros2_bdi_interfaces::srv::UpdDesireSet>::SharedPtr> upd_desire_clients_;
+
+            // ... @agent_ref/check_belief_batch_srv
+            std::map<std::string, rclcpp::Client<ros2_bdi_interfaces::srv::CheckBeliefBatch>::SharedPtr> ck_belief_batch_clients_;
+
+            // ... @agent_ref/check_desire_batch_srv
+            std::map<std::string, rclcpp::Client<ros2_bdi_interfaces::srv::CheckDesireBatch>::SharedPtr> ck_desire_batch_clients_;
+
+            // ... @agent_ref/add_belief_batch_srv OR  ... @agent_ref/del_belief_batch_srv
+            std::map<std::string, rclcpp::Client<ros2_bdi_interfaces::srv::UpdBeliefSetBatch>::SharedPtr> upd_belief_batch_clients_;
+
+            // ... @agent_ref/add_desire_batch_srv OR  ... @agent_ref/del_desire_batch_srv
+            std::map<std::string, rclcpp::Client<ros2_bdi_interfaces::srv::UpdDesireSetBatch>::SharedPtr> upd_desire_batch_clients_;
+
+            // service name -> last time the service has been found down (not there if the service has been found up)
+            std::map<std::string, std::chrono::steady_clock::time_point> srv_down_since_;
+
+            // lock on the deadline timers of the pending requests below
+            std::mutex mtx_pending_;
+
+            // id to be assigned to the next request sent
+            std::atomic<uint64_t> next_request_id_;
+
+            // request id -> one shot timer failing the request if its response has not been received by then (removed once the request is over)
+            std::map<uint64_t, rclcpp::TimerBase::SharedPtr> response_deadlines_;
     };
 };
 
@@ -0,0 +1,9 @@
+#ifndef ACTION_EXECUTOR_PARAMS_H_
+#define ACTION_EXECUTOR_PARAMS_H_
+
+/* Parameters affecting internal logic (recompiling required) */
+#define PARAM_FEEDBACK_PROGRESS_DELTA "feedback_progress_delta" // progress feedback sent to plansys2 executor just when progress has advanced at least this much since the last one
+
+#define FEEDBACK_PROGRESS_DELTA_DEFAULT 0.01
+
+#endif // ACTION_EXECUTOR_PARAMS_H_
@@ -5,5 +5,21 @@
 #define PARAM_SENSING_FREQ "sensing_freq" 
 #define PARAM_SENSOR_NAME "sensor_name"
 #define PARAM_INIT_SLEEP "init_sleep"
+#define PARAM_WAIT_BELIEF_MANAGER "wait_belief_manager" // start sensing as soon as the belief manager notifies to be running (init_sleep is then the max wait for it)
+#define PARAM_DEDUP "dedup" // suppress re-sending of beliefs unchanged wrt. the last sent state (opt-in: a belief altered meanwhile by another writer is restored just at the next refresh)
+#define PARAM_DEDUP_REFRESH_MS "dedup_refresh_ms" // unchanged beliefs are sent anyway once this interval has passed since their last sending (<= 0 to never refresh)
+#define PARAM_COALESCE_WINDOW_MS "coalesce_window_ms" // window in which forwarded sensings are coalesced into a single belief set msg (<= 0 to publish them straight away)
+#define PARAM_FUNCTION_DEADBAND "function_deadband" // function values within this distance from the last sent one are considered unchanged
+#define PARAM_SENSING_MODE "sensing_mode" // when performSensing is called: periodically (at sensing_freq) or as the inputs of the sensor change
+#define PARAM_MIN_SENSING_INTERVAL_MS "min_sensing_interval_ms" // event mode: min interval between two performSensing calls (throttling)
+#define PARAM_MAX_SENSING_INTERVAL_MS "max_sensing_interval_ms" // event mode: max interval between two performSensing calls (heartbeat, <= 0 to disable it)
+
+#define VAL_SENSING_MODE_PERIODIC "periodic"
+#define VAL_SENSING_MODE_EVENT "event"
+
+#define DEDUP_DEFAULT false
+#define DEDUP_REFRESH_MS_DEFAULT 4000
+
+#define SENSING_STATS_INTERVAL_SEC 10 // interval at which msgs published/saved per second are logged (debug mode)
 
 #endif
\ No newline at end of file
@@ -0,0 +1,128 @@
+#ifndef REMOTE_BELIEF_MIRROR_H_
+#define REMOTE_BELIEF_MIRROR_H_
+
+#include <string>
+#include <memory>
+#include <map>
+#include <set>
+#include <mutex>
+#include <thread>
+#include <functional>
+
+#include "ros2_bdi_interfaces/msg/belief_set.hpp"
+#include "ros2_bdi_interfaces/msg/belief_set_delta.hpp"
+#include "ros2_bdi_interfaces/msg/desire.hpp"
+
+#include "ros2_bdi_utils/ManagedDesire.hpp"
+#include "ros2_bdi_utils/ManagedDesireSet.hpp"
+#include "ros2_bdi_utils/PartitionedBeliefSet.hpp"
+
+#include "rclcpp/rclcpp.hpp"
+
+namespace BDICommunications{
+
+    /*
+        Mirror of the belief sets of remote agents, shared by all the action executors of the process
+        (so that there is a single subscription per remote agent, whatever the number of desires monitored in it)
+
+        The mirror of an agent is kept up to date through its belief set deltas, falling back on the whole belief set
+        when some delta went missing. Desires are watched through the fulfillment index of a ManagedDesireSet,
+        so that an update costs as much as the beliefs it alters and watchers are notified as soon as their desire gets fulfilled.
+        Subscriptions are made by a helping node spinning in its own thread, the ones towards an agent dropped with its last watch
+    */
+    class RemoteBeliefMirror
+    {
+        public:
+            /* Called with the agent and the desire of the watch which has become fulfilled */
+            typedef std::function<void(const std::string&, const ros2_bdi_interfaces::msg::Desire&)> FulfilledCallback;
+
+            ~RemoteBeliefMirror();
+
+            /* Mirror shared within the process (created as the first one needs it, destroyed when no one holds it anymore) */
+            static std::shared_ptr<RemoteBeliefMirror> getInstance();
+
+            /*
+                Watch the fulfillment of @desire in the belief set of @agent_ref, returning the id of the watch
+                @callback is called every time the desire becomes fulfilled (right away if it's already fulfilled)
+                n.b. it's called with the mirror locked, hence it has to be quick and not call the mirror back
+            */
+            uint64_t watch(const std::string& agent_ref, const ros2_bdi_interfaces::msg::Desire& desire, const FulfilledCallback& callback);
+
+            /* Stop watch @watch_id (unsubscribing from its agent if it was the last one watching it) */
+            void unwatch(const uint64_t& watch_id);
+
+            /* True if the desire of watch @watch_id is fulfilled in the mirrored belief set of its agent */
+            bool isFulfilled(const uint64_t& watch_id);
+
+        private:
+            RemoteBeliefMirror();
+
+            /* Mirror of the belief set of an agent with the desires watched in it */
+            typedef struct {
+                rclcpp::Subscription<ros2_bdi_interfaces::msg::BeliefSet>::SharedPtr belief_set_subscriber;
+                rclcpp::Subscription<ros2_bdi_interfaces::msg::BeliefSetDelta>::SharedPtr belief_set_delta_subscriber;
+                rclcpp::Subscription<ros2_bdi_interfaces::msg::BeliefSet>::SharedPtr static_belief_set_subscriber;
+
+                BDIManaged::PartitionedBeliefSet belief_set;
+
+                // seq of the last delta applied or reflected in the last whole belief set applied (0 if unknown)
+                uint64_t last_delta_seq;
+                // no delta known to be missing since the last whole belief set applied
+                bool synced;
+                // whole belief set msgs skipped since the last one applied
+                int skipped_full_msgs;
+
+                // desires watched (fulfillment index) and ids of their watches
+                BDIManaged::ManagedDesireSet watched;
+                std::set<uint64_t> watch_ids;
+            } AgentMirror;
+
+            /* Watch of a desire in the belief set of an agent */
+            typedef struct {
+                std::string agent_ref;
+                ros2_bdi_interfaces::msg::Desire desire;
+                // copy of desire named after the watch, so that the same desire can be watched more than once
+                BDIManaged::ManagedDesire watched_desire;
+                FulfilledCallback callback;
+                bool fulfilled;
+            } Watch;
+
+            /* Subscribe to the belief set topics of @agent_ref */
+            void subscribe(const std::string& agent_ref, AgentMirror& agent);
+
+            /* Whole dynamic partition of the belief set of @agent_ref: applied just if out of sync or periodically */
+            void agentBeliefSetCallback(const std::string& agent_ref, const ros2_bdi_interfaces::msg::BeliefSet::SharedPtr msg);
+
+            /* Delta of the belief set of @agent_ref */
+            void agentBeliefSetDeltaCallback(const std::string& agent_ref, const ros2_bdi_interfaces::msg::BeliefSetDelta::SharedPtr msg);
+
+            /* Static partition of the belief set of @agent_ref */
+            void agentStaticBeliefSetCallback(const std::string& agent_ref, const ros2_bdi_interfaces::msg::BeliefSet::SharedPtr msg);
+
+            /* Feed the alterations to the mirrored belief set of @agent into the fulfillment index, notifying the newly fulfilled watches */
+            void applyChanges(AgentMirror& agent, const BDIManaged::BeliefSetChanges& changes);
+
+            // node used to subscribe to the belief set topics, always spinning in its own thread
+            rclcpp::Node::SharedPtr node_;
+
+            // executor spinning node_
+            rclcpp::executors::SingleThreadedExecutor::SharedPtr executor_;
+
+            // thread in which executor_ spins
+            std::thread spin_thread_;
+
+            // lock on the mirrors and the watches
+            std::mutex mtx_;
+
+            // mirrored agents: map (agent_id, mirror of the belief set of agent_id)
+            std::map<std::string, AgentMirror> agents_;
+
+            // watches: map (watch id, watch)
+            std::map<uint64_t, Watch> watches_;
+
+            // id of the next watch
+            uint64_t next_watch_id_;
+    };
+};
+
+#endif  // REMOTE_BELIEF_MIRROR_H_
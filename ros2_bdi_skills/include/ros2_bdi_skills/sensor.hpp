@@ -3,12 +3,20 @@
 
 #include <cstdlib>
 #include <ctime>
+#include <cmath>
+#include <algorithm>
 #include <memory>
 #include <vector>
 #include <map>
+#include <mutex>
+#include <chrono>
+#include <optional>
+#include <functional>
 
 #include "ros2_bdi_interfaces/msg/belief.hpp"
 #include "ros2_bdi_interfaces/msg/belief_set.hpp"
+#include "ros2_bdi_interfaces/msg/lifecycle_status.hpp"
+#include "ros2_bdi_interfaces/srv/load_static_beliefs.hpp"
 #include "rclcpp/rclcpp.hpp"
 
 typedef enum {ADD, UPD, DEL, NOP} UpdOperation;
@@ -34,6 +42,10 @@ public:
     to match the rule defined above, but you can override it so that fluent/function case is basically equivalent to the one of the predicate proto.)
 
     @enable_perform_sensing -> enable periodic perform sensing, i.e. sense is called just within subscription callbacks (default is set to true)
+
+    performSensing is called periodically at sensing_freq or, if sensing_mode = "event", as soon as an input of the sensor changes
+    (see createSensingSubscription and inputChanged), no more often than min_sensing_interval_ms 
+    and at least every max_sensing_interval_ms anyway
   */
   Sensor(const std::string& sensor_name, const ros2_bdi_interfaces::msg::Belief& proto_belief, 
             const bool match_param_by_param=true, const bool enable_perform_sensing=true);
@@ -44,19 +56,57 @@ public:
   /*  Get belief prototype for the sensor node*/
   std::optional<ros2_bdi_interfaces::msg::Belief> getBeliefPrototype(const std::string& name_or_type) 
   {
-    if(proto_belief_map_.find(name_or_type) != proto_belief_map_.end())
-        return proto_belief_map_[name_or_type];
+    auto it = proto_belief_map_.find(name_or_type);
+    if(it != proto_belief_map_.end())
+        return it->second;
     else
         return {};
   }
+
+  /*  Number of sensed beliefs which have been forwarded to the belief set so far */
+  uint64_t getForwardedCount() {return forwarded_count_;}
+
+  /*  Number of sensed beliefs which have been suppressed so far because unchanged wrt. the last sent state */
+  uint64_t getSuppressedCount() {return suppressed_count_;}
+
+  /*  Number of belief/belief set msgs published so far */
+  uint64_t getPublishedMsgsCount() {return published_msgs_count_;}
+
+  /*  Number of msgs saved so far wrt. publishing one msg per sensed belief (suppressed + batched sensings) */
+  uint64_t getSavedMsgsCount() {return forwarded_count_ + suppressed_count_ - published_msgs_count_;}
+
 protected:
 
     /* Sensor logic to be implemented in the actual sensor classes written by the framework user */
     virtual void performSensing() {};
+
+    /*
+        Subscription to an input of the sensor: every msg is passed to @callback, then the input is considered changed
+        (see inputChanged), so that in event mode performSensing is called as soon as the sensor has something new to look at
+    */
+    template<typename MessageT>
+    typename rclcpp::Subscription<MessageT>::SharedPtr createSensingSubscription(const std::string& topic_name, const rclcpp::QoS& qos,
+            const std::function<void(const typename MessageT::SharedPtr)>& callback)
+    {
+        return this->create_subscription<MessageT>(topic_name, qos,
+            [this, callback](const typename MessageT::SharedPtr msg)
+            {
+                callback(msg);
+                inputChanged();
+            });
+    }
+
+    /*
+        Notify that an input of the sensor has changed: in event mode performSensing is called right away,
+        or as soon as min_sensing_interval_ms has passed since its last call
+        (no effect on when performSensing is called in periodic mode, where inputs are just timestamped to measure the sensing latency)
+    */
+    void inputChanged();
     
     /*
         API offered to user so that he can just invoke it within the performSensing() implementation whenever the logic
         requires to update the belief set in some way, i.e. by adding/updating/removing a new belief
+        (everything sensed within a performSensing() call is published at its end as a single batch)
     */
     void sense(const ros2_bdi_interfaces::msg::Belief& belief, const UpdOperation& op);
 
@@ -66,6 +116,20 @@ protected:
     */
     void senseAll(const ros2_bdi_interfaces::msg::BeliefSet& belief_set, const UpdOperation& op);
 
+    /*
+        API offered to user to install a large block of immutable facts (e.g. the topology of a static map) at once
+        through the static beliefs loader of the belief manager, instead of sensing them belief by belief
+        (beliefs not compliant with the prototypes are discarded; the block is sent asynchronously, see staticBeliefsLoaded)
+        Returns false if the loader is not available
+    */
+    bool senseStatic(const ros2_bdi_interfaces::msg::BeliefSet& belief_set);
+
+    /*
+        Called when the block sent through senseStatic has been processed by the belief manager,
+        @success is true if all its facts are in the belief set
+    */
+    virtual void staticBeliefsLoaded(const bool& success) {};
+
 private:
 
     /*
@@ -88,33 +152,103 @@ private:
     void startSensing();
 
     /*
-      Called within the sense method iff the sensed belief is compliant wrt. to the inially
+        Start the main loop of sensing: sensing timer at sensing_freq (periodic mode) 
+        or heartbeat timer at max_sensing_interval_ms (event mode, sensing right away if inputs have changed while waiting to start)
+    */
+    void startSensingLoop();
+
+    /*
+        Event mode: performSensing call triggered by an input change (or by the heartbeat)
+    */
+    void runTriggeredSensing();
+
+    /*
+        Main loop of sensing: call performSensing() batching all its sensings,
+        which are published together once it returns (unless a coalescing window is set)
+    */
+    void runSensing();
+
+    /*
+        Log (debug) the msgs published and saved per second in the last SENSING_STATS_INTERVAL_SEC seconds
+        and the latency between input changes and the publication of the resulting sensings
+    */
+    void logSensingStats();
+
+    /*
+        Prototype @belief has to comply with (instances by type, predicates/functions by name), nullptr if none
+    */
+    const ros2_bdi_interfaces::msg::Belief* findPrototype(const ros2_bdi_interfaces::msg::Belief& belief) const;
+
+    /*
+        True if @belief complies with its prototype (see sensedInstance, sensedPredicate, sensedFunction)
+    */
+    bool compliant(const ros2_bdi_interfaces::msg::Belief& belief) const;
+
+    /*
+        Received (latched) lifecycle status of a core node of the agent:
+        start sensing as soon as the belief manager is running, i.e. ready to accept the sensed beliefs
+    */
+    void callbackLifecycleStatus(const ros2_bdi_interfaces::msg::LifecycleStatus::SharedPtr msg);
+
+    /*
+      Called within the sense method iff the sensed @belief is compliant wrt. to the inially
       defined belief prototype in the constructor
     */
-    void publishSensing(const UpdOperation& op);
+    void publishSensing(const ros2_bdi_interfaces::msg::Belief& belief, const UpdOperation& op);
 
     /*
-      perform update if the new instance is valid with respect to the expected sensed one specified in the constructor
+      true if the new instance is valid with respect to its prototype @proto specified in the constructor
 
       SAME type as the prototype (marked within the first and only param in the params array of the prototype)
     */
-    bool sensedInstance(const ros2_bdi_interfaces::msg::Belief& new_belief);
+    bool sensedInstance(const ros2_bdi_interfaces::msg::Belief& new_belief, const ros2_bdi_interfaces::msg::Belief& proto) const;
 
     /*
-        perform update if the new predicate is valid with respect to the expected sensed one specified in the constructor
+        true if the new predicate is valid with respect to its prototype @proto specified in the constructor
 
         SAME name as the prototype
         PARAMS number remain fixed (otherwise it's another predicate), but individually they do not need to remain the same
     */
-    bool sensedPredicate(const ros2_bdi_interfaces::msg::Belief& new_belief);
+    bool sensedPredicate(const ros2_bdi_interfaces::msg::Belief& new_belief, const ros2_bdi_interfaces::msg::Belief& proto) const;
 
     /*
-        perform update if the new predicate is valid with respect to the expected sensed one specified in the constructor
+        true if the new function is valid with respect to its prototype @proto specified in the constructor
 
         SAME name and exact same params as the prototype
         JUST VALUE can differ
     */
-    bool sensedFunction(const ros2_bdi_interfaces::msg::Belief& new_belief);
+    bool sensedFunction(const ros2_bdi_interfaces::msg::Belief& new_belief, const ros2_bdi_interfaces::msg::Belief& proto) const;
+
+    /*
+        Key identifying the sensed belief in last_sent_ (value excluded)
+    */
+    std::string sensedKey(const ros2_bdi_interfaces::msg::Belief& belief);
+
+    /*
+        Check @belief against its last sent state: return true and record it as sent (ADD/UPD are the same op here)
+        iff it differs from it (different op, function value outside deadband or refresh interval passed),
+        false otherwise (i.e. sending it would be redundant)
+    */
+    bool forwardSensing(const ros2_bdi_interfaces::msg::Belief& belief, const UpdOperation& op);
+
+    /*
+        Put @belief among the pending ones to be published at the end of the current coalescing window
+        (overriding any previous pending sensing of the same belief)
+    */
+    void coalesceSensing(const ros2_bdi_interfaces::msg::Belief& belief, const UpdOperation& op);
+
+    /*
+        Publish the sensings coalesced in the last window (or performSensing() call) as a del belief set followed by an add belief set
+    */
+    void flushCoalescedSensings();
+
+    // last sent state of a belief
+    struct LastSent
+    {
+        UpdOperation op;    // ADD or DEL
+        float value;        // meaningful just for functions
+        std::chrono::steady_clock::time_point sent_at;
+    };
 
     // agent id that defines the namespace in which the node operates
     std::string agent_id_;
@@ -135,15 +269,61 @@ private:
     //  - function type + args already defined (so the value is the property "added" by the sensor)
     std::map<std::string, ros2_bdi_interfaces::msg::Belief> proto_belief_map_;
 
-    // last sensed belief (to be added/deleted/updated)
-    ros2_bdi_interfaces::msg::Belief last_sensed_;
-    // last sense operation
-    UpdOperation last_sensed_op_;
+    // lock on last_sent_, pending sensings and counters
+    std::mutex mtx_sensing_;
 
-    // callback to perform main loop of work regularly
+    // belief key -> last sent state of it
+    std::map<std::string, LastSent> last_sent_;
+
+    // suppress unchanged re-sendings
+    bool dedup_;
+    // refresh interval for unchanged beliefs (<= 0 -> never)
+    int dedup_refresh_ms_;
+    // function values within deadband from the last sent one are considered unchanged
+    double function_deadband_;
+
+    // belief key -> sensing (belief + op) pending in the current coalescing window
+    std::map<std::string, std::pair<ros2_bdi_interfaces::msg::Belief, UpdOperation>> pending_sensings_;
+    // timer flushing pending_sensings_ at the end of every coalescing window (null if coalescing disabled)
+    rclcpp::TimerBase::SharedPtr coalesce_timer_;
+    // within a performSensing() call, i.e. sensings are batched in pending_sensings_
+    bool batching_;
+
+    // sensed beliefs forwarded to the belief set so far
+    uint64_t forwarded_count_;
+    // sensed beliefs suppressed so far
+    uint64_t suppressed_count_;
+    // belief/belief set msgs published so far
+    uint64_t published_msgs_count_;
+
+    // timer logging the msgs published/saved per second (debug only) and counters at its last tick
+    rclcpp::TimerBase::SharedPtr stats_timer_;
+    uint64_t stats_last_published_;
+    uint64_t stats_last_saved_;
+
+    // callback to perform main loop of work regularly (heartbeat in event mode)
     rclcpp::TimerBase::SharedPtr sensor_timer_;
+    // main loop of sensing started
+    bool sensing_started_;
+
+    // performSensing called as inputs change, no more often than min_sensing_interval_ (otherwise periodically)
+    bool event_triggered_;
+    std::chrono::milliseconds min_sensing_interval_;
+    // one shot timer calling performSensing as soon as min_sensing_interval_ has passed (event mode, throttled input change)
+    rclcpp::TimerBase::SharedPtr throttle_timer_;
+    // last performSensing call
+    std::chrono::steady_clock::time_point last_sensing_at_;
+
+    // first input change not looked at by performSensing yet
+    std::optional<std::chrono::steady_clock::time_point> first_input_at_;
+    // input change -> publication latency samples since the last stats log (sum and max in ms)
+    uint64_t latency_samples_;
+    double latency_sum_ms_;
+    double latency_max_ms_;
     // timer to call one time -> to activate the main loop of sensing (maybe later)
     rclcpp::TimerBase::SharedPtr start_timer_;
+    // lifecycle status subscriber, to start sensing when the belief manager is running (null once started)
+    rclcpp::Subscription<ros2_bdi_interfaces::msg::LifecycleStatus>::SharedPtr lifecycle_status_subscriber_;
 
     // ros2 publisher to perform publish to topic agent_id_/add_belief, when sense requires it
     rclcpp::Publisher<ros2_bdi_interfaces::msg::Belief>::SharedPtr add_belief_publisher_;
@@ -153,6 +333,8 @@ private:
     rclcpp::Publisher<ros2_bdi_interfaces::msg::Belief>::SharedPtr del_belief_publisher_;
     // ros2 publisher to perform publish to topic agent_id_/del_belief_set, when sense requires it
     rclcpp::Publisher<ros2_bdi_interfaces::msg::BeliefSet>::SharedPtr del_belief_set_publisher_;
+    // ros2 client to the agent_id_/load_static_beliefs service, when senseStatic requires it
+    rclcpp::Client<ros2_bdi_interfaces::srv::LoadStaticBeliefs>::SharedPtr load_static_beliefs_client_;
 };
 
 #endif  // SENSOR_H_
\ No newline at end of file
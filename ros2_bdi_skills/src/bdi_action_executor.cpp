@@ -1,5 +1,7 @@
 // header file for bdi action executor abstract class
 #include "ros2_bdi_skills/bdi_action_executor.hpp"
+// Inner logic + ROS2 PARAMS & FIXED GLOBAL VALUES for action executors
+#include "ros2_bdi_skills/params/action_executor_params.hpp"
 // Inner logic + ROS2 PARAMS & FIXED GLOBAL VALUES for Belief Manager node (for belief set topic)
 #include "ros2_bdi_core/params/belief_manager_params.hpp"
 // Inner logic + ROS2 PARAMS & FIXED GLOBAL VALUES for Scheduler node (for belief set topic)
@@ -43,6 +45,7 @@ using BDICommunications::CheckDesireResult;
 using BDICommunications::UpdBeliefResult;
 using BDICommunications::UpdDesireResult;
 using BDICommunications::CommunicationsClient;
+using BDICommunications::RemoteBeliefMirror;
 
 
 /*
@@ -56,6 +59,11 @@ BDIActionExecutor::BDIActionExecutor(const string action_name, const int working
       this->declare_parameter(PARAM_AGENT_ID, "agent0");
       this->declare_parameter(PARAM_AGENT_GROUP_ID, "agent0_group");
       this->declare_parameter(PARAM_DEBUG, true);
+      this->declare_parameter(PARAM_FEEDBACK_PROGRESS_DELTA, FEEDBACK_PROGRESS_DELTA_DEFAULT);
+
+      debug_ = this->get_parameter(PARAM_DEBUG).as_bool();
+      progress_ = 0.0f;
+      last_feedback_progress_ = -1.0f;
 
       // store action name
       action_name_ = action_name;
@@ -68,6 +76,8 @@ BDIActionExecutor::BDIActionExecutor(const string action_name, const int working
 
       comm_client_ = std::make_shared<CommunicationsClient>();
 
+      belief_mirror_ = RemoteBeliefMirror::getInstance();
+
       // set agent id as specialized arguments
       vector<string> specialized_arguments = vector<string>();
       if(agent_id_as_specialized_arg)
@@ -85,9 +95,18 @@ BDIActionExecutor::BDIActionExecutor(const string action_name, const int working
       this->trigger_transition(lifecycle_msgs::msg::Transition::TRANSITION_CONFIGURE);
   }
 
+/*
+  Destructor: stop monitoring the desires, so that the mirror shared within the process never calls back a destroyed node
+  (unwatch waits for a running callback, if any, to return)
+*/
+BDIActionExecutor::~BDIActionExecutor()
+{
+  stopMonitoring();
+}
+
 /*
   Method called when node is triggered by the Executor node of PlanSys2
-  Progress for the action sets to 0.0f
+  Progress for the action sets to 0.0f, arguments and params read here once for the whole execution
 */
 rclcpp_lifecycle::node_interfaces::LifecycleNodeInterface::CallbackReturn
   BDIActionExecutor::on_activate(const rclcpp_lifecycle::State & previous_state)
@@ -99,7 +118,18 @@ rclcpp_lifecycle::node_interfaces::LifecycleNodeInterface::CallbackReturn
     executor_client_ = std::make_shared<ExecutorClient>();
 
     progress_ = 0.0f;
-    if(this->get_parameter(PARAM_DEBUG).as_bool())
+    last_feedback_progress_ = -1.0f;//first feedback sent anyway
+    feedback_progress_delta_ = this->get_parameter(PARAM_FEEDBACK_PROGRESS_DELTA).as_double();
+    debug_ = this->get_parameter(PARAM_DEBUG).as_bool();
+
+    // arguments of the action execution (set by plansys2 executor before activation)
+    action_params_ = get_arguments();
+    feedback_prefix_ = "[" + action_name_;
+    for(const string& param : action_params_)
+      feedback_prefix_ += " " + param;
+    feedback_prefix_ += "] ";
+
+    if(debug_)
       RCLCPP_INFO(this->get_logger(), "Action executor controller for \"" + action_name_ + "\" ready for execution");
     
     // exec_status_to_planner_publisher_->on_activate();
@@ -178,10 +208,7 @@ rclcpp_lifecycle::node_interfaces::LifecycleNodeInterface::CallbackReturn
     if(executor_client_.use_count() > 0)
       executor_client_.reset();
     
-    monitored_bsets_.clear();
-    for(auto monitor_desire : monitored_desires_)
-      std::get<2>(monitor_desire).reset();//should allow to cancel subscription to topic (https://answers.ros.org/question/354792/rclcpp-how-to-unsubscribe-from-a-topic/)
-    monitored_desires_.clear();
+    stopMonitoring();
 
     // exec_status_to_planner_publisher_->on_deactivate();
 
@@ -195,29 +222,36 @@ rclcpp_lifecycle::node_interfaces::LifecycleNodeInterface::CallbackReturn
 */
 void BDIActionExecutor::do_work()
 {
-  action_params_ = get_arguments();//get arguments of action execution
+  notifyFulfilledDesires();
   progress_ += advanceWork();
   if(progress_ >= 1.0)
     execSuccess();//send feedback of complete execution to plansys2 executor (node deactivate again)
 
   else
-  {
-    float progress_100 = ((progress_ * 100.0) < 100.0)? (progress_ * 100.0) : 100.0; 
-    string progress_100S = std::to_string(progress_100);
-    progress_100S = progress_100S.substr(0, progress_100S.find(".", 0)+2);//just save one decimal
+    sendProgressFeedback();
+}
 
-    string params_string = "";
-    for(int i = 0; i < action_params_.size(); i++)
-      params_string += " " + action_params_[i];
-    
-    //feedback string to be sent to plansys2 executor along with the progress_status (logged if debug=TRUE)
-    string feedback_string = string("[" + action_name_ +  params_string
-          + "] "+ progress_100S + "%%");
-    send_feedback(progress_, feedback_string);//send feedback to plansys2 executor
+/*
+  Send progress feedback to plansys2 executor (logged if debug=TRUE) just if progress has advanced
+  at least feedback_progress_delta_ since the last one sent, building its string only then
+*/
+void BDIActionExecutor::sendProgressFeedback()
+{
+  if(last_feedback_progress_ >= 0.0f && std::abs(progress_ - last_feedback_progress_) < feedback_progress_delta_)
+    return;//progress has not changed enough
+  last_feedback_progress_ = progress_;
 
-    if(this->get_parameter(PARAM_DEBUG).as_bool())
-      RCLCPP_INFO(this->get_logger(), feedback_string);
-  }
+  float progress_100 = ((progress_ * 100.0) < 100.0)? (progress_ * 100.0) : 100.0; 
+  char progress_100S[16];
+  snprintf(progress_100S, sizeof(progress_100S), "%.1f%%", progress_100);//just one decimal
+
+  //feedback string to be sent to plansys2 executor along with the progress_status
+  feedback_string_.assign(feedback_prefix_);
+  feedback_string_.append(progress_100S);
+  send_feedback(progress_, feedback_string_);//send feedback to plansys2 executor
+
+  if(debug_)
+    RCLCPP_INFO(this->get_logger(), "%s", feedback_string_.c_str());
 }
 
 /*
@@ -254,44 +288,113 @@ UpdDesireResult BDIActionExecutor::sendUpdDesireRequest(const string& agent_ref,
   return res;
 }
 
+/*
+  Async counterparts of the utility methods above: they return immediately with a future holding the result
+  as soon as the response arrives
+*/
+std::shared_future<CheckBeliefResult> BDIActionExecutor::sendCheckBeliefRequestAsync(const string& agent_ref, const Belief& belief)
+{
+  return comm_client_->checkBeliefRequestAsync(agent_ref, agent_group_, belief);
+}
+
+std::shared_future<UpdBeliefResult> BDIActionExecutor::sendUpdBeliefRequestAsync(const string& agent_ref, const Belief& belief, const UpdOperation& op)
+{
+  return comm_client_->updBeliefRequestAsync(agent_ref, agent_group_, belief, op);
+}
+
+std::shared_future<CheckDesireResult> BDIActionExecutor::sendCheckDesireRequestAsync(const string& agent_ref, const Desire& desire)
+{
+  return comm_client_->checkDesireRequestAsync(agent_ref, agent_group_, desire);
+}
+
+std::shared_future<UpdDesireResult> BDIActionExecutor::sendUpdDesireRequestAsync(const string& agent_ref, const Desire& desire, const UpdOperation& op, const bool& monitor_fulfill)
+{
+  // monitor from here (i.e. within the executor thread), since the response is processed in the comm. client one
+  if(op == BDICommunications::ADD && monitor_fulfill)
+    monitor(agent_ref, desire);
+  return comm_client_->updDesireRequestAsync(agent_ref, agent_group_, desire, op);
+}
+
+/*
+  Batched variants of the utility methods above: beliefs/desires are sent in a single request to the agent
+  which applies them as a single belief/desire set operation, returning per item results (same order)
+*/
+vector<CheckBeliefResult> BDIActionExecutor::sendCheckBeliefBatchRequest(const string& agent_ref, const vector<Belief>& beliefs)
+{
+  return comm_client_->checkBeliefBatchRequest(agent_ref, agent_group_, beliefs);
+}
+
+vector<UpdBeliefResult> BDIActionExecutor::sendUpdBeliefBatchRequest(const string& agent_ref, const vector<Belief>& beliefs, const UpdOperation& op)
+{
+  return comm_client_->updBeliefBatchRequest(agent_ref, agent_group_, beliefs, op);
+}
+
+vector<CheckDesireResult> BDIActionExecutor::sendCheckDesireBatchRequest(const string& agent_ref, const vector<Desire>& desires)
+{
+  return comm_client_->checkDesireBatchRequest(agent_ref, agent_group_, desires);
+}
+
+vector<UpdDesireResult> BDIActionExecutor::sendUpdDesireBatchRequest(const string& agent_ref, const vector<Desire>& desires, const UpdOperation& op, const bool& monitor_fulfill)
+{
+  auto res = comm_client_->updDesireBatchRequest(agent_ref, agent_group_, desires, op);
+  for(auto desire_res : res)
+    if(desire_res.accepted && desire_res.performed && monitor_fulfill)
+      monitor(agent_ref, desire_res.desire);
+  return res;
+}
+
 /*
   if no monitored desire, just return false
   otherwise check if it is fulfilled in the respective monitored belief set
 */
 bool BDIActionExecutor::isMonitoredDesireFulfilled(const std::string& agent_ref, const ros2_bdi_interfaces::msg::Desire& desire)
 {
-  for(auto monitor_desire : monitored_desires_)
-  {
-    if(std::get<0>(monitor_desire) == agent_ref && std::get<1>(monitor_desire) == ManagedDesire{desire})
-      return monitored_bsets_.find(agent_ref) != monitored_bsets_.end() &&
-        (ManagedDesire{desire}).isFulfilled(monitored_bsets_.find(agent_ref)->second);
-  }   
-  return false;
+  auto it = monitored_desires_.find(std::make_pair(agent_ref, ManagedDesire{desire}));
+  return it != monitored_desires_.end() && belief_mirror_->isFulfilled(it->second);
 }
 
 /*
-  Monitor belief set update of an agent 
+  Monitor the fulfillment of desire in the belief set of an agent (through the mirror shared within the process)
 */
 void BDIActionExecutor::monitor(const string& agent_ref, const Desire& desire)
 {
-  rclcpp::QoS qos_reliable = rclcpp::QoS(10);
-  qos_reliable.reliable();
+  auto key = std::make_pair(agent_ref, ManagedDesire{desire});
+  auto it = monitored_desires_.find(key);
+  if(it != monitored_desires_.end())
+    belief_mirror_->unwatch(it->second);//same desire monitored again: replaced by the new watch
+
+  monitored_desires_[key] = belief_mirror_->watch(agent_ref, desire, 
+    [this](const string& agent_ref, const Desire& desire){
+      mtx_fulfilled_.lock();
+      fulfilled_desires_.push_back(std::make_pair(agent_ref, desire));
+      mtx_fulfilled_.unlock();
+    });
+}
 
-  rclcpp::Subscription<ros2_bdi_interfaces::msg::BeliefSet>::SharedPtr agent_belief_set_subscriber = this->create_subscription<BeliefSet>(
-            "/"+agent_ref+"/"+BELIEF_SET_TOPIC, qos_reliable,
-            bind(&BDIActionExecutor::agentBeliefSetCallback, this, _1));
+/*
+  Stop monitoring all the desires
+*/
+void BDIActionExecutor::stopMonitoring()
+{
+  for(auto monitored_desire : monitored_desires_)
+    belief_mirror_->unwatch(monitored_desire.second);
+  monitored_desires_.clear();
 
-  monitored_desires_.push_back(std::make_tuple(agent_ref, ManagedDesire{desire}, agent_belief_set_subscriber));
+  mtx_fulfilled_.lock();
+  fulfilled_desires_.clear();
+  mtx_fulfilled_.unlock();
 }
 
 /*
-  update the current monitored belief set 
+  Notify monitoredDesireFulfilled of the monitored desires fulfilled since the last call
 */
-void BDIActionExecutor::agentBeliefSetCallback(const BeliefSet::SharedPtr msg)
+void BDIActionExecutor::notifyFulfilledDesires()
 {
-  map<string, set<ManagedBelief>>::iterator it = monitored_bsets_.find(msg->agent_id);
-  if(it != monitored_bsets_.end())
-    it->second = BDIFilter::extractMGBeliefs(msg->value);
-  else
-    monitored_bsets_.insert(monitored_bsets_.begin(), pair<string, set<ManagedBelief>>(msg->agent_id, BDIFilter::extractMGBeliefs(msg->value)));
+  vector<pair<string, Desire>> fulfilled;
+  mtx_fulfilled_.lock();
+  fulfilled.swap(fulfilled_desires_);
+  mtx_fulfilled_.unlock();
+
+  for(auto agent_desire : fulfilled)
+    monitoredDesireFulfilled(agent_desire.first, agent_desire.second);
 }
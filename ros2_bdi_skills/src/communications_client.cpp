@@ -9,7 +9,19 @@
 //seconds to wait before giving up on waiting for the response
 #define WAIT_RESPONSE_TIMEOUT 1
 
+//seconds after which an async request still waiting for its response is considered failed 
+//(greater than the max time the queried agent takes to confirm a write request)
+#define RESPONSE_DEADLINE 5
+
+//seconds during which a service found down is considered still down (requests to it fail immediately)
+#define SRV_DOWN_RETRY_INTERVAL 2
+
 using std::string;
+using std::vector;
+using std::map;
+using std::function;
+using std::shared_future;
+using std::chrono::steady_clock;
 
 using ros2_bdi_interfaces::msg::Belief;                
 using ros2_bdi_interfaces::msg::Desire;  
@@ -17,6 +29,10 @@ using ros2_bdi_interfaces::srv::CheckBelief;
 using ros2_bdi_interfaces::srv::UpdBeliefSet;  
 using ros2_bdi_interfaces::srv::CheckDesire;  
 using ros2_bdi_interfaces::srv::UpdDesireSet; 
+using ros2_bdi_interfaces::srv::CheckBeliefBatch;  
+using ros2_bdi_interfaces::srv::UpdBeliefSetBatch;  
+using ros2_bdi_interfaces::srv::CheckDesireBatch;  
+using ros2_bdi_interfaces::srv::UpdDesireSetBatch; 
 
 using BDICommunications::CommunicationsClient;
 using BDICommunications::UpdOperation;
@@ -28,55 +44,188 @@ using BDICommunications::UpdDesireResult;
 CommunicationsClient::CommunicationsClient()
 {
     // node to perform async request to communication services of queried agent(s)
-    // make the node spin just while waiting response or until timeout is reached
+    // spinning in its own thread, so that responses are processed without blocking the caller
     node_ = rclcpp::Node::make_shared("communications_client");
+    executor_ = std::make_shared<rclcpp::executors::SingleThreadedExecutor>();
+    executor_->add_node(node_);
+    next_request_id_ = 0;
+    spin_thread_ = std::thread([this](){ executor_->spin(); });
 }
 
-CheckBeliefResult CommunicationsClient::checkBeliefRequest(const string& agent_ref, const string& agent_group, const Belief& belief)
+CommunicationsClient::~CommunicationsClient()
 {
-    string serviceName = "/" + agent_ref + "/" + CK_BELIEF_SRV;
-    CheckBeliefResult res{belief, false, false};
+    executor_->cancel();
+    if(spin_thread_.joinable())
+        spin_thread_.join();
+}
+
+/*
+    Return the client for @serviceName stored in @clients, creating it just the first time it's needed
+*/
+template<typename ServiceT>
+typename rclcpp::Client<ServiceT>::SharedPtr CommunicationsClient::getClient(const string& serviceName,
+        map<string, typename rclcpp::Client<ServiceT>::SharedPtr>& clients)
+{
+    mtx_clients_.lock();
+    auto it = clients.find(serviceName);
+    if(it == clients.end())
+        it = clients.emplace(serviceName, node_->create_client<ServiceT>(serviceName)).first;
+    auto client = it->second;
+    mtx_clients_.unlock();
+    return client;
+}
+
+/*
+    Check whether the service behind @client is up, relying on the cached availability of it:
+    block (max WAIT_SRV_UP) just when the service has not been seen up yet and it has not been found down recently
+*/
+bool CommunicationsClient::isServiceUp(const rclcpp::ClientBase::SharedPtr& client)
+{
+    string serviceName = client->get_service_name();
+    if(client->service_is_ready())
+    {
+        mtx_clients_.lock();
+        srv_down_since_.erase(serviceName);
+        mtx_clients_.unlock();
+        return true;
+    }
+
+    mtx_clients_.lock();
+    auto it = srv_down_since_.find(serviceName);
+    bool recentlyDown = it != srv_down_since_.end() && 
+        steady_clock::now() - it->second < std::chrono::seconds(SRV_DOWN_RETRY_INTERVAL);
+    mtx_clients_.unlock();
+    if(recentlyDown)
+        return false;
+
+    bool up = client->wait_for_service(std::chrono::seconds(WAIT_SRV_UP));
+    mtx_clients_.lock();
+    if(up)
+        srv_down_since_.erase(serviceName);
+    else
+        srv_down_since_[serviceName] = steady_clock::now();
+    mtx_clients_.unlock();
+    return up;
+}
+
+/*
+    Send @request through @client, fulfilling the returned future with @res, 
+    filled in with the response by @fillRes (or left as it is if the service appears to be down 
+    or no response has been received within RESPONSE_DEADLINE)
+*/
+template<typename ServiceT, typename ResultT>
+shared_future<ResultT> CommunicationsClient::sendRequestAsync(const typename rclcpp::Client<ServiceT>::SharedPtr& client,
+        const typename ServiceT::Request::SharedPtr& request, const ResultT& res,
+        function<void(ResultT&, const typename ServiceT::Response::SharedPtr&)> fillRes,
+        function<void(const ResultT&)> callback)
+{
+    auto promise = std::make_shared<std::promise<ResultT>>();
+    shared_future<ResultT> future = promise->get_future().share();
+    // set once the promise has been fulfilled
+    auto done = std::make_shared<std::atomic<bool>>(false);
 
     try{
-        ck_belief_client_ = node_->create_client<CheckBelief>(serviceName);
-    
-        while (!ck_belief_client_->wait_for_service(std::chrono::seconds(WAIT_SRV_UP))) {
+        if(!isServiceUp(client))
+        {
             RCLCPP_ERROR_STREAM(
                 node_->get_logger(),
-                ck_belief_client_->get_service_name() <<
+                client->get_service_name() <<
                     " service appears to be down");
-                    
-            return res;
+            
+            promise->set_value(res);
+            if(callback) callback(res);
+            return future;
         }
-        auto request = std::make_shared<CheckBelief::Request>();
-        request->belief = belief;
-        request->agent_group = agent_group;
-        auto future_result = ck_belief_client_->async_send_request(request);
 
-        if (rclcpp::spin_until_future_complete(node_, future_result, std::chrono::seconds(WAIT_RESPONSE_TIMEOUT)) !=
-            rclcpp::FutureReturnCode::SUCCESS)
-        {
-            return res;
-        }
+        string serviceName = client->get_service_name();
+        auto logger = node_->get_logger();
+        uint64_t reqId = next_request_id_++;
 
-        auto response = future_result.get();
-        res.accepted = response->accepted;
-        res.found = response->found;
-    
+        // whichever comes first between the response and the deadline fulfills the promise, dropping the deadline timer
+        auto complete = [this, promise, callback, done, reqId](const ResultT& final_res)
+        {
+            mtx_pending_.lock();
+            auto it = response_deadlines_.find(reqId);
+            if(it != response_deadlines_.end())
+            {
+                it->second->cancel();
+                response_deadlines_.erase(it);
+            }
+            mtx_pending_.unlock();
+
+            if(done->exchange(true))
+                return;
+            promise->set_value(final_res);
+            if(callback) callback(final_res);
+        };
+
+        mtx_pending_.lock();
+        response_deadlines_[reqId] = node_->create_wall_timer(std::chrono::seconds(RESPONSE_DEADLINE), 
+            [complete, res, serviceName, logger, done]()
+            {
+                if(!(*done))
+                    RCLCPP_ERROR(logger, "No response received from " + serviceName + " within the deadline");
+                complete(res);
+            });
+        mtx_pending_.unlock();
+
+        client->async_send_request(request, 
+            [complete, res, fillRes, serviceName, logger](typename rclcpp::Client<ServiceT>::SharedFuture future_response)
+            {
+                ResultT upd_res = res;
+                try{
+                    fillRes(upd_res, future_response.get());
+                }
+                catch(const std::exception &e)
+                {
+                    RCLCPP_ERROR(logger, "Response error in " + serviceName);
+                }
+                complete(upd_res);
+            });
     }
     catch(const rclcpp::exceptions::RCLError& rclerr)
     {
         RCLCPP_ERROR(node_->get_logger(), rclerr.what());
+        if(!done->exchange(true))
+        {
+            promise->set_value(res);
+            if(callback) callback(res);
+        }
     }
-    catch(const std::exception &e)
-    {
-        RCLCPP_ERROR(node_->get_logger(), "Response error in " + serviceName);
-    }
+    
+    return future;
+}
 
-    return res;
+/*
+    Wait for @future to be fulfilled at most WAIT_RESPONSE_TIMEOUT, returning @timeoutRes otherwise
+*/
+template<typename ResultT>
+ResultT CommunicationsClient::waitResult(const shared_future<ResultT>& future, const ResultT& timeoutRes)
+{
+    if(future.wait_for(std::chrono::seconds(WAIT_RESPONSE_TIMEOUT)) != std::future_status::ready)
+        return timeoutRes;
+    return future.get();
 }
 
-UpdBeliefResult CommunicationsClient::updBeliefRequest(const string& agent_ref, const string& agent_group, const Belief& belief, const UpdOperation& op)
+shared_future<CheckBeliefResult> CommunicationsClient::checkBeliefRequestAsync(const string& agent_ref, const string& agent_group, const Belief& belief,
+    function<void(const CheckBeliefResult&)> callback)
+{
+    string serviceName = "/" + agent_ref + "/" + CK_BELIEF_SRV;
+    CheckBeliefResult res{belief, false, false};
+
+    auto request = std::make_shared<CheckBelief::Request>();
+    request->belief = belief;
+    request->agent_group = agent_group;
+    
+    return sendRequestAsync<CheckBelief, CheckBeliefResult>(getClient<CheckBelief>(serviceName, ck_belief_clients_), request, res,
+        [](CheckBeliefResult& r, const CheckBelief::Response::SharedPtr& response){
+            r.accepted = response->accepted;
+            r.found = response->found;
+        }, callback);
+}
+
+shared_future<UpdBeliefResult> CommunicationsClient::updBeliefRequestAsync(const string& agent_ref, const string& agent_group, const Belief& belief, const UpdOperation& op,
+    function<void(const UpdBeliefResult&)> callback)
 {
     string serviceName = "/" + agent_ref + "/";
     if(op == ADD)
@@ -86,134 +235,202 @@ UpdBeliefResult CommunicationsClient::updBeliefRequest(const string& agent_ref,
 
     UpdBeliefResult res{belief, op, false, false};
 
-    try{
-        upd_belief_client_ = node_->create_client<UpdBeliefSet>(serviceName);
+    auto request = std::make_shared<UpdBeliefSet::Request>();
+    request->belief = belief;
+    request->agent_group = agent_group;
 
-        while (!upd_belief_client_->wait_for_service(std::chrono::seconds(WAIT_SRV_UP))) {
-            RCLCPP_ERROR_STREAM(
-                node_->get_logger(),
-                upd_belief_client_->get_service_name() <<
-                    " service appears to be down");
-                    
-            return res;
-        }
+    return sendRequestAsync<UpdBeliefSet, UpdBeliefResult>(getClient<UpdBeliefSet>(serviceName, upd_belief_clients_), request, res,
+        [](UpdBeliefResult& r, const UpdBeliefSet::Response::SharedPtr& response){
+            r.accepted = response->accepted;
+            r.performed = response->updated;
+        }, callback);
+}
 
-        auto request = std::make_shared<UpdBeliefSet::Request>();
-        request->belief = belief;
-        request->agent_group = agent_group;
-        auto future_result = upd_belief_client_->async_send_request(request);
+shared_future<CheckDesireResult> CommunicationsClient::checkDesireRequestAsync(const string& agent_ref, const string& agent_group, const Desire& desire,
+    function<void(const CheckDesireResult&)> callback)
+{
+    string serviceName = "/" + agent_ref + "/" + CK_DESIRE_SRV;
+    CheckDesireResult res{desire, false, false};
 
-        if (rclcpp::spin_until_future_complete(node_, future_result, std::chrono::seconds(WAIT_RESPONSE_TIMEOUT)) !=
-            rclcpp::FutureReturnCode::SUCCESS)
-        {
-            return res;
-        }
+    auto request = std::make_shared<CheckDesire::Request>();
+    request->desire = desire;
+    request->agent_group = agent_group;
 
-        auto response = future_result.get();
-        res.accepted = response->accepted;
-        res.performed = response->updated;
-    }
-    catch(const rclcpp::exceptions::RCLError& rclerr)
-    {
-        RCLCPP_ERROR(node_->get_logger(), rclerr.what());
-    }
-    catch(const std::exception &e)
-    {
-        RCLCPP_ERROR(node_->get_logger(), "Response error in " + serviceName);
-    }
+    return sendRequestAsync<CheckDesire, CheckDesireResult>(getClient<CheckDesire>(serviceName, ck_desire_clients_), request, res,
+        [](CheckDesireResult& r, const CheckDesire::Response::SharedPtr& response){
+            r.accepted = response->accepted;
+            r.found = response->found;
+        }, callback);
+}
 
-    return res;
+shared_future<UpdDesireResult> CommunicationsClient::updDesireRequestAsync(const string& agent_ref, const string& agent_group, const Desire& desire, const UpdOperation& op,
+    function<void(const UpdDesireResult&)> callback)
+{
+    string serviceName = "/" + agent_ref + "/";
+    if(op == ADD)
+        serviceName += ADD_DESIRE_SRV;
+    else
+        serviceName += DEL_DESIRE_SRV;
+
+    UpdDesireResult res{desire, op, false, false};
+
+    auto request = std::make_shared<UpdDesireSet::Request>();
+    request->desire = desire;
+    request->agent_group = agent_group;
+
+    return sendRequestAsync<UpdDesireSet, UpdDesireResult>(getClient<UpdDesireSet>(serviceName, upd_desire_clients_), request, res,
+        [](UpdDesireResult& r, const UpdDesireSet::Response::SharedPtr& response){
+            r.accepted = response->accepted;
+            r.performed = response->updated;
+        }, callback);
+}
+
+CheckBeliefResult CommunicationsClient::checkBeliefRequest(const string& agent_ref, const string& agent_group, const Belief& belief)
+{
+    return waitResult(checkBeliefRequestAsync(agent_ref, agent_group, belief), CheckBeliefResult{belief, false, false});
+}
+
+UpdBeliefResult CommunicationsClient::updBeliefRequest(const string& agent_ref, const string& agent_group, const Belief& belief, const UpdOperation& op)
+{
+    return waitResult(updBeliefRequestAsync(agent_ref, agent_group, belief, op), UpdBeliefResult{belief, op, false, false});
 }
 
 CheckDesireResult CommunicationsClient::checkDesireRequest(const string& agent_ref, const string& agent_group, const Desire& desire)
 {
-    string serviceName = "/" + agent_ref + "/" + CK_DESIRE_SRV;
-    CheckDesireResult res{desire, false, false};
+    return waitResult(checkDesireRequestAsync(agent_ref, agent_group, desire), CheckDesireResult{desire, false, false});
+}
 
-    try{
-        ck_desire_client_ = node_->create_client<CheckDesire>(serviceName);
-        
-        while (!ck_desire_client_->wait_for_service(std::chrono::seconds(WAIT_SRV_UP))) {
-            RCLCPP_ERROR_STREAM(
-                node_->get_logger(),
-                ck_desire_client_->get_service_name() <<
-                    " service appears to be down");
-                    
-            return res;
-        }
+UpdDesireResult CommunicationsClient::updDesireRequest(const string& agent_ref, const string& agent_group, const Desire& desire, const UpdOperation& op)
+{
+    return waitResult(updDesireRequestAsync(agent_ref, agent_group, desire, op), UpdDesireResult{desire, op, false, false});
+}
 
-        auto request = std::make_shared<CheckDesire::Request>();
-        request->desire = desire;
-        request->agent_group = agent_group;
-        auto future_result = ck_desire_client_->async_send_request(request);
+/*
+    Build the default (i.e. not accepted) per item results for a batched request
+*/
+template<typename ItemT, typename ResultT>
+static vector<ResultT> defaultBatchResults(const vector<ItemT>& items, std::function<ResultT(const ItemT&)> buildRes)
+{
+    vector<ResultT> res;
+    for(const ItemT& item : items)
+        res.push_back(buildRes(item));
+    return res;
+}
 
-        if (rclcpp::spin_until_future_complete(node_, future_result, std::chrono::seconds(WAIT_RESPONSE_TIMEOUT)) !=
-            rclcpp::FutureReturnCode::SUCCESS)
-        {
-            return res;
-        }
+shared_future<vector<CheckBeliefResult>> CommunicationsClient::checkBeliefBatchRequestAsync(const string& agent_ref, const string& agent_group, const vector<Belief>& beliefs,
+    function<void(const vector<CheckBeliefResult>&)> callback)
+{
+    string serviceName = "/" + agent_ref + "/" + CK_BELIEF_BATCH_SRV;
+    vector<CheckBeliefResult> res = defaultBatchResults<Belief, CheckBeliefResult>(beliefs, 
+        [](const Belief& b){ return CheckBeliefResult{b, false, false}; });
 
-        auto response = future_result.get();
-        res.accepted = response->accepted;
-        res.found = response->found;
-    }
-    catch(const rclcpp::exceptions::RCLError& rclerr)
-    {
-        RCLCPP_ERROR(node_->get_logger(), rclerr.what());
-    }
-    catch(const std::exception &e)
-    {
-        RCLCPP_ERROR(node_->get_logger(), "Response error in " + serviceName);
-    }
+    auto request = std::make_shared<CheckBeliefBatch::Request>();
+    request->beliefs = beliefs;
+    request->agent_group = agent_group;
     
-    return res;
+    return sendRequestAsync<CheckBeliefBatch, vector<CheckBeliefResult>>(getClient<CheckBeliefBatch>(serviceName, ck_belief_batch_clients_), request, res,
+        [](vector<CheckBeliefResult>& r, const CheckBeliefBatch::Response::SharedPtr& response){
+            for(int i = 0; i < r.size(); i++)
+            {
+                r[i].accepted = response->accepted;
+                r[i].found = i < response->found.size() && response->found[i];
+            }
+        }, callback);
 }
 
-UpdDesireResult CommunicationsClient::updDesireRequest(const string& agent_ref, const string& agent_group, const Desire& desire, const UpdOperation& op)
+shared_future<vector<UpdBeliefResult>> CommunicationsClient::updBeliefBatchRequestAsync(const string& agent_ref, const string& agent_group, const vector<Belief>& beliefs, const UpdOperation& op,
+    function<void(const vector<UpdBeliefResult>&)> callback)
 {
     string serviceName = "/" + agent_ref + "/";
     if(op == ADD)
-        serviceName += ADD_DESIRE_SRV;
+        serviceName += ADD_BELIEF_BATCH_SRV;
     else
-        serviceName += DEL_DESIRE_SRV;
+        serviceName += DEL_BELIEF_BATCH_SRV;
+
+    vector<UpdBeliefResult> res = defaultBatchResults<Belief, UpdBeliefResult>(beliefs, 
+        [op](const Belief& b){ return UpdBeliefResult{b, op, false, false}; });
+
+    auto request = std::make_shared<UpdBeliefSetBatch::Request>();
+    request->beliefs = beliefs;
+    request->agent_group = agent_group;
+
+    return sendRequestAsync<UpdBeliefSetBatch, vector<UpdBeliefResult>>(getClient<UpdBeliefSetBatch>(serviceName, upd_belief_batch_clients_), request, res,
+        [](vector<UpdBeliefResult>& r, const UpdBeliefSetBatch::Response::SharedPtr& response){
+            for(int i = 0; i < r.size(); i++)
+            {
+                r[i].accepted = response->accepted;
+                r[i].performed = i < response->updated.size() && response->updated[i];
+            }
+        }, callback);
+}
 
-    UpdDesireResult res{desire, op, false, false};
-    
-    try{
-        upd_desire_client_ = node_->create_client<UpdDesireSet>(serviceName);
+shared_future<vector<CheckDesireResult>> CommunicationsClient::checkDesireBatchRequestAsync(const string& agent_ref, const string& agent_group, const vector<Desire>& desires,
+    function<void(const vector<CheckDesireResult>&)> callback)
+{
+    string serviceName = "/" + agent_ref + "/" + CK_DESIRE_BATCH_SRV;
+    vector<CheckDesireResult> res = defaultBatchResults<Desire, CheckDesireResult>(desires, 
+        [](const Desire& d){ return CheckDesireResult{d, false, false}; });
+
+    auto request = std::make_shared<CheckDesireBatch::Request>();
+    request->desires = desires;
+    request->agent_group = agent_group;
+
+    return sendRequestAsync<CheckDesireBatch, vector<CheckDesireResult>>(getClient<CheckDesireBatch>(serviceName, ck_desire_batch_clients_), request, res,
+        [](vector<CheckDesireResult>& r, const CheckDesireBatch::Response::SharedPtr& response){
+            for(int i = 0; i < r.size(); i++)
+            {
+                r[i].accepted = response->accepted;
+                r[i].found = i < response->found.size() && response->found[i];
+            }
+        }, callback);
+}
 
-        while (!upd_desire_client_->wait_for_service(std::chrono::seconds(WAIT_SRV_UP))) {
-            RCLCPP_ERROR_STREAM(
-                node_->get_logger(),
-                upd_desire_client_->get_service_name() <<
-                    " service appears to be down");
-                    
-            return res;
-        }
+shared_future<vector<UpdDesireResult>> CommunicationsClient::updDesireBatchRequestAsync(const string& agent_ref, const string& agent_group, const vector<Desire>& desires, const UpdOperation& op,
+    function<void(const vector<UpdDesireResult>&)> callback)
+{
+    string serviceName = "/" + agent_ref + "/";
+    if(op == ADD)
+        serviceName += ADD_DESIRE_BATCH_SRV;
+    else
+        serviceName += DEL_DESIRE_BATCH_SRV;
+
+    vector<UpdDesireResult> res = defaultBatchResults<Desire, UpdDesireResult>(desires, 
+        [op](const Desire& d){ return UpdDesireResult{d, op, false, false}; });
+
+    auto request = std::make_shared<UpdDesireSetBatch::Request>();
+    request->desires = desires;
+    request->agent_group = agent_group;
+
+    return sendRequestAsync<UpdDesireSetBatch, vector<UpdDesireResult>>(getClient<UpdDesireSetBatch>(serviceName, upd_desire_batch_clients_), request, res,
+        [](vector<UpdDesireResult>& r, const UpdDesireSetBatch::Response::SharedPtr& response){
+            for(int i = 0; i < r.size(); i++)
+            {
+                r[i].accepted = response->accepted;
+                r[i].performed = i < response->updated.size() && response->updated[i];
+            }
+        }, callback);
+}
 
-        auto request = std::make_shared<UpdDesireSet::Request>();
-        request->desire = desire;
-        request->agent_group = agent_group;
-        auto future_result = upd_desire_client_->async_send_request(request);
+vector<CheckBeliefResult> CommunicationsClient::checkBeliefBatchRequest(const string& agent_ref, const string& agent_group, const vector<Belief>& beliefs)
+{
+    return waitResult(checkBeliefBatchRequestAsync(agent_ref, agent_group, beliefs), defaultBatchResults<Belief, CheckBeliefResult>(beliefs, 
+        [](const Belief& b){ return CheckBeliefResult{b, false, false}; }));
+}
 
-        if (rclcpp::spin_until_future_complete(node_, future_result, std::chrono::seconds(WAIT_RESPONSE_TIMEOUT)) !=
-            rclcpp::FutureReturnCode::SUCCESS)
-        {
-            return res;
-        }
+vector<UpdBeliefResult> CommunicationsClient::updBeliefBatchRequest(const string& agent_ref, const string& agent_group, const vector<Belief>& beliefs, const UpdOperation& op)
+{
+    return waitResult(updBeliefBatchRequestAsync(agent_ref, agent_group, beliefs, op), defaultBatchResults<Belief, UpdBeliefResult>(beliefs, 
+        [op](const Belief& b){ return UpdBeliefResult{b, op, false, false}; }));
+}
 
-        auto response = future_result.get();
-        res.accepted = response->accepted;
-        res.performed = response->updated;
-    }
-    catch(const rclcpp::exceptions::RCLError& rclerr)
-    {
-        RCLCPP_ERROR(node_->get_logger(), rclerr.what());
-    }
-    catch(const std::exception &e)
-    {
-        RCLCPP_ERROR(node_->get_logger(), "Response error in " + serviceName);
-    }
+vector<CheckDesireResult> CommunicationsClient::checkDesireBatchRequest(const string& agent_ref, const string& agent_group, const vector<Desire>& desires)
+{
+    return waitResult(checkDesireBatchRequestAsync(agent_ref, agent_group, desires), defaultBatchResults<Desire, CheckDesireResult>(desires, 
+        [](const Desire& d){ return CheckDesireResult{d, false, false}; }));
+}
 
-    return res;
+vector<UpdDesireResult> CommunicationsClient::updDesireBatchRequest(const string& agent_ref, const string& agent_group, const vector<Desire>& desires, const UpdOperation& op)
+{
+    return waitResult(updDesireBatchRequestAsync(agent_ref, agent_group, desires, op), defaultBatchResults<Desire, UpdDesireResult>(desires, 
+        [op](const Desire& d){ return UpdDesireResult{d, op, false, false}; }));
 }
@@ -0,0 +1,233 @@
+#include "ros2_bdi_skills/remote_belief_mirror.hpp"
+
+#include "ros2_bdi_utils/BDIFilter.hpp"
+#include "ros2_bdi_utils/StaticBeliefSegment.hpp"
+
+// Inner logic + ROS2 PARAMS & FIXED GLOBAL VALUES for Belief Manager node (for belief set topics)
+#include "ros2_bdi_core/params/belief_manager_params.hpp"
+
+//whole belief set msgs skipped while in sync before applying one anyway (in case a delta went missing unnoticed)
+#define FULL_BELIEF_SET_RESYNC_MSGS 10
+
+using std::string;
+using std::set;
+using std::shared_ptr;
+using std::weak_ptr;
+using std::mutex;
+
+using ros2_bdi_interfaces::msg::BeliefSet;
+using ros2_bdi_interfaces::msg::BeliefSetDelta;
+using ros2_bdi_interfaces::msg::Desire;
+
+using BDIManaged::ManagedBelief;
+using BDIManaged::ManagedDesire;
+using BDIManaged::BeliefSetChanges;
+using BDIManaged::StaticBeliefSegment;
+
+using BDICommunications::RemoteBeliefMirror;
+
+RemoteBeliefMirror::RemoteBeliefMirror():
+    next_watch_id_(1)
+{
+    // node to subscribe to the belief set topics of the monitored agent(s)
+    // spinning in its own thread, so that updates are processed without involving the executors of the action nodes
+    node_ = rclcpp::Node::make_shared("remote_belief_mirror");
+    executor_ = std::make_shared<rclcpp::executors::SingleThreadedExecutor>();
+    executor_->add_node(node_);
+    spin_thread_ = std::thread([this](){ executor_->spin(); });
+}
+
+RemoteBeliefMirror::~RemoteBeliefMirror()
+{
+    executor_->cancel();
+    if(spin_thread_.joinable())
+        spin_thread_.join();
+}
+
+/* Mirror shared within the process (created as the first one needs it, destroyed when no one holds it anymore) */
+shared_ptr<RemoteBeliefMirror> RemoteBeliefMirror::getInstance()
+{
+    static mutex mtx_instance;
+    static weak_ptr<RemoteBeliefMirror> instance;
+
+    mtx_instance.lock();
+    shared_ptr<RemoteBeliefMirror> mirror = instance.lock();
+    if(!mirror)
+    {
+        mirror = shared_ptr<RemoteBeliefMirror>(new RemoteBeliefMirror());
+        instance = mirror;
+    }
+    mtx_instance.unlock();
+    return mirror;
+}
+
+/*
+    Watch the fulfillment of @desire in the belief set of @agent_ref, returning the id of the watch
+    @callback is called every time the desire becomes fulfilled (right away if it's already fulfilled)
+*/
+uint64_t RemoteBeliefMirror::watch(const string& agent_ref, const Desire& desire, const FulfilledCallback& callback)
+{
+    mtx_.lock();
+    uint64_t watch_id = next_watch_id_++;
+
+    auto agentIt = agents_.find(agent_ref);
+    if(agentIt == agents_.end())
+    {
+        agentIt = agents_.emplace(agent_ref, AgentMirror{}).first;
+        subscribe(agent_ref, agentIt->second);
+    }
+    AgentMirror& agent = agentIt->second;
+
+    Watch w;
+    w.agent_ref = agent_ref;
+    w.desire = desire;
+    w.watched_desire = ManagedDesire{desire};
+    w.watched_desire.setName("watch_" + std::to_string(watch_id));
+    w.callback = callback;
+    agent.watched.insert(w.watched_desire);
+    agent.watch_ids.insert(watch_id);
+    w.fulfilled = agent.watched.isFulfilled(w.watched_desire);
+    watches_[watch_id] = w;
+
+    if(w.fulfilled && w.callback)
+        w.callback(agent_ref, desire);
+    mtx_.unlock();
+    return watch_id;
+}
+
+/* Stop watch @watch_id (unsubscribing from its agent if it was the last one watching it) */
+void RemoteBeliefMirror::unwatch(const uint64_t& watch_id)
+{
+    mtx_.lock();
+    auto watchIt = watches_.find(watch_id);
+    if(watchIt != watches_.end())
+    {
+        auto agentIt = agents_.find(watchIt->second.agent_ref);
+        if(agentIt != agents_.end())
+        {
+            agentIt->second.watched.erase(watchIt->second.watched_desire);
+            agentIt->second.watch_ids.erase(watch_id);
+            if(agentIt->second.watch_ids.empty())
+                agents_.erase(agentIt);//should allow to cancel subscriptions to its topics
+        }
+        watches_.erase(watchIt);
+    }
+    mtx_.unlock();
+}
+
+/* True if the desire of watch @watch_id is fulfilled in the mirrored belief set of its agent */
+bool RemoteBeliefMirror::isFulfilled(const uint64_t& watch_id)
+{
+    mtx_.lock();
+    auto watchIt = watches_.find(watch_id);
+    bool fulfilled = watchIt != watches_.end() && watchIt->second.fulfilled;
+    mtx_.unlock();
+    return fulfilled;
+}
+
+/* Subscribe to the belief set topics of @agent_ref */
+void RemoteBeliefMirror::subscribe(const string& agent_ref, AgentMirror& agent)
+{
+    agent.last_delta_seq = 0;
+    agent.synced = false;
+    agent.skipped_full_msgs = 0;
+
+    rclcpp::QoS qos_reliable = rclcpp::QoS(10);
+    qos_reliable.reliable();
+
+    agent.belief_set_subscriber = node_->create_subscription<BeliefSet>(
+            "/"+agent_ref+"/"+BELIEF_SET_TOPIC, qos_reliable,
+            [this, agent_ref](const BeliefSet::SharedPtr msg){agentBeliefSetCallback(agent_ref, msg);});
+
+    agent.belief_set_delta_subscriber = node_->create_subscription<BeliefSetDelta>(
+            "/"+agent_ref+"/"+BELIEF_SET_DELTA_TOPIC, qos_reliable,
+            [this, agent_ref](const BeliefSetDelta::SharedPtr msg){agentBeliefSetDeltaCallback(agent_ref, msg);});
+
+    //static partition of the agent's belief set (latched)
+    agent.static_belief_set_subscriber = node_->create_subscription<BeliefSet>(
+            "/"+agent_ref+"/"+STATIC_BELIEF_SET_TOPIC, rclcpp::QoS(1).reliable().transient_local(),
+            [this, agent_ref](const BeliefSet::SharedPtr msg){agentStaticBeliefSetCallback(agent_ref, msg);});
+}
+
+/*
+    Whole dynamic partition of the belief set of @agent_ref: applied just if out of sync (i.e. no whole belief set yet or some delta missing)
+    or once every FULL_BELIEF_SET_RESYNC_MSGS msgs, since the deltas are enough to keep the mirror up to date otherwise.
+    Discarded anyway if older than the last delta applied (it comes on another topic, so it might be received after newer deltas)
+*/
+void RemoteBeliefMirror::agentBeliefSetCallback(const string& agent_ref, const BeliefSet::SharedPtr msg)
+{
+    mtx_.lock();
+    auto agentIt = agents_.find(agent_ref);
+    if(agentIt != agents_.end())
+    {
+        AgentMirror& agent = agentIt->second;
+        //not stale (seq 0: no delta published yet, e.g. belief manager just restarted)
+        if(msg->seq >= agent.last_delta_seq || msg->seq == 0)
+        {
+            if(agent.synced && agent.skipped_full_msgs + 1 < FULL_BELIEF_SET_RESYNC_MSGS)
+                agent.skipped_full_msgs++;
+            else
+            {
+                applyChanges(agent, agent.belief_set.setDynamic(BDIFilter::extractMGBeliefs(msg->value)));
+                agent.synced = true;
+                agent.last_delta_seq = msg->seq;//next delta expected to follow the last one reflected in the belief set (0: taken as the baseline)
+                agent.skipped_full_msgs = 0;
+            }
+        }
+    }
+    mtx_.unlock();
+}
+
+/* Delta of the belief set of @agent_ref (a gap in the seq numbers puts the mirror out of sync till the next whole belief set) */
+void RemoteBeliefMirror::agentBeliefSetDeltaCallback(const string& agent_ref, const BeliefSetDelta::SharedPtr msg)
+{
+    set<ManagedBelief> removed = BDIFilter::extractMGBeliefs(msg->removed);
+    set<ManagedBelief> added = BDIFilter::extractMGBeliefs(msg->added);
+
+    mtx_.lock();
+    auto agentIt = agents_.find(agent_ref);
+    if(agentIt != agents_.end())
+    {
+        AgentMirror& agent = agentIt->second;
+        if(agent.last_delta_seq != 0 && msg->seq != agent.last_delta_seq + 1)
+            agent.synced = false;
+        agent.last_delta_seq = msg->seq;
+        applyChanges(agent, agent.belief_set.applyDelta(removed, added));
+    }
+    mtx_.unlock();
+}
+
+/* Static partition of the belief set of @agent_ref */
+void RemoteBeliefMirror::agentStaticBeliefSetCallback(const string& agent_ref, const BeliefSet::SharedPtr msg)
+{
+    auto segment = std::make_shared<const StaticBeliefSegment>(BDIFilter::extractMGBeliefs(msg->value));
+
+    mtx_.lock();
+    auto agentIt = agents_.find(agent_ref);
+    if(agentIt != agents_.end())
+        applyChanges(agentIt->second, agentIt->second.belief_set.setStatic(segment));
+    mtx_.unlock();
+}
+
+/* Feed the alterations to the mirrored belief set of @agent into the fulfillment index, notifying the newly fulfilled watches */
+void RemoteBeliefMirror::applyChanges(AgentMirror& agent, const BeliefSetChanges& changes)
+{
+    bool newlyFulfilled = false;
+    for(const ManagedBelief& mb : changes.removed)
+        agent.watched.beliefRemoved(mb);
+    for(const ManagedBelief& mb : changes.added)
+        newlyFulfilled = agent.watched.beliefAdded(mb) || newlyFulfilled;
+
+    // function value updates do not affect desire fulfillment
+    if(changes.removed.empty() && !newlyFulfilled)
+        return;
+
+    for(const uint64_t& watch_id : agent.watch_ids)
+    {
+        Watch& w = watches_[watch_id];
+        bool fulfilled = agent.watched.isFulfilled(w.watched_desire);
+        if(fulfilled && !w.fulfilled && w.callback)
+            w.callback(w.agent_ref, w.desire);
+        w.fulfilled = fulfilled;
+    }
+}
@@ -9,14 +9,19 @@
 using std::string;
 using std::vector;
 using std::map;
+using std::pair;
+using std::mutex;
 using std::chrono::seconds;
 using std::chrono::milliseconds;
+using std::chrono::steady_clock;
 using std::bind;
 using std::placeholders::_1;
 using std::optional;
 
 using ros2_bdi_interfaces::msg::Belief;  
 using ros2_bdi_interfaces::msg::BeliefSet;
+using ros2_bdi_interfaces::msg::LifecycleStatus;
+using ros2_bdi_interfaces::srv::LoadStaticBeliefs;
 
 /*
 @sensor_name for the specific name of the node, 
@@ -60,7 +65,6 @@ void Sensor::initPrototypeBsetMap(const vector<Belief>& proto_beliefs)
 {
     proto_belief_map_= map<string, Belief>();
     Belief proto_belief_checked = Belief();
-    last_sensed_op_ = NOP;
 
     for(Belief proto_belief : proto_beliefs)
     {
@@ -94,10 +98,37 @@ void Sensor::initSensing(const string& sensor_name)
     this->declare_parameter(PARAM_SENSOR_NAME, sensor_name);
     this->declare_parameter(PARAM_SENSING_FREQ, 8.0);//sensing frequency by default set to 8Hz
     this->declare_parameter(PARAM_INIT_SLEEP, 2);//init node sleep (e.g. sensor activated later) // default now is 2 to wait for the other to boot as well (since they wait a bit for psys2) 
+    this->declare_parameter(PARAM_WAIT_BELIEF_MANAGER, true);
+    this->declare_parameter(PARAM_DEDUP, DEDUP_DEFAULT);
+    this->declare_parameter(PARAM_DEDUP_REFRESH_MS, DEDUP_REFRESH_MS_DEFAULT);
+    this->declare_parameter(PARAM_COALESCE_WINDOW_MS, 0);//by default forwarded sensings are published straight away
+    this->declare_parameter(PARAM_FUNCTION_DEADBAND, 0.0);
+    this->declare_parameter(PARAM_SENSING_MODE, VAL_SENSING_MODE_PERIODIC);
+    this->declare_parameter(PARAM_MIN_SENSING_INTERVAL_MS, 100);
+    this->declare_parameter(PARAM_MAX_SENSING_INTERVAL_MS, 2000);
 
     // agent's namespace
     agent_id_ = this->get_parameter(PARAM_AGENT_ID).as_string();
 
+    // dedup & deadband of sensed beliefs wrt. last sent ones
+    dedup_ = this->get_parameter(PARAM_DEDUP).as_bool();
+    dedup_refresh_ms_ = this->get_parameter(PARAM_DEDUP_REFRESH_MS).as_int();
+    function_deadband_ = std::max(0.0, this->get_parameter(PARAM_FUNCTION_DEADBAND).as_double());
+    last_sent_ = map<string, LastSent>();
+    forwarded_count_ = 0;
+    suppressed_count_ = 0;
+    published_msgs_count_ = 0;
+    batching_ = false;
+
+    // periodic or event triggered sensing
+    sensing_started_ = false;
+    event_triggered_ = this->get_parameter(PARAM_SENSING_MODE).as_string() == VAL_SENSING_MODE_EVENT;
+    min_sensing_interval_ = milliseconds(std::max<int64_t>(0, this->get_parameter(PARAM_MIN_SENSING_INTERVAL_MS).as_int()));
+    last_sensing_at_ = steady_clock::time_point{};
+    latency_samples_ = 0;
+    latency_sum_ms_ = 0.0;
+    latency_max_ms_ = 0.0;
+
     // Add new belief publisher
     add_belief_publisher_ = this->create_publisher<Belief>(ADD_BELIEF_TOPIC, 10);
 
@@ -109,22 +140,39 @@ void Sensor::initSensing(const string& sensor_name)
 
     // Del set of beliefs publisher
     del_belief_set_publisher_ = this->create_publisher<BeliefSet>(DEL_BELIEF_SET_TOPIC, 10);
-    
-    // retrieve from parameter frequency at which to perform sensing
-    float sensing_freq = this->get_parameter(PARAM_SENSING_FREQ).as_double();
 
+    // coalescing window: forwarded sensings are collected and published all together at the end of it
+    int coalesce_window_ms = this->get_parameter(PARAM_COALESCE_WINDOW_MS).as_int();
+    if(coalesce_window_ms > 0)
+        coalesce_timer_ = this->create_wall_timer(
+            milliseconds(coalesce_window_ms),
+            bind(&Sensor::flushCoalescedSensings, this));
+
+    // msgs published/saved per second (debug only)
+    stats_last_published_ = 0;
+    stats_last_saved_ = 0;
+    if(this->get_parameter(PARAM_DEBUG).as_bool())
+        stats_timer_ = this->create_wall_timer(
+            seconds(SENSING_STATS_INTERVAL_SEC),
+            bind(&Sensor::logSensingStats, this));
+    
     int init_sleep_sec = this->get_parameter(PARAM_INIT_SLEEP).as_int();
     if (init_sleep_sec <= 0)// directly init sensor_timer_
-
-        sensor_timer_ = this->create_wall_timer(
-            milliseconds((int) (1000/sensing_freq)),
-            bind(&Sensor::performSensing, this));// loop to be called regularly to publish the sensing result (publish add_belief)
+        startSensingLoop();
 
     else if(enable_perform_sensing_)// wait init sleep seconds before starting sensor_timer_
+    {
         start_timer_ = this->create_wall_timer(
             seconds(init_sleep_sec),
             bind(&Sensor::startSensing, this));
 
+        // ... or less, if the belief manager notifies to be running before
+        if(this->get_parameter(PARAM_WAIT_BELIEF_MANAGER).as_bool())
+            lifecycle_status_subscriber_ = this->create_subscription<LifecycleStatus>(
+                LIFECYCLE_STATUS_TOPIC, rclcpp::QoS(10).reliable().transient_local(),
+                bind(&Sensor::callbackLifecycleStatus, this, _1));
+    }
+
     RCLCPP_INFO(this->get_logger(), "Sensor node \"" + this->get_parameter(PARAM_SENSOR_NAME).as_string() + "\" initialized");
 }
 
@@ -136,13 +184,174 @@ void Sensor::startSensing()
 {   
     // cancel start time
     start_timer_->cancel();
+    lifecycle_status_subscriber_.reset();
+    if(sensing_started_)
+        return;//already started
 
-    // retrieve from parameter frequency at which to perform sensing
-    float sensing_freq = this->get_parameter(PARAM_SENSING_FREQ).as_double();
     if(enable_perform_sensing_)
+        startSensingLoop();
+}
+
+/*
+    Start the main loop of sensing: sensing timer at sensing_freq (periodic mode) 
+    or heartbeat timer at max_sensing_interval_ms (event mode, sensing right away if inputs have changed while waiting to start)
+*/
+void Sensor::startSensingLoop()
+{
+    sensing_started_ = true;
+    if(event_triggered_)
+    {
+        int max_sensing_interval_ms = this->get_parameter(PARAM_MAX_SENSING_INTERVAL_MS).as_int();
+        if(max_sensing_interval_ms > 0)
+            sensor_timer_ = this->create_wall_timer(    // heartbeat: performSensing called anyway if inputs do not change for a while
+                milliseconds(max_sensing_interval_ms),
+                bind(&Sensor::runTriggeredSensing, this));
+        if(first_input_at_.has_value())
+            runTriggeredSensing();
+    }
+    else
+    {
+        // retrieve from parameter frequency at which to perform sensing
+        float sensing_freq = this->get_parameter(PARAM_SENSING_FREQ).as_double();
         sensor_timer_ = this->create_wall_timer(    // loop to be called regularly to publish the sensing result (publish add_belief)
             milliseconds((int) (1000/sensing_freq)),
-            bind(&Sensor::performSensing, this));
+            bind(&Sensor::runSensing, this));
+    }
+}
+
+/*
+    Notify that an input of the sensor has changed: in event mode performSensing is called right away,
+    or as soon as min_sensing_interval_ms has passed since its last call
+*/
+void Sensor::inputChanged()
+{
+    if(!first_input_at_.has_value())
+        first_input_at_ = steady_clock::now();
+
+    if(!event_triggered_ || !sensing_started_ || (throttle_timer_ != nullptr && !throttle_timer_->is_canceled()))
+        return;//not event triggered, not started yet (first sensing made as it starts) or already waiting to sense
+    
+    auto elapsed = steady_clock::now() - last_sensing_at_;
+    if(elapsed >= min_sensing_interval_)
+        runTriggeredSensing();
+    else
+        throttle_timer_ = this->create_wall_timer(
+            std::chrono::duration_cast<milliseconds>(min_sensing_interval_ - elapsed) + milliseconds(1),
+            [this](){
+                throttle_timer_->cancel();
+                runTriggeredSensing();
+            });
+}
+
+/*
+    Event mode: performSensing call triggered by an input change (or by the heartbeat)
+*/
+void Sensor::runTriggeredSensing()
+{
+    if(throttle_timer_ != nullptr)
+        throttle_timer_->cancel();//input changes waiting for it are looked at right now
+    last_sensing_at_ = steady_clock::now();
+    runSensing();
+    if(sensor_timer_ != nullptr)
+        sensor_timer_->reset();//heartbeat restarts from the last sensing
+}
+
+/*
+    Received (latched) lifecycle status of a core node of the agent:
+    start sensing as soon as the belief manager is running, i.e. ready to accept the sensed beliefs
+*/
+void Sensor::callbackLifecycleStatus(const LifecycleStatus::SharedPtr msg)
+{
+    if(msg->node_name == BELIEF_MANAGER_NODE_NAME && msg->status == msg->RUNNING && !sensing_started_)
+    {
+        if(this->get_parameter(PARAM_DEBUG).as_bool())
+            RCLCPP_INFO(this->get_logger(), "Belief manager running: sensing started");
+        startSensing();
+    }
+}
+
+/*
+    Main loop of sensing: call performSensing() batching all its sensings,
+    which are published together once it returns (unless a coalescing window is set)
+*/
+void Sensor::runSensing()
+{
+    std::optional<steady_clock::time_point> input_at = first_input_at_;
+    first_input_at_ = std::nullopt;//input changes up to now looked at by this call
+    uint64_t published_before = published_msgs_count_;
+
+    batching_ = true;
+    performSensing();
+    batching_ = false;
+
+    if(coalesce_timer_ == nullptr)
+        flushCoalescedSensings();
+
+    // input change -> publication latency (just when the sensings are published by this call)
+    if(input_at.has_value() && published_msgs_count_ > published_before)
+    {
+        double latency_ms = std::chrono::duration<double, std::milli>(steady_clock::now() - input_at.value()).count();
+        latency_samples_++;
+        latency_sum_ms_ += latency_ms;
+        latency_max_ms_ = std::max(latency_max_ms_, latency_ms);
+    }
+}
+
+/*
+    Log (debug) the msgs published and saved per second in the last SENSING_STATS_INTERVAL_SEC seconds
+*/
+void Sensor::logSensingStats()
+{
+    mtx_sensing_.lock();
+    uint64_t published = published_msgs_count_;
+    uint64_t saved = getSavedMsgsCount();
+    mtx_sensing_.unlock();
+
+    RCLCPP_INFO(this->get_logger(), "Sensing msgs/s: %.2f published, %.2f saved (published so far = %lu, saved so far = %lu)",
+        (published - stats_last_published_) / (float) SENSING_STATS_INTERVAL_SEC, (saved - stats_last_saved_) / (float) SENSING_STATS_INTERVAL_SEC,
+        published, saved);
+    stats_last_published_ = published;
+    stats_last_saved_ = saved;
+
+    if(latency_samples_ > 0)
+        RCLCPP_INFO(this->get_logger(), "Sensing latency (input change -> publication, %s mode): avg = %.1f ms, max = %.1f ms (%lu samples)",
+            event_triggered_? VAL_SENSING_MODE_EVENT : VAL_SENSING_MODE_PERIODIC, latency_sum_ms_ / latency_samples_, latency_max_ms_, latency_samples_);
+    latency_samples_ = 0;
+    latency_sum_ms_ = 0.0;
+    latency_max_ms_ = 0.0;
+}
+
+/*
+    Prototype @belief has to comply with (instances by type, predicates/functions by name), nullptr if none
+*/
+const Belief* Sensor::findPrototype(const Belief& belief) const
+{
+    auto protoIt = proto_belief_map_.find(belief.type);
+    if(protoIt != proto_belief_map_.end() && protoIt->second.pddl_type == Belief().INSTANCE_TYPE)
+        return &protoIt->second;
+    
+    protoIt = proto_belief_map_.find(belief.name);
+    if(protoIt != proto_belief_map_.end() && 
+            (protoIt->second.pddl_type == Belief().PREDICATE_TYPE || protoIt->second.pddl_type == Belief().FUNCTION_TYPE))
+        return &protoIt->second;
+
+    return nullptr;
+}
+
+/*
+    True if @belief complies with its prototype (see sensedInstance, sensedPredicate, sensedFunction)
+*/
+bool Sensor::compliant(const Belief& belief) const
+{
+    const Belief* proto = findPrototype(belief);
+    if(proto == nullptr)
+        return false;
+    else if(proto->pddl_type == Belief().INSTANCE_TYPE)
+        return sensedInstance(belief, *proto);
+    else if(proto->pddl_type == Belief().PREDICATE_TYPE)
+        return sensedPredicate(belief, *proto);
+    else
+        return sensedFunction(belief, *proto);
 }
 
 /*
@@ -151,16 +360,13 @@ void Sensor::startSensing()
 */
 void Sensor::sense(const Belief& belief, const UpdOperation& op)
 {
-    bool updated = false;
-    
-    if(proto_belief_map_.find(belief.type) != proto_belief_map_.end() && proto_belief_map_[belief.type].pddl_type == Belief().INSTANCE_TYPE)
-        updated = sensedInstance(belief);
-    else if(proto_belief_map_.find(belief.name) != proto_belief_map_.end() && proto_belief_map_[belief.name].pddl_type == Belief().PREDICATE_TYPE)
-        updated = sensedPredicate(belief);
-    else if(proto_belief_map_.find(belief.name) != proto_belief_map_.end() && proto_belief_map_[belief.name].pddl_type == Belief().FUNCTION_TYPE)
-        updated = sensedFunction(belief);
-    if(updated)
-        publishSensing(op);
+    if(op == NOP || !compliant(belief) || !forwardSensing(belief, op))
+        return;
+
+    if(coalesce_timer_ != nullptr || batching_)
+        coalesceSensing(belief, op);
+    else
+        publishSensing(belief, op);
 }
 
 
@@ -173,102 +379,217 @@ void Sensor::senseAll(const BeliefSet& belief_set, const UpdOperation& op)
 {
     BeliefSet filteredBSetMsg = BeliefSet{};
     filteredBSetMsg.agent_id = agent_id_;
-    for(Belief belief : belief_set.value)
+    for(const Belief& belief : belief_set.value)
     {
-        bool updated = false;
-    
-        if(proto_belief_map_.find(belief.type) != proto_belief_map_.end() && proto_belief_map_[belief.type].pddl_type == Belief().INSTANCE_TYPE)
-            updated = sensedInstance(belief);
-        else if(proto_belief_map_.find(belief.name) != proto_belief_map_.end() && proto_belief_map_[belief.name].pddl_type == Belief().PREDICATE_TYPE)
-            updated = sensedPredicate(belief);
-        else if(proto_belief_map_.find(belief.name) != proto_belief_map_.end() && proto_belief_map_[belief.name].pddl_type == Belief().FUNCTION_TYPE)
-            updated = sensedFunction(belief);
-        
-        if(updated)
-            filteredBSetMsg.value.push_back(belief);
+        if(op != NOP && compliant(belief) && forwardSensing(belief, op))
+        {
+            if(coalesce_timer_ != nullptr || batching_)
+                coalesceSensing(belief, op);
+            else
+                filteredBSetMsg.value.push_back(belief);
+        }
     }
 
+    if(filteredBSetMsg.value.size() == 0)
+        return;// nothing changed (or everything coalesced)
+
     if(op == ADD || op == UPD)
         add_belief_set_publisher_->publish(filteredBSetMsg);
     else if(op == DEL)
         del_belief_set_publisher_->publish(filteredBSetMsg);
+    
+    mtx_sensing_.lock();
+    published_msgs_count_++;
+    mtx_sensing_.unlock();
 }
 
 /*
-    Called within the sense method iff the sensed belief is compliant wrt. to the inially
+    API offered to user to install a large block of immutable facts (e.g. the topology of a static map) at once
+    through the static beliefs loader of the belief manager, instead of sensing them belief by belief
+    (beliefs not compliant with the prototypes are discarded; the block is sent asynchronously, see staticBeliefsLoaded)
+    Returns false if the loader is not available
+*/
+bool Sensor::senseStatic(const BeliefSet& belief_set)
+{
+    if(load_static_beliefs_client_ == nullptr)
+        load_static_beliefs_client_ = this->create_client<LoadStaticBeliefs>(LOAD_STATIC_BELIEFS_SRV);
+    if(!load_static_beliefs_client_->service_is_ready())
+        return false;
+
+    auto request = std::make_shared<LoadStaticBeliefs::Request>();
+    request->beliefs.reserve(belief_set.value.size());
+    for(const Belief& belief : belief_set.value)
+        if(compliant(belief))
+            request->beliefs.push_back(belief);
+
+    load_static_beliefs_client_->async_send_request(request, 
+        [this](rclcpp::Client<LoadStaticBeliefs>::SharedFuture future)
+        {
+            auto response = future.get();
+            if(this->get_parameter(PARAM_DEBUG).as_bool())
+                RCLCPP_INFO(this->get_logger(), "Static beliefs block: %d loaded, %d rejected in %.1f ms", 
+                    response->loaded, response->rejected, response->elapsed_ms);
+            staticBeliefsLoaded(response->success);
+        });
+    return true;
+}
+
+/*
+    Called within the sense method iff the sensed @belief is compliant wrt. to the inially
     defined belief prototype in the constructor
 */
-void Sensor::publishSensing(const UpdOperation& op)
+void Sensor::publishSensing(const Belief& belief, const UpdOperation& op)
 {
-    last_sensed_op_ = op;
-    
     if(op == ADD || op == UPD)
-        add_belief_publisher_->publish(last_sensed_);
+        add_belief_publisher_->publish(belief);
     else if(op == DEL)
-        del_belief_publisher_->publish(last_sensed_);
+        del_belief_publisher_->publish(belief);
+    
+    mtx_sensing_.lock();
+    published_msgs_count_++;
+    mtx_sensing_.unlock();
 
     if(this->get_parameter(PARAM_DEBUG).as_bool())
     {
         string stringOp = ((op==ADD)? "ADD" : "DEL");
         string paramsJoined = "";
-        for(auto p : last_sensed_.params)
+        for(auto p : belief.params)
             paramsJoined += p + ", ";
-        string stringBelief = "name = " + last_sensed_.name + ", params = " + paramsJoined + 
-            ((last_sensed_.pddl_type == last_sensed_.FUNCTION_TYPE)? " value = " + std::to_string(last_sensed_.value) : "");
+        string stringBelief = "name = " + belief.name + ", params = " + paramsJoined + 
+            ((belief.pddl_type == belief.FUNCTION_TYPE)? " value = " + std::to_string(belief.value) : "");
         RCLCPP_INFO(this->get_logger(), "Operation = " + stringOp + " , belief " + stringBelief);
     }
 }
 
 /*
-    perform update if the new instance is valid with respect to the expected sensed one specified in the constructor
+    Key identifying the sensed belief in last_sent_ (value excluded)
+*/
+string Sensor::sensedKey(const Belief& belief)
+{
+    string key = std::to_string(belief.pddl_type) + " " + ((belief.pddl_type == Belief().INSTANCE_TYPE)? belief.type + " " : "") + belief.name;
+    for(string p : belief.params)
+        key += " " + p;
+    return key;
+}
+
+/*
+    Check @belief against its last sent state: return true and record it as sent (ADD/UPD are the same op here)
+    iff it differs from it (different op, function value outside deadband or refresh interval passed),
+    false otherwise (i.e. sending it would be redundant)
+*/
+bool Sensor::forwardSensing(const Belief& belief, const UpdOperation& op)
+{
+    UpdOperation sentOp = (op == DEL)? DEL : ADD;
+    auto now = std::chrono::steady_clock::now();
+    string key = sensedKey(belief);
+
+    mtx_sensing_.lock();
+    bool forward = !dedup_;
+    if(!forward)
+    {
+        auto lastSentIt = last_sent_.find(key);
+        forward = lastSentIt == last_sent_.end() || lastSentIt->second.op != sentOp
+            || (sentOp == ADD && belief.pddl_type == Belief().FUNCTION_TYPE && std::abs(belief.value - lastSentIt->second.value) > function_deadband_)
+            || (dedup_refresh_ms_ > 0 && now - lastSentIt->second.sent_at >= milliseconds(dedup_refresh_ms_));
+        
+        if(forward)// record new last sent state (compared against the last SENT value -> no drift within the deadband)
+            last_sent_[key] = LastSent{sentOp, belief.value, now};
+    }
+
+    if(forward)
+        forwarded_count_++;
+    else
+        suppressed_count_++;
+    mtx_sensing_.unlock();
+
+    return forward;
+}
+
+/*
+    Put @belief among the pending ones to be published at the end of the current coalescing window
+    (overriding any previous pending sensing of the same belief)
+*/
+void Sensor::coalesceSensing(const Belief& belief, const UpdOperation& op)
+{
+    mtx_sensing_.lock();
+    pending_sensings_[sensedKey(belief)] = pair<Belief, UpdOperation>(belief, op);
+    mtx_sensing_.unlock();
+}
+
+/*
+    Publish the sensings coalesced in the last window as a del belief set followed by an add belief set
+*/
+void Sensor::flushCoalescedSensings()
+{
+    mtx_sensing_.lock();
+    map<string, pair<Belief, UpdOperation>> pending;
+    pending.swap(pending_sensings_);
+    uint64_t forwarded = forwarded_count_, suppressed = suppressed_count_;
+    mtx_sensing_.unlock();
+
+    if(pending.size() == 0)
+        return;
+
+    BeliefSet addBSetMsg = BeliefSet{};
+    addBSetMsg.agent_id = agent_id_;
+    BeliefSet delBSetMsg = BeliefSet{};
+    delBSetMsg.agent_id = agent_id_;
+    for(auto sensing : pending)
+        if(sensing.second.second == DEL)
+            delBSetMsg.value.push_back(sensing.second.first);
+        else
+            addBSetMsg.value.push_back(sensing.second.first);
+
+    if(delBSetMsg.value.size() > 0)
+        del_belief_set_publisher_->publish(delBSetMsg);
+    if(addBSetMsg.value.size() > 0)
+        add_belief_set_publisher_->publish(addBSetMsg);
+
+    mtx_sensing_.lock();
+    published_msgs_count_ += (delBSetMsg.value.size() > 0? 1 : 0) + (addBSetMsg.value.size() > 0? 1 : 0);
+    mtx_sensing_.unlock();
+
+    if(this->get_parameter(PARAM_DEBUG).as_bool())
+        RCLCPP_INFO(this->get_logger(), "Published " + std::to_string(addBSetMsg.value.size()) + " additions and " + 
+            std::to_string(delBSetMsg.value.size()) + " deletions (forwarded so far = " + std::to_string(forwarded) + 
+            ", suppressed so far = " + std::to_string(suppressed) + ")");
+}
+
+/*
+    true if the new instance is valid with respect to its prototype @proto specified in the constructor
 
     SAME type as the prototype (marked within the first and only param in the params array of the prototype)
 */
-bool Sensor::sensedInstance(const Belief& new_belief)
+bool Sensor::sensedInstance(const Belief& new_belief, const Belief& proto) const
 {   
-    bool found = proto_belief_map_.find(new_belief.type) != proto_belief_map_.end();
-    bool do_upd = found && new_belief.pddl_type == Belief().INSTANCE_TYPE && proto_belief_map_[new_belief.type].type == new_belief.type;
-    if(do_upd) //only 1 param which indicates the type which has to remain the same
-        last_sensed_ = new_belief;
-    return do_upd;
+    //only 1 param which indicates the type which has to remain the same
+    return new_belief.pddl_type == Belief().INSTANCE_TYPE && proto.type == new_belief.type;
 }
 
 /*
-    perform update if the new predicate is valid with respect to the expected sensed one specified in the constructor
+    true if the new predicate is valid with respect to its prototype @proto specified in the constructor
 
     SAME name as the prototype
     PARAMS number remain fixed (otherwise it's another predicate), but individually they do not need to remain the same
 */
-bool Sensor::sensedPredicate(const Belief& new_belief)
+bool Sensor::sensedPredicate(const Belief& new_belief, const Belief& proto) const
 {
-    bool found = proto_belief_map_.find(new_belief.name) != proto_belief_map_.end();
-    bool do_upd = found && new_belief.pddl_type == Belief().PREDICATE_TYPE && new_belief.name == proto_belief_map_[new_belief.name].name 
-    && new_belief.params.size() == proto_belief_map_[new_belief.name].params.size(); //same name -> same predicate -> same num of params
-    
-    if(do_upd)
-        last_sensed_ = new_belief;
-    return do_upd;
+    return new_belief.pddl_type == Belief().PREDICATE_TYPE && new_belief.name == proto.name 
+        && new_belief.params.size() == proto.params.size(); //same name -> same predicate -> same num of params
 }
 
 /*
-    perform update if the new predicate is valid with respect to the expected sensed one specified in the constructor
+    true if the new function is valid with respect to its prototype @proto specified in the constructor
 
     SAME name and exact same params as the prototype
     JUST VALUE can differ
 */
-bool Sensor::sensedFunction(const Belief& new_belief)
+bool Sensor::sensedFunction(const Belief& new_belief, const Belief& proto) const
 {
-    bool found = proto_belief_map_.find(new_belief.name) != proto_belief_map_.end();
-    bool do_upd = found && new_belief.pddl_type == Belief().FUNCTION_TYPE && new_belief.name == proto_belief_map_[new_belief.name].name 
-    && new_belief.params.size() == proto_belief_map_[new_belief.name].params.size(); //same name -> same function -> same params
+    bool do_upd = new_belief.pddl_type == Belief().FUNCTION_TYPE && new_belief.name == proto.name 
+        && new_belief.params.size() == proto.params.size(); //same name -> same function -> same params
 
-    if(match_param_by_param_)
-    {
-        for(int i=0; do_upd && i<proto_belief_map_[new_belief.name].params.size(); i++)//check match param by param
-            if(proto_belief_map_[new_belief.name].params != new_belief.params)
-                do_upd = false;
-    }
-    if(do_upd)
-        last_sensed_ = new_belief;
+    if(match_param_by_param_)//check match param by param
+        do_upd = do_upd && proto.params == new_belief.params;
     return do_upd;
-}
\ No newline at end of file
+}
@@ -0,0 +1,97 @@
+#ifndef ACTION_TABLE_H_
+#define ACTION_TABLE_H_
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <unordered_map>
+
+#include "plansys2_msgs/msg/plan_item.hpp"
+
+/* Namespace for wrapper classes wrt. BDI msgs defined in ros2_bdi_interfaces::msg */
+namespace BDIManaged
+{
+
+    /*
+        Table of the action instances of a plan, built once from its plan items:
+        every row holds the interned ids of the action name and args, the planned start key (planned start x1000, as in PlanSys2)
+        and the canonical strings of the action instance, so that they're never parsed or rebuilt again afterwards.
+        PlanSys2 feedback refers to an action through its action_full_name "(a1 p1 p2):timex1000", which is mapped to its row by hashing
+    */
+    class ActionTable
+    {
+        public:
+            /* Constructor methods */
+            ActionTable();
+            ActionTable(const std::vector<plansys2_msgs::msg::PlanItem>& plan_items);
+
+            size_t size() const {return rows_.size();}
+
+            /* Interned id of the action name/of the k-th arg of action @i, symbol corresponding to interned @id */
+            uint32_t actionId(const size_t& i) const {return rows_[i].action_id;}
+            uint32_t argId(const size_t& i, const size_t& k) const {return arg_ids_[rows_[i].first_arg + k];}
+            const std::string& symbol(const uint32_t& id) const {return symbols_[id];}
+
+            /* Name and args of action @i */
+            const std::string& name(const size_t& i) const {return symbols_[rows_[i].action_id];}
+            const std::vector<std::string>& args(const size_t& i) const {return rows_[i].args;}
+
+            /* Planned start, planned start x1000 and duration of action @i */
+            float plannedStart(const size_t& i) const {return rows_[i].planned_start;}
+            int plannedStartKey(const size_t& i) const {return rows_[i].planned_start_key;}
+            float duration(const size_t& i) const {return rows_[i].duration;}
+
+            /* "(a1 p1 p2)" of action @i */
+            const std::string& fullName(const size_t& i) const {return rows_[i].full_name;}
+
+            /* "(a1 p1 p2):timex1000" of action @i, i.e. its PlanSys2 action_full_name */
+            const std::string& fullNameTimex1000(const size_t& i) const {return rows_[i].full_name_timex1000;}
+
+            /* Index of the action with PlanSys2 action_full_name @action_full_name, -1 if not in the table */
+            int index(const std::string& action_full_name) const
+            {
+                auto it = index_.find(action_full_name);
+                return it != index_.end()? it->second : -1;
+            }
+
+            /*
+                Index of action @action (either "a1 p1 p2" or "(a1 p1 p2)") planned to start at @planned_start_key (planned start x1000), 
+                -1 if not in the table: just the few actions starting at the same time are compared, without building any string
+            */
+            int index(const std::string& action, const int& planned_start_key) const;
+
+        private:
+            typedef struct {
+                uint32_t action_id;
+                // args ids in arg_ids_[first_arg, first_arg + args.size())
+                size_t first_arg;
+                std::vector<std::string> args;
+                float planned_start;
+                int planned_start_key;
+                float duration;
+                std::string full_name;
+                std::string full_name_timex1000;
+            } Row;
+
+            /* Id of the interned @symbol, interning it if never seen */
+            uint32_t intern(const std::string& symbol);
+
+            std::vector<Row> rows_;
+            std::vector<uint32_t> arg_ids_;
+
+            // interned symbols
+            std::unordered_map<std::string, uint32_t> symbol_ids_;
+            std::vector<std::string> symbols_;
+
+            // action_full_name -> row (first one, if repeated)
+            std::unordered_map<std::string, int> index_;
+
+            // planned start key -> rows (in plan order)
+            std::unordered_map<int, std::vector<size_t>> rows_by_start_;
+
+    };  // class ActionTable
+
+}
+
+#endif  // ACTION_TABLE_H_
@@ -0,0 +1,109 @@
+#ifndef BDI_SNAPSHOT_H_
+#define BDI_SNAPSHOT_H_
+
+#include <string>
+#include <vector>
+#include <set>
+#include <map>
+#include <optional>
+
+#include "ros2_bdi_utils/ManagedBelief.hpp"
+#include "ros2_bdi_utils/ManagedDesire.hpp"
+#include "ros2_bdi_utils/ManagedReactiveRule.hpp"
+
+/*
+    Compact binary snapshot of (a part of) the mental state of an agent, used for warm restarts.
+
+    File layout (host byte order, the snapshot is meant to be read back on the same machine):
+        - header: magic "BDISNAP\0" (8 bytes), format version (uint32), number of sections (uint32)
+        - sections, one after the other: type (uint32), crc32 of the payload (uint32), payload length (uint64), payload
+
+    Belief/desire payloads are the CDR serialization of the BeliefSet/DesireSet msgs,
+    reactive rules are encoded as a sequence of records built on top of the CDR serialization of the ConditionsDNF,
+    BeliefSet and DesireSet msgs.
+
+    Snapshots are written to a temporary file and then renamed, so that a crash while writing never leaves
+    a truncated snapshot behind; they're read back through a read-only memory mapping and any section whose
+    checksum does not match is ignored.
+*/
+namespace BDISnapshot
+{
+    const uint32_t FORMAT_VERSION = 1;
+
+    typedef enum {
+        INSTANCES_SECTION = 1,      // PDDL instance table
+        BELIEFS_SECTION = 2,        // predicates and functions of the belief set
+        DESIRES_SECTION = 3,        // desire set
+        REACTIVE_RULES_SECTION = 4, // compiled reactive rules
+        STATIC_BELIEFS_SECTION = 5, // static partition of the belief set (subset of the instances + beliefs sections)
+        SOURCE_HASH_SECTION = 6     // crc32 of the content of the init. file the snapshot state descends from
+    } SectionType;
+
+    // section type -> payload
+    typedef std::map<uint32_t, std::vector<uint8_t>> Sections;
+
+    /* Encode @beliefs as payload of the section @type within @sections */
+    void putBeliefs(Sections& sections, const uint32_t& type, const std::set<BDIManaged::ManagedBelief>& beliefs);
+
+    /* Encode @desires as payload of the desires section within @sections */
+    void putDesires(Sections& sections, const std::set<BDIManaged::ManagedDesire>& desires);
+
+    /* Encode @rules as payload of the reactive rules section within @sections */
+    void putReactiveRules(Sections& sections, const std::set<BDIManaged::ManagedReactiveRule>& rules);
+
+    /* Store @source_hash (see fileHash) as payload of the source hash section within @sections */
+    void putSourceHash(Sections& sections, const uint32_t& source_hash);
+
+    /* Write @sections into the snapshot file @filepath (atomically, through a temporary file), true if succeeded */
+    bool writeSnapshot(const std::string& filepath, const Sections& sections);
+
+    /* crc32 of the content of file @filepath, if it can be read */
+    std::optional<uint32_t> fileHash(const std::string& filepath);
+
+    /* Read-only memory mapped snapshot file */
+    class Snapshot
+    {
+        public:
+            /* Map @filepath and validate its header; check valid() afterwards */
+            Snapshot(const std::string& filepath);
+            ~Snapshot();
+
+            Snapshot(const Snapshot&) = delete;
+            Snapshot& operator=(const Snapshot&) = delete;
+
+            /* True if the file has been mapped and presents a supported header */
+            bool valid() const {return data_ != nullptr;}
+
+            /* True if the snapshot contains an intact section @type */
+            bool has(const uint32_t& type) const {return sections_.count(type) == 1;}
+
+            /* Beliefs stored in section @type, if present and intact */
+            std::optional<std::set<BDIManaged::ManagedBelief>> getBeliefs(const uint32_t& type) const;
+
+            /* Desires stored in the desires section, if present and intact */
+            std::optional<std::set<BDIManaged::ManagedDesire>> getDesires() const;
+
+            /* Reactive rules stored in the reactive rules section, if present and intact */
+            std::optional<std::set<BDIManaged::ManagedReactiveRule>> getReactiveRules() const;
+
+            /* Hash of the init. file stored in the source hash section, if present and intact */
+            std::optional<uint32_t> getSourceHash() const;
+
+            /*
+                True if the snapshot descends from the current content of @sourceFilepath (or if there is no such file to compare with),
+                i.e. the init. file has not been edited since the snapshot state was initialized from it
+                (contents are compared, so that copying the same init. file again on every launch does not invalidate the snapshot)
+            */
+            bool isUpToDate(const std::string& sourceFilepath) const;
+
+        private:
+            // mapped file
+            const uint8_t* data_;
+            size_t size_;
+
+            // section type -> (payload start, payload length) for the sections passing the checksum
+            std::map<uint32_t, std::pair<const uint8_t*, size_t>> sections_;
+    };
+}
+
+#endif  // BDI_SNAPSHOT_H_
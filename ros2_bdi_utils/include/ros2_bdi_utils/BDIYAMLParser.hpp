@@ -28,6 +28,14 @@ namespace BDIYAMLParser
     */
     std::vector<BDIManaged::ManagedBelief> extractMGBeliefs(const std::string& bset_filepath, const std::shared_ptr<plansys2::DomainExpertClient>& domain_expert);
 
+    /*
+        Extract managed beliefs from a YAML file containing them, putting the ones flagged with "static: true"
+        into @static_beliefs instead of the returned vector
+        throws YAML::InvalidNode, YAML::BadFile, YAML::BadConversion
+    */
+    std::vector<BDIManaged::ManagedBelief> extractMGBeliefs(const std::string& bset_filepath, const std::shared_ptr<plansys2::DomainExpertClient>& domain_expert,
+        std::vector<BDIManaged::ManagedBelief>& static_beliefs);
+
     /*
         Extract managed desires from a YAML file containing them
     */
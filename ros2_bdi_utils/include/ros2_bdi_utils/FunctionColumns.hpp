@@ -0,0 +1,90 @@
+#ifndef FUNCTION_COLUMNS_H_
+#define FUNCTION_COLUMNS_H_
+
+#include <string>
+#include <vector>
+#include <map>
+#include <unordered_map>
+#include <cstdint>
+
+#include "ros2_bdi_utils/ManagedBelief.hpp"
+
+/* Namespace for wrapper classes wrt. BDI msgs defined in ros2_bdi_interfaces::msg */
+namespace BDIManaged
+{
+
+    /* Comparison of a function value against a threshold, i.e. the check of a ManagedCondition over a function */
+    typedef enum {SMALLER, SMALLER_OR_EQUALS, EQUALS, GREATER_OR_EQUALS, GREATER} ValueCheck;
+
+    /*
+        Columnar store of the function beliefs of a belief set: a column per function (name + arity) holding
+        the interned ids of the params of every instance packed one row after the other, and their values in a float array,
+        so that a check over the values of all the instances of a function is a single batch kernel producing a match bitmap
+    */
+    class FunctionColumns
+    {
+        public:
+            // no id assigned to a symbol
+            static const uint32_t NO_ID = UINT32_MAX;
+
+            typedef struct {
+                size_t arity;
+                // param ids of the i-th instance in [i*arity, (i+1)*arity)
+                std::vector<uint32_t> params;
+                // value of the i-th instance
+                std::vector<float> values;
+                // param ids -> row of the instance
+                std::map<std::vector<uint32_t>, size_t> rows;
+            } Column;
+
+            /* Constructor methods */
+            FunctionColumns();
+
+            /* Add function belief @mb or update its value (other belief types are ignored) */
+            void set(const ManagedBelief& mb);
+
+            /* Remove function belief @mb (other belief types are ignored) */
+            void erase(const ManagedBelief& mb);
+
+            /* Remove all the function beliefs (symbols stay interned) */
+            void clear();
+
+            /* Number of function beliefs stored */
+            size_t size() const;
+
+            /* Id of the interned @symbol (function name or param), NO_ID if never seen */
+            uint32_t symbolId(const std::string& symbol) const;
+
+            /* Symbol interned with @id */
+            const std::string& symbol(const uint32_t& id) const {return symbols_[id];}
+
+            /* Column of the function @name with @arity params, nullptr if none */
+            const Column* column(const std::string& name, const size_t& arity) const;
+
+            /*
+                Batch kernel: bit i of @bitmap set iff @values[i] @check @threshold
+                (words of 64 bits, as many as needed for @n values)
+            */
+            static void compare(const float* values, const size_t& n, const ValueCheck& check, const float& threshold, std::vector<uint64_t>& bitmap);
+
+            /* Value check corresponding to the check string of a Condition msg, false if it's not a check over a function value */
+            static bool toValueCheck(const std::string& check, ValueCheck& value_check);
+
+        private:
+            /* Id of the interned @symbol, interning it if never seen */
+            uint32_t intern(const std::string& symbol);
+
+            // interned symbols
+            std::unordered_map<std::string, uint32_t> symbol_ids_;
+            std::vector<std::string> symbols_;
+
+            // (name id, arity) -> column
+            std::map<std::pair<uint32_t, size_t>, Column> columns_;
+
+            size_t size_;
+
+    };  // class FunctionColumns
+
+}
+
+#endif  // FUNCTION_COLUMNS_H_
@@ -51,10 +51,10 @@ namespace BDIManaged
             static ManagedBelief buildMBFunction(const std::string& name, const std::vector<ManagedParam>& params, const float& value);
 
             /* getter methods for ManagedBelief instance prop */
-            std::string getName() const {return name_;};
+            const std::string& getName() const {return name_;};
             int pddlType() const {return pddl_type_;};
             ManagedType type() const {return type_;};
-            std::vector<ManagedParam> getParams() const {return params_;};
+            const std::vector<ManagedParam>& getParams() const {return params_;};
             float getValue() const {return value_;};
             std::string pddlTypeString() const;
 
@@ -9,6 +9,7 @@
 #include "ros2_bdi_interfaces/msg/condition.hpp"
 
 #include "ros2_bdi_utils/ManagedBelief.hpp"
+#include "ros2_bdi_utils/WildPattern.hpp"
 
 /* Namespace for wrapper classes wrt. BDI msgs defined in ros2_bdi_interfaces::msg */
 namespace BDIManaged
@@ -68,11 +69,30 @@ namespace BDIManaged
             // return true iff check_ is a valid check string property for a Fluent type Belief
             bool isCheckStringForFluent() const;
 
+            // compile the wild patterns in the name and params of condition_to_check_
+            void compilePatterns();
+            /*
+                return true iff @mb is equivalent to condition_to_check_ wrt. the wild patterns in its name and params
+                (e.g. params={"box_*"} will be considered equivalent to params={"box_a1"}), value not considered
+            */
+            bool matchesPatterns(const ManagedBelief& mb) const;
+            /*
+                performCheckAgainstBeliefs when the name of condition_to_check_ has no wild chars:
+                just the beliefs in @mbSet with the same pddl type and name are checked, found through the set ordering
+            */
+            bool performCheckAgainstNamedBeliefs(const std::set<ManagedBelief>& mbSet);
+
             /*  Belief that needs to be checked, available checks differs based on the belief type */
             ManagedBelief condition_to_check_;
             /*  Check to be performed (consult ros2_bdi_interfaces::msg::Condition msg for info)*/
             std::string check_;
 
+            /*  Compiled wild patterns of the name and params of condition_to_check_ */
+            WildPattern name_pattern_;
+            std::vector<WildPattern> param_patterns_;
+            /*  No wild chars in name and params of condition_to_check_ */
+            bool exact_;
+
     };  // class ManagedCondition
 
     std::ostream& operator<<(std::ostream& os, const ManagedCondition& mc);
@@ -10,6 +10,7 @@
 
 #include "ros2_bdi_utils/ManagedBelief.hpp"
 #include "ros2_bdi_utils/ManagedCondition.hpp"
+#include "ros2_bdi_utils/FunctionColumns.hpp"
 
 /* Namespace for wrapper classes wrt. BDI msgs defined in ros2_bdi_interfaces::msg */
 namespace BDIManaged
@@ -52,6 +53,13 @@ namespace BDIManaged
             /* substitute placeholders as per assignments map and return a new ManagedConditionsConjunction instance*/
             ManagedConditionsConjunction applySubstitution(const std::map<std::string, std::string> assignments) const;
 
+            /*
+                Restrict the candidates in @assignments of the placeholders among the params of the function literals with a value check
+                to the instances for which the check holds for at least a function in @functions (evaluated over its whole column at once):
+                the other ones could never satisfy the conjunction
+            */
+            void pruneAssignments(std::map<std::string, std::vector<ManagedBelief>>& assignments, const FunctionColumns& functions) const;
+
         private:
             /* All literals need to be satisfied being this a conjunction among them */
             std::vector<ManagedCondition> literals_;
@@ -53,6 +53,12 @@ class ManagedConditionsDNF
         // extract assigment for all placeholders in mgconditions dnf
         std::map<std::string, std::vector<ManagedBelief>> extractAssignmentsMap(const std::set<BDIManaged::ManagedBelief>& belief_set);
 
+        /*
+            Prune the candidates in @assignments wrt. the value checks over @functions (see ManagedConditionsConjunction::pruneAssignments);
+            done just when there is a single clause, otherwise an assignment failing a clause could still satisfy another one
+        */
+        void pruneAssignments(std::map<std::string, std::vector<ManagedBelief>>& assignments, const FunctionColumns& functions) const;
+
         /* substitute placeholders as per assignments map and return a new ManagedConditionsDNF instance*/
         ManagedConditionsDNF applySubstitution(const std::map<std::string, std::string> assignments) const;
 
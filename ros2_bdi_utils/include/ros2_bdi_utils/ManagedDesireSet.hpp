@@ -0,0 +1,180 @@
+#ifndef MANAGED_DESIRE_SET_H_
+#define MANAGED_DESIRE_SET_H_
+
+#include <string>
+#include <vector>
+#include <set>
+#include <tuple>
+#include <iterator>
+#include <optional>
+#include <unordered_map>
+#include <unordered_set>
+
+#include "ros2_bdi_utils/ManagedBelief.hpp"
+#include "ros2_bdi_utils/ManagedDesire.hpp"
+
+/* Namespace for wrapper classes wrt. BDI msgs defined in ros2_bdi_interfaces::msg */
+namespace BDIManaged
+{
+
+    /*
+        Desire set of an agent, indexed to make selection and lookups cheap even with thousands of desires:
+            - every desire gets a stable id when inserted (kept when the desire is replaced, e.g. boosted)
+            - desires are kept ordered by priority (desc.) and deadline (asc.), which is also the iteration order
+            - desires are hash indexed by name, desire group and target belief
+            - fulfillment index: the set mirrors which beliefs are currently in the belief set and keeps, for every desire,
+                the number of its target beliefs still missing, so that the fulfilled desires are known straight away
+                and a belief set alteration costs just as much as the desires targeting the altered beliefs
+        Desire names are unique within the set (as they are within the desire set of the Scheduler)
+    */
+    class ManagedDesireSet
+    {
+        // priority index key: (-priority, deadline, id)
+        typedef std::tuple<float, float, uint64_t> PriorityKey;
+
+        public:
+
+            /* Iterator over the desires of the set by priority (desc.) and deadline (asc.) */
+            class const_iterator
+            {
+                public:
+                    typedef std::forward_iterator_tag iterator_category;
+                    typedef ManagedDesire value_type;
+                    typedef std::ptrdiff_t difference_type;
+                    typedef const ManagedDesire* pointer;
+                    typedef const ManagedDesire& reference;
+
+                    const_iterator(const std::set<PriorityKey>::const_iterator& it, const std::unordered_map<uint64_t, ManagedDesire>* desires)
+                        : it_(it), desires_(desires) {}
+
+                    reference operator*() const {return desires_->at(std::get<2>(*it_));}
+                    pointer operator->() const {return &(desires_->at(std::get<2>(*it_)));}
+                    const_iterator& operator++() {++it_; return *this;}
+                    const_iterator operator++(int) {const_iterator prev = *this; ++it_; return prev;}
+                    bool operator==(const const_iterator& other) const {return it_ == other.it_;}
+                    bool operator!=(const const_iterator& other) const {return it_ != other.it_;}
+
+                private:
+                    std::set<PriorityKey>::const_iterator it_;
+                    const std::unordered_map<uint64_t, ManagedDesire>* desires_;
+            };
+
+            /* Constructor methods */
+            ManagedDesireSet();
+            ManagedDesireSet(const std::set<ManagedDesire>& desires);
+
+            const_iterator begin() const {return const_iterator(by_priority_.begin(), &desires_);}
+            const_iterator end() const {return const_iterator(by_priority_.end(), &desires_);}
+
+            size_t size() const {return desires_.size();}
+            bool empty() const {return desires_.empty();}
+
+            /* 1 if @md is in the set, 0 otherwise (same semantic of std::set<ManagedDesire>::count) */
+            size_t count(const ManagedDesire& md) const;
+
+            /* Insert @md giving it a new id; false if @md or another desire with the same name is already there */
+            bool insert(const ManagedDesire& md);
+
+            /* Erase @md from the set; false if not there */
+            bool erase(const ManagedDesire& md);
+
+            /* Replace @original with @updated, which keeps the id of @original; false if @original is not there */
+            bool replace(const ManagedDesire& original, const ManagedDesire& updated);
+
+            void clear();
+
+            /* Id assigned to @md, if it's in the set */
+            std::optional<uint64_t> getId(const ManagedDesire& md) const;
+
+            /* Desire with the given @id, if it's in the set */
+            std::optional<ManagedDesire> get(const uint64_t& id) const;
+
+            /* Desire with the given @name, if it's in the set */
+            std::optional<ManagedDesire> getByName(const std::string& name) const;
+
+            /* Desire with the highest priority (earliest deadline among the ones with the same priority), if the set is not empty */
+            std::optional<ManagedDesire> top() const;
+
+            /* Desires within @desireGroup (by insertion order) */
+            std::vector<ManagedDesire> getByGroup(const std::string& desireGroup) const;
+
+            /* Number of desires within @desireGroup */
+            size_t countInGroup(const std::string& desireGroup) const;
+
+            /* Desires having @mb among their target beliefs (by insertion order) */
+            std::vector<ManagedDesire> getByTargetBelief(const ManagedBelief& mb) const;
+
+            /* Copy of the desires of the set into a std::set<ManagedDesire> */
+            std::set<ManagedDesire> toSet() const;
+
+            /* 
+                @mb has been added to the belief set: update the missing counters of the desires targeting it.
+                Returns true if some desire has become fulfilled
+            */
+            bool beliefAdded(const ManagedBelief& mb);
+
+            /* 
+                @mb has been removed from the belief set: update the missing counters of the desires targeting it
+            */
+            void beliefRemoved(const ManagedBelief& mb);
+
+            /* Reset the mirrored belief set to @bset, recomputing all the missing counters */
+            void setBeliefSet(const std::set<ManagedBelief>& bset);
+
+            /* True if all the target beliefs of @md (which has to be in the set) are in the mirrored belief set */
+            bool isFulfilled(const ManagedDesire& md) const;
+
+            /* Desires whose target beliefs are all in the mirrored belief set (by priority desc., deadline asc.) */
+            std::vector<ManagedDesire> getFulfilled() const;
+
+            /*
+                Key identifying a belief wrt. the ManagedBelief ordering (pddl type, name and params; function value excluded),
+                used to index desires by target belief
+            */
+            static std::string beliefKey(const ManagedBelief& mb);
+
+        private:
+            /* Put desire @md with id @id into all the indexes */
+            void index(const uint64_t& id, const ManagedDesire& md);
+
+            /* Remove desire @md with id @id from all the indexes */
+            void unindex(const uint64_t& id, const ManagedDesire& md);
+
+            /* Collect the desires whose ids are in @ids */
+            std::vector<ManagedDesire> collect(const std::set<uint64_t>& ids) const;
+
+            /* Count the target beliefs of @md not in the mirrored belief set and update the fulfillment index for @id */
+            void computeMissing(const uint64_t& id, const ManagedDesire& md);
+
+            // id to be assigned to the next inserted desire
+            uint64_t next_id_;
+
+            // id -> desire
+            std::unordered_map<uint64_t, ManagedDesire> desires_;
+
+            // (-priority, deadline, id) ordered index
+            std::set<PriorityKey> by_priority_;
+
+            // name -> id
+            std::unordered_map<std::string, uint64_t> by_name_;
+
+            // desire group -> ids
+            std::unordered_map<std::string, std::set<uint64_t>> by_group_;
+
+            // target belief key -> ids
+            std::unordered_map<std::string, std::set<uint64_t>> by_target_;
+
+            // keys of the beliefs currently in the mirrored belief set
+            std::unordered_set<std::string> believed_;
+
+            // id -> number of (distinct) target beliefs not in the mirrored belief set
+            std::unordered_map<uint64_t, int> missing_;
+
+            // ids of the desires with no missing target belief
+            std::set<uint64_t> fulfilled_;
+
+    };  // class ManagedDesireSet
+
+}
+
+#endif  // MANAGED_DESIRE_SET_H_
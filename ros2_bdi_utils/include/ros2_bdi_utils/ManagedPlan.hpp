@@ -4,6 +4,8 @@
 #include <string>
 #include <vector>
 #include <iostream>
+#include <memory>
+#include <algorithm>
 
 #include "plansys2_planner/PlannerClient.hpp"
 #include "plansys2_msgs/msg/plan_item.hpp"
@@ -13,6 +15,7 @@
 #include "ros2_bdi_interfaces/msg/bdi_plan_execution_info.hpp"
 #include "ros2_bdi_utils/ManagedBelief.hpp"
 #include "ros2_bdi_utils/ManagedDesire.hpp"
+#include "ros2_bdi_utils/ActionTable.hpp"
 
 
 /* Namespace for wrapper classes wrt. BDI msgs defined in ros2_bdi_interfaces::msg */
@@ -52,49 +55,62 @@ namespace BDIManaged
                 // do not lose current committed status
                 if(actions_exec_info.size() == actions_exec_info_.size())
                     for(int i=0; i<actions_exec_info_.size(); i++)
-                        actions_exec_info[i].committed = actions_exec_info_[i].committed;
+                        actions_exec_info[i].committed = isActionCommitted(i);
                 this->actions_exec_info_ = actions_exec_info;
             }
 
             void setCommittedStatus(const bool& defaultValue)
             {
+                std::fill(committed_.begin(), committed_.end(), defaultValue? ~uint64_t{0} : uint64_t{0});
+                if(defaultValue && action_table_->size() % 64 > 0)
+                    committed_.back() = (uint64_t{1} << (action_table_->size() % 64)) - 1;
+                committed_count_ = defaultValue? action_table_->size() : 0;
                 for(int i=0; i<actions_exec_info_.size(); i++)
-                    actions_exec_info_[i].committed = defaultValue;
+                    actions_exec_info_[i].committed = isActionCommitted(i);
             }
 
             void setActionCommittedStatus(const std::string& action_name, const float& planned_time, const bool& committed)
             {
-                std::string action_name_timex1000 = buildFullActionNameTimex1000(action_name, planned_time);
-                for(int i=0; i<actions_exec_info_.size(); i++)
-                {
-                    if(action_name_timex1000 == buildFullActionNameTimex1000(
-                        buildFullActionName(actions_exec_info_[i].name, actions_exec_info_[i].args),
-                        actions_exec_info_[i].planned_start)
-                    )
-                        actions_exec_info_[i].committed = committed;
-                }
+                int i = action_table_->index(action_name, static_cast<int>(planned_time * 1000));
+                if(i < 0 || isActionCommitted(i) == committed)
+                    return;
+                committed_[i / 64] ^= uint64_t{1} << (i % 64);
+                committed_count_ += committed? 1 : -1;
+                if(i < actions_exec_info_.size())
+                    actions_exec_info_[i].committed = committed;
             }
 
-            plansys2_msgs::msg::Plan getActionCommittedStatus()
+            /* Committed status of the i-th action and number of committed actions */
+            bool isActionCommitted(const size_t& i) const {return i < action_table_->size() && (committed_[i / 64] >> (i % 64)) & 1;}
+            size_t committedActionsCount() const {return committed_count_;}
+
+            /* Committed status of the actions (bit i of word i/64 for the i-th action) */
+            const std::vector<uint64_t>& getCommittedBits() const {return committed_;}
+
+            plansys2_msgs::msg::Plan getActionCommittedStatus() const {return getActionCommittedStatus(committed_);}
+
+            /* Plan with the actions of this one and committed status @committed (bit i of word i/64 for the i-th action) */
+            plansys2_msgs::msg::Plan getActionCommittedStatus(const std::vector<uint64_t>& committed) const
             {
                 plansys2_msgs::msg::Plan committedPlan;
                 committedPlan.plan_index = getPlanQueueIndex();
-                for(int i=0; i<actions_exec_info_.size(); i++)
+                committedPlan.items = std::vector<plansys2_msgs::msg::PlanItem>(action_table_->size());
+                for(size_t i=0; i<action_table_->size(); i++)
                 {
-                    plansys2_msgs::msg::PlanItem action;
-                    std::string joinedArgs = "";
-                    for(std::string arg : actions_exec_info_[i].args)
-                        joinedArgs += " " + arg;
-                    action.action = "(" + actions_exec_info_[i].name + joinedArgs + ")";
-                    action.time = actions_exec_info_[i].planned_start;
-                    action.duration = actions_exec_info_[i].duration;
-                    action.committed = actions_exec_info_[i].committed;
-                    committedPlan.items.push_back(action);
+                    committedPlan.items[i].action = action_table_->fullName(i);
+                    committedPlan.items[i].time = action_table_->plannedStart(i);
+                    committedPlan.items[i].duration = action_table_->duration(i);
+                    committedPlan.items[i].committed = i / 64 < committed.size() && (committed[i / 64] >> (i % 64)) & 1;
                 }
                 return committedPlan;
             }
 
-            std::vector<ros2_bdi_interfaces::msg::BDIActionExecutionInfo> getActionsExecInfo() const {return actions_exec_info_;};
+            const std::vector<ros2_bdi_interfaces::msg::BDIActionExecutionInfo>& getActionsExecInfo() const {return actions_exec_info_;};
+
+            /* Action instances of the plan, with their canonical strings (built once together with the plan) */
+            const ActionTable& getActionTable() const {return *action_table_;}
+            /* Same table, shared among the copies of the plan (so it also tells apart plans built from distinct plan items) */
+            std::shared_ptr<const ActionTable> getSharedActionTable() const {return action_table_;}
             float getPlannedDeadline() const {return planned_deadline_;};
             
             /*Already started/executing actions start/end time taken in consideration for estimating the new deadline at run time*/
@@ -134,29 +150,15 @@ namespace BDIManaged
         private:
 
             /*
-                compute actoin exec info from plan item, execution status UNKNOWN
+                compute actoin exec info from the action table of the plan, execution status UNKNOWN
             */
             static std::vector<ros2_bdi_interfaces::msg::BDIActionExecutionInfo> 
-                computeActionsExecInfo(std::vector<plansys2_msgs::msg::PlanItem> plan_items);
+                computeActionsExecInfo(const ActionTable& action_table);
 
-            
-            static std::string buildFullActionName(const std::string& action_name, const std::vector<std::string>& args)
+            /* "(a1 p1 p2)" for the i-th action (cached in the action table) */
+            std::string actionFullName(const size_t& i) const
             {
-                std::string result = std::string{action_name};
-                for(uint16_t i = 0; i < args.size(); i++)
-                    result += " " + args[i];
-                return "(" + result + ")";
-            }
-            
-            static std::string buildFullActionNameTimex1000(const std::string& action_name, const float& planned_time)
-            {
-                std::string result = std::string{action_name};
-                if(result.find("(") != std::string::npos)
-                    result = result.substr(result.find("(")+1);
-                if(result.find(")") != std::string::npos)
-                    result = result.substr(0,result.find(")"));
-               int ptimex1000 = static_cast<int>(planned_time * 1000);
-               return "(" + result + "):" + std::to_string(ptimex1000);
+                return i < action_table_->size()? action_table_->fullName(i) : computeActionFullName(actions_exec_info_[i]);
             }
 
             /* Compute deadline estimate based on current actions estimated duration within the one listed in the plan */
@@ -170,10 +172,17 @@ namespace BDIManaged
             /* Main desire that is currently under pursuit and the plan execution should increment the possibilities to fulfill it*/
             std::shared_ptr<ManagedDesire> final_target_;
 
+            /* Action instances of the plan (shared among the copies of the plan, never modified after construction) */
+            std::shared_ptr<const ActionTable> action_table_;
+
             /* Plansys2 action (name, duration, start time) vector enwrapping the tree of actions to be performed to fulfilled the desire
                 that needs to be passed to PlanSys2 Executor */
             std::vector<ros2_bdi_interfaces::msg::BDIActionExecutionInfo> actions_exec_info_;
 
+            /* Committed status of the actions in the action table (bit i of word i/64 for the i-th action) and number of committed ones */
+            std::vector<uint64_t> committed_;
+            size_t committed_count_ = 0;
+
             /* Condition clauses in a DNF expression that must be verified before plan exec starts */
             ManagedConditionsDNF precondition_;
 
@@ -13,6 +13,8 @@
 #include "ros2_bdi_interfaces/msg/desire.hpp"
 #include "ros2_bdi_interfaces/msg/bdi_action_execution_info.hpp"
 
+#include "ros2_bdi_utils/ActionTable.hpp"
+
 
 namespace PDDLBDIConverter
 {
@@ -62,13 +64,14 @@ namespace PDDLBDIConverter
   
   /*
     Build a BDIActionExecutionInfo from the corresponding PlanSys2 ActionExecutionInfo
-    PlanSys2 plan body is needed too (PlanItem array) to get the index of the executing action within it
+    Action table of the current plan is needed too to get name, args and planned times of the action
+    and the index of the actions it's waiting for (without parsing any action string)
 
     Timestamps of corresponding plan start are passed too 
   */
   ros2_bdi_interfaces::msg::BDIActionExecutionInfo buildBDIActionExecutionInfo(
     const std::optional<plansys2_msgs::msg::ActionExecutionInfo>& psys2_action_feed, 
-    const std::vector<plansys2_msgs::msg::PlanItem>& current_plan_body,
+    const BDIManaged::ActionTable& current_plan_actions,
     const int& action_index, 
     const int& first_ts_plan_sec, const unsigned int& first_ts_plan_nanosec);
 
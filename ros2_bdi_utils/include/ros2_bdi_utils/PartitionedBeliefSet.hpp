@@ -0,0 +1,94 @@
+#ifndef PARTITIONED_BELIEF_SET_H_
+#define PARTITIONED_BELIEF_SET_H_
+
+#include <set>
+#include <memory>
+
+#include "ros2_bdi_utils/ManagedBelief.hpp"
+#include "ros2_bdi_utils/StaticBeliefSegment.hpp"
+#include "ros2_bdi_utils/FunctionColumns.hpp"
+
+/* Namespace for wrapper classes wrt. BDI msgs defined in ros2_bdi_interfaces::msg */
+namespace BDIManaged
+{
+
+    /* Beliefs which have been added/removed from a belief set after an update (+ functions whose value has changed) */
+    typedef struct {
+        std::set<ManagedBelief> added;
+        std::set<ManagedBelief> removed;
+        std::set<ManagedBelief> modified;
+
+        bool empty() const {return added.empty() && removed.empty() && modified.empty();}
+    } BeliefSetChanges;
+
+    /*
+        Belief set held by the consumers of the belief set topics, split in:
+            - static partition: immutable segment received once (and replaced only when it grows),
+                never diffed again by the consumer
+            - dynamic partition: updated by full belief set msgs or by belief set deltas,
+                where only the dynamic beliefs get compared
+        get() returns the union of the two, i.e. what the agent believes overall, built the first time it's asked for
+        and kept up to date from then on (consumers just looking up beliefs through count()/find() never build it,
+        lookups going to the static segment index and the dynamic set),
+        getFunctions() the function beliefs in it in columnar form (for batch value checks)
+        n.b. get() is const but may build the union: call it with the same synchronization used for the updates
+    */
+    class PartitionedBeliefSet
+    {
+        public:
+            /* Constructor methods */
+            PartitionedBeliefSet();
+
+            /* Whole belief set (static + dynamic partition), union built on demand */
+            const std::set<ManagedBelief>& get() const;
+
+            /* Dynamic partition */
+            const std::set<ManagedBelief>& getDynamic() const {return dynamic_;}
+
+            /* Static partition */
+            std::shared_ptr<const StaticBeliefSegment> getStatic() const {return static_;}
+
+            /* Function beliefs of the whole belief set, one column per function */
+            const FunctionColumns& getFunctions() const {return functions_;}
+
+            /* Lookups in the two partitions (disjoint, since a static belief wins over a dynamic one with the same signature) */
+            size_t count(const ManagedBelief& mb) const {return static_->count(mb) + dynamic_.count(mb);}
+            size_t size() const {return static_->size() + dynamic_.size();}
+
+            /* Belief equivalent to @mb (e.g. to read a function value), nullptr if not there */
+            const ManagedBelief* find(const ManagedBelief& mb) const;
+
+            /* Replace the static partition with @segment */
+            BeliefSetChanges setStatic(const std::shared_ptr<const StaticBeliefSegment>& segment);
+
+            /* Replace the dynamic partition with @beliefs (diffed only against the current dynamic partition) */
+            BeliefSetChanges setDynamic(const std::set<ManagedBelief>& beliefs);
+
+            /* Apply a delta to the dynamic partition: @removed first, then @added (static beliefs can't be removed) */
+            BeliefSetChanges applyDelta(const std::set<ManagedBelief>& removed, const std::set<ManagedBelief>& added);
+
+        private:
+            /* Add @mb to the dynamic partition (replacing the function value if already there), tracking it in @changes */
+            void addDynamic(const ManagedBelief& mb, BeliefSetChanges& changes);
+
+            /* Remove @mb from the dynamic partition, true if changed */
+            bool removeDynamic(const ManagedBelief& mb);
+
+            // static partition
+            std::shared_ptr<const StaticBeliefSegment> static_;
+
+            // dynamic partition
+            std::set<ManagedBelief> dynamic_;
+
+            // static + dynamic partition (valid just if all_built_, i.e. once get() has been called)
+            mutable std::set<ManagedBelief> all_;
+            mutable bool all_built_;
+
+            // function beliefs in all_
+            FunctionColumns functions_;
+
+    };  // class PartitionedBeliefSet
+
+}
+
+#endif  // PARTITIONED_BELIEF_SET_H_
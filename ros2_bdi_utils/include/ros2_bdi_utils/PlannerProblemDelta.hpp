@@ -0,0 +1,71 @@
+#ifndef PLANNER_PROBLEM_DELTA_H_
+#define PLANNER_PROBLEM_DELTA_H_
+
+#include <cstdint>
+#include <string>
+#include <set>
+
+#include "ros2_bdi_utils/ManagedBelief.hpp"
+
+/*
+    Incremental submission of the PDDL problem to an online planner: instead of the whole problem, the planner receives
+    just what has changed since the version of the problem it got last, in a line based PDDL-like format
+
+        (:delta {base_version} {new_version})
+        (:del-object {name} {type})
+        (:add-object {name} {type})
+        (:del-fact ({predicate} {p1} ... {pn}))
+        (:add-fact ({predicate} {p1} ... {pn}))
+        (:del-function ({function} {p1} ... {pn}))
+        (:set-function ({function} {p1} ... {pn}) {value})
+        (:goal {goal})
+
+    the goal record is always the last one and it's there only if the goal has changed.
+    A full problem is always version 1 and every delta moves it one version ahead:
+    a planner holding a version different from {base_version} has to reject the delta, so that the full problem is sent again
+*/
+namespace PlannerProblemDelta
+{
+    /* True if @problem is a delta rather than a full PDDL problem */
+    bool isDelta(const std::string& problem);
+
+    /*
+        Planner side: apply @delta to the problem made of @beliefs and @goal, at version @version
+        false (and nothing changed) if the delta is malformed or is not based on @version
+    */
+    bool applyDelta(const std::string& delta, uint32_t& version, std::set<BDIManaged::ManagedBelief>& beliefs, std::string& goal);
+
+    /* Full PDDL problem made of @beliefs and @goal */
+    std::string toPDDLProblem(const std::string& problem_name, const std::string& domain_name,
+        const std::set<BDIManaged::ManagedBelief>& beliefs, const std::string& goal);
+
+    /*
+        Scheduler side: versioned view of the problem the planner has received last
+        version 0 means the planner has got nothing yet (or has to be considered out of sync), i.e. the full problem has to be sent
+    */
+    class ProblemView
+    {
+        public:
+            /* Constructor methods */
+            ProblemView();
+
+            uint32_t version() const {return version_;}
+            const std::string& goal() const {return goal_;}
+
+            /* The full problem made of @beliefs and @goal is being sent to the planner (a full problem is always version 1) */
+            void setFull(const std::set<BDIManaged::ManagedBelief>& beliefs, const std::string& goal);
+
+            /* Delta wrt. the last problem sent to reach the one made of @beliefs and @goal, which becomes the last one sent */
+            std::string nextDelta(const std::set<BDIManaged::ManagedBelief>& beliefs, const std::string& goal);
+
+            /* Planner out of sync (e.g. delta rejected): next time send the full problem */
+            void reset();
+
+        private:
+            uint32_t version_;
+            std::set<BDIManaged::ManagedBelief> beliefs_;
+            std::string goal_;
+    };
+}
+
+#endif  // PLANNER_PROBLEM_DELTA_H_
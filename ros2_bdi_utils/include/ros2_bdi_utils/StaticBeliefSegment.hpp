@@ -0,0 +1,74 @@
+#ifndef STATIC_BELIEF_SEGMENT_H_
+#define STATIC_BELIEF_SEGMENT_H_
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <set>
+#include <utility>
+
+#include "ros2_bdi_utils/ManagedBelief.hpp"
+
+/* Namespace for wrapper classes wrt. BDI msgs defined in ros2_bdi_interfaces::msg */
+namespace BDIManaged
+{
+
+    /*
+        Immutable, read-optimized set of static beliefs (e.g. map topology facts which never change during a run),
+        built once and then shared among its readers (through std::shared_ptr<const StaticBeliefSegment>):
+            - beliefs are kept in a sorted array (same ordering of std::set<ManagedBelief>), so that all the beliefs
+                with the same pddl type and name are contiguous
+            - membership is checked through a minimal perfect hash index (hash and displace) built over the array,
+                i.e. a lookup costs a couple of hashes and a single comparison
+    */
+    class StaticBeliefSegment
+    {
+        public:
+            typedef std::vector<ManagedBelief>::const_iterator const_iterator;
+
+            /* Constructor methods */
+            StaticBeliefSegment();
+            StaticBeliefSegment(const std::set<ManagedBelief>& beliefs);
+
+            const_iterator begin() const {return beliefs_.begin();}
+            const_iterator end() const {return beliefs_.end();}
+
+            size_t size() const {return beliefs_.size();}
+            bool empty() const {return beliefs_.empty();}
+
+            /* 1 if @mb is in the segment, 0 otherwise (function value not considered, as in std::set<ManagedBelief>::count) */
+            size_t count(const ManagedBelief& mb) const {return find(mb) != nullptr? 1 : 0;}
+
+            /* Belief in the segment equivalent to @mb (e.g. to read a function value), nullptr if not there */
+            const ManagedBelief* find(const ManagedBelief& mb) const;
+
+            /* Range of the beliefs in the segment with the given @pddl_type and @name */
+            std::pair<const_iterator, const_iterator> equalRange(const int& pddl_type, const std::string& name) const;
+
+            /* Copy of the beliefs of the segment into a std::set<ManagedBelief> */
+            std::set<ManagedBelief> toSet() const {return std::set<ManagedBelief>(beliefs_.begin(), beliefs_.end());}
+
+        private:
+            /* Build the perfect hash index over beliefs_ */
+            void buildIndex();
+
+            /* Hash of @mb wrt. pddl type, name and params (i.e. consistent with the ManagedBelief ordering) */
+            static uint64_t hashBelief(const ManagedBelief& mb);
+
+            /* Slot of the index for a belief with hash @h in a bucket with displacement @d */
+            size_t slotOf(const uint64_t& h, const uint32_t& d) const;
+
+            // beliefs of the segment, sorted
+            std::vector<ManagedBelief> beliefs_;
+
+            // bucket -> displacement (0 = empty bucket)
+            std::vector<uint32_t> displacements_;
+
+            // slot -> position in beliefs_ (size() = empty slot)
+            std::vector<uint32_t> slots_;
+
+    };  // class StaticBeliefSegment
+
+}
+
+#endif  // STATIC_BELIEF_SEGMENT_H_
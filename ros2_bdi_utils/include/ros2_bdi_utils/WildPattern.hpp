@@ -0,0 +1,77 @@
+#ifndef WILD_PATTERN_H_
+#define WILD_PATTERN_H_
+
+#include <string>
+#include <vector>
+
+/* Namespace for wrapper classes wrt. BDI msgs defined in ros2_bdi_interfaces::msg */
+namespace BDIManaged
+{
+
+    /*
+        Pattern potentially containing wild characters that are meant to be replaced by a single char ('?' by default)
+        or by multiple ones ('*' by default), compiled once wrt. its class:
+            - EXACT: no wild chars at all, plain string comparison
+            - PREFIX: "abc*" (or just "*"), i.e. literal prefix
+            - SUFFIX: "*abc", i.e. literal suffix
+            - GLOB: anything else, split in the segments between the multi wild chars and matched
+                with a single left-to-right scan of the text (no allocation per match)
+    */
+    class WildPattern
+    {
+        public:
+            typedef enum {EXACT, PREFIX, SUFFIX, GLOB} PatternClass;
+
+            /* Constructor methods */
+            WildPattern();
+            WildPattern(const std::string& pattern, const char& wild_single_char = '?', const char& wild_multi_char = '*');
+
+            /* true iff @text matches the pattern */
+            bool match(const std::string& text) const
+            {
+                switch(class_)
+                {
+                    case EXACT:
+                        return text == literal_;
+                    case PREFIX:
+                        return text.size() >= literal_.size() && text.compare(0, literal_.size(), literal_) == 0;
+                    case SUFFIX:
+                        return text.size() >= literal_.size() && text.compare(text.size() - literal_.size(), literal_.size(), literal_) == 0;
+                    default:
+                        return matchGlob(text);
+                }
+            }
+
+            PatternClass patternClass() const {return class_;};
+            bool isExact() const {return class_ == EXACT;};
+
+        private:
+            /* match @text against the precompiled segments of a GLOB pattern */
+            bool matchGlob(const std::string& text) const;
+
+            /* true iff @segment (single wild chars allowed) matches @text starting from @pos */
+            bool segmentAt(const std::string& segment, const std::string& text, const size_t& pos) const;
+
+            /* leftmost position in [@from, @to] where @segment matches @text, npos if none */
+            size_t findSegment(const std::string& segment, const std::string& text, const size_t& from, const size_t& to) const;
+
+            PatternClass class_;
+
+            // literal part of EXACT, PREFIX and SUFFIX patterns
+            std::string literal_;
+
+            // GLOB patterns: segments between the multi wild chars (non empty)
+            std::vector<std::string> segments_;
+            // GLOB patterns: no multi wild char at the start/end of the pattern, i.e. first/last segment anchored to the text start/end
+            bool anchored_start_;
+            bool anchored_end_;
+            // GLOB patterns: at least one multi wild char in the pattern
+            bool has_multi_;
+
+            char wild_single_char_;
+
+    };  // class WildPattern
+
+}
+
+#endif  // WILD_PATTERN_H_
@@ -0,0 +1,79 @@
+#include "ros2_bdi_utils/ActionTable.hpp"
+
+#include "ros2_bdi_utils/PDDLUtils.hpp"
+
+using std::string;
+using std::vector;
+
+using plansys2_msgs::msg::PlanItem;
+
+using BDIManaged::ActionTable;
+
+ActionTable::ActionTable()
+    {}
+
+ActionTable::ActionTable(const vector<PlanItem>& plan_items)
+{
+    rows_.reserve(plan_items.size());
+    index_.reserve(plan_items.size());
+    for(const PlanItem& pi : plan_items)
+    {
+        vector<string> tokens = PDDLUtils::extractPlanItemActionElements(pi.action);
+
+        Row row;
+        row.action_id = intern(tokens.empty()? "" : tokens[0]);
+        row.first_arg = arg_ids_.size();
+        row.full_name = "(" + symbols_[row.action_id];
+        for(size_t k = 1; k < tokens.size(); k++)
+        {
+            arg_ids_.push_back(intern(tokens[k]));
+            row.full_name += " " + tokens[k];
+        }
+        row.full_name += ")";
+        row.args.assign(tokens.begin() + (tokens.empty()? 0 : 1), tokens.end());
+        row.planned_start = pi.time;
+        row.planned_start_key = static_cast<int>(pi.time * 1000);
+        row.duration = pi.duration;
+        row.full_name_timex1000 = row.full_name + ":" + std::to_string(row.planned_start_key);
+
+        index_.emplace(row.full_name_timex1000, rows_.size());
+        rows_by_start_[row.planned_start_key].push_back(rows_.size());
+        rows_.push_back(row);
+    }
+}
+
+/*
+    Index of action @action (either "a1 p1 p2" or "(a1 p1 p2)") planned to start at @planned_start_key (planned start x1000), 
+    -1 if not in the table: just the few actions starting at the same time are compared, without building any string
+*/
+int ActionTable::index(const string& action, const int& planned_start_key) const
+{
+    auto rows = rows_by_start_.find(planned_start_key);
+    if(rows == rows_by_start_.end())
+        return -1;
+
+    // what is within the parenthesis, if any
+    std::string_view key(action);
+    if(key.find('(') != std::string_view::npos)
+        key = key.substr(key.find('(') + 1);
+    if(key.find(')') != std::string_view::npos)
+        key = key.substr(0, key.find(')'));
+
+    for(const size_t& i : rows->second)
+        if(std::string_view(rows_[i].full_name).substr(1, rows_[i].full_name.size() - 2) == key)
+            return i;
+    return -1;
+}
+
+/* Id of the interned @symbol, interning it if never seen */
+uint32_t ActionTable::intern(const string& symbol)
+{
+    auto it = symbol_ids_.find(symbol);
+    if(it != symbol_ids_.end())
+        return it->second;
+
+    uint32_t id = symbols_.size();
+    symbols_.push_back(symbol);
+    symbol_ids_[symbol] = id;
+    return id;
+}
@@ -0,0 +1,411 @@
+#include "ros2_bdi_utils/BDISnapshot.hpp"
+
+#include <array>
+#include <cstring>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "rclcpp/serialization.hpp"
+#include "rclcpp/serialized_message.hpp"
+
+#include "ros2_bdi_interfaces/msg/belief_set.hpp"
+#include "ros2_bdi_interfaces/msg/desire_set.hpp"
+#include "ros2_bdi_interfaces/msg/conditions_dnf.hpp"
+
+using std::string;
+using std::vector;
+using std::set;
+using std::optional;
+
+using ros2_bdi_interfaces::msg::BeliefSet;
+using ros2_bdi_interfaces::msg::DesireSet;
+using ros2_bdi_interfaces::msg::ConditionsDNF;
+
+using BDIManaged::ManagedBelief;
+using BDIManaged::ManagedDesire;
+using BDIManaged::ManagedConditionsDNF;
+using BDIManaged::ManagedReactiveRule;
+
+namespace
+{
+    const char MAGIC[8] = {'B','D','I','S','N','A','P','\0'};
+    const size_t HEADER_SIZE = sizeof(MAGIC) + 2 * sizeof(uint32_t);
+    const size_t SECTION_HEADER_SIZE = 2 * sizeof(uint32_t) + sizeof(uint64_t);
+
+    /* Standard (IEEE 802.3) crc32 of @len bytes starting from @data */
+    uint32_t crc32(const uint8_t* data, const size_t& len)
+    {
+        // built once, thread safe (several nodes may share the process)
+        static const std::array<uint32_t, 256> table = [](){
+            std::array<uint32_t, 256> t;
+            for(uint32_t i = 0; i < 256; i++)
+            {
+                uint32_t c = i;
+                for(int k = 0; k < 8; k++)
+                    c = (c & 1)? 0xEDB88320 ^ (c >> 1) : c >> 1;
+                t[i] = c;
+            }
+            return t;
+        }();
+
+        uint32_t crc = 0xFFFFFFFF;
+        for(size_t i = 0; i < len; i++)
+            crc = table[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+        return crc ^ 0xFFFFFFFF;
+    }
+
+    template<typename T>
+    void appendRaw(vector<uint8_t>& out, const T& value)
+    {
+        const uint8_t* bytes = reinterpret_cast<const uint8_t*>(&value);
+        out.insert(out.end(), bytes, bytes + sizeof(T));
+    }
+
+    template<typename T>
+    bool readRaw(const uint8_t*& cursor, const uint8_t* end, T& value)
+    {
+        if(end - cursor < (std::ptrdiff_t) sizeof(T))
+            return false;
+        std::memcpy(&value, cursor, sizeof(T));
+        cursor += sizeof(T);
+        return true;
+    }
+
+    /* CDR serialization of @msg */
+    template<typename MsgT>
+    vector<uint8_t> serialize(const MsgT& msg)
+    {
+        rclcpp::Serialization<MsgT> serializer;
+        rclcpp::SerializedMessage serialized_msg;
+        serializer.serialize_message(&msg, &serialized_msg);
+        const rcl_serialized_message_t& raw = serialized_msg.get_rcl_serialized_message();
+        return vector<uint8_t>(raw.buffer, raw.buffer + raw.buffer_length);
+    }
+
+    /* Deserialize @len bytes starting from @data into @msg, false if they're not a valid CDR encoding */
+    template<typename MsgT>
+    bool deserialize(const uint8_t* data, const size_t& len, MsgT& msg)
+    {
+        try{
+            rclcpp::Serialization<MsgT> serializer;
+            rclcpp::SerializedMessage serialized_msg(len);
+            rcl_serialized_message_t& raw = serialized_msg.get_rcl_serialized_message();
+            std::memcpy(raw.buffer, data, len);
+            raw.buffer_length = len;
+            serializer.deserialize_message(&serialized_msg, &msg);
+            return true;
+        }catch(const std::exception& e){
+            return false;
+        }
+    }
+
+    /* Append @msg serialization to @out prefixed by its length */
+    template<typename MsgT>
+    void appendMsg(vector<uint8_t>& out, const MsgT& msg)
+    {
+        vector<uint8_t> bytes = serialize(msg);
+        appendRaw(out, (uint64_t) bytes.size());
+        out.insert(out.end(), bytes.begin(), bytes.end());
+    }
+
+    /* Read a length prefixed msg serialization from @cursor (moved forward) */
+    template<typename MsgT>
+    bool readMsg(const uint8_t*& cursor, const uint8_t* end, MsgT& msg)
+    {
+        uint64_t len;
+        if(!readRaw(cursor, end, len) || (uint64_t)(end - cursor) < len)
+            return false;
+        if(!deserialize(cursor, len, msg))
+            return false;
+        cursor += len;
+        return true;
+    }
+
+    /* Read a reactive rule ops block (count, operations, BeliefSet msg) from @cursor (moved forward) */
+    bool readOps(const uint8_t*& cursor, const uint8_t* end, set<MGBeliefOp>& belief_ops)
+    {
+        uint32_t num_ops;
+        if(!readRaw(cursor, end, num_ops) || (uint64_t)(end - cursor) < num_ops)
+            return false;
+        const uint8_t* ops = cursor;
+        cursor += num_ops;
+
+        BeliefSet bset_msg;
+        if(!readMsg(cursor, end, bset_msg) || bset_msg.value.size() != num_ops)
+            return false;
+        for(uint32_t i = 0; i < num_ops; i++)
+            belief_ops.insert(std::make_pair((ReactiveOp) ops[i], ManagedBelief{bset_msg.value[i]}));
+        return true;
+    }
+
+    /* Read a reactive rule ops block (count, operations, DesireSet msg) from @cursor (moved forward) */
+    bool readOps(const uint8_t*& cursor, const uint8_t* end, set<MGDesireOp>& desire_ops)
+    {
+        uint32_t num_ops;
+        if(!readRaw(cursor, end, num_ops) || (uint64_t)(end - cursor) < num_ops)
+            return false;
+        const uint8_t* ops = cursor;
+        cursor += num_ops;
+
+        DesireSet dset_msg;
+        if(!readMsg(cursor, end, dset_msg) || dset_msg.value.size() != num_ops)
+            return false;
+        for(uint32_t i = 0; i < num_ops; i++)
+            desire_ops.insert(std::make_pair((ReactiveOp) ops[i], ManagedDesire{dset_msg.value[i]}));
+        return true;
+    }
+}
+
+/* Encode @beliefs as payload of the section @type within @sections */
+void BDISnapshot::putBeliefs(Sections& sections, const uint32_t& type, const set<ManagedBelief>& beliefs)
+{
+    BeliefSet bset_msg = BeliefSet{};
+    bset_msg.value.reserve(beliefs.size());
+    for(ManagedBelief mb : beliefs)
+        bset_msg.value.push_back(mb.toBelief());
+    sections[type] = serialize(bset_msg);
+}
+
+/* Encode @desires as payload of the desires section within @sections */
+void BDISnapshot::putDesires(Sections& sections, const set<ManagedDesire>& desires)
+{
+    DesireSet dset_msg = DesireSet{};
+    dset_msg.value.reserve(desires.size());
+    for(ManagedDesire md : desires)
+        dset_msg.value.push_back(md.toDesire());
+    sections[DESIRES_SECTION] = serialize(dset_msg);
+}
+
+/*
+    Encode @rules as payload of the reactive rules section within @sections
+    Every rule is stored as: id, condition, belief ops (count, operations, beliefs), desire ops (count, operations, desires)
+*/
+void BDISnapshot::putReactiveRules(Sections& sections, const set<ManagedReactiveRule>& rules)
+{
+    vector<uint8_t> payload;
+    appendRaw(payload, (uint64_t) rules.size());
+    for(ManagedReactiveRule rule : rules)
+    {
+        appendRaw(payload, rule.getId());
+        appendMsg(payload, rule.getMGCondition().toConditionsDNF());
+
+        set<MGBeliefOp> belief_rules = rule.getBeliefRules();
+        BeliefSet bset_msg = BeliefSet{};
+        appendRaw(payload, (uint32_t) belief_rules.size());
+        for(MGBeliefOp belief_op : belief_rules)
+        {
+            appendRaw(payload, (uint8_t) belief_op.first);
+            bset_msg.value.push_back(belief_op.second.toBelief());
+        }
+        appendMsg(payload, bset_msg);
+
+        set<MGDesireOp> desire_rules = rule.getDesireRules();
+        DesireSet dset_msg = DesireSet{};
+        appendRaw(payload, (uint32_t) desire_rules.size());
+        for(MGDesireOp desire_op : desire_rules)
+        {
+            appendRaw(payload, (uint8_t) desire_op.first);
+            dset_msg.value.push_back(desire_op.second.toDesire());
+        }
+        appendMsg(payload, dset_msg);
+    }
+    sections[REACTIVE_RULES_SECTION] = payload;
+}
+
+/* Store @source_hash (see fileHash) as payload of the source hash section within @sections */
+void BDISnapshot::putSourceHash(Sections& sections, const uint32_t& source_hash)
+{
+    vector<uint8_t> payload;
+    appendRaw(payload, source_hash);
+    sections[SOURCE_HASH_SECTION] = payload;
+}
+
+/* Write @sections into the snapshot file @filepath (atomically, through a temporary file), true if succeeded */
+bool BDISnapshot::writeSnapshot(const string& filepath, const Sections& sections)
+{
+    string tmp_filepath = filepath + ".tmp";
+    {
+        std::ofstream out(tmp_filepath, std::ios::binary | std::ios::trunc);
+        if(!out)
+            return false;
+
+        uint32_t version = FORMAT_VERSION;
+        uint32_t num_sections = sections.size();
+        out.write(MAGIC, sizeof(MAGIC));
+        out.write(reinterpret_cast<const char*>(&version), sizeof(version));
+        out.write(reinterpret_cast<const char*>(&num_sections), sizeof(num_sections));
+
+        for(auto section : sections)
+        {
+            uint32_t type = section.first;
+            uint32_t crc = crc32(section.second.data(), section.second.size());
+            uint64_t len = section.second.size();
+            out.write(reinterpret_cast<const char*>(&type), sizeof(type));
+            out.write(reinterpret_cast<const char*>(&crc), sizeof(crc));
+            out.write(reinterpret_cast<const char*>(&len), sizeof(len));
+            out.write(reinterpret_cast<const char*>(section.second.data()), len);
+        }
+
+        out.flush();
+        if(!out)
+            return false;
+    }
+    return std::rename(tmp_filepath.c_str(), filepath.c_str()) == 0;
+}
+
+/* crc32 of the content of file @filepath, if it can be read */
+optional<uint32_t> BDISnapshot::fileHash(const string& filepath)
+{
+    std::ifstream in(filepath, std::ios::binary);
+    if(!in)
+        return std::nullopt;
+    vector<uint8_t> content((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+    return crc32(content.data(), content.size());
+}
+
+/* Map @filepath and validate its header; check valid() afterwards */
+BDISnapshot::Snapshot::Snapshot(const string& filepath):
+    data_(nullptr), size_(0)
+{
+    int fd = open(filepath.c_str(), O_RDONLY);
+    if(fd < 0)
+        return;
+
+    struct stat st;
+    if(fstat(fd, &st) != 0 || (size_t) st.st_size < HEADER_SIZE)
+    {
+        close(fd);
+        return;
+    }
+
+    void* mapped = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);//mapping stays valid
+    if(mapped == MAP_FAILED)
+        return;
+
+    const uint8_t* data = static_cast<const uint8_t*>(mapped);
+    const uint8_t* end = data + st.st_size;
+    const uint8_t* cursor = data + sizeof(MAGIC);
+    uint32_t version, num_sections;
+    if(std::memcmp(data, MAGIC, sizeof(MAGIC)) != 0 || !readRaw(cursor, end, version) || version != FORMAT_VERSION
+        || !readRaw(cursor, end, num_sections))
+    {
+        munmap(mapped, st.st_size);
+        return;
+    }
+
+    data_ = data;
+    size_ = st.st_size;
+
+    for(uint32_t i = 0; i < num_sections && (size_t)(end - cursor) >= SECTION_HEADER_SIZE; i++)
+    {
+        uint32_t type, crc;
+        uint64_t len;
+        readRaw(cursor, end, type);
+        readRaw(cursor, end, crc);
+        readRaw(cursor, end, len);
+        if((uint64_t)(end - cursor) < len)
+            break;//truncated
+
+        if(crc32(cursor, len) == crc)
+            sections_[type] = std::make_pair(cursor, (size_t) len);
+        cursor += len;
+    }
+}
+
+BDISnapshot::Snapshot::~Snapshot()
+{
+    if(data_ != nullptr)
+        munmap(const_cast<uint8_t*>(data_), size_);
+}
+
+/* Beliefs stored in section @type, if present and intact */
+optional<set<ManagedBelief>> BDISnapshot::Snapshot::getBeliefs(const uint32_t& type) const
+{
+    auto sectionIt = sections_.find(type);
+    BeliefSet bset_msg;
+    if(sectionIt == sections_.end() || !deserialize(sectionIt->second.first, sectionIt->second.second, bset_msg))
+        return std::nullopt;
+
+    set<ManagedBelief> beliefs;
+    for(auto b : bset_msg.value)
+        beliefs.insert(ManagedBelief{b});
+    return beliefs;
+}
+
+/* Desires stored in the desires section, if present and intact */
+optional<set<ManagedDesire>> BDISnapshot::Snapshot::getDesires() const
+{
+    auto sectionIt = sections_.find(DESIRES_SECTION);
+    DesireSet dset_msg;
+    if(sectionIt == sections_.end() || !deserialize(sectionIt->second.first, sectionIt->second.second, dset_msg))
+        return std::nullopt;
+
+    set<ManagedDesire> desires;
+    for(auto d : dset_msg.value)
+        desires.insert(ManagedDesire{d});
+    return desires;
+}
+
+/* Hash of the init. file stored in the source hash section, if present and intact */
+optional<uint32_t> BDISnapshot::Snapshot::getSourceHash() const
+{
+    auto sectionIt = sections_.find(SOURCE_HASH_SECTION);
+    if(sectionIt == sections_.end())
+        return std::nullopt;
+
+    const uint8_t* cursor = sectionIt->second.first;
+    uint32_t source_hash;
+    if(!readRaw(cursor, cursor + sectionIt->second.second, source_hash))
+        return std::nullopt;
+    return source_hash;
+}
+
+/*
+    True if the snapshot descends from the current content of @sourceFilepath (or if there is no such file to compare with),
+    i.e. the init. file has not been edited since the snapshot state was initialized from it
+*/
+bool BDISnapshot::Snapshot::isUpToDate(const string& sourceFilepath) const
+{
+    optional<uint32_t> current_hash = fileHash(sourceFilepath);
+    if(!current_hash.has_value())
+        return true;//no source to compare with
+    optional<uint32_t> source_hash = getSourceHash();
+    return source_hash.has_value() && source_hash.value() == current_hash.value();
+}
+
+/* Reactive rules stored in the reactive rules section, if present and intact */
+optional<set<ManagedReactiveRule>> BDISnapshot::Snapshot::getReactiveRules() const
+{
+    auto sectionIt = sections_.find(REACTIVE_RULES_SECTION);
+    if(sectionIt == sections_.end())
+        return std::nullopt;
+
+    const uint8_t* cursor = sectionIt->second.first;
+    const uint8_t* end = cursor + sectionIt->second.second;
+    uint64_t num_rules;
+    if(!readRaw(cursor, end, num_rules))
+        return std::nullopt;
+
+    set<ManagedReactiveRule> rules;
+    for(uint64_t r = 0; r < num_rules; r++)
+    {
+        uint16_t id;
+        ConditionsDNF condition_msg;
+        if(!readRaw(cursor, end, id) || !readMsg(cursor, end, condition_msg))
+            return std::nullopt;
+
+        set<MGBeliefOp> belief_rules;
+        set<MGDesireOp> desire_rules;
+        if(!readOps(cursor, end, belief_rules) || !readOps(cursor, end, desire_rules))
+            return std::nullopt;
+
+        rules.insert(ManagedReactiveRule{id, ManagedConditionsDNF{condition_msg}, belief_rules, desire_rules});
+    }
+    return rules;
+}
@@ -31,6 +31,30 @@ namespace BDIYAMLParser
         return parseMGBeliefs(mybset, domain_expert);
     }
 
+    /*
+        Extract managed beliefs from a YAML file containing them, putting the ones flagged with "static: true"
+        into @static_beliefs instead of the returned vector
+    */
+    vector<ManagedBelief> extractMGBeliefs(const string& bset_filepath, const std::shared_ptr<plansys2::DomainExpertClient>& domain_expert,
+        vector<ManagedBelief>& static_beliefs)
+    {
+        vector<ManagedBelief> mgBeliefs;
+        YAML::Node mybset = YAML::LoadFile(bset_filepath);
+        for(YAML::Node::iterator it = mybset.begin(); it != mybset.end(); it++)
+        {
+            auto yaml_belief = (*it);
+            std::optional<ManagedBelief> opt_mb = parseMGBelief(yaml_belief, domain_expert);
+            if(!opt_mb.has_value())
+                continue;
+
+            if(yaml_belief["static"].IsDefined() && yaml_belief["static"].as<bool>())
+                static_beliefs.push_back(opt_mb.value());
+            else
+                mgBeliefs.push_back(opt_mb.value());
+        }
+        return mgBeliefs;
+    }
+
     /*
         Given a YAML Node which should represent an array of beliefs, parse it and build a vector<ManagedBelief>
         return empty if there isn't any belief available within the node
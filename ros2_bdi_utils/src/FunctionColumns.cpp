@@ -0,0 +1,190 @@
+#include "ros2_bdi_utils/FunctionColumns.hpp"
+
+#include <algorithm>
+
+#include "ros2_bdi_interfaces/msg/belief.hpp"
+#include "ros2_bdi_interfaces/msg/condition.hpp"
+
+using std::string;
+using std::vector;
+using std::pair;
+
+using ros2_bdi_interfaces::msg::Belief;
+using ros2_bdi_interfaces::msg::Condition;
+
+using BDIManaged::ManagedParam;
+using BDIManaged::ManagedBelief;
+using BDIManaged::ValueCheck;
+using BDIManaged::FunctionColumns;
+
+namespace
+{
+    /* Fill @bitmap with the result of @cmp over @values, 64 values per word, without branches in the inner loop */
+    template<typename Cmp>
+    void compareWith(const float* values, const size_t& n, std::vector<uint64_t>& bitmap, Cmp cmp)
+    {
+        for(size_t w = 0; w < bitmap.size(); w++)
+        {
+            const float* word_values = values + w * 64;
+            size_t word_n = std::min((size_t) 64, n - w * 64);
+            uint64_t bits = 0;
+            for(size_t k = 0; k < word_n; k++)
+                bits |= ((uint64_t) cmp(word_values[k])) << k;
+            bitmap[w] = bits;
+        }
+    }
+}
+
+FunctionColumns::FunctionColumns():
+    size_(0)
+    {}
+
+/* Add function belief @mb or update its value (other belief types are ignored) */
+void FunctionColumns::set(const ManagedBelief& mb)
+{
+    if(mb.pddlType() != Belief().FUNCTION_TYPE)
+        return;
+
+    const vector<ManagedParam>& params = mb.getParams();
+    vector<uint32_t> param_ids(params.size());
+    for(size_t i = 0; i < params.size(); i++)
+        param_ids[i] = intern(params[i].name);
+
+    Column& column = columns_[std::make_pair(intern(mb.getName()), params.size())];
+    column.arity = params.size();
+    auto row = column.rows.find(param_ids);
+    if(row != column.rows.end())
+    {
+        column.values[row->second] = mb.getValue();
+        return;
+    }
+
+    column.rows[param_ids] = column.values.size();
+    column.params.insert(column.params.end(), param_ids.begin(), param_ids.end());
+    column.values.push_back(mb.getValue());
+    size_++;
+}
+
+/* Remove function belief @mb (other belief types are ignored) */
+void FunctionColumns::erase(const ManagedBelief& mb)
+{
+    if(mb.pddlType() != Belief().FUNCTION_TYPE)
+        return;
+
+    auto column_it = columns_.find(std::make_pair(symbolId(mb.getName()), mb.getParams().size()));
+    if(column_it == columns_.end())
+        return;
+    Column& column = column_it->second;
+
+    const vector<ManagedParam>& params = mb.getParams();
+    vector<uint32_t> param_ids(params.size());
+    for(size_t i = 0; i < params.size(); i++)
+        param_ids[i] = symbolId(params[i].name);
+
+    auto row = column.rows.find(param_ids);
+    if(row == column.rows.end())
+        return;
+
+    // move the last row in place of the removed one
+    size_t removed = row->second, last = column.values.size() - 1;
+    column.rows.erase(row);
+    if(removed != last)
+    {
+        vector<uint32_t> last_ids(column.params.begin() + last * column.arity, column.params.begin() + (last + 1) * column.arity);
+        std::copy(last_ids.begin(), last_ids.end(), column.params.begin() + removed * column.arity);
+        column.values[removed] = column.values[last];
+        column.rows[last_ids] = removed;
+    }
+    column.params.resize(last * column.arity);
+    column.values.pop_back();
+    size_--;
+
+    if(column.values.empty())
+        columns_.erase(column_it);
+}
+
+/* Remove all the function beliefs (symbols stay interned) */
+void FunctionColumns::clear()
+{
+    columns_.clear();
+    size_ = 0;
+}
+
+/* Number of function beliefs stored */
+size_t FunctionColumns::size() const
+{
+    return size_;
+}
+
+/* Id of the interned @symbol (function name or param), NO_ID if never seen */
+uint32_t FunctionColumns::symbolId(const string& symbol) const
+{
+    auto it = symbol_ids_.find(symbol);
+    return it != symbol_ids_.end()? it->second : NO_ID;
+}
+
+/* Column of the function @name with @arity params, nullptr if none */
+const FunctionColumns::Column* FunctionColumns::column(const string& name, const size_t& arity) const
+{
+    auto it = columns_.find(std::make_pair(symbolId(name), arity));
+    return it != columns_.end()? &(it->second) : nullptr;
+}
+
+/*
+    Batch kernel: bit i of @bitmap set iff @values[i] @check @threshold
+    (words of 64 bits, as many as needed for @n values)
+*/
+void FunctionColumns::compare(const float* values, const size_t& n, const ValueCheck& check, const float& threshold, vector<uint64_t>& bitmap)
+{
+    bitmap.assign((n + 63) / 64, 0);
+    switch(check)
+    {
+        case SMALLER:
+            compareWith(values, n, bitmap, [threshold](const float& v){return v < threshold;});
+            break;
+        case SMALLER_OR_EQUALS:
+            compareWith(values, n, bitmap, [threshold](const float& v){return v <= threshold;});
+            break;
+        case EQUALS:
+            compareWith(values, n, bitmap, [threshold](const float& v){return v == threshold;});
+            break;
+        case GREATER_OR_EQUALS:
+            compareWith(values, n, bitmap, [threshold](const float& v){return v >= threshold;});
+            break;
+        case GREATER:
+            compareWith(values, n, bitmap, [threshold](const float& v){return v > threshold;});
+            break;
+    }
+}
+
+/* Value check corresponding to the check string of a Condition msg, false if it's not a check over a function value */
+bool FunctionColumns::toValueCheck(const string& check, ValueCheck& value_check)
+{
+    Condition c = Condition();
+    if(check == c.SMALLER_CHECK)
+        value_check = SMALLER;
+    else if(check == c.SMALLER_OR_EQUALS_CHECK)
+        value_check = SMALLER_OR_EQUALS;
+    else if(check == c.EQUALS_CHECK)
+        value_check = EQUALS;
+    else if(check == c.GREATER_OR_EQUALS_CHECK)
+        value_check = GREATER_OR_EQUALS;
+    else if(check == c.GREATER_CHECK)
+        value_check = GREATER;
+    else
+        return false;
+    return true;
+}
+
+/* Id of the interned @symbol, interning it if never seen */
+uint32_t FunctionColumns::intern(const string& symbol)
+{
+    auto it = symbol_ids_.find(symbol);
+    if(it != symbol_ids_.end())
+        return it->second;
+
+    uint32_t id = symbols_.size();
+    symbols_.push_back(symbol);
+    symbol_ids_[symbol] = id;
+    return id;
+}
@@ -14,87 +14,59 @@ using ros2_bdi_interfaces::msg::Condition;
 using BDIManaged::ManagedParam;
 using BDIManaged::ManagedBelief;
 using BDIManaged::ManagedCondition;
+using BDIManaged::WildPattern;
 
-/*
-    returns true if the wild_string potentially containing wild characters that are meant to be replaced by a single char (wild_single_char) or multiple ones (wild_multi_char)
-    mathes the text_string
-    Krauss algorithm https://en.wikipedia.org/wiki/Krauss_wildcard-matching_algorithm 
-*/
-bool krauss_wild_pattern_match(string wild_string, string text_string, 
-    const char& wild_single_char = '?', const char& wild_multi_char = '*')
-{
-    if(wild_string == text_string || wild_string == std::to_string(wild_multi_char))//trivial case
-        return true;
+ManagedCondition::ManagedCondition(const ManagedBelief& managedBelief, const string& check):
+    condition_to_check_(managedBelief),
+    check_(check)
+    {
+        compilePatterns();
+    }
 
-    bool TRUE=true,FALSE=false;
-    bool check[wild_string.length()+1][text_string.length()+1];
-    check[0][0]=TRUE;
-    
-    for(int i=1;i<=text_string.length();i++)
-       check[0][i]=FALSE;
-    for(int i=1;i<=wild_string.length();i++)
-        if(wild_string[i-1] == wild_multi_char)//Checking for wild characters.
-            check[i][0]=check[i-1][0];
-    else
-        check[i][0]=FALSE;
-        
-    for(int i=1;i<=wild_string.length();i++)
+ManagedCondition::ManagedCondition(const Condition& condition):
+    condition_to_check_(ManagedBelief{condition.condition_to_check}),
+    check_(condition.check)
     {
-        for(int j=1;j<=text_string.length();j++)
-        {
-            if(wild_string[i-1] == text_string[j-1])
-                check[i][j]=check[i-1][j-1];
-            else if(wild_string[i-1] == wild_single_char)//Checking for wild character '?'.
-                check[i][j]=check[i-1][j-1];
-            else if(wild_string[i-1] == wild_multi_char)//Checking for wild character '*'.
-                check[i][j]=check[i-1][j]||check[i][j-1];
-                
-            else
-               check[i][j] =FALSE;
-        }
+        compilePatterns();
     }
 
-    return check[wild_string.length()][text_string.length()];
+// compile the wild patterns in the name and params of condition_to_check_
+void ManagedCondition::compilePatterns()
+{
+    name_pattern_ = WildPattern{condition_to_check_.getName()};
+    exact_ = name_pattern_.isExact();
+    for(const ManagedParam& p : condition_to_check_.getParams())
+    {
+        param_patterns_.push_back(WildPattern{p.name});
+        exact_ = exact_ && param_patterns_.back().isExact();
+    }
 }
 
 /*
-    Returns true if the two mg beliefs are equivalent, taking into consideration wild pattern in the first
-    (e.g. params={"box_*"} will be considered equivalent to params={"box_a1"} ) when comparing names and params
-    (does not apply to value which are not a factor in order to consider the equivalence of two managed belief)
+    return true iff @mb is equivalent to condition_to_check_ wrt. the wild patterns in its name and params
+    (e.g. params={"box_*"} will be considered equivalent to params={"box_a1"}), value not considered
 */
-bool wild_pattern_equal(const ManagedBelief& mgBeliefWildPattern, const ManagedBelief& mgBeliefToCheckAgainst)
+bool ManagedCondition::matchesPatterns(const ManagedBelief& mb) const
 {
-    if(mgBeliefWildPattern.pddlType() != mgBeliefToCheckAgainst.pddlType()) // different pddl type... no reason to go further in the comparison
+    if(condition_to_check_.pddlType() != mb.pddlType()) // different pddl type... no reason to go further in the comparison
         return false;
-        
-    if(!krauss_wild_pattern_match(mgBeliefWildPattern.getName(), mgBeliefToCheckAgainst.getName())) // names do not match (considering wild pattern chars)
+
+    if(!name_pattern_.match(mb.getName())) // names do not match (considering wild pattern chars)
         return false;
 
-    vector<ManagedParam> wild_params = mgBeliefWildPattern.getParams();
-    vector<ManagedParam> text_params = mgBeliefToCheckAgainst.getParams();
-    if(wild_params.size() != mgBeliefToCheckAgainst.getParams().size())// params size differ
+    const vector<ManagedParam>& text_params = mb.getParams();
+    if(param_patterns_.size() != text_params.size())// params size differ
         return false;
-    
+
     //check equals param by param (at this point you know the two arrays are the same size)
-    for(uint8_t i = 0; i < wild_params.size(); i++)
-    {   
-        if(!krauss_wild_pattern_match(wild_params[i].name,text_params[i].name)) //params in pos i do not match
+    for(size_t i = 0; i < param_patterns_.size(); i++)
+        if(!param_patterns_[i].match(text_params[i].name)) //params in pos i do not match
             return false;
-    }
+
     //otherwise equals
     return true;
 }
 
-ManagedCondition::ManagedCondition(const ManagedBelief& managedBelief, const string& check):
-    condition_to_check_(managedBelief),
-    check_(check)
-    {}
-
-ManagedCondition::ManagedCondition(const Condition& condition):
-    condition_to_check_(ManagedBelief{condition.condition_to_check}),
-    check_(condition.check)
-    {}
-
 // Clone a MG Conditions DNF
 ManagedCondition ManagedCondition::clone()
 {
@@ -131,13 +103,13 @@ bool ManagedCondition::performCheckAgainstBelief(const ManagedBelief& mb)
     Condition c = Condition();
 
     if(condition_to_check_.pddlType() == Belief().INSTANCE_TYPE)
-        return wild_pattern_equal(condition_to_check_, mb);
+        return matchesPatterns(mb);
 
     else if (condition_to_check_.pddlType() == Belief().PREDICATE_TYPE)
         //true if (same predicate and TRUE CHECK requested) or (diff predicate and FALSE CHECK requested)
-        return (check_ == c.TRUE_CHECK)? wild_pattern_equal(condition_to_check_, mb) : !(wild_pattern_equal(condition_to_check_, mb));
+        return (check_ == c.TRUE_CHECK)? matchesPatterns(mb) : !(matchesPatterns(mb));
 
-    else if (condition_to_check_.pddlType() == Belief().FUNCTION_TYPE && wild_pattern_equal(condition_to_check_, mb))//has to be the same fluent
+    else if (condition_to_check_.pddlType() == Belief().FUNCTION_TYPE && matchesPatterns(mb))//has to be the same fluent
     {
         //now check the value wrt the given check request
         if(check_ == c.SMALLER_CHECK)
@@ -190,6 +162,9 @@ bool ManagedCondition::performCheckAgainstBeliefs(const set<ManagedBelief>& mbSe
 
     if(!validCheckRequest())
         return false;
+
+    if(name_pattern_.isExact())
+        return performCheckAgainstNamedBeliefs(mbSet);
     
     // int counter = 0;
     for(ManagedBelief mb : mbSet)
@@ -222,6 +197,35 @@ bool ManagedCondition::performCheckAgainstBeliefs(const set<ManagedBelief>& mbSe
     return false;
 }
 
+/*
+    performCheckAgainstBeliefs when the name of condition_to_check_ has no wild chars:
+    just the beliefs in @mbSet with the same pddl type and name are checked, found through the set ordering
+*/
+bool ManagedCondition::performCheckAgainstNamedBeliefs(const set<ManagedBelief>& mbSet)
+{
+    Condition c = Condition();
+
+    // beliefs are sorted by pddl type, name and then params (size first), so the first candidate is found by a lower bound
+    // wrt. a belief with no params (or directly, when the condition has no wild chars at all)
+    auto it = exact_? mbSet.find(condition_to_check_) :
+        mbSet.lower_bound(ManagedBelief{condition_to_check_.getName(), condition_to_check_.pddlType(), vector<ManagedParam>{}, 0.0f});
+
+    for(; it != mbSet.end() && it->pddlType() == condition_to_check_.pddlType() && it->getName() == condition_to_check_.getName(); it++)
+    {
+        bool check_res = performCheckAgainstBelief(*it);
+        if(check_ != c.FALSE_CHECK && check_res)
+            return true;
+
+        if(check_ == c.FALSE_CHECK && !check_res)
+            return false; // check false where found to be true
+
+        if(exact_)
+            break;// no other candidate
+    }
+
+    // check false has been successfully verified against all candidates (beliefs with other names verify it trivially)
+    return check_ == c.FALSE_CHECK;
+}
 
 Condition ManagedCondition::toCondition() const
 {
@@ -1,16 +1,24 @@
 #include "ros2_bdi_utils/ManagedConditionsConjunction.hpp"
 
 #include <algorithm>
+#include <unordered_set>
+
+#include "ros2_bdi_interfaces/msg/belief.hpp"
 
 using std::string;
 using std::vector;
 using std::set;
 using std::map;
 
+using ros2_bdi_interfaces::msg::Belief;
 using ros2_bdi_interfaces::msg::Condition;
 using ros2_bdi_interfaces::msg::ConditionsConjunction;
 
+using BDIManaged::ManagedParam;
 using BDIManaged::ManagedBelief;
+using BDIManaged::WildPattern;
+using BDIManaged::ValueCheck;
+using BDIManaged::FunctionColumns;
 using BDIManaged::ManagedCondition;
 using BDIManaged::ManagedConditionsConjunction;
 
@@ -70,6 +78,52 @@ ManagedConditionsConjunction ManagedConditionsConjunction::applySubstitution(con
     return ManagedConditionsConjunction{new_literals};
 }
 
+/*
+    Restrict the candidates in @assignments of the placeholders among the params of the function literals with a value check
+    to the instances for which the check holds for at least a function in @functions (evaluated over its whole column at once):
+    the other ones could never satisfy the conjunction
+*/
+void ManagedConditionsConjunction::pruneAssignments(map<string, vector<ManagedBelief>>& assignments, const FunctionColumns& functions) const
+{
+    vector<uint64_t> bitmap;
+    for(const ManagedCondition& mc : literals_)
+    {
+        ValueCheck value_check;
+        ManagedBelief mb = mc.getMGBelief();
+        if(mb.pddlType() != Belief().FUNCTION_TYPE || !FunctionColumns::toValueCheck(mc.getCheck(), value_check) || !WildPattern{mb.getName()}.isExact())
+            continue;
+
+        // positions of the params holding placeholders with candidates to prune
+        vector<size_t> positions;
+        vector<ManagedParam> params = mb.getParams();
+        for(size_t k = 0; k < params.size(); k++)
+            if(params[k].isPlaceholder() && assignments.count(params[k].name) > 0)
+                positions.push_back(k);
+        if(positions.empty())
+            continue;
+
+        const FunctionColumns::Column* column = functions.column(mb.getName(), params.size());
+        if(column != nullptr)
+            FunctionColumns::compare(column->values.data(), column->values.size(), value_check, mb.getValue(), bitmap);
+        else
+            bitmap.clear();// no function instance at all
+
+        for(size_t k : positions)
+        {
+            // param ids found in position k in the rows passing the check
+            std::unordered_set<uint32_t> allowed;
+            for(size_t w = 0; w < bitmap.size(); w++)
+                for(uint64_t bits = bitmap[w]; bits != 0; bits &= bits - 1)
+                    allowed.insert(column->params[(w * 64 + __builtin_ctzll(bits)) * column->arity + k]);
+
+            vector<ManagedBelief>& candidates = assignments[params[k].name];
+            candidates.erase(std::remove_if(candidates.begin(), candidates.end(),
+                [&allowed, &functions](const ManagedBelief& instance){return allowed.count(functions.symbolId(instance.getName())) == 0;}),
+                candidates.end());
+        }
+    }
+}
+
 ManagedConditionsConjunction::ManagedConditionsConjunction(const vector<ManagedCondition>& literals):
     literals_(literals){}
 
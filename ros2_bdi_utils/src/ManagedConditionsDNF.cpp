@@ -260,6 +260,16 @@ map<string, vector<ManagedBelief>> ManagedConditionsDNF::extractAssignmentsMap(c
     return assignments_result;
 }
 
+/*
+    Prune the candidates in @assignments wrt. the value checks over @functions (see ManagedConditionsConjunction::pruneAssignments);
+    done just when there is a single clause, otherwise an assignment failing a clause could still satisfy another one
+*/
+void ManagedConditionsDNF::pruneAssignments(map<string, vector<ManagedBelief>>& assignments, const FunctionColumns& functions) const
+{
+    if(clauses_.size() == 1)
+        clauses_[0].pruneAssignments(assignments, functions);
+}
+
 std::ostream& BDIManaged::operator<<(std::ostream& os, const ManagedConditionsDNF& mcdnf)
 {
     auto clauses = mcdnf.getClauses();
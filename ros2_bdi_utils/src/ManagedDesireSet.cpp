@@ -0,0 +1,294 @@
+#include "ros2_bdi_utils/ManagedDesireSet.hpp"
+
+using std::string;
+using std::vector;
+using std::set;
+using std::optional;
+
+using BDIManaged::ManagedBelief;
+using BDIManaged::ManagedDesire;
+using BDIManaged::ManagedDesireSet;
+
+ManagedDesireSet::ManagedDesireSet():
+    next_id_(1)
+    {}
+
+ManagedDesireSet::ManagedDesireSet(const set<ManagedDesire>& desires):
+    next_id_(1)
+    {
+        for(ManagedDesire md : desires)
+            insert(md);
+    }
+
+/* 1 if @md is in the set, 0 otherwise (same semantic of std::set<ManagedDesire>::count) */
+size_t ManagedDesireSet::count(const ManagedDesire& md) const
+{
+    return getId(md).has_value()? 1 : 0;
+}
+
+/* Insert @md giving it a new id; false if @md or another desire with the same name is already there */
+bool ManagedDesireSet::insert(const ManagedDesire& md)
+{
+    if(by_name_.count(md.getName()) > 0)
+        return false;
+
+    uint64_t id = next_id_++;
+    desires_.emplace(id, md);
+    index(id, md);
+    return true;
+}
+
+/* Erase @md from the set; false if not there */
+bool ManagedDesireSet::erase(const ManagedDesire& md)
+{
+    optional<uint64_t> id = getId(md);
+    if(!id.has_value())
+        return false;
+
+    unindex(id.value(), desires_.at(id.value()));
+    desires_.erase(id.value());
+    return true;
+}
+
+/* Replace @original with @updated, which keeps the id of @original; false if @original is not there */
+bool ManagedDesireSet::replace(const ManagedDesire& original, const ManagedDesire& updated)
+{
+    optional<uint64_t> id = getId(original);
+    if(!id.has_value())
+        return false;
+
+    if(updated.getName() != original.getName() && by_name_.count(updated.getName()) > 0)
+        return false;//would clash with another desire in the set
+
+    unindex(id.value(), desires_.at(id.value()));
+    desires_.at(id.value()) = updated;
+    index(id.value(), updated);
+    return true;
+}
+
+void ManagedDesireSet::clear()
+{
+    desires_.clear();
+    by_priority_.clear();
+    by_name_.clear();
+    by_group_.clear();
+    by_target_.clear();
+    missing_.clear();
+    fulfilled_.clear();
+}
+
+/* Id assigned to @md, if it's in the set */
+optional<uint64_t> ManagedDesireSet::getId(const ManagedDesire& md) const
+{
+    auto nameIt = by_name_.find(md.getName());
+    if(nameIt != by_name_.end() && desires_.at(nameIt->second) == md)
+        return nameIt->second;
+    return std::nullopt;
+}
+
+/* Desire with the given @id, if it's in the set */
+optional<ManagedDesire> ManagedDesireSet::get(const uint64_t& id) const
+{
+    auto desireIt = desires_.find(id);
+    if(desireIt != desires_.end())
+        return desireIt->second;
+    return std::nullopt;
+}
+
+/* Desire with the given @name, if it's in the set */
+optional<ManagedDesire> ManagedDesireSet::getByName(const string& name) const
+{
+    auto nameIt = by_name_.find(name);
+    if(nameIt != by_name_.end())
+        return desires_.at(nameIt->second);
+    return std::nullopt;
+}
+
+/* Desire with the highest priority (earliest deadline among the ones with the same priority), if the set is not empty */
+optional<ManagedDesire> ManagedDesireSet::top() const
+{
+    if(by_priority_.empty())
+        return std::nullopt;
+    return desires_.at(std::get<2>(*by_priority_.begin()));
+}
+
+/* Desires within @desireGroup (by insertion order) */
+vector<ManagedDesire> ManagedDesireSet::getByGroup(const string& desireGroup) const
+{
+    auto groupIt = by_group_.find(desireGroup);
+    return (groupIt != by_group_.end())? collect(groupIt->second) : vector<ManagedDesire>();
+}
+
+/* Number of desires within @desireGroup */
+size_t ManagedDesireSet::countInGroup(const string& desireGroup) const
+{
+    auto groupIt = by_group_.find(desireGroup);
+    return (groupIt != by_group_.end())? groupIt->second.size() : 0;
+}
+
+/* Desires having @mb among their target beliefs (by insertion order) */
+vector<ManagedDesire> ManagedDesireSet::getByTargetBelief(const ManagedBelief& mb) const
+{
+    auto targetIt = by_target_.find(beliefKey(mb));
+    return (targetIt != by_target_.end())? collect(targetIt->second) : vector<ManagedDesire>();
+}
+
+/* Copy of the desires of the set into a std::set<ManagedDesire> */
+set<ManagedDesire> ManagedDesireSet::toSet() const
+{
+    set<ManagedDesire> desires;
+    for(auto idDesire : desires_)
+        desires.insert(idDesire.second);
+    return desires;
+}
+
+/* 
+    @mb has been added to the belief set: update the missing counters of the desires targeting it.
+    Returns true if some desire has become fulfilled
+*/
+bool ManagedDesireSet::beliefAdded(const ManagedBelief& mb)
+{
+    string key = beliefKey(mb);
+    if(!believed_.insert(key).second)
+        return false;//already there (e.g. function value update)
+
+    bool newlyFulfilled = false;
+    auto targetIt = by_target_.find(key);
+    if(targetIt != by_target_.end())
+        for(uint64_t id : targetIt->second)
+            if(--missing_[id] == 0)
+            {
+                fulfilled_.insert(id);
+                newlyFulfilled = true;
+            }
+    return newlyFulfilled;
+}
+
+/* 
+    @mb has been removed from the belief set: update the missing counters of the desires targeting it
+*/
+void ManagedDesireSet::beliefRemoved(const ManagedBelief& mb)
+{
+    string key = beliefKey(mb);
+    if(believed_.erase(key) == 0)
+        return;//was not there
+
+    auto targetIt = by_target_.find(key);
+    if(targetIt != by_target_.end())
+        for(uint64_t id : targetIt->second)
+            if(missing_[id]++ == 0)
+                fulfilled_.erase(id);
+}
+
+/* Reset the mirrored belief set to @bset, recomputing all the missing counters */
+void ManagedDesireSet::setBeliefSet(const set<ManagedBelief>& bset)
+{
+    believed_.clear();
+    for(ManagedBelief mb : bset)
+        believed_.insert(beliefKey(mb));
+
+    fulfilled_.clear();
+    for(auto idDesire : desires_)
+        computeMissing(idDesire.first, idDesire.second);
+}
+
+/* True if all the target beliefs of @md (which has to be in the set) are in the mirrored belief set */
+bool ManagedDesireSet::isFulfilled(const ManagedDesire& md) const
+{
+    optional<uint64_t> id = getId(md);
+    return id.has_value() && fulfilled_.count(id.value()) == 1;
+}
+
+/* Desires whose target beliefs are all in the mirrored belief set (by priority desc., deadline asc.) */
+vector<ManagedDesire> ManagedDesireSet::getFulfilled() const
+{
+    set<PriorityKey> ordered;
+    for(uint64_t id : fulfilled_)
+    {
+        const ManagedDesire& md = desires_.at(id);
+        ordered.insert(PriorityKey{-md.getPriority(), md.getDeadline(), id});
+    }
+
+    vector<ManagedDesire> fulfilled;
+    fulfilled.reserve(ordered.size());
+    for(PriorityKey key : ordered)
+        fulfilled.push_back(desires_.at(std::get<2>(key)));
+    return fulfilled;
+}
+
+/*
+    Key identifying a belief wrt. the ManagedBelief ordering (pddl type, name and params; function value excluded),
+    used to index desires by target belief
+*/
+string ManagedDesireSet::beliefKey(const ManagedBelief& mb)
+{
+    return std::to_string(mb.pddlType()) + " " + mb.getName() + " " + mb.getParamsJoined();
+}
+
+/* Put desire @md with id @id into all the indexes */
+void ManagedDesireSet::index(const uint64_t& id, const ManagedDesire& md)
+{
+    by_priority_.insert(PriorityKey{-md.getPriority(), md.getDeadline(), id});
+    by_name_[md.getName()] = id;
+    by_group_[md.getDesireGroup()].insert(id);
+    for(ManagedBelief target : md.getValue())
+        by_target_[beliefKey(target)].insert(id);
+    computeMissing(id, md);
+}
+
+/* Remove desire @md with id @id from all the indexes */
+void ManagedDesireSet::unindex(const uint64_t& id, const ManagedDesire& md)
+{
+    by_priority_.erase(PriorityKey{-md.getPriority(), md.getDeadline(), id});
+    by_name_.erase(md.getName());
+    missing_.erase(id);
+    fulfilled_.erase(id);
+
+    auto groupIt = by_group_.find(md.getDesireGroup());
+    if(groupIt != by_group_.end())
+    {
+        groupIt->second.erase(id);
+        if(groupIt->second.empty())
+            by_group_.erase(groupIt);
+    }
+
+    for(ManagedBelief target : md.getValue())
+    {
+        auto targetIt = by_target_.find(beliefKey(target));
+        if(targetIt != by_target_.end())
+        {
+            targetIt->second.erase(id);
+            if(targetIt->second.empty())
+                by_target_.erase(targetIt);
+        }
+    }
+}
+
+/* Count the target beliefs of @md not in the mirrored belief set and update the fulfillment index for @id */
+void ManagedDesireSet::computeMissing(const uint64_t& id, const ManagedDesire& md)
+{
+    std::unordered_set<string> targets;
+    for(ManagedBelief target : md.getValue())
+        targets.insert(beliefKey(target));
+
+    int missing = 0;
+    for(string key : targets)
+        if(believed_.count(key) == 0)
+            missing++;
+
+    missing_[id] = missing;
+    if(missing == 0)
+        fulfilled_.insert(id);
+    else
+        fulfilled_.erase(id);
+}
+
+/* Collect the desires whose ids are in @ids */
+vector<ManagedDesire> ManagedDesireSet::collect(const set<uint64_t>& ids) const
+{
+    vector<ManagedDesire> collected;
+    collected.reserve(ids.size());
+    for(uint64_t id : ids)
+        collected.push_back(desires_.at(id));
+    return collected;
+}
@@ -1,7 +1,5 @@
 #include "ros2_bdi_utils/ManagedPlan.hpp"
 
-#include "ros2_bdi_utils/PDDLUtils.hpp"
-
 #include "ros2_bdi_interfaces/msg/desire.hpp"
 
 #include <boost/algorithm/string.hpp>
@@ -31,25 +29,23 @@ string ManagedPlan::computeActionFullName(BDIActionExecutionInfo action_exec)
     return full_name;
 }
 
-vector<BDIActionExecutionInfo> ManagedPlan::computeActionsExecInfo(vector<PlanItem> plan_items)
+vector<BDIActionExecutionInfo> ManagedPlan::computeActionsExecInfo(const ActionTable& action_table)
 {
 
     vector<BDIActionExecutionInfo> actions_exec_info = vector<BDIActionExecutionInfo>();
+    actions_exec_info.reserve(action_table.size());
 
-    for(PlanItem pi : plan_items)
+    for(size_t i = 0; i < action_table.size(); i++)
     {
         BDIActionExecutionInfo bdi_ai = BDIActionExecutionInfo();
 
-        vector<string> tokens = PDDLUtils::extractPlanItemActionElements(pi.action);
-        bdi_ai.name = tokens[0];
-
-        for(uint16_t i = 1; i<tokens.size(); i++)
-            bdi_ai.args.push_back(tokens[i]);
+        bdi_ai.name = action_table.name(i);
+        bdi_ai.args = action_table.args(i);
 
         bdi_ai.status = bdi_ai.UNKNOWN;
         bdi_ai.actual_start = 0.0f;
-        bdi_ai.planned_start = pi.time;
-        bdi_ai.duration = pi.duration;
+        bdi_ai.planned_start = action_table.plannedStart(i);
+        bdi_ai.duration = action_table.duration(i);
         bdi_ai.progress = 0.0f;
         bdi_ai.exec_time = 0.0f;
 
@@ -60,6 +56,7 @@ vector<BDIActionExecutionInfo> ManagedPlan::computeActionsExecInfo(vector<PlanIt
 }
 
 ManagedPlan::ManagedPlan():
+    action_table_(std::make_shared<const ActionTable>()),
     actions_exec_info_(vector<BDIActionExecutionInfo>()),
     precondition_(ManagedConditionsDNF{}),
     context_(ManagedConditionsDNF{}),
@@ -73,7 +70,9 @@ ManagedPlan::ManagedPlan():
 
 ManagedPlan::ManagedPlan(const int16_t& plan_index, const ManagedDesire& md, const vector<PlanItem>& planitems):
     planqueue_index_(plan_index),
-    actions_exec_info_(computeActionsExecInfo(planitems)),
+    action_table_(std::make_shared<const ActionTable>(planitems)),
+    actions_exec_info_(computeActionsExecInfo(*action_table_)),
+    committed_((action_table_->size() + 63) / 64, 0),
     precondition_(ManagedConditionsDNF{}),
     context_(ManagedConditionsDNF{})
     {   
@@ -85,7 +84,9 @@ ManagedPlan::ManagedPlan(const int16_t& plan_index, const ManagedDesire& md, con
 ManagedPlan::ManagedPlan(const int16_t& plan_index, const ManagedDesire& md, const vector<PlanItem>& planitems, 
     const ManagedConditionsDNF& precondition, const ManagedConditionsDNF& context):
     planqueue_index_(plan_index),
-    actions_exec_info_(computeActionsExecInfo(planitems)),
+    action_table_(std::make_shared<const ActionTable>(planitems)),
+    actions_exec_info_(computeActionsExecInfo(*action_table_)),
+    committed_((action_table_->size() + 63) / 64, 0),
     precondition_(precondition),
     context_(context)
     {   
@@ -97,7 +98,9 @@ ManagedPlan::ManagedPlan(const int16_t& plan_index, const ManagedDesire& md, con
 ManagedPlan::ManagedPlan(const int16_t& plan_index, const ManagedDesire& finalDesire, const ManagedDesire& intermediateDesire,
     const vector<PlanItem>& planitems, const ManagedConditionsDNF& precondition, const ManagedConditionsDNF& context):
     planqueue_index_(plan_index),
-    actions_exec_info_(computeActionsExecInfo(planitems)),
+    action_table_(std::make_shared<const ActionTable>(planitems)),
+    actions_exec_info_(computeActionsExecInfo(*action_table_)),
+    committed_((action_table_->size() + 63) / 64, 0),
     precondition_(precondition),
     context_(context)
     {   
@@ -110,15 +113,14 @@ Plan ManagedPlan::toPsys2Plan() const
 {
     Plan p = Plan();
     p.plan_index = planqueue_index_;
-    p.items =  vector<PlanItem>();
-    for(BDIActionExecutionInfo bdi_ai : actions_exec_info_)
+    p.items =  vector<PlanItem>(actions_exec_info_.size());
+    for(size_t i = 0; i < actions_exec_info_.size(); i++)
     {
-        PlanItem pi = PlanItem();
-        pi.time = bdi_ai.planned_start;
-        pi.duration = bdi_ai.duration;
-        pi.action = ManagedPlan::computeActionFullName(bdi_ai);
+        PlanItem& pi = p.items[i];
+        pi.time = actions_exec_info_[i].planned_start;
+        pi.duration = actions_exec_info_[i].duration;
+        pi.action = actionFullName(i);
         pi.committed = true;
-        p.items.push_back(pi);
     }
     return p;
 }
@@ -18,6 +18,8 @@ using ros2_bdi_interfaces::msg::Belief;
 using ros2_bdi_interfaces::msg::Desire;
 using ros2_bdi_interfaces::msg::BDIActionExecutionInfo;
 
+using BDIManaged::ActionTable;
+
 namespace PDDLBDIConverter
 {
 
@@ -211,33 +213,33 @@ namespace PDDLBDIConverter
 
   /*
     Build a BDIActionExecutionInfo from the corresponding PlanSys2 ActionExecutionInfo
-    PlanSys2 plan body is needed too (PlanItem array) to get the index of the executing action within it
+    Action table of the current plan is needed too to get name, args and planned times of the action
+    and the index of the actions it's waiting for (without parsing any action string)
   */
   BDIActionExecutionInfo buildBDIActionExecutionInfo(
 
     const std::optional<ActionExecutionInfo>& psys2_action_feed_opt, 
-    const vector<PlanItem>& current_plan_body,
+    const ActionTable& current_plan_actions,
     const int& action_index, 
     const int& first_ts_plan_sec, const unsigned int& first_ts_plan_nanosec)
   {
     ActionExecutionInfo psys2_action_feed = psys2_action_feed_opt.has_value()? psys2_action_feed_opt.value() : ActionExecutionInfo();
     
     BDIActionExecutionInfo bdiActionExecutionInfo = BDIActionExecutionInfo();
-    vector<string> plan_item_elems = PDDLUtils::extractPlanItemActionElements(current_plan_body[action_index].action);
 
     //assign index
     bdiActionExecutionInfo.index = action_index;
     //assign action's name
-    bdiActionExecutionInfo.name = plan_item_elems[0];
+    bdiActionExecutionInfo.name = current_plan_actions.name(action_index);
     //assign action's args
-    for(int i = 1; i<plan_item_elems.size(); i++)
-      bdiActionExecutionInfo.args.push_back(plan_item_elems[i]);
+    bdiActionExecutionInfo.args = current_plan_actions.args(action_index);
 
     bdiActionExecutionInfo.wait_action_indexes = std::vector<short int>();
     if(psys2_action_feed_opt.has_value())
     {
-      for(auto waitAction : psys2_action_feed.waiting_actions)
-        bdiActionExecutionInfo.wait_action_indexes.push_back(getActionIndex(current_plan_body, waitAction));
+      bdiActionExecutionInfo.wait_action_indexes.reserve(psys2_action_feed.waiting_actions.size());
+      for(const string& waitAction : psys2_action_feed.waiting_actions)
+        bdiActionExecutionInfo.wait_action_indexes.push_back(current_plan_actions.index(waitAction));
     }
 
     if(psys2_action_feed_opt.has_value() && first_ts_plan_sec >= 0 && psys2_action_feed.status != psys2_action_feed.NOT_EXECUTED)
@@ -263,10 +265,10 @@ namespace PDDLBDIConverter
     }
 
     // planned start time for this action
-    bdiActionExecutionInfo.planned_start = current_plan_body[action_index].time;
+    bdiActionExecutionInfo.planned_start = current_plan_actions.plannedStart(action_index);
 
     //retrieve estimated duration for action from pddl domain
-    bdiActionExecutionInfo.duration = current_plan_body[action_index].duration;
+    bdiActionExecutionInfo.duration = current_plan_actions.duration(action_index);
 
     bdiActionExecutionInfo.progress = psys2_action_feed_opt.has_value()? psys2_action_feed.completion : 0.0f;
 
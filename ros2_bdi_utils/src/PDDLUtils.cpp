@@ -1,35 +1,29 @@
 #include "ros2_bdi_utils/PDDLUtils.hpp"
 
-#include <boost/algorithm/string.hpp>
-
 using std::vector;
 using std::string;
 
-/*Remove ALL parenthesis from an expression*/
-string removeParenthesis(const string& expression)
-{
-    string stringNoPar = string(expression);
-    while(stringNoPar.find("(") != string::npos)
-        stringNoPar = stringNoPar.substr(stringNoPar.find("(")+1);
-    while(stringNoPar.find(")") != string::npos)
-        stringNoPar = stringNoPar.substr(0,stringNoPar.find(")"));
-    return stringNoPar;
-}
-
 namespace PDDLUtils{
 
     /*
         Returns all the items within a PlanItem.action string
         E.g. "(dosweep sweeper kitchen)" -> ["dosweep", "sweeper", "kitchen"]
+        (single scan of the string, parenthesis and repeated blanks skipped)
     */
     vector<string> extractPlanItemActionElements(const string& planItemAction)
     {
         vector<string> elems;
-        if(planItemAction.length() > 0)
+        size_t start = string::npos;
+        for(size_t i = 0; i <= planItemAction.length(); i++)
         {
-            string planItemActionNoPar = removeParenthesis(planItemAction);
-
-            boost::split(elems, planItemActionNoPar, [](char c){return c == ' ';});//split string
+            bool separator = i == planItemAction.length() || planItemAction[i] == ' ' || planItemAction[i] == '(' || planItemAction[i] == ')';
+            if(!separator && start == string::npos)
+                start = i;
+            else if(separator && start != string::npos)
+            {
+                elems.emplace_back(planItemAction, start, i - start);
+                start = string::npos;
+            }
         }
         return elems;
     }
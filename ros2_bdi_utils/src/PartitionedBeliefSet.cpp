@@ -0,0 +1,138 @@
+#include "ros2_bdi_utils/PartitionedBeliefSet.hpp"
+
+using std::set;
+using std::shared_ptr;
+
+using BDIManaged::ManagedBelief;
+using BDIManaged::StaticBeliefSegment;
+using BDIManaged::BeliefSetChanges;
+using BDIManaged::PartitionedBeliefSet;
+
+PartitionedBeliefSet::PartitionedBeliefSet():
+    static_(std::make_shared<const StaticBeliefSegment>()),
+    all_built_(false)
+    {}
+
+/* Whole belief set (static + dynamic partition), union built on demand */
+const set<ManagedBelief>& PartitionedBeliefSet::get() const
+{
+    if(!all_built_)
+    {
+        all_ = dynamic_;
+        for(const ManagedBelief& mb : *static_)
+            all_.insert(mb);
+        all_built_ = true;
+    }
+    return all_;
+}
+
+/* Belief equivalent to @mb (e.g. to read a function value), nullptr if not there */
+const ManagedBelief* PartitionedBeliefSet::find(const ManagedBelief& mb) const
+{
+    const ManagedBelief* static_mb = static_->find(mb);
+    if(static_mb != nullptr)
+        return static_mb;
+    auto it = dynamic_.find(mb);
+    return it != dynamic_.end()? &(*it) : nullptr;
+}
+
+/* Replace the static partition with @segment */
+BeliefSetChanges PartitionedBeliefSet::setStatic(const shared_ptr<const StaticBeliefSegment>& segment)
+{
+    BeliefSetChanges changes;
+    if(segment == nullptr || segment == static_)
+        return changes;
+
+    for(const ManagedBelief& mb : *static_)
+        if(segment->count(mb) == 0 && dynamic_.count(mb) == 0)
+        {
+            if(all_built_)
+                all_.erase(mb);
+            functions_.erase(mb);
+            changes.removed.insert(mb);
+        }
+
+    for(const ManagedBelief& mb : *segment)
+        if(static_->count(mb) == 0)
+        {
+            // a static belief wins over a dynamic one with the same signature
+            if(dynamic_.erase(mb) == 0)
+                changes.added.insert(mb);
+            if(all_built_)
+            {
+                all_.erase(mb);
+                all_.insert(mb);
+            }
+            functions_.set(mb);
+        }
+
+    static_ = segment;
+    return changes;
+}
+
+/* Replace the dynamic partition with @beliefs (diffed only against the current dynamic partition) */
+BeliefSetChanges PartitionedBeliefSet::setDynamic(const set<ManagedBelief>& beliefs)
+{
+    BeliefSetChanges changes;
+    set<ManagedBelief> old_dynamic = dynamic_;
+    for(const ManagedBelief& mb : old_dynamic)
+        if(beliefs.count(mb) == 0 && removeDynamic(mb))
+            changes.removed.insert(mb);
+
+    for(const ManagedBelief& mb : beliefs)
+        addDynamic(mb, changes);
+
+    return changes;
+}
+
+/* Apply a delta to the dynamic partition: @removed first, then @added (static beliefs can't be removed) */
+BeliefSetChanges PartitionedBeliefSet::applyDelta(const set<ManagedBelief>& removed, const set<ManagedBelief>& added)
+{
+    BeliefSetChanges changes;
+    for(const ManagedBelief& mb : removed)
+        if(removeDynamic(mb))
+            changes.removed.insert(mb);
+
+    for(const ManagedBelief& mb : added)
+        addDynamic(mb, changes);
+
+    return changes;
+}
+
+/* Add @mb to the dynamic partition (replacing the function value if already there), tracking it in @changes */
+void PartitionedBeliefSet::addDynamic(const ManagedBelief& mb, BeliefSetChanges& changes)
+{
+    if(static_->count(mb) == 1)
+        return;
+
+    auto it = dynamic_.find(mb);
+    if(it != dynamic_.end())
+    {
+        if(it->getValue() == mb.getValue())
+            return;
+        // function value update
+        dynamic_.erase(it);
+        if(all_built_)
+            all_.erase(mb);
+        changes.modified.erase(mb);
+        changes.modified.insert(mb);
+    }
+    else if(changes.removed.erase(mb) == 0)
+        changes.added.insert(mb);
+    dynamic_.insert(mb);
+    if(all_built_)
+        all_.insert(mb);
+    functions_.set(mb);
+}
+
+/* Remove @mb from the dynamic partition, true if changed */
+bool PartitionedBeliefSet::removeDynamic(const ManagedBelief& mb)
+{
+    if(static_->count(mb) == 1 || dynamic_.erase(mb) == 0)
+        return false;
+
+    if(all_built_)
+        all_.erase(mb);
+    functions_.erase(mb);
+    return true;
+}
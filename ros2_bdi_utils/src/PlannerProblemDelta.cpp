@@ -0,0 +1,252 @@
+#include "ros2_bdi_utils/PlannerProblemDelta.hpp"
+
+#include <sstream>
+#include <cstdlib>
+#include <vector>
+
+#include "ros2_bdi_interfaces/msg/belief.hpp"
+
+using std::string;
+using std::vector;
+using std::set;
+
+using ros2_bdi_interfaces::msg::Belief;
+
+using BDIManaged::ManagedType;
+using BDIManaged::ManagedParam;
+using BDIManaged::ManagedBelief;
+
+using PlannerProblemDelta::ProblemView;
+
+namespace
+{
+    const string DELTA_HEADER = "(:delta ";
+    const string GOAL_RECORD = "(:goal ";
+
+    /* "(name p1 ... pn)" for predicates and functions */
+    string atom(const ManagedBelief& mb)
+    {
+        string result = "(" + mb.getName();
+        for(const ManagedParam& p : mb.getParams())
+            result += " " + p.name;
+        return result + ")";
+    }
+
+    /* function values are written with enough digits to be read back as the very same float */
+    string value(const float& v)
+    {
+        std::ostringstream oss;
+        oss.precision(9);
+        oss << v;
+        return oss.str();
+    }
+
+    /* Record of the delta stating @mb has been removed (@del) or added/updated */
+    string record(const ManagedBelief& mb, const bool& del)
+    {
+        if(mb.pddlType() == Belief().INSTANCE_TYPE)
+            return string(del? "(:del-object " : "(:add-object ") + mb.getName() + " " + mb.type().name + ")\n";
+        else if(mb.pddlType() == Belief().PREDICATE_TYPE)
+            return string(del? "(:del-fact " : "(:add-fact ") + atom(mb) + ")\n";
+        else if(mb.pddlType() == Belief().FUNCTION_TYPE)
+            return del? "(:del-function " + atom(mb) + ")\n" : "(:set-function " + atom(mb) + " " + value(mb.getValue()) + ")\n";
+        return "";
+    }
+
+    /* Split @s wrt. blank chars */
+    vector<string> tokens(const string& s)
+    {
+        vector<string> result;
+        std::istringstream iss(s);
+        string token;
+        while(iss >> token)
+            result.push_back(token);
+        return result;
+    }
+
+    /* Version number in @s */
+    bool parseVersion(const string& s, uint32_t& version)
+    {
+        char* end = nullptr;
+        unsigned long v = std::strtoul(s.c_str(), &end, 10);
+        if(s.empty() || *end != '\0' || v > UINT32_MAX)
+            return false;
+        version = v;
+        return true;
+    }
+
+    /* Belief of type @pddl_type from the atom "(name p1 ... pn)" (parenthesis included) */
+    bool parseAtom(const string& text, const int& pddl_type, const float& v, ManagedBelief& mb)
+    {
+        if(text.size() < 3 || text.front() != '(' || text.back() != ')')
+            return false;
+        vector<string> items = tokens(text.substr(1, text.size() - 2));
+        if(items.empty())
+            return false;
+
+        vector<ManagedParam> params;
+        for(size_t i = 1; i < items.size(); i++)
+            params.push_back(ManagedParam{items[i], ManagedType{"", std::nullopt}});
+        mb = ManagedBelief{items[0], pddl_type, params, v};
+        return true;
+    }
+}
+
+/* True if @problem is a delta rather than a full PDDL problem */
+bool PlannerProblemDelta::isDelta(const string& problem)
+{
+    return problem.compare(0, DELTA_HEADER.size(), DELTA_HEADER) == 0;
+}
+
+/*
+    Planner side: apply @delta to the problem made of @beliefs and @goal, at version @version
+    false (and nothing changed) if the delta is malformed or is not based on @version
+*/
+bool PlannerProblemDelta::applyDelta(const string& delta, uint32_t& version, set<ManagedBelief>& beliefs, string& goal)
+{
+    std::istringstream iss(delta);
+    string line;
+    if(!std::getline(iss, line) || !isDelta(line))
+        return false;
+    vector<string> header = tokens(line.substr(DELTA_HEADER.size(), line.size() - DELTA_HEADER.size() - 1));
+    uint32_t base_version, new_version;
+    if(header.size() != 2 || !parseVersion(header[0], base_version) || !parseVersion(header[1], new_version) || base_version != version)
+        return false;
+
+    set<ManagedBelief> updated = beliefs;
+    string updated_goal = goal;
+    while(std::getline(iss, line))
+    {
+        if(line.empty())
+            continue;
+
+        if(line.compare(0, GOAL_RECORD.size(), GOAL_RECORD) == 0)
+        {
+            // last record, spanning till the end of the delta
+            string rest((std::istreambuf_iterator<char>(iss)), std::istreambuf_iterator<char>());
+            updated_goal = (line + (rest.empty()? "" : "\n" + rest));
+            while(!updated_goal.empty() && updated_goal.back() == '\n')
+                updated_goal.pop_back();
+            if(updated_goal.empty() || updated_goal.back() != ')')
+                return false;
+            updated_goal = updated_goal.substr(GOAL_RECORD.size(), updated_goal.size() - GOAL_RECORD.size() - 1);
+            break;
+        }
+
+        size_t space = line.find(' ');
+        if(line.size() < 4 || line.back() != ')' || space == string::npos)
+            return false;
+        string kind = line.substr(0, space);
+        string body = line.substr(space + 1, line.size() - space - 2);
+
+        ManagedBelief mb;
+        if(kind == "(:add-object" || kind == "(:del-object")
+        {
+            vector<string> items = tokens(body);
+            if(items.size() != 2)
+                return false;
+            mb = ManagedBelief::buildMBInstance(items[0], items[1]);
+        }
+        else if(kind == "(:add-fact" || kind == "(:del-fact")
+        {
+            if(!parseAtom(body, Belief().PREDICATE_TYPE, 0.0f, mb))
+                return false;
+        }
+        else if(kind == "(:del-function")
+        {
+            if(!parseAtom(body, Belief().FUNCTION_TYPE, 0.0f, mb))
+                return false;
+        }
+        else if(kind == "(:set-function")
+        {
+            size_t close = body.rfind(')');
+            char* end = nullptr;
+            float v = (close == string::npos)? 0.0f : std::strtof(body.c_str() + close + 1, &end);
+            if(close == string::npos || end == body.c_str() + close + 1 || !parseAtom(body.substr(0, close + 1), Belief().FUNCTION_TYPE, v, mb))
+                return false;
+        }
+        else
+            return false;
+
+        // additions and function updates replace the old entry, if any
+        updated.erase(mb);
+        if(kind.compare(0, 6, "(:del-") != 0)
+            updated.insert(mb);
+    }
+
+    beliefs = updated;
+    goal = updated_goal;
+    version = new_version;
+    return true;
+}
+
+/* Full PDDL problem made of @beliefs and @goal */
+string PlannerProblemDelta::toPDDLProblem(const string& problem_name, const string& domain_name,
+    const set<ManagedBelief>& beliefs, const string& goal)
+{
+    string objects = "", init = "";
+    for(const ManagedBelief& mb : beliefs)
+        if(mb.pddlType() == Belief().INSTANCE_TYPE)
+            objects += "\t" + mb.getName() + " - " + mb.type().name + "\n";
+        else if(mb.pddlType() == Belief().PREDICATE_TYPE)
+            init += "\t" + atom(mb) + "\n";
+        else if(mb.pddlType() == Belief().FUNCTION_TYPE)
+            init += "\t(= " + atom(mb) + " " + value(mb.getValue()) + ")\n";
+
+    return "( define ( problem " + problem_name + " )\n( :domain " + domain_name + " )\n" +
+        "( :objects\n" + objects + ")\n" +
+        "( :init\n" + init + ")\n" +
+        "( :goal\n\t" + goal + "\n)\n)\n";
+}
+
+ProblemView::ProblemView():
+    version_(0)
+    {}
+
+/* The full problem made of @beliefs and @goal is being sent to the planner (a full problem is always version 1) */
+void ProblemView::setFull(const set<ManagedBelief>& beliefs, const string& goal)
+{
+    beliefs_ = beliefs;
+    goal_ = goal;
+    version_ = 1;
+}
+
+/* Delta wrt. the last problem sent to reach the one made of @beliefs and @goal, which becomes the last one sent */
+string ProblemView::nextDelta(const set<ManagedBelief>& beliefs, const string& goal)
+{
+    string delta = DELTA_HEADER + std::to_string(version_) + " " + std::to_string(version_ + 1) + ")\n";
+
+    // single merge pass over the two sorted sets
+    auto old_it = beliefs_.begin();
+    auto new_it = beliefs.begin();
+    while(old_it != beliefs_.end() || new_it != beliefs.end())
+    {
+        if(new_it == beliefs.end() || (old_it != beliefs_.end() && *old_it < *new_it))
+            delta += record(*(old_it++), true);
+        else if(old_it == beliefs_.end() || *new_it < *old_it)
+            delta += record(*(new_it++), false);
+        else
+        {
+            if(new_it->pddlType() == Belief().FUNCTION_TYPE && new_it->getValue() != old_it->getValue())
+                delta += record(*new_it, false);
+            old_it++;
+            new_it++;
+        }
+    }
+
+    if(goal != goal_)
+        delta += GOAL_RECORD + goal + ")\n";
+
+    beliefs_ = beliefs;
+    goal_ = goal;
+    version_++;
+    return delta;
+}
+
+/* Planner out of sync (e.g. delta rejected): next time send the full problem */
+void ProblemView::reset()
+{
+    beliefs_.clear();
+    goal_ = "";
+    version_ = 0;
+}
@@ -0,0 +1,155 @@
+#include "ros2_bdi_utils/StaticBeliefSegment.hpp"
+
+#include <algorithm>
+#include <functional>
+
+using std::string;
+using std::vector;
+using std::set;
+using std::pair;
+
+using BDIManaged::ManagedParam;
+using BDIManaged::ManagedBelief;
+using BDIManaged::StaticBeliefSegment;
+
+namespace
+{
+    // beliefs per bucket (on average) in the perfect hash index
+    const size_t BUCKET_LOAD = 4;
+
+    // max displacement tried for a bucket before growing the slots table
+    const uint32_t MAX_DISPLACEMENT = 1 << 16;
+
+    /* splitmix64 finalizer */
+    uint64_t mix(uint64_t x)
+    {
+        x ^= x >> 30;
+        x *= 0xBF58476D1CE4E5B9ULL;
+        x ^= x >> 27;
+        x *= 0x94D049BB133111EBULL;
+        x ^= x >> 31;
+        return x;
+    }
+}
+
+StaticBeliefSegment::StaticBeliefSegment()
+    {}
+
+StaticBeliefSegment::StaticBeliefSegment(const set<ManagedBelief>& beliefs):
+    beliefs_(beliefs.begin(), beliefs.end())
+    {
+        buildIndex();
+    }
+
+/* Belief in the segment equivalent to @mb (e.g. to read a function value), nullptr if not there */
+const ManagedBelief* StaticBeliefSegment::find(const ManagedBelief& mb) const
+{
+    if(beliefs_.empty())
+        return nullptr;
+
+    uint64_t h = hashBelief(mb);
+    uint32_t d = displacements_[h % displacements_.size()];
+    if(d == 0)
+        return nullptr;//empty bucket
+
+    uint32_t pos = slots_[slotOf(h, d)];
+    if(pos == beliefs_.size())
+        return nullptr;
+
+    const ManagedBelief& candidate = beliefs_[pos];
+    return (!(candidate < mb) && !(mb < candidate))? &candidate : nullptr;
+}
+
+/* Range of the beliefs in the segment with the given @pddl_type and @name */
+pair<StaticBeliefSegment::const_iterator, StaticBeliefSegment::const_iterator>
+    StaticBeliefSegment::equalRange(const int& pddl_type, const string& name) const
+{
+    // beliefs are sorted by pddl type first (instances, predicates, functions), then by name
+    auto lower = std::lower_bound(beliefs_.begin(), beliefs_.end(), std::make_pair(pddl_type, name),
+        [](const ManagedBelief& mb, const pair<int, string>& key)
+            {return mb.pddlType() < key.first || mb.pddlType() == key.first && mb.getName() < key.second;});
+    auto upper = std::upper_bound(lower, beliefs_.end(), std::make_pair(pddl_type, name),
+        [](const pair<int, string>& key, const ManagedBelief& mb)
+            {return key.first < mb.pddlType() || key.first == mb.pddlType() && key.second < mb.getName();});
+    return std::make_pair(lower, upper);
+}
+
+/* Build the perfect hash index over beliefs_ */
+void StaticBeliefSegment::buildIndex()
+{
+    size_t n = beliefs_.size();
+    if(n == 0)
+        return;
+
+    vector<uint64_t> hashes(n);
+    for(size_t i = 0; i < n; i++)
+        hashes[i] = hashBelief(beliefs_[i]);
+
+    size_t num_buckets = std::max((size_t) 1, n / BUCKET_LOAD);
+    vector<vector<uint32_t>> buckets(num_buckets);
+    for(size_t i = 0; i < n; i++)
+        buckets[hashes[i] % num_buckets].push_back(i);
+
+    // place the biggest buckets first, while the table is still mostly empty
+    vector<size_t> order(num_buckets);
+    for(size_t b = 0; b < num_buckets; b++)
+        order[b] = b;
+    std::stable_sort(order.begin(), order.end(), [&buckets](size_t b1, size_t b2){return buckets[b1].size() > buckets[b2].size();});
+
+    size_t num_slots = n;
+    bool built = false;
+    while(!built)
+    {
+        displacements_.assign(num_buckets, 0);
+        slots_.assign(num_slots, n);
+        built = true;
+
+        for(size_t b : order)
+        {
+            if(buckets[b].empty())
+                break;//all the following ones are empty too
+
+            bool placed = false;
+            vector<size_t> bucket_slots(buckets[b].size());
+            for(uint32_t d = 1; !placed && d < MAX_DISPLACEMENT; d++)
+            {
+                displacements_[b] = d;
+                placed = true;
+                for(size_t k = 0; placed && k < buckets[b].size(); k++)
+                {
+                    bucket_slots[k] = slotOf(hashes[buckets[b][k]], d);
+                    placed = slots_[bucket_slots[k]] == n &&
+                        std::find(bucket_slots.begin(), bucket_slots.begin() + k, bucket_slots[k]) == bucket_slots.begin() + k;
+                }
+            }
+
+            if(!placed)
+            {
+                // (very unlikely, e.g. equal hashes) give up on minimality and retry with a bigger table
+                num_slots += num_slots / 4 + 1;
+                built = false;
+                break;
+            }
+
+            for(size_t k = 0; k < buckets[b].size(); k++)
+                slots_[bucket_slots[k]] = buckets[b][k];
+        }
+    }
+}
+
+/* Hash of @mb wrt. pddl type, name and params (i.e. consistent with the ManagedBelief ordering) */
+uint64_t StaticBeliefSegment::hashBelief(const ManagedBelief& mb)
+{
+    std::hash<string> hash_string;
+    uint64_t h = mix(mb.pddlType() + 1);
+    h = mix(h ^ hash_string(mb.getName()));
+    for(ManagedParam p : mb.getParams())
+        h = mix(h ^ hash_string(p.name));
+    return h;
+}
+
+/* Slot of the index for a belief with hash @h in a bucket with displacement @d */
+size_t StaticBeliefSegment::slotOf(const uint64_t& h, const uint32_t& d) const
+{
+    return mix(h + d * 0x9E3779B97F4A7C15ULL) % slots_.size();
+}
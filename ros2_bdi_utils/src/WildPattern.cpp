@@ -0,0 +1,118 @@
+#include "ros2_bdi_utils/WildPattern.hpp"
+
+using std::string;
+
+using BDIManaged::WildPattern;
+
+WildPattern::WildPattern():
+    class_(EXACT),
+    anchored_start_(true),
+    anchored_end_(true),
+    has_multi_(false),
+    wild_single_char_('?')
+    {}
+
+WildPattern::WildPattern(const string& pattern, const char& wild_single_char, const char& wild_multi_char):
+    class_(GLOB),
+    anchored_start_(pattern.empty() || pattern.front() != wild_multi_char),
+    anchored_end_(pattern.empty() || pattern.back() != wild_multi_char),
+    has_multi_(false),
+    wild_single_char_(wild_single_char)
+{
+    // split in the segments between the multi wild chars (consecutive ones are the same as a single one)
+    bool has_single = false;
+    string segment = "";
+    for(char ch : pattern)
+    {
+        if(ch == wild_multi_char)
+        {
+            has_multi_ = true;
+            if(!segment.empty())
+                segments_.push_back(segment);
+            segment = "";
+        }
+        else
+        {
+            has_single = has_single || ch == wild_single_char;
+            segment += ch;
+        }
+    }
+    if(!segment.empty())
+        segments_.push_back(segment);
+
+    if(!has_multi_ && !has_single)
+    {
+        class_ = EXACT;
+        literal_ = pattern;
+    }
+    else if(!has_single && segments_.size() <= 1 && (anchored_start_ || segments_.empty()))
+    {
+        class_ = PREFIX;// "abc*" or "*"
+        literal_ = segments_.empty()? "" : segments_[0];
+    }
+    else if(!has_single && segments_.size() == 1 && anchored_end_)
+    {
+        class_ = SUFFIX;// "*abc"
+        literal_ = segments_[0];
+    }
+
+    if(class_ != GLOB)
+        segments_.clear();
+}
+
+/* match @text against the precompiled segments of a GLOB pattern */
+bool WildPattern::matchGlob(const string& text) const
+{
+    if(!has_multi_)// just single wild chars: one segment spanning the whole text
+        return text.size() == segments_[0].size() && segmentAt(segments_[0], text, 0);
+
+    size_t begin = 0, end = text.size();
+    size_t first = 0, last = segments_.size();
+
+    if(anchored_start_)
+    {
+        if(text.size() < segments_[0].size() || !segmentAt(segments_[0], text, 0))
+            return false;
+        begin = segments_[0].size();
+        first++;
+    }
+
+    if(anchored_end_ && last > first)
+    {
+        const string& last_segment = segments_[last - 1];
+        if(end - begin < last_segment.size() || !segmentAt(last_segment, text, end - last_segment.size()))
+            return false;
+        end -= last_segment.size();
+        last--;
+    }
+
+    // segments in between: leftmost occurrence of each, one after the other
+    for(size_t i = first; i < last; i++)
+    {
+        if(end - begin < segments_[i].size())
+            return false;
+        size_t pos = findSegment(segments_[i], text, begin, end - segments_[i].size());
+        if(pos == string::npos)
+            return false;
+        begin = pos + segments_[i].size();
+    }
+    return true;
+}
+
+/* true iff @segment (single wild chars allowed) matches @text starting from @pos */
+bool WildPattern::segmentAt(const string& segment, const string& text, const size_t& pos) const
+{
+    for(size_t k = 0; k < segment.size(); k++)
+        if(segment[k] != wild_single_char_ && segment[k] != text[pos + k])
+            return false;
+    return true;
+}
+
+/* leftmost position in [@from, @to] where @segment matches @text, npos if none */
+size_t WildPattern::findSegment(const string& segment, const string& text, const size_t& from, const size_t& to) const
+{
+    for(size_t pos = from; pos <= to; pos++)
+        if(segmentAt(segment, text, pos))
+            return pos;
+    return string::npos;
+}
@@ -8,6 +8,7 @@ import rclpy
 from rclpy.executors import MultiThreadedExecutor
 from rclpy.node import Node
 from rclpy.action import ActionServer
+from rclpy.qos import QoSProfile, QoSDurabilityPolicy
 
 from .tk_litter_world_thread import TkLitterWorldThread
 from .pose import MGPose
@@ -18,6 +19,7 @@ from ros2_bdi_interfaces.msg import BeliefSet
 from ros2_bdi_interfaces.msg import Desire
 from ros2_bdi_interfaces.msg import BDIActionExecutionInfoMin
 from ros2_bdi_interfaces.msg import BDIPlanExecutionInfoMin
+from ros2_bdi_interfaces.msg import IntentionDelta
 
 from litter_world_interfaces.msg import Pose
 from litter_world_interfaces.action import CmdPose
@@ -66,7 +68,16 @@ class LitterWorldROS2Controller(Node):
         
         if self.get_parameter("show_agent_view").value == 'plastic_agent' or self.get_parameter("show_agent_view").value == 'paper_agent':
             monitoring_agent = self.get_parameter("show_agent_view").value
-            self.agent_intention_subscriber_ = self.create_subscription(BDIPlanExecutionInfoMin, "/"+monitoring_agent+"/current_intentions", self.callback_pa_agent_intentions, 10)
+            self.agent_intention_ = None # intention snapshot kept up to date with the deltas received after it
+            self.agent_intention_delta_seq_ = 0
+            self.agent_intention_subscriber_ = self.create_subscription(BDIPlanExecutionInfoMin, "/"+monitoring_agent+"/current_intentions", self.callback_pa_agent_intentions, 
+                QoSProfile(depth=1, durability=QoSDurabilityPolicy.TRANSIENT_LOCAL)) # latched snapshot
+            self.agent_intention_delta_subscriber_ = self.create_subscription(IntentionDelta, "/"+monitoring_agent+"/current_intentions_delta", self.callback_pa_agent_intention_delta, 10)
+            # agent's belief set = static partition (latched, e.g. map and bins) + dynamic partition
+            self.agent_static_bset_ = []
+            self.agent_dynamic_bset_ = []
+            self.agent_static_bset_subscriber_ = self.create_subscription(BeliefSet, "/"+monitoring_agent+"/static_belief_set", self.callback_pa_agent_static_bset, 
+                QoSProfile(depth=1, durability=QoSDurabilityPolicy.TRANSIENT_LOCAL)) # latched
             self.agent_bset_subscriber_ = self.create_subscription(BeliefSet, "/"+monitoring_agent+"/belief_set", self.callback_pa_agent_bset, 10)
 
         self.plastic_agent_cmd_pose_ = ActionServer(self, CmdPose, 'cmd_plastic_agent_move', self.callback_cmd_plastic_agent_move)
@@ -89,7 +100,16 @@ class LitterWorldROS2Controller(Node):
             self.get_logger().info("Play simulation")
             self.tk_litter_world_thread_.play_sim()
 
+    def callback_pa_agent_static_bset(self, msg:BeliefSet):
+        self.agent_static_bset_ = msg.value
+        self.show_pa_agent_bset()
+
     def callback_pa_agent_bset(self, msg:BeliefSet):
+        self.agent_dynamic_bset_ = msg.value
+        self.show_pa_agent_bset()
+
+    def show_pa_agent_bset(self):
+        beliefs = list(self.agent_static_bset_) + list(self.agent_dynamic_bset_)
         plastic_bin_pose = MGPose(-1,-1)
         paper_bin_pose = MGPose(-1,-1)
         plastic_agent_pose = MGPose(-1,-1)
@@ -101,7 +121,7 @@ class LitterWorldROS2Controller(Node):
 
         columns = 0
         rows = 0
-        for belief in msg.value:
+        for belief in beliefs:
             if belief.type == 'cell':
                 cell_pose = self.extract_pose_from_cell_name(belief.name)
                 columns = max(columns, cell_pose.y+1)
@@ -109,7 +129,7 @@ class LitterWorldROS2Controller(Node):
         
         current_map = [[OBSTACLE_CELL for x in range(columns)] for x in range(rows)]
         
-        for belief in msg.value:
+        for belief in beliefs:
             if belief.name == 'detection_depth':
                 detection_depth = int(belief.value)
             
@@ -162,6 +182,23 @@ class LitterWorldROS2Controller(Node):
             return MGPose(-1, -1)
 
     def callback_pa_agent_intentions(self, msg:BDIPlanExecutionInfoMin):
+        self.agent_intention_ = msg
+        self.agent_intention_delta_seq_ = 0
+        self.show_pa_agent_intention(msg)
+
+    def callback_pa_agent_intention_delta(self, msg:IntentionDelta):
+        # apply just the deltas following the ones already applied to the current snapshot (otherwise wait for the next snapshot)
+        if self.agent_intention_ is None or msg.seq != self.agent_intention_.seq or msg.delta_seq != self.agent_intention_delta_seq_ + 1:
+            return
+        actions = self.agent_intention_.actions_exec_info[msg.dequeued:]
+        for index, aex_min in zip(msg.updated_indexes, msg.updated):
+            actions[index] = aex_min
+        actions.extend(msg.appended)
+        self.agent_intention_.actions_exec_info = actions
+        self.agent_intention_delta_seq_ = msg.delta_seq
+        self.show_pa_agent_intention(self.agent_intention_)
+
+    def show_pa_agent_intention(self, msg:BDIPlanExecutionInfoMin):
         if self.get_parameter("show_agent_view").value == 'plastic_agent' or self.get_parameter("show_agent_view").value == 'paper_agent':
             #self.get_logger().info("Current info from /{}/current_intentions:".format(self.get_parameter("show_agent_view").value))
             target_pose = MGPose(-1, -1)
@@ -42,7 +42,7 @@ class LoadMapSensor : public Sensor
                     rclcpp::QoS(1).reliable(),
                     [&](const GridStatus::SharedPtr msg)
                         {
-                            if(msg->rows.size() > 0)
+                            if(msg->rows.size() > 0 && !static_map_requested_)
                             {
                                 BeliefSet bsetAddAll;
                                 vector<Belief> nearBeliefs = (loadNearPredicates(msg));
@@ -50,11 +50,6 @@ class LoadMapSensor : public Sensor
                                     bsetAddAll.value.push_back(b);
                                 // std::cout << "sensing " << nearBeliefs.size() << std::flush << std::endl;
 
-                                vector<Belief> freeCellsBeliefs = (markEmptyCells(msg));
-                                for(Belief b : freeCellsBeliefs)
-                                    bsetAddAll.value.push_back(b);
-                                // std::cout << "sensing " << freeCellsBeliefs.size() << std::flush << std::endl;
-
                                 if(robot_name_ == "plastic_agent")
                                 {
                                     Belief bPlaBin = getBeliefPrototype("plastic_bin").value();
@@ -76,21 +71,51 @@ class LoadMapSensor : public Sensor
                                     bsetAddAll.value.push_back(b);
                                 
                                 // std::cout << "sensing " << binPoses.size() << " binPoses" << std::flush << std::endl;
-                                if(belief_set_.value.size() < bsetAddAll.value.size())//still need to load all static info
-                                    senseAll(bsetAddAll, UpdOperation::ADD);
+                                // whole static map topology installed at once through the static beliefs loader
+                                static_map_requested_ = senseStatic(bsetAddAll);
+                            }
 
-                                else // loaded all static info -> can quit
+                            else if(static_map_loaded_)
+                            {
+                                // free cells are altered by the agents' moves, so they're sensed as usual (not static)
+                                BeliefSet bsetFreeCells;
+                                vector<Belief> freeCellsBeliefs = (markEmptyCells(msg));
+                                for(Belief b : freeCellsBeliefs)
+                                    bsetFreeCells.value.push_back(b);
+                                // std::cout << "sensing " << freeCellsBeliefs.size() << std::flush << std::endl;
+
+                                int freeCellsKnown = 0;
+                                for(auto b : belief_set_.value)
+                                    if(b.name == "free")
+                                        freeCellsKnown++;
+
+                                if(freeCellsKnown < freeCellsBeliefs.size())//still need to load all free cells
                                 {
-                                    Belief bMapLoaded = getBeliefPrototype("map_loaded").value();
-                                    sense(bMapLoaded, UpdOperation::ADD);
-                                    for(auto b : belief_set_.value)
-                                        if(b.name == "map_loaded")//map loaded and agent knows it->can quit
-                                            rclcpp::shutdown();
+                                    senseAll(bsetFreeCells, UpdOperation::ADD);
+                                    return;
                                 }
+
+                                // loaded all static info -> can quit
+                                Belief bMapLoaded = getBeliefPrototype("map_loaded").value();
+                                sense(bMapLoaded, UpdOperation::ADD);
+                                for(auto b : belief_set_.value)
+                                    if(b.name == "map_loaded")//map loaded and agent knows it->can quit
+                                        rclcpp::shutdown();
                             }
                         });
         }
 
+    protected:
+
+        /*
+            Static map block processed by the belief manager: if something went wrong, send it again at the next grid status
+        */
+        void staticBeliefsLoaded(const bool& success) override
+        {
+            static_map_loaded_ = success;
+            static_map_requested_ = success;
+        }
+
     private:
 
         /*
@@ -200,6 +225,8 @@ class LoadMapSensor : public Sensor
             return "c_" + std::to_string(i) + "_" + std::to_string(j);
         }
         string robot_name_;
+        bool static_map_requested_ = false;
+        bool static_map_loaded_ = false;
         BeliefSet belief_set_;
         rclcpp::Subscription<BeliefSet>::SharedPtr belief_set_subscriber_;
         rclcpp::Subscription<GridStatus>::SharedPtr litter_world_status_subscriber_;
@@ -55,7 +55,9 @@ def generate_launch_description():
         name=CARRIER_B_AGENT_ID+'_carrier_moving_boxes_sensor',
         specific_params=[
             {"init_sleep": 2},
-            {"sensing_freq": 0.5}
+            {"sensing_freq": 0.5},
+            {"sensing_mode": "event"},
+            {"min_sensing_interval_ms": 250}
         ])
 
 
@@ -36,6 +36,8 @@ class CarrierMovingBoxesSensor : public Sensor
         {
             robot_name_ = this->get_parameter("agent_id").as_string();
 
+            // gps topics stream continuously: in event mode sensing is triggered just when the count of the boxes 
+            // on the carrier changes, not at every position received
             current_position_sub_ = this->create_subscription<PointStamped>("/"+robot_name_+"_driver/gps", 
                 rclcpp::QoS(5).best_effort(),
                 std::bind(&CarrierMovingBoxesSensor::carrierGPSCallback, this, _1));
@@ -44,6 +46,7 @@ class CarrierMovingBoxesSensor : public Sensor
                 boxes_positions_subs_.push_back(this->create_subscription<PointStamped>("/"+box+"/gps", 
                     rclcpp::QoS(5).best_effort(),
                     [=](const PointStamped::SharedPtr msg){boxGPSCallback(msg, box);}));
+            last_counted_ = -1.0f;
 
             current_mb_ = Belief();
             current_mb_.name = proto_belief.name;
@@ -54,6 +57,18 @@ class CarrierMovingBoxesSensor : public Sensor
         }
 
         void performSensing()
+        {
+            //UPDATE current value of moving by agent boxes    
+            current_mb_.value = countMovingBoxes();
+            sense(current_mb_, ADD);
+        }
+
+    private:
+
+        /*
+            Returns the number of boxes currently on the carrier
+        */
+        float countMovingBoxes()
         {
             float moving_counter = 0.0f;
             for(auto box : boxes_)
@@ -64,13 +79,21 @@ class CarrierMovingBoxesSensor : public Sensor
                         moving_counter += 1.0;
                 }    
             }
-
-            //UPDATE current value of moving by agent boxes    
-            current_mb_.value = moving_counter;
-            sense(current_mb_, ADD);
+            return moving_counter;
         }
 
-    private:
+        /*
+            A position has been updated: notify the sensor input has changed just if the boxes on the carrier are not the same anymore
+        */
+        void positionUpdated()
+        {
+            float counted = countMovingBoxes();
+            if(counted != last_counted_)
+            {
+                last_counted_ = counted;
+                inputChanged();
+            }
+        }
 
         /*
             Returns true if the box is within the x boundaries of the carrier
@@ -99,15 +122,18 @@ class CarrierMovingBoxesSensor : public Sensor
         void carrierGPSCallback(const PointStamped::SharedPtr msg)
         {
             current_position_ = msg->point;//current position
+            positionUpdated();
         }
 
         void boxGPSCallback(const PointStamped::SharedPtr msg, const string box)
         {   
             boxes_positions_[box] = msg->point;//update gps value for box a1
+            positionUpdated();
         }
 
         string robot_name_;
         Belief current_mb_;//current value of moving_boxes function for the agent 
+        float last_counted_;//boxes on the carrier as counted at the last position update
         rclcpp::Subscription<PointStamped>::SharedPtr current_position_sub_;
         Point current_position_;
         vector<rclcpp::Subscription<PointStamped>::SharedPtr> boxes_positions_subs_;
@@ -1,5 +1,7 @@
 #include <string>
 #include <vector>
+#include <future>
+#include <chrono>
 
 #include "ros2_bdi_interfaces/msg/belief.hpp"
 #include "ros2_bdi_interfaces/msg/desire.hpp"
@@ -17,6 +19,9 @@ using BDICommunications::UpdOperation;
 using BDICommunications::ADD;
 using BDICommunications::UpdDesireResult;
 
+//seconds to wait for the response to the sweep desire request before failing the action
+#define MAX_WAIT_RESPONSE 6
+
 class AskSweeping : public BDIActionExecutor
 {
     public:
@@ -26,6 +31,15 @@ class AskSweeping : public BDIActionExecutor
             sent_ = false;
         }
 
+        rclcpp_lifecycle::node_interfaces::LifecycleNodeInterface::CallbackReturn
+            on_activate(const rclcpp_lifecycle::State & previous_state)
+        {
+            // forget any request left pending by a previous activation
+            sent_ = false;
+            req_status_ = std::shared_future<UpdDesireResult>();
+            return BDIActionExecutor::on_activate(previous_state);
+        }
+
         float advanceWork()
         {
             float currProgress = getProgress();
@@ -36,14 +50,29 @@ class AskSweeping : public BDIActionExecutor
 
             if(currProgress == 0.0f)
             {
-                sweep_desire_ = buildSweepRequest(waypoint);
-                auto reqStatus = sendUpdDesireRequest(sweeper_id, sweep_desire_, ADD, true);
-                if(reqStatus.accepted && reqStatus.performed)
-                    advancement += 0.015625f;//stop asking, wait for the fulfillment or long enough to know action is failed
-
-                else//desire request not accepted -> fail action    
-                    execFailed("Desire to sweep " + waypoint + " has been denied by " + sweeper_id);
-                
+                if(!sent_)
+                {
+                    sweep_desire_ = buildSweepRequest(waypoint);
+                    req_status_ = sendUpdDesireRequestAsync(sweeper_id, sweep_desire_, ADD, true);
+                    sent_at_ = std::chrono::steady_clock::now();
+                    sent_ = true;
+                }
+
+                if(req_status_.wait_for(std::chrono::seconds(0)) == std::future_status::ready)//response arrived (do not block in the meantime)
+                {
+                    auto reqStatus = req_status_.get();
+                    sent_ = false;
+                    if(reqStatus.accepted && reqStatus.performed)
+                        advancement += 0.015625f;//stop asking, wait for the fulfillment or long enough to know action is failed
+
+                    else//desire request not accepted -> fail action    
+                        execFailed("Desire to sweep " + waypoint + " has been denied by " + sweeper_id);
+                }
+                else if(std::chrono::steady_clock::now() - sent_at_ > std::chrono::seconds(MAX_WAIT_RESPONSE))
+                {
+                    sent_ = false;
+                    execFailed("No response from " + sweeper_id + " to the desire to sweep " + waypoint);
+                }
             
             }else if(isMonitoredDesireFulfilled(sweeper_id, sweep_desire_)){
                 advancement = 1.0f - currProgress;//missing part complete
@@ -81,6 +110,10 @@ class AskSweeping : public BDIActionExecutor
         }
 
         Desire sweep_desire_;
+        // pending response to the sweep desire request
+        std::shared_future<UpdDesireResult> req_status_;
+        // when the sweep desire request has been sent
+        std::chrono::steady_clock::time_point sent_at_;
         bool sent_;
 };
 